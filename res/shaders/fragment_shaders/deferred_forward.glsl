@@ -16,11 +16,20 @@ struct Material {
 	sampler2D EmissiveMap;
 	sampler2D NormalMap;
 	sampler2D MetallicShininessMap;
-	float     DiscardThreshold;
 };
 // Create a uniform for the material
 uniform Material u_Material;
 
+// Non-texture material parameters are stored in the material block, and
+// are still set from the application as u_Material.[name]
+layout (std140, binding = 3) uniform b_Material {
+	float DiscardThreshold;
+	// Set by the material when the normal map is BC5 compressed
+	int   NormalMapIsTwoChannel;
+} u_MaterialParams;
+
+#include "../fragments/normal_maps.glsl"
+
 #include "../fragments/frame_uniforms.glsl"
 
 // https://learnopengl.com/Advanced-Lighting/Advanced-Lighting
@@ -32,7 +41,7 @@ void main() {
 	vec4 lightingParams = texture(u_Material.MetallicShininessMap, inUV);
 
 	// Discarding fragments who's alpha is below the material's threshold
-	if (albedoColor.a < u_Material.DiscardThreshold) {
+	if (albedoColor.a < u_MaterialParams.DiscardThreshold) {
 		discard;
 	}
 
@@ -41,8 +50,7 @@ void main() {
 	
 	// Normalize our input normal
     // Read our tangent from the map, and convert from the [0,1] range to [-1,1] range
-    vec3 normal = texture(u_Material.NormalMap, inUV).rgb;
-    normal = normal * 2.0 - 1.0;
+    vec3 normal = UnpackNormalMap(texture(u_Material.NormalMap, inUV).rgb, u_MaterialParams.NormalMapIsTwoChannel != 0);
 
     // Here we apply the TBN matrix to transform the normal from tangent space to view space
     normal = normalize(inTBN * normal);
@@ -0,0 +1,64 @@
+#version 440
+#extension GL_ARB_bindless_texture : require
+
+#include "../fragments/fs_common_inputs.glsl"
+
+// The index of our material in the material buffer
+layout(location = 7) flat in uint inMaterialIndex;
+
+// We output to the same G-Buffer layers as deferred_forward.glsl
+layout(location = 0) out vec4 albedo_specPower;
+layout(location = 1) out vec4 normal_metallic;
+layout(location = 2) out vec4 emissive;
+layout(location = 3) out vec3 view_pos;
+
+// Same as the material in deferred_forward.glsl, but the textures are
+// bindless handles, so every material in the scene can be read from one buffer
+// Must match RenderLayer::IndirectMaterialData
+struct Material {
+	sampler2D AlbedoMap;
+	sampler2D EmissiveMap;
+	sampler2D NormalMap;
+	sampler2D MetallicShininessMap;
+	float     DiscardThreshold;
+	uint      NormalMapIsTwoChannel;
+	float     _padding[2];
+};
+layout(std430, binding = 1) readonly buffer b_Materials {
+	Material u_Materials[];
+};
+
+#include "../fragments/frame_uniforms.glsl"
+#include "../fragments/normal_maps.glsl"
+
+void main() {
+	Material material = u_Materials[inMaterialIndex];
+
+	// Get albedo from the material
+	vec4 albedoColor = texture(material.AlbedoMap, inUV);
+
+	// We can use another texture to store things like our lighting settings
+	vec4 lightingParams = texture(material.MetallicShininessMap, inUV);
+
+	// Discarding fragments who's alpha is below the material's threshold
+	if (albedoColor.a < material.DiscardThreshold) {
+		discard;
+	}
+
+	albedo_specPower = vec4(albedoColor.rgb, 1.0f);
+
+	// Read our normal from the map, and convert from the [0,1] range to [-1,1] range
+	vec3 normal = UnpackNormalMap(texture(material.NormalMap, inUV).rgb, material.NormalMapIsTwoChannel != 0);
+
+	// Here we apply the TBN matrix to transform the normal from tangent space to view space
+	normal = normalize(inTBN * normal);
+
+	// Map [-1, 1] to [0, 1]
+	normal = clamp((normal + 1) / 2.0, 0, 1);
+	normal_metallic = vec4(normal, lightingParams.y);
+
+	// Extract emissive from the material
+	emissive = texture(material.EmissiveMap, inUV);
+
+	view_pos = inViewPos;
+}
@@ -43,6 +43,17 @@ layout (std140, binding = 1) uniform b_InstanceLevelUniforms {
 #define FLAG_ENABLE_COLOR_GRADING_COOL (1 << 8)
 #define FLAG_ENABLE_COLOR_GRADING_CUSTOM (1 << 9)
 
+// Shader variants compiled with the render flags as keywords get the flags as a
+// constant, so that the compiler can strip out any branches that are disabled
+#ifdef SHADER_KEYWORDS
+bool IsFlagSet(uint flag) {
+    return (SHADER_KEYWORDS & flag) != 0;
+}
+
+bool IsMultipleFlagSet(uint flags) {
+    return (SHADER_KEYWORDS & flags) == flags;
+}
+#else
 bool IsFlagSet(uint flag) {
     return (u_Flags & flag) != 0;
 }
@@ -50,6 +61,7 @@ bool IsFlagSet(uint flag) {
 bool IsMultipleFlagSet(uint flags) {
     return (u_Flags & flags) == flags;
 }
+#endif
 
 float linearize(float depth) {
     return (2 * u_ZNear) / (u_ZFar + u_ZNear - depth * (u_ZFar - u_ZNear));
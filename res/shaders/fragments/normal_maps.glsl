@@ -0,0 +1,10 @@
+// Converts a texel read from a tangent space normal map into a normal in the [-1, 1] range
+// Normal maps that are block compressed as BC5 only store X and Y (blue reads as 0), so for
+// those we rebuild Z from the fact that the normal is unit length and always faces outwards
+vec3 UnpackNormalMap(vec3 texel, bool isTwoChannel) {
+    vec3 normal = texel * 2.0 - 1.0;
+    if (isTwoChannel) {
+        normal.z = sqrt(clamp(1.0 - dot(normal.xy, normal.xy), 0.0, 1.0));
+    }
+    return normal;
+}
@@ -0,0 +1,47 @@
+#version 460
+
+// Include our common vertex shader attributes and uniforms
+#include "../fragments/vs_common.glsl"
+
+// The index of this shader's first draw in the draw data, gl_DrawID is relative to the
+// start of the glMultiDrawElementsIndirect call (see RenderLayer::_SubmitIndirectBatches)
+uniform uint u_DrawOffset;
+
+// The material to use, passed along to the fragment shader
+layout(location = 7) flat out uint outMaterialIndex;
+
+// Per-draw data, replaces the instance level uniforms
+struct DrawData {
+	mat4 Model;
+	mat4 NormalMatrix;
+	uint MaterialIndex;
+};
+layout(std430, binding = 0) readonly buffer b_DrawData {
+	DrawData u_Draws[];
+};
+
+void main() {
+	DrawData draw = u_Draws[u_DrawOffset + uint(gl_DrawID)];
+	mat3 normalMatrix = mat3(draw.NormalMatrix);
+
+	vec4 worldPos = draw.Model * vec4(inPosition, 1.0);
+	gl_Position = u_ViewProjection * worldPos;
+
+	// Pass vertex pos in view space to frag shader
+	outViewPos = (u_View * worldPos).xyz;
+
+	// Normals
+	outNormal = (u_View * vec4(normalMatrix * inNormal, 0)).xyz;
+
+	// We use a TBN matrix for tangent space normal mapping
+	vec3 T = normalize((u_View * vec4(normalMatrix * inTangent, 0)).xyz);
+	vec3 B = normalize((u_View * vec4(normalMatrix * inBiTangent, 0)).xyz);
+	vec3 N = normalize((u_View * vec4(normalMatrix * inNormal, 0)).xyz);
+	outTBN = mat3(T, B, N);
+
+	// Pass our UV coords to the fragment shader
+	outUV = inUV;
+	outColor = inColor;
+
+	outMaterialIndex = draw.MaterialIndex;
+}
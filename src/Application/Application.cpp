@@ -12,6 +12,7 @@
 #include "Utils/FileHelpers.h"
 #include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/ImGuiHelper.h"
+#include "Utils/ThreadPool.h"
 
 // Graphics
 #include "Graphics/Buffers/IndexBuffer.h"
@@ -24,6 +25,7 @@
 #include "Graphics/Textures/TextureCube.h"
 #include "Graphics/VertexTypes.h"
 #include "Graphics/Font.h"
+#include "Graphics/GuiSprite.h"
 #include "Graphics/GuiBatcher.h"
 #include "Graphics/Framebuffer.h"
 
@@ -31,6 +33,7 @@
 #include "Gameplay/Material.h"
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
+#include "Gameplay/AnimationClipSet.h"
 
 // Components
 #include "Gameplay/Components/IComponent.h"
@@ -82,7 +85,9 @@ Application::Application() :
 	_isEditor(true),
 	_windowTitle("INFR - 2350U"),
 	_currentScene(nullptr),
-	_targetScene(nullptr)
+	_targetScene(nullptr),
+	_sceneLoad(),
+	_uploadBudgetMs(4.0f)
 { }
 
 Application::~Application() = default; 
@@ -120,17 +125,37 @@ void Application::Quit() {
 	_isRunning = false;
 }
 
-bool Application::LoadScene(const std::string& path) {
+bool Application::LoadScene(const std::string& path, const std::function<void(float)>& onProgress) {
 	if (std::filesystem::exists(path)) { 
 
 		std::string manifestPath = std::filesystem::path(path).stem().string() + "-manifest.json";
+		bool isAsync = ResourceManager::IsAsyncLoadingEnabled();
 		if (std::filesystem::exists(manifestPath)) {
 			LOG_INFO("Loading manifest from \"{}\"", manifestPath);
-			ResourceManager::LoadManifest(manifestPath);
+			// When streaming, we kick off all the scene's assets now so they can decode in parallel while the scene parses
+			ResourceManager::LoadManifest(manifestPath, isAsync, false);
+		}
+
+		// If we're streaming, parse the scene in the background and switch once everything is ready
+		if (isAsync) {
+			LOG_INFO("Loading scene from \"{}\"", path);
+			_sceneLoad = SceneLoadRequest();
+			_sceneLoad.IsActive   = true;
+			_sceneLoad.Path       = path;
+			_sceneLoad.OnProgress = onProgress;
+			// Binary snapshots are memory mapped and built in a single pass, so there's nothing to parse in the background
+			_sceneLoad.IsSnapshot = !Gameplay::Scene::FindSnapshot(path).empty();
+			if (!_sceneLoad.IsSnapshot) {
+				_sceneLoad.Blob = ThreadPool::Enqueue([path]() { return Gameplay::Scene::ReadSceneFile(path); });
+			}
+			return true;
 		}
 
 		Gameplay::Scene::Sptr scene = Gameplay::Scene::Load(path);
 		LoadScene(scene);
+		if (onProgress) {
+			onProgress(1.0f);
+		}
 		return scene != nullptr;
 	}
 	return false;
@@ -179,6 +204,11 @@ void Application::_Run()
 	// By default, we want our viewport to be the whole screen
 	_primaryViewport = { 0, 0, _windowSize.x, _windowSize.y };
 
+	// Spin up our worker threads so that resources can be streamed in the background
+	ThreadPool::Init(JsonGet(_appSettings, "worker_threads", 0));
+	ResourceManager::SetAsyncLoadingEnabled(JsonGet(_appSettings, "async_loading", true));
+	_uploadBudgetMs = JsonGet(_appSettings, "upload_budget_ms", 4.0f);
+
 	// Register all component and resource types
 	_RegisterClasses();
 
@@ -194,6 +224,10 @@ void Application::_Run()
 
 	// Infinite loop as long as the application is running
 	while (_isRunning) {
+		// Upload any resources that have finished decoding, and check on background scene loads
+		ResourceManager::ProcessUploads(_uploadBudgetMs);
+		_PollSceneLoad();
+
 		// Handle scene switching
 		if (_targetScene != nullptr) {
 			_HandleSceneChange();
@@ -264,7 +298,9 @@ void Application::_RegisterClasses()
 	ResourceManager::RegisterType<ShaderProgram>();
 	ResourceManager::RegisterType<Material>();
 	ResourceManager::RegisterType<MeshResource>();
+	ResourceManager::RegisterType<AnimationClipSet>();
 	ResourceManager::RegisterType<Font>();
+	ResourceManager::RegisterType<GuiSprite>();
 	ResourceManager::RegisterType<Framebuffer>();
 
 	// Register all of our component types so we can load them from files
@@ -363,6 +399,10 @@ void Application::_PostRender() {
 }
 
 void Application::_Unload() {
+	// Make sure no workers are still decoding into resources that are about to be released
+	ResourceManager::FlushAsyncLoads(true);
+	ThreadPool::Shutdown();
+
 	// Note that we use a reverse iterator for unloading
 	for (auto it = _layers.crbegin(); it != _layers.crend(); it++) {
 		const auto& layer = *it;
@@ -407,6 +447,47 @@ void Application::_HandleSceneChange() {
 	_targetScene = nullptr;
 }
 
+void Application::_PollSceneLoad() {
+	if (!_sceneLoad.IsActive) {
+		return;
+	}
+
+	// Wait for the worker to finish reading the file, then build the scene, which will kick off resource loads
+	if (_sceneLoad.Scene == nullptr) {
+		if (!_sceneLoad.IsSnapshot && _sceneLoad.Blob.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			if (_sceneLoad.OnProgress) {
+				_sceneLoad.OnProgress(0.0f);
+			}
+			return;
+		}
+
+		try {
+			_sceneLoad.Scene = _sceneLoad.IsSnapshot ?
+				Gameplay::Scene::Load(_sceneLoad.Path) :
+				Gameplay::Scene::FromJson(_sceneLoad.Blob.get(), _sceneLoad.Path);
+		}
+		catch (std::exception& e) {
+			LOG_ERROR("Failed to load scene from \"{}\": {}", _sceneLoad.Path, e.what());
+			_sceneLoad = SceneLoadRequest();
+			return;
+		}
+	}
+
+	// Parsing the scene counts as the first 10%, the rest is streaming in resources
+	if (ResourceManager::GetPendingLoadCount() > 0) {
+		if (_sceneLoad.OnProgress) {
+			_sceneLoad.OnProgress(0.1f + 0.9f * ResourceManager::GetLoadProgress());
+		}
+		return;
+	}
+
+	if (_sceneLoad.OnProgress) {
+		_sceneLoad.OnProgress(1.0f);
+	}
+	LoadScene(_sceneLoad.Scene);
+	_sceneLoad = SceneLoadRequest();
+}
+
 void Application::_HandleWindowSizeChanged(const glm::ivec2& newSize) {
 	for (const auto& layer : _layers) {
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnWindowResize)) {
@@ -456,6 +537,10 @@ nlohmann::json Application::_GetDefaultAppSettings()
 
 	result["window_width"]  = DEFAULT_WINDOW_WIDTH;
 	result["window_height"] = DEFAULT_WINDOW_HEIGHT;
+
+	result["async_loading"]    = true;
+	result["upload_budget_ms"] = 4.0f;
+	result["worker_threads"]   = 0;
 	return result;
 }
 
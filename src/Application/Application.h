@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+#include <future>
+#include <functional>
 #include <GLM/glm.hpp>
 #include <json.hpp>
 #include "Utils/Macros.h"
@@ -67,12 +69,14 @@ public:
 	void Quit();
 
 	/**
-	 * Loads a new scene into the application using a path on disk
+	 * Loads a new scene into the application using a path on disk. If async loading is enabled, the
+	 * scene is parsed in the background and will be switched to once all of it's resources have streamed in
 	 * 
 	 * @param path The path to the scene file to load
-	 * @returns True if the file was found and the scene loaded, false if otherwise
+	 * @param onProgress An optional callback that will receive the load progress in the 0-1 range each frame
+	 * @returns True if the file was found and the scene load started, false if otherwise
 	 */
-	bool LoadScene(const std::string& path);
+	bool LoadScene(const std::string& path, const std::function<void(float)>& onProgress = nullptr);
 	/**
 	 * Loads a scene that has been pre-loaded into the application
 	 * 
@@ -140,6 +144,22 @@ protected:
 	// Stores all the layers of the application, in the order they should be invoked
 	std::vector<ApplicationLayer::Sptr> _layers;
 
+	// Tracks a scene that is being loaded in the background
+	struct SceneLoadRequest {
+		bool                       IsActive = false;
+		std::string                Path;
+		// True if the scene will be loaded from a binary snapshot instead of JSON
+		bool                       IsSnapshot = false;
+		// The parsed scene file, filled in by a worker thread
+		std::future<nlohmann::json> Blob;
+		// The scene, once it has been constructed from the blob
+		Gameplay::Scene::Sptr      Scene = nullptr;
+		std::function<void(float)> OnProgress = nullptr;
+	} _sceneLoad;
+
+	// The maximum time in milliseconds to spend uploading streamed resources each frame
+	float       _uploadBudgetMs;
+
 	void _Run();
 	void _RegisterClasses();
 	void _Load();
@@ -150,6 +170,7 @@ protected:
 	void _PostRender();
 	void _Unload();
 	void _HandleSceneChange();
+	void _PollSceneLoad();
 	void _HandleWindowSizeChanged(const glm::ivec2& newSize);
 	void _ConfigureSettings();
 	nlohmann::json _GetDefaultAppSettings();
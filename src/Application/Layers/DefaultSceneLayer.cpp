@@ -79,6 +79,7 @@
 #include "Graphics/Textures/Texture3D.h"
 #include "Graphics/Textures/Texture1D.h"
 #include "Application/Layers/ImGuiDebugLayer.h"
+#include "Application/Layers/RenderLayer.h"
 #include "Application/Windows/DebugWindow.h"
 #include "Gameplay/Components/ShadowCamera.h"
 
@@ -117,6 +118,17 @@ void DefaultSceneLayer::_CreateScene()
 		});
 		deferredForward->SetDebugName("Deferred - GBuffer Generation");  
 
+		// Same as deferredForward, but reads transforms and materials from storage buffers, letting
+		// the render layer draw everything using deferredForward with one multi-draw-indirect call
+		if (ITexture::GetLimits().SUPPORTS_BINDLESS) {
+			ShaderProgram::Sptr deferredForwardIndirect = ResourceManager::CreateAsset<ShaderProgram>(std::unordered_map<ShaderPartType, std::string>{
+				{ ShaderPartType::Vertex, "shaders/vertex_shaders/gpu_driven.glsl" },
+				{ ShaderPartType::Fragment, "shaders/fragment_shaders/deferred_forward_indirect.glsl" }
+			});
+			deferredForwardIndirect->SetDebugName("Deferred - GBuffer Generation (Indirect)");
+			app.GetLayer<RenderLayer>()->SetIndirectShader(deferredForward, deferredForwardIndirect);
+		}
+
 		// Our foliage shader which manipulates the vertices of the mesh
 		ShaderProgram::Sptr foliageShader = ResourceManager::CreateAsset<ShaderProgram>(std::unordered_map<ShaderPartType, std::string>{
 			{ ShaderPartType::Vertex, "shaders/vertex_shaders/foliage.glsl" },
@@ -622,13 +634,13 @@ void DefaultSceneLayer::_CreateScene()
 
 		///////////////////////////////////////////////////////////////////////
 
-		GuiBatcher::SetDefaultTexture(ResourceManager::CreateAsset<Texture2D>("textures/ui-sprite.png"));
+		GuiBatcher::SetDefaultSprite(ResourceManager::CreateAsset<GuiSprite>("textures/ui-sprite.png"));
 		GuiBatcher::SetDefaultBorderRadius(8);
 
 		// Save the asset manifest for all the resources we just loaded
 		ResourceManager::SaveManifest("scene-manifest.json");
-		// Save the scene to a JSON file
-		scene->Save("scene.json");
+		// Save the scene to a JSON file, along with a binary snapshot for fast loading
+		scene->Save("scene.json", SceneFormat::Both);
 
 		// Send the scene to the application
 		app.LoadScene(scene);
@@ -165,7 +165,7 @@ void ImGuiDebugLayer::OnRender(const Framebuffer::Sptr& prevLayer)
 
 				// Load scene item
 				if (ImGui::MenuItem("Load Scene", NULL, false)) {
-					std::optional<std::string> path = FileDialogs::OpenFile("Scene File\0*.json\0\0");
+					std::optional<std::string> path = FileDialogs::OpenFile("Scene File\0*.json;*.scnb\0\0");
 					if (path.has_value()) {
 						app.LoadScene(path.value());
 					}
@@ -175,7 +175,7 @@ void ImGuiDebugLayer::OnRender(const Framebuffer::Sptr& prevLayer)
 				if (ImGui::MenuItem("Save Scene", NULL, false)) {
 					std::optional<std::string> path = FileDialogs::SaveFile("Scene File\0*.json\0\0");
 					if (path.has_value()) {
-						app.CurrentScene()->Save(path.value());
+						app.CurrentScene()->Save(path.value(), SceneFormat::Both);
 
 						std::string newFilename = std::filesystem::path(path.value()).stem().string() + "-manifest.json";
 						ResourceManager::SaveManifest(newFilename);
@@ -302,7 +302,7 @@ void ImGuiDebugLayer::_RenderGameWindow()
 	if (ImGui::Button(buffer)) {
 		// Save scene so it can be restored when exiting play mode
 		if (!scene->IsPlaying) {
-			_backupState = scene->ToJson();
+			_backupState = scene->ToSnapshot();
 		}
 
 		// Toggle state
@@ -310,9 +310,10 @@ void ImGuiDebugLayer::_RenderGameWindow()
 
 		// If we've gone from playing to not playing, restore the state from before we started playing
 		if (!scene->IsPlaying) {
+			std::string filePath = scene->GetFilePath();
 			scene = nullptr;
 			// We reload to scene from our cached state
-			scene = Scene::FromJson(_backupState);
+			scene = Scene::FromSnapshot(_backupState.data(), _backupState.size(), filePath);
 			app.LoadScene(scene);
 		}
 	}
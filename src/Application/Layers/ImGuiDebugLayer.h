@@ -49,7 +49,7 @@ public:
 
 protected:
 	std::vector<IEditorWindow::Sptr> _windows;
-	nlohmann::json _backupState;
+	std::vector<uint8_t> _backupState;
 	bool           _dockInvalid;
 
 	void _RenderGameWindow();
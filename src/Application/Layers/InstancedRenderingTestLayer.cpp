@@ -45,7 +45,9 @@ void InstancedRenderingTestLayer::OnSceneLoad() {
 	_shader = ShaderProgram::Create();
 	_shader->LoadShaderPartFromFile("shaders/vertex_shaders/basic_instanced.glsl", ShaderPartType::Vertex); 
 	_shader->LoadShaderPartFromFile("shaders/fragment_shaders/frag_environment_mirror.glsl", ShaderPartType::Fragment);
-	_shader->Link();
+	if (!_shader->Link()) {
+		LOG_ERROR("Failed to build the instanced rendering shader, instances will not be drawn");
+	}
 
 
 	// Due to how scene stuff is handled in editor, we'll remove all existing instances and re-add them
@@ -81,6 +83,9 @@ void InstancedRenderingTestLayer::OnUpdate() {
 }
 
 void InstancedRenderingTestLayer::OnRender(const Framebuffer::Sptr& prevLayer) {
+	if (!_shader->WaitForLink()) {
+		return;
+	}
 	_shader->Bind();
 	_vao->DrawInstanced(_instances.size());
 }
@@ -0,0 +1,96 @@
+#include "PhysicsStressTestLayer.h"
+#include "Gameplay/Scene.h"
+#include "Gameplay/MeshResource.h"
+#include "Gameplay/Components/RenderComponent.h"
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/Colliders/BoxCollider.h"
+#include "Application/Application.h"
+#include "Utils/MeshFactory.h"
+#include "Utils/ResourceManager/ResourceManager.h"
+
+using namespace Gameplay;
+using namespace Gameplay::Physics;
+
+PhysicsStressTestLayer::PhysicsStressTestLayer() :
+	ApplicationLayer(),
+	GridSize(glm::ivec3(16, 16, 12)),
+	_objects(),
+	_stepTimeTotal(0.0f),
+	_sampleCount(0)
+{
+	Name = "Physics Stress Test";
+	Overrides = AppLayerFunctions::OnSceneLoad | AppLayerFunctions::OnUpdate;
+}
+
+PhysicsStressTestLayer::~PhysicsStressTestLayer()
+{ }
+
+void PhysicsStressTestLayer::OnSceneLoad() {
+	Scene::Sptr scene = Application::Get().CurrentScene();
+
+	// Due to how scene stuff is handled in editor, we'll remove all existing objects and re-add them
+	for (auto& object : _objects) {
+		scene->RemoveGameObject(scene->FindObjectByGUID(object));
+	}
+	_objects.clear();
+	_objects.reserve(GridSize.x * GridSize.y * GridSize.z + 1);
+
+	// The boxes need something to fall onto
+	if (glm::length(scene->GetGravity()) == 0.0f) {
+		scene->SetGravity(glm::vec3(0.0f, 0.0f, -9.81f));
+	}
+
+	MeshResource::Sptr boxMesh = ResourceManager::CreateAsset<MeshResource>();
+	boxMesh->AddParam(MeshBuilderParam::CreateCube(ZERO_3, ONE_3));
+	boxMesh->GenerateMesh();
+
+	const float spacing = 1.5f;
+	glm::vec2 gridExtents = glm::vec2(GridSize.x, GridSize.y) * spacing * 0.5f;
+
+	GameObject::Sptr ground = scene->CreateGameObject("Stress Ground");
+	{
+		ground->SetPosition(glm::vec3(0.0f, 0.0f, -1.0f));
+		ground->HideInHierarchy = true;
+
+		RigidBody::Sptr physics = ground->Add<RigidBody>(RigidBodyType::Static);
+		physics->AddCollider(BoxCollider::Create(glm::vec3(gridExtents + spacing, 0.5f)));
+		_objects.push_back(ground);
+	}
+
+	// Towers of unit boxes, each resting on the one below so the solver has large islands to chew through
+	for (int ix = 0; ix < GridSize.x; ix++) {
+		for (int iy = 0; iy < GridSize.y; iy++) {
+			for (int iz = 0; iz < GridSize.z; iz++) {
+				GameObject::Sptr box = scene->CreateGameObject("Stress Box");
+				box->SetPosition(glm::vec3(ix * spacing - gridExtents.x, iy * spacing - gridExtents.y, iz * 1.0f));
+				box->HideInHierarchy = true;
+
+				RenderComponent::Sptr renderer = box->Add<RenderComponent>();
+				renderer->SetMesh(boxMesh);
+				renderer->SetMaterial(scene->DefaultMaterial);
+
+				RigidBody::Sptr physics = box->Add<RigidBody>(RigidBodyType::Dynamic);
+				physics->AddCollider(BoxCollider::Create(glm::vec3(0.5f)));
+
+				_objects.push_back(box);
+			}
+		}
+	}
+
+	LOG_INFO("Spawned {} boxes for physics stress test", GridSize.x * GridSize.y * GridSize.z);
+	_stepTimeTotal = 0.0f;
+	_sampleCount = 0;
+}
+
+void PhysicsStressTestLayer::OnUpdate() {
+	Scene::Sptr scene = Application::Get().CurrentScene();
+	if (!scene->IsPlaying) return;
+
+	_stepTimeTotal += scene->GetLastPhysicsStepTime();
+	_sampleCount++;
+	if (_sampleCount >= SAMPLE_FRAMES) {
+		LOG_INFO("Physics step ({}): {:.3f} ms average", scene->GetMultithreadedPhysics() ? "multithreaded" : "single threaded", _stepTimeTotal / _sampleCount);
+		_stepTimeTotal = 0.0f;
+		_sampleCount = 0;
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "Application/ApplicationLayer.h"
+#include "Gameplay/GameObject.h"
+
+/**
+ * Spawns a large number of stacked dynamic boxes into the current scene, and periodically
+ * logs the average physics step time so that the single and multithreaded worlds can be
+ * compared (toggle "Multithreaded Physics" in the debug window)
+ */
+class PhysicsStressTestLayer final : public ApplicationLayer {
+public:
+	MAKE_PTRS(PhysicsStressTestLayer)
+
+	PhysicsStressTestLayer();
+	virtual ~PhysicsStressTestLayer();
+
+	/**
+	 * The number of box towers along the X and Y axis, and the number of boxes in each tower
+	 */
+	glm::ivec3 GridSize;
+
+	// Inherited from ApplicationLayer
+
+	virtual void OnSceneLoad() override;
+	virtual void OnUpdate() override;
+
+protected:
+	std::vector<Gameplay::GameObject::WeakRef> _objects;
+
+	// Step times are averaged over this many frames before being logged
+	static const int SAMPLE_FRAMES = 120;
+	float _stepTimeTotal;
+	int   _sampleCount;
+};
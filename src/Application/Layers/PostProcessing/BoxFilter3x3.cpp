@@ -27,8 +27,10 @@ BoxFilter3x3::~BoxFilter3x3() = default;
 void BoxFilter3x3::Apply(const Framebuffer::Sptr& gBuffer)
 {
 	_shader->Bind(); 
-	_shader->SetUniform("u_Filter", Filter, 9); 
-	_shader->SetUniform("u_PixelSize", glm::vec2(1.0f) / (glm::vec2)gBuffer->GetSize()); 
+	_filterUniform.Resolve(_shader);
+	_pixelSizeUniform.Resolve(_shader);
+	_filterUniform.Set(Filter, 9);
+	_pixelSizeUniform.Set(glm::vec2(1.0f) / (glm::vec2)gBuffer->GetSize());
 }
 
 void BoxFilter3x3::RenderImGui()
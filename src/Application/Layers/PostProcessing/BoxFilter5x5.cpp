@@ -26,8 +26,10 @@ BoxFilter5x5::~BoxFilter5x5() = default;
 void BoxFilter5x5::Apply(const Framebuffer::Sptr& gBuffer)
 {
 	_shader->Bind();
-	_shader->SetUniform("u_Filter", Filter, 25);
-	_shader->SetUniform("u_PixelSize", glm::vec2(1.0f) / (glm::vec2)gBuffer->GetSize()); 
+	_filterUniform.Resolve(_shader);
+	_pixelSizeUniform.Resolve(_shader);
+	_filterUniform.Set(Filter, 25);
+	_pixelSizeUniform.Set(glm::vec2(1.0f) / (glm::vec2)gBuffer->GetSize());
 }
 
 void BoxFilter5x5::RenderImGui()
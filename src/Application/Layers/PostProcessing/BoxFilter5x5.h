@@ -1,6 +1,7 @@
 #pragma once
 #include "Application/Layers/PostProcessingLayer.h"
 #include "Graphics/ShaderProgram.h"
+#include "Graphics/UniformHandle.h"
 #include "Graphics/Textures/Texture3D.h"
 #include "Graphics/Framebuffer.h"
 
@@ -22,4 +23,6 @@ public:
 
 protected:
 	ShaderProgram::Sptr _shader;
+	UniformHandle<float>     _filterUniform    = "u_Filter";
+	UniformHandle<glm::vec2> _pixelSizeUniform = "u_PixelSize";
 };
\ No newline at end of file
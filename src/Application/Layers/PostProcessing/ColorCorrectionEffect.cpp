@@ -31,7 +31,8 @@ void ColorCorrectionEffect::Apply(const Framebuffer::Sptr& gBuffer)
 {
 	_shader->Bind();
 	Lut->Bind(1);
-	_shader->SetUniform("u_Strength", _strength);
+	_strengthUniform.Resolve(_shader);
+	_strengthUniform.Set(_strength);
 }
 
 void ColorCorrectionEffect::RenderImGui()
@@ -1,6 +1,7 @@
 #pragma once
 #include "Application/Layers/PostProcessingLayer.h"
 #include "Graphics/ShaderProgram.h"
+#include "Graphics/UniformHandle.h"
 #include "Graphics/Textures/Texture3D.h"
 
 class ColorCorrectionEffect : public PostProcessingLayer::Effect {
@@ -23,5 +24,6 @@ public:
 protected:
 	ShaderProgram::Sptr _shader;
 	float _strength;
+	UniformHandle<float> _strengthUniform = "u_Strength";
 };
 
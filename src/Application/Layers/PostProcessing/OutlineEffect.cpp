@@ -27,13 +27,22 @@ OutlineEffect::~OutlineEffect() = default;
 void OutlineEffect::Apply(const Framebuffer::Sptr& gBuffer)
 {
 	_shader->Bind();
-	_shader->SetUniform("u_OutlineColor", _outlineColor);
-	_shader->SetUniform("u_Scale", _scale);
-	_shader->SetUniform("u_DepthThreshold", _depthThreshold);
-	_shader->SetUniform("u_NormalThreshold", _normalThreshold);
-	_shader->SetUniform("u_DepthNormThreshold", _depthNormalThreshold);
-	_shader->SetUniform("u_DepthNormThresholdScale", _depthNormalThresholdScale);
-	_shader->SetUniform("u_PixelSize", glm::vec2(1.0f) / (glm::vec2)gBuffer->GetSize());
+	// Resolving is only done the first time, after that these are just a pointer comparison
+	_outlineColorUniform.Resolve(_shader);
+	_scaleUniform.Resolve(_shader);
+	_depthThresholdUniform.Resolve(_shader);
+	_normalThresholdUniform.Resolve(_shader);
+	_depthNormThresholdUniform.Resolve(_shader);
+	_depthNormThresholdScaleUniform.Resolve(_shader);
+	_pixelSizeUniform.Resolve(_shader);
+
+	_outlineColorUniform.Set(_outlineColor);
+	_scaleUniform.Set(_scale);
+	_depthThresholdUniform.Set(_depthThreshold);
+	_normalThresholdUniform.Set(_normalThreshold);
+	_depthNormThresholdUniform.Set(_depthNormalThreshold);
+	_depthNormThresholdScaleUniform.Set(_depthNormalThresholdScale);
+	_pixelSizeUniform.Set(glm::vec2(1.0f) / (glm::vec2)gBuffer->GetSize());
 	gBuffer->BindAttachment(RenderTargetAttachment::Depth, 1);
 	gBuffer->BindAttachment(RenderTargetAttachment::Color1, 2); // The normal buffer
 }
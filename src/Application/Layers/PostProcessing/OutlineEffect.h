@@ -1,6 +1,7 @@
 #pragma once
 #include "Application/Layers/PostProcessingLayer.h"
 #include "Graphics/ShaderProgram.h"
+#include "Graphics/UniformHandle.h"
 #include "Graphics/Textures/Texture3D.h"
 
 class OutlineEffect : public PostProcessingLayer::Effect {
@@ -27,6 +28,14 @@ protected:
 	float               _depthNormalThreshold;
 	float               _depthNormalThresholdScale;
 
+	UniformHandle<glm::vec4> _outlineColorUniform            = "u_OutlineColor";
+	UniformHandle<float>     _scaleUniform                   = "u_Scale";
+	UniformHandle<float>     _depthThresholdUniform          = "u_DepthThreshold";
+	UniformHandle<float>     _normalThresholdUniform         = "u_NormalThreshold";
+	UniformHandle<float>     _depthNormThresholdUniform      = "u_DepthNormThreshold";
+	UniformHandle<float>     _depthNormThresholdScaleUniform = "u_DepthNormThresholdScale";
+	UniformHandle<glm::vec2> _pixelSizeUniform               = "u_PixelSize";
+
 };
 
 
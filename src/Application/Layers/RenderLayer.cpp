@@ -16,7 +16,24 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <GLM/gtx/common.hpp> // for fmod (floating modulus)
 #include "Gameplay/Components/ShadowCamera.h"
-
+#include "Graphics/MeshMegaBuffer.h"
+
+const char* RenderLayer::DRAW_DATA_BLOCK_NAME = "b_DrawData";
+
+// Shader keywords for each of our render flags, in bit order so that a variant's
+// keyword mask is the same as the render flags it was compiled for
+static const std::vector<std::string> RENDER_FLAG_KEYWORDS = {
+	"RENDER_NO_LIGHTS",
+	"RENDER_AMBIENT_ONLY",
+	"RENDER_SPECULAR_ONLY",
+	"RENDER_AMBIENT_SPECULAR",
+	"RENDER_AMBIENT_SPECULAR_SHADER",
+	"RENDER_DIFFUSE_WARP",
+	"RENDER_SPECULAR_WARP",
+	"RENDER_WARM_COLOR_CORRECTION",
+	"RENDER_COOL_COLOR_CORRECTION",
+	"RENDER_CUSTOM_COLOR_CORRECTION"
+};
 
 RenderLayer::RenderLayer() :
 	ApplicationLayer(),
@@ -25,7 +42,9 @@ RenderLayer::RenderLayer() :
 	_frameUniforms(nullptr),
 	_instanceUniforms(nullptr),
 	_renderFlags(RenderFlags::AmbientSpecularShader),
-	_clearColor({ 0.1f, 0.1f, 0.1f, 1.0f })
+	_clearColor({ 0.1f, 0.1f, 0.1f, 1.0f }),
+	_gpuDriven(false),
+	_indirectBatchCount(0)
 {
 	Name = "Rendering";
 	Overrides = 
@@ -279,21 +298,20 @@ void RenderLayer::_AccumulateLighting()
 			shadowCam->GetProjectionMask()->Bind(6);
 		}
 
-		//_shadowShader->SetUniformMatrix("u_ClipToShadow", clipToShadow); 
-		_shadowShader->SetUniformMatrix("u_ViewToShadow", viewToShadow); 
+		_shadowUniforms.ViewToShadow.Set(viewToShadow);
 
 		// Get color and normalize it (strip the alpha)
 		glm::vec4 color = shadowCam->GetColor();
 		color *= color.w;
 
-		_shadowShader->SetUniform("u_LightDirViewspace", lightDirViewSpace);
-		_shadowShader->SetUniform("u_ShadowBias", shadowCam->Bias);
-		_shadowShader->SetUniform("u_NormalBias", shadowCam->NormalBias);
-		_shadowShader->SetUniform("u_Attenuation", 1/shadowCam->Range);
-		_shadowShader->SetUniform("u_Intensity", shadowCam->Intensity);
-		_shadowShader->SetUniform("u_LightColor", (glm::vec3)color);
-		_shadowShader->SetUniform("u_LightPosViewspace", lightPosViewSpace);
-		_shadowShader->SetUniform("u_ShadowFlags", *shadowCam->Flags);
+		_shadowUniforms.LightDirViewspace.Set(lightDirViewSpace);
+		_shadowUniforms.ShadowBias.Set(shadowCam->Bias);
+		_shadowUniforms.NormalBias.Set(shadowCam->NormalBias);
+		_shadowUniforms.Attenuation.Set(1/shadowCam->Range);
+		_shadowUniforms.Intensity.Set(shadowCam->Intensity);
+		_shadowUniforms.LightColor.Set((glm::vec3)color);
+		_shadowUniforms.LightPosViewspace.Set(lightPosViewSpace);
+		_shadowUniforms.ShadowFlags.Set(*shadowCam->Flags);
 
 		// Draw the fullscreen quad to accumulate the lights
 		_fullscreenQuad->Draw();
@@ -312,11 +330,13 @@ void RenderLayer::_Composite()
 
 	_AccumulateLighting();
 
-	// We want to switch to our compositing shader
-	_compositingShader->Bind();
-
+	// We want to switch to the variant of our compositing shader that matches our render flags
+	ShaderProgram* compositingShader = _compositingShader->GetVariant(*_renderFlags);
+	compositingShader->Bind();
 
-	_compositingShader->SetUniform("s_Ambient", scene->GetAmbientLight());
+	// Each variant has it's own locations, re-resolving only does work when the variant changes
+	_ambientUniform.Resolve(compositingShader);
+	_ambientUniform.Set(scene->GetAmbientLight());
 
 
 	// Switch rendering to output
@@ -371,7 +391,7 @@ void RenderLayer::_ClearFramebuffer(Framebuffer::Sptr& buffer, const glm::vec4*
 
 	// Bind our clear shader, and draw a fullscreen quad with all the clear colors
 	_clearShader->Bind();
-	_clearShader->SetUniform<glm::vec4>("ClearColors", colors, layers);
+	_clearColorsUniform.Set(colors, layers);
 	_fullscreenQuad->Draw();
 
 	// Reset depth test function to default
@@ -437,22 +457,46 @@ void RenderLayer::OnAppLoad(const nlohmann::json& config)
 	_lightAccumulationShader = ShaderProgram::Create();
 	_lightAccumulationShader->LoadShaderPartFromFile("shaders/vertex_shaders/fullscreen_quad.glsl", ShaderPartType::Vertex);
 	_lightAccumulationShader->LoadShaderPartFromFile("shaders/fragment_shaders/light_accumulation.glsl", ShaderPartType::Fragment);
-	_lightAccumulationShader->Link();
+	_lightAccumulationShader->LinkAsync();
 
 	_compositingShader = ShaderProgram::Create();
 	_compositingShader->LoadShaderPartFromFile("shaders/vertex_shaders/fullscreen_quad.glsl", ShaderPartType::Vertex);
 	_compositingShader->LoadShaderPartFromFile("shaders/fragment_shaders/deferred_composite.glsl", ShaderPartType::Fragment);
-	_compositingShader->Link();
+	_compositingShader->SetDebugName("Deferred Composite");
+	// The compositing shader branches on most of our render flags, so we compile a variant for each
+	// combination that gets used, starting with our initial flags. Only the variants are ever bound,
+	// so the base program just holds the sources and is never linked
+	_compositingShader->SetKeywords(RENDER_FLAG_KEYWORDS);
+	_compositingShader->GetVariant(*_renderFlags);
 
 	_clearShader = ShaderProgram::Create();
 	_clearShader->LoadShaderPartFromFile("shaders/vertex_shaders/fullscreen_quad.glsl", ShaderPartType::Vertex);
 	_clearShader->LoadShaderPartFromFile("shaders/fragment_shaders/clear.glsl", ShaderPartType::Fragment);
-	_clearShader->Link();
+	_clearShader->LinkAsync();
 
 	_shadowShader = ShaderProgram::Create();
 	_shadowShader->LoadShaderPartFromFile("shaders/vertex_shaders/fullscreen_quad.glsl", ShaderPartType::Vertex);
 	_shadowShader->LoadShaderPartFromFile("shaders/fragment_shaders/shadow_composite.glsl", ShaderPartType::Fragment);
-	_shadowShader->Link();
+	_shadowShader->LinkAsync();
+
+	// Resolve the uniforms for our own passes, this will wait for the shaders to finish linking
+	_shadowUniforms.ViewToShadow.Resolve(_shadowShader);
+	_shadowUniforms.LightDirViewspace.Resolve(_shadowShader);
+	_shadowUniforms.LightPosViewspace.Resolve(_shadowShader);
+	_shadowUniforms.ShadowBias.Resolve(_shadowShader);
+	_shadowUniforms.NormalBias.Resolve(_shadowShader);
+	_shadowUniforms.Attenuation.Resolve(_shadowShader);
+	_shadowUniforms.Intensity.Resolve(_shadowShader);
+	_shadowUniforms.LightColor.Resolve(_shadowShader);
+	_shadowUniforms.ShadowFlags.Resolve(_shadowShader);
+	_clearColorsUniform.Resolve(_clearShader);
+
+	// Compile errors are only reported once a link completes, so this is where we find out if our passes are usable
+	for (const ShaderProgram::Sptr& shader : { _lightAccumulationShader, _clearShader, _shadowShader }) {
+		if (!shader->WaitForLink()) {
+			LOG_ERROR("Failed to build render layer shader \"{}\", deferred rendering will not work correctly", shader->GetDebugName());
+		}
+	}
 
 	// We need a mesh for drawing fullscreen quads
 
@@ -473,6 +517,30 @@ void RenderLayer::OnAppLoad(const nlohmann::json& config)
 	_frameUniforms = std::make_shared<UniformBuffer<FrameLevelUniforms>>(BufferUsage::DynamicDraw);
 	_instanceUniforms = std::make_shared<UniformBuffer<InstanceLevelUniforms>>(BufferUsage::DynamicDraw);
 	_lightingUbo = std::make_shared<UniformBuffer<LightingUboStruct>>(BufferUsage::DynamicDraw);
+
+	// Buffers for the GPU driven path, these will grow to fit the scene
+	_indirectDrawData = StorageBuffer::Create(BufferUsage::DynamicDraw);
+	_indirectDrawData->SetDebugName("Indirect Draw Data");
+	_indirectMaterials = StorageBuffer::Create(BufferUsage::DynamicDraw);
+	_indirectMaterials->SetDebugName("Indirect Materials");
+	_indirectCommands = DrawIndirectBuffer::Create(BufferUsage::DynamicDraw);
+	_indirectCommands->SetDebugName("Indirect Commands");
+
+	// Single pixel textures to use in place of material textures that are missing
+	Texture2DDescription singlePixelDescriptor;
+	singlePixelDescriptor.Width = singlePixelDescriptor.Height = 1;
+	singlePixelDescriptor.Format = InternalFormat::RGB8;
+
+	float white[3] = { 1.0f, 1.0f, 1.0f };
+	float black[3] = { 0.0f, 0.0f, 0.0f };
+	float flatNormal[3] = { 0.5f, 0.5f, 1.0f };
+
+	_indirectWhiteTex = std::make_shared<Texture2D>(singlePixelDescriptor);
+	_indirectWhiteTex->LoadData(1, 1, PixelFormat::RGB, PixelType::Float, white);
+	_indirectBlackTex = std::make_shared<Texture2D>(singlePixelDescriptor);
+	_indirectBlackTex->LoadData(1, 1, PixelFormat::RGB, PixelType::Float, black);
+	_indirectNormalTex = std::make_shared<Texture2D>(singlePixelDescriptor);
+	_indirectNormalTex->LoadData(1, 1, PixelFormat::RGB, PixelType::Float, flatNormal);
 }
 
 const Framebuffer::Sptr& RenderLayer::GetPrimaryFBO() const {
@@ -501,12 +569,39 @@ void RenderLayer::SetClearColor(const glm::vec4 & value) {
 
 void RenderLayer::SetRenderFlags(RenderFlags value) {
 	_renderFlags = value;
+	// Start compiling the variant for the new flags right away
+	if (_compositingShader != nullptr) {
+		_compositingShader->GetVariant(*_renderFlags);
+	}
 }
 
 RenderFlags RenderLayer::GetRenderFlags() const {
 	return _renderFlags;
 }
 
+void RenderLayer::SetGpuDrivenRendering(bool value) {
+	if (value && !ITexture::GetLimits().SUPPORTS_BINDLESS) {
+		LOG_WARN("GPU driven rendering requires GL_ARB_bindless_texture, which is not supported");
+	}
+	_gpuDriven = value;
+}
+
+bool RenderLayer::IsGpuDrivenRendering() const {
+	return _gpuDriven;
+}
+
+void RenderLayer::SetIndirectShader(const ShaderProgram::Sptr& shader, const ShaderProgram::Sptr& indirectShader) {
+	if (indirectShader == nullptr) {
+		_indirectShaders.erase(shader);
+		return;
+	}
+	if (!indirectShader->FindStorageBlock(DRAW_DATA_BLOCK_NAME)) {
+		LOG_WARN("Indirect shader \"{}\" does not declare the {} storage block, ignoring", indirectShader->GetDebugName(), DRAW_DATA_BLOCK_NAME);
+		return;
+	}
+	_indirectShaders[shader] = indirectShader;
+}
+
 const Framebuffer::Sptr& RenderLayer::GetLightingBuffer() const {
 	return _lightingFBO;
 }
@@ -564,6 +659,20 @@ void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projectio
 	frameData.u_CameraPos = view * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 	_frameUniforms->Update();
 
+	// Objects that can use the GPU driven path are batched up and drawn after everything else
+	const bool useIndirect = _gpuDriven && ITexture::GetLimits().SUPPORTS_BINDLESS;
+	if (useIndirect) {
+		for (size_t ix = 0; ix < _indirectBatchCount; ix++) {
+			_indirectBatches[ix].Shader = nullptr;
+			_indirectBatches[ix].Commands.clear();
+			_indirectBatches[ix].DrawData.clear();
+		}
+		_indirectBatchCount = 0;
+		_indirectBatchIndices.clear();
+		_indirectMaterialData.clear();
+		_indirectMaterialIndices.clear();
+	}
+
 	// Render all our objects
 	app.CurrentScene()->Components().Each<RenderComponent>([&](const RenderComponent::Sptr& renderable) {
 		// Early bail if mesh not set
@@ -582,6 +691,10 @@ void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projectio
 			}
 		}
 
+		if (useIndirect && _QueueIndirect(renderable)) {
+			return;
+		}
+
 		// If the material has changed, we need to bind the new shader and set up our material and frame data
 		// Note: This is a good reason why we should be sorting the render components in ComponentManager
 		if (renderable->GetMaterial() != currentMat) {
@@ -608,5 +721,137 @@ void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projectio
 
 	});
 
+	if (useIndirect) {
+		_SubmitIndirectBatches();
+	}
+}
+
+bool RenderLayer::_QueueIndirect(const std::shared_ptr<Gameplay::RenderComponent>& renderable)
+{
+	using namespace Gameplay;
+
+	Material* material = renderable->GetMaterial().get();
+	auto shaderIt = _indirectShaders.find(material->GetShader());
+	if (shaderIt == _indirectShaders.end()) {
+		return false;
+	}
+	const ShaderProgram::Sptr& shader = shaderIt->second;
+
+	// Only meshes that have been copied into the mega buffers can be drawn indirectly
+	const MeshResource::Sptr& meshResource = renderable->GetMeshResource();
+	if (meshResource == nullptr || meshResource->Mesh != renderable->GetMesh()) {
+		return false;
+	}
+	const MeshMegaBuffer::Allocation& allocation = meshResource->GetMegaBufferAllocation();
+	if (!allocation.IsValid()) {
+		return false;
+	}
+
+	// Find or start the batch for the shader
+	size_t batchIndex = 0;
+	auto it = _indirectBatchIndices.find(shader.get());
+	if (it != _indirectBatchIndices.end()) {
+		batchIndex = it->second;
+	} else {
+		batchIndex = _indirectBatchCount++;
+		if (batchIndex >= _indirectBatches.size()) {
+			_indirectBatches.emplace_back();
+		}
+		ShaderProgram::UniformInfo drawOffset;
+		_indirectBatches[batchIndex].Shader = shader;
+		_indirectBatches[batchIndex].DrawOffsetLocation = shader->FindUniform("u_DrawOffset", &drawOffset) ? drawOffset.Location : -1;
+		_indirectBatchIndices[shader.get()] = batchIndex;
+	}
+	IndirectBatch& batch = _indirectBatches[batchIndex];
+
+	// Draws find their data through gl_DrawID, so we don't need to use BaseInstance
+	DrawElementsIndirectCommand command;
+	command.Count = allocation.IndexCount;
+	command.InstanceCount = 1;
+	command.FirstIndex = allocation.FirstIndex;
+	command.BaseVertex = static_cast<int32_t>(allocation.BaseVertex);
+	command.BaseInstance = 0;
+	batch.Commands.push_back(command);
+
+	const glm::mat4& transform = renderable->GetGameObject()->GetTransform();
+	IndirectDrawData data;
+	data.u_Model = transform;
+	data.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(transform)));
+	data.MaterialIndex = _GetIndirectMaterialIndex(material);
+	batch.DrawData.push_back(data);
+
+	return true;
+}
+
+uint32_t RenderLayer::_GetIndirectMaterialIndex(Gameplay::Material* material)
+{
+	auto it = _indirectMaterialIndices.find(material);
+	if (it != _indirectMaterialIndices.end()) {
+		return it->second;
+	}
+
+	// Gets the bindless handle for a material texture, or for a stand-in if it's not available
+	auto getHandle = [&](const char* name, const Texture2D::Sptr& fallback) {
+		ITexture::Sptr texture = material->GetTexture(name);
+		uint64_t handle = texture != nullptr ? texture->GetBindlessHandle() : 0;
+		return handle != 0 ? handle : fallback->GetBindlessHandle();
+	};
+
+	IndirectMaterialData data;
+	data.AlbedoMap            = getHandle("u_Material.AlbedoMap", _indirectWhiteTex);
+	data.EmissiveMap          = getHandle("u_Material.EmissiveMap", _indirectBlackTex);
+	data.NormalMap            = getHandle("u_Material.NormalMap", _indirectNormalTex);
+	data.MetallicShininessMap = getHandle("u_Material.MetallicShininessMap", _indirectWhiteTex);
+	data.DiscardThreshold = 0.0f;
+	material->TryGet("u_Material.DiscardThreshold", data.DiscardThreshold);
+	int normalMapIsTwoChannel = 0;
+	material->TryGet("u_Material.NormalMapIsTwoChannel", normalMapIsTwoChannel);
+	data.NormalMapIsTwoChannel = normalMapIsTwoChannel;
+
+	uint32_t result = static_cast<uint32_t>(_indirectMaterialData.size());
+	_indirectMaterialData.push_back(data);
+	_indirectMaterialIndices[material] = result;
+	return result;
+}
+
+void RenderLayer::_SubmitIndirectBatches()
+{
+	if (_indirectBatchCount == 0) {
+		return;
+	}
+
+	// Flatten all the batches into one set of buffers, so that we only need to upload and bind once
+	_indirectCommandData.clear();
+	_indirectDrawDataFlat.clear();
+	for (size_t ix = 0; ix < _indirectBatchCount; ix++) {
+		IndirectBatch& batch = _indirectBatches[ix];
+		_indirectCommandData.insert(_indirectCommandData.end(), batch.Commands.begin(), batch.Commands.end());
+		_indirectDrawDataFlat.insert(_indirectDrawDataFlat.end(), batch.DrawData.begin(), batch.DrawData.end());
+	}
+
+	const uint32_t drawCount = static_cast<uint32_t>(_indirectCommandData.size());
+	_indirectCommands->UpdateData(_indirectCommandData.data(), sizeof(DrawElementsIndirectCommand), drawCount);
+	_indirectDrawData->UpdateData(_indirectDrawDataFlat.data(), sizeof(IndirectDrawData), drawCount);
+	_indirectMaterials->UpdateData(_indirectMaterialData.data(), sizeof(IndirectMaterialData), static_cast<uint32_t>(_indirectMaterialData.size()));
+
+	_indirectDrawData->Bind(DRAW_DATA_SSBO_BINDING);
+	_indirectMaterials->Bind(MATERIAL_SSBO_BINDING);
+	_indirectCommands->Bind();
+	MeshMegaBuffer::GetVao()->Bind();
+
+	// One draw call per shader, gl_DrawID restarts at 0 for each call so the shader is told where the batch starts
+	size_t offset = 0;
+	for (size_t ix = 0; ix < _indirectBatchCount; ix++) {
+		IndirectBatch& batch = _indirectBatches[ix];
+		batch.Shader->Bind();
+		// gl_DrawID restarts at 0 for each multi-draw, so the shader needs to know where the batch starts
+		uint32_t drawOffset = static_cast<uint32_t>(offset);
+		batch.Shader->SetUniform(batch.DrawOffsetLocation, &drawOffset);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)(offset * sizeof(DrawElementsIndirectCommand)), static_cast<GLsizei>(batch.Commands.size()), 0);
+		offset += batch.Commands.size();
+	}
+
+	VertexArrayObject::Unbind();
+	DrawIndirectBuffer::UnBind();
 }
 
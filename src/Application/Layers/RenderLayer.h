@@ -3,7 +3,17 @@
 #include "Graphics/Framebuffer.h"
 #include "Graphics/Buffers/UniformBuffer.h"
 #include "Graphics/ShaderProgram.h"
+#include "Graphics/UniformHandle.h"
 #include "Graphics/VertexArrayObject.h"
+#include "Graphics/Buffers/StorageBuffer.h"
+#include "Graphics/Buffers/DrawIndirectBuffer.h"
+#include "Graphics/Textures/Texture2D.h"
+#include <unordered_map>
+
+namespace Gameplay {
+	class Material;
+	class RenderComponent;
+}
 
 #define MAX_LIGHTS 8
 
@@ -87,6 +97,33 @@ public:
 		glm::mat4 EnvironmentRotation;
 	};
 
+	// Structure for the per-draw data of the GPU driven path, matches the
+	// b_DrawData storage block in vertex_shaders/gpu_driven.glsl (std430)
+	struct IndirectDrawData {
+		glm::mat4 u_Model;
+		glm::mat4 u_NormalMatrix;
+		uint32_t  MaterialIndex;
+		uint32_t  _padding[3];
+	};
+
+	// Structure for a material in the GPU driven path, matches the Material struct
+	// in fragment_shaders/deferred_forward_indirect.glsl (std430). Textures are stored
+	// as bindless handles
+	struct IndirectMaterialData {
+		uint64_t AlbedoMap;
+		uint64_t EmissiveMap;
+		uint64_t NormalMap;
+		uint64_t MetallicShininessMap;
+		float    DiscardThreshold;
+		uint32_t NormalMapIsTwoChannel;
+		float    _padding[2];
+	};
+
+	/// <summary>
+	/// The name of the storage block that indirect shaders read their per-draw data from
+	/// </summary>
+	static const char* DRAW_DATA_BLOCK_NAME;
+
 	RenderLayer();
 	virtual ~RenderLayer();
 
@@ -104,6 +141,27 @@ public:
 	void SetRenderFlags(RenderFlags value);
 	RenderFlags GetRenderFlags() const;
 
+	/// <summary>
+	/// Enables or disables the GPU driven render path. When enabled, objects whose mesh lives in
+	/// the mesh mega buffers and whose shader has an indirect shader registered are drawn with
+	/// a single glMultiDrawElementsIndirect per shader, with their materials read from a storage
+	/// buffer of bindless texture handles. Everything else uses the regular path
+	/// 
+	/// Has no effect if GL_ARB_bindless_texture is not supported
+	/// </summary>
+	void SetGpuDrivenRendering(bool value);
+	bool IsGpuDrivenRendering() const;
+
+	/// <summary>
+	/// Registers the shader that replaces a material shader in the GPU driven path. The indirect
+	/// shader must read it's per-draw data from the b_DrawData storage block and it's material from
+	/// the material storage buffer (see vertex_shaders/gpu_driven.glsl and
+	/// fragment_shaders/deferred_forward_indirect.glsl)
+	/// </summary>
+	/// <param name="shader">The shader used by materials</param>
+	/// <param name="indirectShader">The shader to draw those materials with in the GPU driven path, or nullptr to remove</param>
+	void SetIndirectShader(const ShaderProgram::Sptr& shader, const ShaderProgram::Sptr& indirectShader);
+
 	const Framebuffer::Sptr& GetLightingBuffer() const;
 	const Framebuffer::Sptr& GetRenderOutput() const;
 	const Framebuffer::Sptr& GetGBuffer() const;
@@ -126,6 +184,21 @@ protected:
 	ShaderProgram::Sptr _compositingShader;
 	ShaderProgram::Sptr _shadowShader;
 
+	// Uniforms for our shadow compositing pass, set once per shadow casting light
+	struct ShadowUniforms {
+		UniformHandle<glm::mat4> ViewToShadow      = "u_ViewToShadow";
+		UniformHandle<glm::vec3> LightDirViewspace = "u_LightDirViewspace";
+		UniformHandle<glm::vec3> LightPosViewspace = "u_LightPosViewspace";
+		UniformHandle<float>     ShadowBias        = "u_ShadowBias";
+		UniformHandle<float>     NormalBias        = "u_NormalBias";
+		UniformHandle<float>     Attenuation       = "u_Attenuation";
+		UniformHandle<float>     Intensity         = "u_Intensity";
+		UniformHandle<glm::vec3> LightColor        = "u_LightColor";
+		UniformHandle<uint32_t>  ShadowFlags       = "u_ShadowFlags";
+	} _shadowUniforms;
+	UniformHandle<glm::vec3> _ambientUniform     = "s_Ambient";
+	UniformHandle<glm::vec4> _clearColorsUniform = "ClearColors";
+
 	VertexArrayObject::Sptr _fullscreenQuad;
 
 	bool              _blitFbo;
@@ -141,9 +214,53 @@ protected:
 	const int LIGHTING_UBO_BINDING = 2;
 	UniformBuffer<LightingUboStruct>::Sptr _lightingUbo;
 
+	// All the draws for a single shader in the GPU driven path
+	struct IndirectBatch {
+		ShaderProgram::Sptr                      Shader;
+		// Location of u_DrawOffset, the index of the batch's first draw in the flattened draw data
+		int                                      DrawOffsetLocation;
+		std::vector<DrawElementsIndirectCommand> Commands;
+		std::vector<IndirectDrawData>            DrawData;
+	};
+
+	bool _gpuDriven;
+	std::unordered_map<ShaderProgram::Sptr, ShaderProgram::Sptr> _indirectShaders;
+	const int DRAW_DATA_SSBO_BINDING = 0;
+	const int MATERIAL_SSBO_BINDING = 1;
+	StorageBuffer::Sptr      _indirectDrawData;
+	StorageBuffer::Sptr      _indirectMaterials;
+	DrawIndirectBuffer::Sptr _indirectCommands;
+	// Stand-ins for material textures that are not set or still loading
+	Texture2D::Sptr          _indirectWhiteTex;
+	Texture2D::Sptr          _indirectBlackTex;
+	Texture2D::Sptr          _indirectNormalTex;
+
+	// These are kept between frames so that we are not re-allocating every frame
+	std::vector<IndirectBatch>                           _indirectBatches;
+	size_t                                               _indirectBatchCount;
+	std::unordered_map<ShaderProgram*, size_t>           _indirectBatchIndices;
+	std::vector<IndirectMaterialData>                    _indirectMaterialData;
+	std::unordered_map<Gameplay::Material*, uint32_t>    _indirectMaterialIndices;
+	std::vector<DrawElementsIndirectCommand>             _indirectCommandData;
+	std::vector<IndirectDrawData>                        _indirectDrawDataFlat;
+
 	void _InitFrameUniforms();
 	void _RenderScene(const glm::mat4& view, const glm::mat4&Projection);
 
+	/// <summary>
+	/// Attempts to add a renderable to the GPU driven batches
+	/// </summary>
+	/// <returns>True if the renderable will be drawn by _SubmitIndirectBatches, false if it should be drawn normally</returns>
+	bool _QueueIndirect(const std::shared_ptr<Gameplay::RenderComponent>& renderable);
+	/// <summary>
+	/// Gets the index of a material in the GPU driven material buffer, adding it if needed
+	/// </summary>
+	uint32_t _GetIndirectMaterialIndex(Gameplay::Material* material);
+	/// <summary>
+	/// Uploads the GPU driven batches and draws each with a single glMultiDrawElementsIndirect
+	/// </summary>
+	void _SubmitIndirectBatches();
+
 	void _AccumulateLighting();
 	void _Composite();
 	void _ClearFramebuffer(Framebuffer::Sptr& buffer, const glm::vec4* colors, int layers);
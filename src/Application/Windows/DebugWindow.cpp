@@ -2,6 +2,7 @@
 #include "Application/Application.h"
 #include "Application/ApplicationLayer.h"
 #include "Application/Layers/RenderLayer.h"
+#include "Gameplay/Physics/CollisionShapeCache.h"
 
 DebugWindow::DebugWindow() : 
 	IEditorWindow()
@@ -24,6 +25,32 @@ void DebugWindow::RenderMenuBar()
 		app.CurrentScene()->SetPhysicsDebugDrawMode(physicsDrawMode);
 	}
 
+	bool fixedStep = app.CurrentScene()->GetFixedPhysicsStep();
+	if (ImGui::Checkbox("Fixed Physics Step", &fixedStep)) {
+		app.CurrentScene()->SetFixedPhysicsStep(fixedStep);
+	}
+
+	bool multithreaded = app.CurrentScene()->GetMultithreadedPhysics();
+	if (ImGui::Checkbox("Multithreaded Physics", &multithreaded)) {
+		app.CurrentScene()->SetMultithreadedPhysics(multithreaded);
+	}
+	ImGui::Text("Physics Step: %.2f ms", app.CurrentScene()->GetLastPhysicsStepTime());
+	ImGui::Text("Collision Shapes: %d", (int)Gameplay::Physics::CollisionShapeCache::GetShapeCount());
+
+	Gameplay::AnimationSystem& animation = app.CurrentScene()->GetAnimationSystem();
+	bool multithreadedAnimation = animation.IsMultithreaded();
+	if (ImGui::Checkbox("Multithreaded Animation", &multithreadedAnimation)) {
+		animation.SetMultithreaded(multithreadedAnimation);
+	}
+	ImGui::Text("Animated Objects: %d", (int)animation.GetNumAnimated());
+
+	ImGui::Separator();
+
+	bool gpuDriven = renderLayer->IsGpuDrivenRendering();
+	if (ImGui::Checkbox("GPU Driven Rendering", &gpuDriven)) {
+		renderLayer->SetGpuDrivenRendering(gpuDriven);
+	}
+
 	ImGui::Separator();
 
 	RenderFlags flags = renderLayer->GetRenderFlags();
@@ -0,0 +1,232 @@
+#include "Gameplay/AnimationClipSet.h"
+#include <fstream>
+#include <filesystem>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <GLM/gtx/spline.hpp>
+
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Utils/JsonGlmHelpers.h"
+#include "Logging.h"
+
+namespace Gameplay {
+	AnimationClipSet::AnimationClipSet() :
+		IResource(),
+		Filename(""),
+		_keys(),
+		_keyRotations(),
+		_clips(),
+		_pendingKeys(),
+		_pendingName(""),
+		_pendingInterpolation(AnimationInterpolation::Linear),
+		_pendingSlerp(false),
+		_isBuilding(false)
+	{ }
+
+	AnimationClipSet::AnimationClipSet(const std::string& filename) :
+		AnimationClipSet()
+	{
+		Filename = filename;
+		_Compile();
+	}
+
+	AnimationClipSet::~AnimationClipSet() = default;
+
+	const std::vector<AnimationClip>& AnimationClipSet::GetClips() const {
+		return _clips;
+	}
+
+	int AnimationClipSet::FindClip(const std::string& name) const {
+		for (int ix = 0; ix < _clips.size(); ix++) {
+			if (_clips[ix].Name == name) {
+				return ix;
+			}
+		}
+		return -1;
+	}
+
+	const AnimationKey* AnimationClipSet::GetKeys(const AnimationClip& clip, int channel) const {
+		return _keys.data() + clip.Channels[channel].FirstKey;
+	}
+
+	void AnimationClipSet::Advance(const AnimationClip& clip, int channel, AnimationCursor& cursor, float deltaTime, bool loop) const {
+		const AnimationKey* keys = GetKeys(clip, channel);
+		uint32_t last = clip.Channels[channel].NumKeys - 1;
+
+		// Once we've spent the key's duration blending away from it, move on to the next key
+		cursor.Time += deltaTime;
+		if (cursor.Time >= keys[cursor.Key].Duration) {
+			cursor.Time = 0.0f;
+			cursor.Key++;
+		}
+
+		if (cursor.Key >= last) {
+			// Non-looping channels stop and hold their last key
+			if (!loop) {
+				cursor.Key = last;
+				cursor.Finished = true;
+			}
+			// Looping channels blend from their last key back to their first before starting over
+			else if (cursor.Key > last) {
+				cursor.Key = 0;
+			}
+		}
+	}
+
+	glm::vec3 AnimationClipSet::Sample(const AnimationClip& clip, int channel, const AnimationCursor& cursor, bool loop) const {
+		const AnimationKey* keys = GetKeys(clip, channel);
+		if (cursor.Finished) {
+			return keys[cursor.Key].Value;
+		}
+
+		uint32_t next = _GetNextKey(clip, channel, cursor);
+		float t = _GetBlendFactor(keys[cursor.Key], cursor);
+
+		if (clip.Interpolation == AnimationInterpolation::Cubic) {
+			// The spline needs the keys on either side of the segment, which are clamped at the ends unless we loop
+			uint32_t last  = clip.Channels[channel].NumKeys - 1;
+			uint32_t prev  = cursor.Key > 0 ? cursor.Key - 1 : (loop ? last : 0);
+			uint32_t after = next != last ? next + 1 : (loop ? 0 : last);
+			return glm::catmullRom(keys[prev].Value, keys[cursor.Key].Value, keys[next].Value, keys[after].Value, t);
+		} else {
+			return glm::mix(keys[cursor.Key].Value, keys[next].Value, t);
+		}
+	}
+
+	glm::quat AnimationClipSet::SampleRotation(const AnimationClip& clip, const AnimationCursor& cursor, bool loop) const {
+		// Euler angles are blended like any other channel, which lets scripts spin objects more than 180 degrees between keys
+		if (!clip.SlerpRotation) {
+			return glm::quat(glm::radians(Sample(clip, AnimationClip::CHANNEL_ROTATION, cursor, loop)));
+		}
+
+		const glm::quat* rotations = _keyRotations.data() + clip.Channels[AnimationClip::CHANNEL_ROTATION].FirstKey;
+		if (cursor.Finished) {
+			return rotations[cursor.Key];
+		}
+
+		uint32_t next = _GetNextKey(clip, AnimationClip::CHANNEL_ROTATION, cursor);
+		float t = _GetBlendFactor(GetKeys(clip, AnimationClip::CHANNEL_ROTATION)[cursor.Key], cursor);
+		return glm::slerp(rotations[cursor.Key], rotations[next], t);
+	}
+
+	float AnimationClipSet::_GetBlendFactor(const AnimationKey& key, const AnimationCursor& cursor) {
+		return key.Duration > 0.0f ? cursor.Time / key.Duration : 1.0f;
+	}
+
+	uint32_t AnimationClipSet::_GetNextKey(const AnimationClip& clip, int channel, const AnimationCursor& cursor) {
+		return cursor.Key != clip.Channels[channel].NumKeys - 1 ? cursor.Key + 1 : 0;
+	}
+
+	void AnimationClipSet::BeginClip(const std::string& name) {
+		_pendingName = name;
+		_pendingInterpolation = AnimationInterpolation::Linear;
+		_pendingSlerp = false;
+		_isBuilding  = true;
+	}
+
+	void AnimationClipSet::AddKey(int channel, float duration, const glm::vec3& value) {
+		// Scripts treat any unknown channel as scale
+		int index = (channel == 0 || channel == 1) ? channel : 2;
+		_pendingKeys[index].push_back(AnimationKey{ value, duration });
+	}
+
+	void AnimationClipSet::SetInterpolation(AnimationInterpolation interpolation, bool slerpRotation) {
+		_pendingInterpolation = interpolation;
+		_pendingSlerp = slerpRotation;
+	}
+
+	void AnimationClipSet::EndClip() {
+		AnimationClip clip;
+		clip.Name = _pendingName;
+		clip.Interpolation = _pendingInterpolation;
+		clip.SlerpRotation = _pendingSlerp;
+		for (int ix = 0; ix < AnimationClip::NUM_CHANNELS; ix++) {
+			clip.Channels[ix].FirstKey = static_cast<uint32_t>(_keys.size());
+			clip.Channels[ix].NumKeys  = static_cast<uint32_t>(_pendingKeys[ix].size());
+			for (const AnimationKey& key : _pendingKeys[ix]) {
+				_keys.push_back(key);
+				_keyRotations.push_back(glm::quat(glm::radians(key.Value)));
+			}
+			_pendingKeys[ix].clear();
+		}
+		_clips.push_back(clip);
+		_isBuilding = false;
+	}
+
+	AnimationClipSet::Sptr AnimationClipSet::Load(const std::string& filename) {
+		// Scripts are shared, so we only compile them the first time they are requested. Sets that failed
+		// to compile (ex: loaded from a manifest after the script was deleted) are never shared
+		AnimationClipSet::Sptr result = nullptr;
+		ResourceManager::Each<AnimationClipSet>([&](const AnimationClipSet::Sptr& set) {
+			if (result == nullptr && set->Filename == filename && set->GetLoadState() != ResourceLoadState::Failed) {
+				result = set;
+			}
+		});
+		if (result != nullptr) {
+			return result;
+		}
+
+		// Don't register missing scripts, otherwise they would be saved to the manifest
+		if (!std::filesystem::exists(filename)) {
+			LOG_ERROR("Could not locate animation script \"{}\"", filename);
+			return nullptr;
+		}
+		return ResourceManager::CreateAsset<AnimationClipSet>(filename);
+	}
+
+	nlohmann::json AnimationClipSet::ToJson() const {
+		nlohmann::json result;
+		result["filename"] = Filename;
+		return result;
+	}
+
+	AnimationClipSet::Sptr AnimationClipSet::FromJson(const nlohmann::json& blob) {
+		return std::make_shared<AnimationClipSet>(JsonGet<std::string>(blob, "filename", ""));
+	}
+
+	void AnimationClipSet::_Compile() {
+		std::ifstream script(Filename);
+		if (!script.is_open()) {
+			LOG_ERROR("Could not locate animation script \"{}\"", Filename);
+			_loadState = ResourceLoadState::Failed;
+			return;
+		}
+
+		std::string command;
+		while (script >> command) {
+			if (command == "s") {
+				std::string name;
+				script >> name;
+				BeginClip(name);
+			}
+			else if (command == "f") {
+				int channel;
+				float duration;
+				glm::vec3 value;
+				script >> channel >> duration >> value.x >> value.y >> value.z;
+				AddKey(channel, duration, value);
+			}
+			else if (command == "i") {
+				std::string mode;
+				script >> mode;
+				if (mode == "linear" || mode == "cubic") {
+					_pendingInterpolation = mode == "cubic" ? AnimationInterpolation::Cubic : AnimationInterpolation::Linear;
+				} else if (mode == "slerp") {
+					_pendingSlerp = true;
+				} else {
+					LOG_WARN("Unknown interpolation mode \"{}\" in animation script \"{}\"", mode, Filename);
+				}
+			}
+			else if (command == "e") {
+				EndClip();
+			}
+		}
+
+		// Don't lose the last clip if the script is missing it's end command
+		if (_isBuilding) {
+			EndClip();
+		}
+		_keys.shrink_to_fit();
+		_keyRotations.shrink_to_fit();
+	}
+}
@@ -0,0 +1,243 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <GLM/glm.hpp>
+#include <GLM/gtc/quaternion.hpp>
+#include <EnumToString.h>
+
+#include "Utils/ResourceManager/IResource.h"
+
+namespace Gameplay {
+	class AnimationClipSet;
+
+	/// <summary>
+	/// How the translation and scale channels of a clip blend between keys. Cubic
+	/// follows a Catmull-Rom spline through the keys, giving smooth motion through each key
+	/// </summary>
+	ENUM(AnimationInterpolation, uint8_t,
+		Linear = 0,
+		Cubic  = 1
+	);
+
+	/// <summary>
+	/// A single keyframe in an animation channel, the duration is how long it
+	/// takes to blend from this key to the next one
+	/// </summary>
+	struct AnimationKey {
+		glm::vec3 Value;
+		float     Duration;
+	};
+
+	/// <summary>
+	/// Playback state for a single channel of a clip, this is all that an object
+	/// needs to store to play back a shared clip
+	/// </summary>
+	struct AnimationCursor {
+		// The key we are currently blending away from
+		uint32_t Key;
+		// How long we've been blending away from the current key
+		float    Time;
+		// True once a non-looping channel has reached it's last key
+		bool     Finished;
+
+		AnimationCursor() : Key(0), Time(0.0f), Finished(false) { }
+
+		void Reset() {
+			Key = 0;
+			Time = 0.0f;
+			Finished = false;
+		}
+	};
+
+	/// <summary>
+	/// A named animation with separate position, rotation and scale channels. Clips
+	/// do not store their keys directly, each channel is a range in the key array of
+	/// the AnimationClipSet that owns the clip
+	/// </summary>
+	struct AnimationClip {
+		/// <summary>
+		/// The number of channels in a clip, channels are indexed as 
+		/// 0 = translation, 1 = rotation, 2 = scale
+		/// </summary>
+		static const int NUM_CHANNELS = 3;
+		static const int CHANNEL_TRANSLATION = 0;
+		static const int CHANNEL_ROTATION    = 1;
+		static const int CHANNEL_SCALE       = 2;
+
+		struct Channel {
+			uint32_t FirstKey;
+			uint32_t NumKeys;
+		};
+
+		std::string Name;
+		Channel     Channels[NUM_CHANNELS];
+		// How the translation and scale channels are blended, and the rotation channel when not slerping
+		AnimationInterpolation Interpolation;
+		// When true, rotation keys are converted to quaternions and blended with slerp, rather
+		// than blending their euler angles
+		bool        SlerpRotation;
+
+		/// <summary>
+		/// Returns true if the given channel has any keys
+		/// </summary>
+		bool HasKeys(int channel) const { return Channels[channel].NumKeys > 0; }
+	};
+
+	/// <summary>
+	/// Everything an object needs to play a shared clip, see AnimationSystem
+	/// </summary>
+	struct AnimationPlayback {
+		// The clip that is playing, and the set that holds it's keys
+		const AnimationClipSet* Set;
+		const AnimationClip*    Clip;
+		AnimationCursor         Cursors[AnimationClip::NUM_CHANNELS];
+		bool                    IsLooping;
+
+		AnimationPlayback() : Set(nullptr), Clip(nullptr), Cursors(), IsLooping(true) { }
+
+		/// <summary>
+		/// Moves all the channels back to the start of the clip
+		/// </summary>
+		void Reset() {
+			for (int ix = 0; ix < AnimationClip::NUM_CHANNELS; ix++) {
+				Cursors[ix].Reset();
+			}
+		}
+	};
+
+	/// <summary>
+	/// A set of animation clips compiled from an interpolation script (see res/interp_scripts).
+	/// Scripts are only compiled once and the resulting set is shared between all objects that
+	/// play it, with the keys for every clip packed into a single array
+	///
+	/// Script format, one command per line:
+	///		s [name]                   - starts a new clip
+	///		f [channel] [duration] x y z - adds a key to the given channel (0 = translation, 1 = rotation, 2 = scale)
+	///		i [mode]                   - sets how the current clip blends, "linear" (default) or "cubic" for
+	///		                             translation and scale, and "slerp" to slerp rotations instead of
+	///		                             blending their euler angles
+	///		e                          - ends the current clip
+	/// </summary>
+	class AnimationClipSet : public IResource {
+	public:
+		typedef std::shared_ptr<AnimationClipSet> Sptr;
+
+		// Default constructor, creates an empty set that clips can be built into from code
+		AnimationClipSet();
+		/// <summary>
+		/// Compiles the clips from an interpolation script
+		/// </summary>
+		/// <param name="filename">The path to the script to compile</param>
+		AnimationClipSet(const std::string& filename);
+
+		virtual ~AnimationClipSet();
+
+		/// <summary>
+		/// The script that the clips were compiled from, or empty if they were built from code
+		/// </summary>
+		std::string Filename;
+
+		/// <summary>
+		/// Gets all the clips in this set
+		/// </summary>
+		const std::vector<AnimationClip>& GetClips() const;
+		/// <summary>
+		/// Gets the index of the first clip with the given name
+		/// </summary>
+		/// <returns>The index of the clip, or -1 if no clip has the name</returns>
+		int FindClip(const std::string& name) const;
+
+		/// <summary>
+		/// Gets the keys for a channel of one of our clips
+		/// </summary>
+		/// <param name="clip">The clip to get the keys of, must belong to this set</param>
+		/// <param name="channel">The index of the channel (0 = translation, 1 = rotation, 2 = scale)</param>
+		const AnimationKey* GetKeys(const AnimationClip& clip, int channel) const;
+
+		/// <summary>
+		/// Advances a cursor along a channel of one of our clips. The channel must have at least one key
+		/// </summary>
+		/// <param name="clip">The clip the cursor is playing, must belong to this set</param>
+		/// <param name="channel">The index of the channel (0 = translation, 1 = rotation, 2 = scale)</param>
+		/// <param name="cursor">The playback state for the channel</param>
+		/// <param name="deltaTime">The time in seconds to advance the cursor by</param>
+		/// <param name="loop">True if the channel should wrap back to it's first key, false to stop on the last key</param>
+		void Advance(const AnimationClip& clip, int channel, AnimationCursor& cursor, float deltaTime, bool loop) const;
+		/// <summary>
+		/// Gets the value of a channel at a cursor, using the clip's interpolation mode
+		/// </summary>
+		/// <param name="clip">The clip to sample, must belong to this set</param>
+		/// <param name="channel">The index of the channel (0 = translation, 1 = rotation, 2 = scale)</param>
+		/// <param name="cursor">The playback state for the channel</param>
+		/// <param name="loop">True if the channel wraps back to it's first key</param>
+		glm::vec3 Sample(const AnimationClip& clip, int channel, const AnimationCursor& cursor, bool loop) const;
+		/// <summary>
+		/// Gets the value of the clip's rotation channel at a cursor, slerping between keys if the
+		/// clip has SlerpRotation enabled
+		/// </summary>
+		glm::quat SampleRotation(const AnimationClip& clip, const AnimationCursor& cursor, bool loop) const;
+
+		/// <summary>
+		/// Starts building a new clip, should only be used while the set is being created
+		/// </summary>
+		/// <param name="name">The name of the clip</param>
+		void BeginClip(const std::string& name);
+		/// <summary>
+		/// Adds a key to the clip that is being built
+		/// </summary>
+		/// <param name="channel">The channel to add the key to (0 = translation, 1 = rotation, anything else is scale)</param>
+		/// <param name="duration">The time in seconds to blend from this key to the next</param>
+		/// <param name="value">The value of the channel at this key</param>
+		void AddKey(int channel, float duration, const glm::vec3& value);
+		/// <summary>
+		/// Sets how the clip that is being built blends between keys
+		/// </summary>
+		/// <param name="interpolation">The interpolation for the translation and scale channels</param>
+		/// <param name="slerpRotation">True to slerp the rotation channel, false to blend it's euler angles</param>
+		void SetInterpolation(AnimationInterpolation interpolation, bool slerpRotation);
+		/// <summary>
+		/// Finishes the clip that is being built and packs it's keys into the set
+		/// </summary>
+		void EndClip();
+
+		/// <summary>
+		/// Gets the shared clip set for a script, compiling it and registering it with the
+		/// resource manager if no set has been loaded from the script yet
+		/// </summary>
+		/// <param name="filename">The path to the script</param>
+		/// <returns>The clip set, or nullptr if the script does not exist</returns>
+		static AnimationClipSet::Sptr Load(const std::string& filename);
+
+		// Inherited from IResource
+		virtual nlohmann::json ToJson() const override;
+		static AnimationClipSet::Sptr FromJson(const nlohmann::json& blob);
+
+	protected:
+		// The keys for all clips, each clip's channels are stored back to back
+		std::vector<AnimationKey>  _keys;
+		// Every key's value converted from euler angles, so rotation channels can be slerped
+		std::vector<glm::quat>     _keyRotations;
+		std::vector<AnimationClip> _clips;
+
+		// Keys for the clip that is being built, sorted by channel
+		std::vector<AnimationKey>  _pendingKeys[AnimationClip::NUM_CHANNELS];
+		std::string                _pendingName;
+		AnimationInterpolation     _pendingInterpolation;
+		bool                       _pendingSlerp;
+		bool                       _isBuilding;
+
+		/// <summary>
+		/// Gets how far the cursor is between it's key and the next one, in the 0-1 range
+		/// </summary>
+		static float _GetBlendFactor(const AnimationKey& key, const AnimationCursor& cursor);
+		/// <summary>
+		/// Gets the index of the key after the cursor's key, wrapping back to the first key
+		/// </summary>
+		static uint32_t _GetNextKey(const AnimationClip& clip, int channel, const AnimationCursor& cursor);
+
+		/// <summary>
+		/// Parses the script at Filename into our clips
+		/// </summary>
+		void _Compile();
+	};
+}
@@ -0,0 +1,115 @@
+#include "Gameplay/AnimationSystem.h"
+
+#include "Gameplay/GameObject.h"
+#include "Gameplay/Components/ComponentManager.h"
+#include "Gameplay/Components/InterpolationBehaviour.h"
+#include "Utils/ThreadPool.h"
+#include <algorithm>
+
+namespace Gameplay {
+	AnimationSystem::AnimationSystem() :
+		_active(),
+		_objects(),
+		_isMultithreaded(true)
+	{ }
+
+	void AnimationSystem::SetMultithreaded(bool value) {
+		_isMultithreaded = value;
+	}
+
+	bool AnimationSystem::IsMultithreaded() const {
+		return _isMultithreaded;
+	}
+
+	uint32_t AnimationSystem::GetNumAnimated() const {
+		return static_cast<uint32_t>(_objects.size());
+	}
+
+	void AnimationSystem::Update(ComponentManager& components, float deltaTime) {
+		// Gathering locks the component pool's weak pointers, so it stays on the main thread
+		_active.clear();
+		components.Each<InterpolationBehaviour>([&](const std::shared_ptr<InterpolationBehaviour>& behaviour) {
+			if (behaviour->_isRunning && behaviour->_playback.Clip != nullptr) {
+				_active.push_back(behaviour.get());
+			}
+		});
+
+		// Group the behaviours by object, so that an object with several running behaviours is only ever
+		// written to by one worker. The sort is stable so behaviours on an object keep their order
+		std::stable_sort(_active.begin(), _active.end(), [](const InterpolationBehaviour* a, const InterpolationBehaviour* b) {
+			return a->GetGameObject() < b->GetGameObject();
+		});
+		_objects.clear();
+		for (uint32_t ix = 0; ix < _active.size(); ix++) {
+			if (_objects.empty() || _active[_objects.back().First]->GetGameObject() != _active[ix]->GetGameObject()) {
+				_objects.push_back({ ix, 0 });
+			}
+			_objects.back().Count++;
+		}
+
+		auto animateObject = [&](uint32_t ix) {
+			const ObjectRange& range = _objects[ix];
+			for (uint32_t behaviourIx = range.First; behaviourIx < range.First + range.Count; behaviourIx++) {
+				_Animate(_active[behaviourIx], deltaTime);
+			}
+		};
+
+		if (_isMultithreaded) {
+			ThreadPool::ParallelFor(static_cast<uint32_t>(_objects.size()), animateObject, MIN_BATCH_SIZE);
+		} else {
+			for (uint32_t ix = 0; ix < _objects.size(); ix++) {
+				animateObject(ix);
+			}
+		}
+	}
+
+	void AnimationSystem::_Animate(InterpolationBehaviour* behaviour, float deltaTime) {
+		AnimationPlayback& playback = behaviour->_playback;
+		const AnimationClipSet& set = *playback.Set;
+		const AnimationClip& clip = *playback.Clip;
+
+		int totalChannels = 0;
+		int finishedChannels = 0;
+		for (int ix = 0; ix < AnimationClip::NUM_CHANNELS; ix++) {
+			if (clip.HasKeys(ix)) {
+				finishedChannels += playback.Cursors[ix].Finished;
+				totalChannels++;
+			}
+		}
+
+		// Once every channel is done the clip starts over, or stops if it doesn't loop
+		if (finishedChannels == totalChannels) {
+			if (!playback.IsLooping) {
+				behaviour->_isRunning = false;
+			}
+			playback.Reset();
+			return;
+		}
+
+		// Channels without keys, or that have finished, keep whatever the object already has
+		GameObject* object = behaviour->GetGameObject();
+		glm::vec3 position = object->GetPosition();
+		glm::quat rotation = object->GetRotation();
+		glm::vec3 scale    = object->GetScale();
+
+		AnimationCursor& translationCursor = playback.Cursors[AnimationClip::CHANNEL_TRANSLATION];
+		if (clip.HasKeys(AnimationClip::CHANNEL_TRANSLATION) && !translationCursor.Finished) {
+			set.Advance(clip, AnimationClip::CHANNEL_TRANSLATION, translationCursor, deltaTime, playback.IsLooping);
+			position = set.Sample(clip, AnimationClip::CHANNEL_TRANSLATION, translationCursor, playback.IsLooping);
+		}
+
+		AnimationCursor& rotationCursor = playback.Cursors[AnimationClip::CHANNEL_ROTATION];
+		if (clip.HasKeys(AnimationClip::CHANNEL_ROTATION) && !rotationCursor.Finished) {
+			set.Advance(clip, AnimationClip::CHANNEL_ROTATION, rotationCursor, deltaTime, playback.IsLooping);
+			rotation = set.SampleRotation(clip, rotationCursor, playback.IsLooping);
+		}
+
+		AnimationCursor& scaleCursor = playback.Cursors[AnimationClip::CHANNEL_SCALE];
+		if (clip.HasKeys(AnimationClip::CHANNEL_SCALE) && !scaleCursor.Finished) {
+			set.Advance(clip, AnimationClip::CHANNEL_SCALE, scaleCursor, deltaTime, playback.IsLooping);
+			scale = set.Sample(clip, AnimationClip::CHANNEL_SCALE, scaleCursor, playback.IsLooping);
+		}
+
+		object->SetLocalTransform(position, rotation, scale);
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+class InterpolationBehaviour;
+
+namespace Gameplay {
+	class ComponentManager;
+
+	/// <summary>
+	/// Plays every running InterpolationBehaviour in a scene in a single pass. The running behaviours
+	/// are gathered into a flat list, then each one advances it's cursors, samples it's clip and
+	/// writes it's object's position, rotation and scale in one go
+	///
+	/// Behaviours are grouped by the object they animate, and each group is played by one worker,
+	/// so objects with more than one running behaviour are safe when the list is spread across
+	/// the ThreadPool. Behaviours on the same object are applied in component order
+	/// </summary>
+	class AnimationSystem {
+	public:
+		/// <summary>
+		/// The smallest number of objects that will be handed to a single worker
+		/// </summary>
+		static const uint32_t MIN_BATCH_SIZE = 64;
+
+		AnimationSystem();
+
+		/// <summary>
+		/// Sets whether objects are animated across the ThreadPool's workers (default true)
+		/// </summary>
+		void SetMultithreaded(bool value);
+		bool IsMultithreaded() const;
+
+		/// <summary>
+		/// Gets the number of objects that were animated in the last update
+		/// </summary>
+		uint32_t GetNumAnimated() const;
+
+		/// <summary>
+		/// Advances and applies all running interpolation behaviours, must be called from the main thread
+		/// </summary>
+		/// <param name="components">The component pool to gather behaviours from</param>
+		/// <param name="deltaTime">The time in seconds since the last update</param>
+		void Update(ComponentManager& components, float deltaTime);
+
+	private:
+		// The behaviours for a single object, as a range of _active
+		struct ObjectRange {
+			uint32_t First;
+			uint32_t Count;
+		};
+
+		// Kept between frames so that gathering does not allocate
+		std::vector<InterpolationBehaviour*> _active;
+		std::vector<ObjectRange>             _objects;
+		bool _isMultithreaded;
+
+		/// <summary>
+		/// Advances a single behaviour's playback and writes the result to it's object
+		/// </summary>
+		static void _Animate(InterpolationBehaviour* behaviour, float deltaTime);
+	};
+}
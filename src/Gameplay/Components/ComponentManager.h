@@ -18,6 +18,7 @@ namespace Gameplay {
 
 		inline void Clear() {
 			_Components.clear();
+			_ComponentsByGuid.clear();
 		}
 
 		/// <summary>
@@ -30,29 +31,50 @@ namespace Gameplay {
 		/// <returns>The component as decoded from the JSON data, or nullptr</returns>
 		inline IComponent::Sptr Load(const std::string& typeName, const nlohmann::json& blob) {
 			// Try and get the type index from the name
-			std::optional<std::type_index> typeIndex = _TypeNameMap[typeName];
+			std::optional<std::type_index> typeIndex = GetTypeByName(typeName);
 
 			// If we have a value for type index, this component type was registered!
 			if (typeIndex.has_value()) {
-				// Get the load callback and make sure it exists
-				LoadComponentFunc callback = _TypeLoadRegistry[typeIndex.value()];
-				if (callback) {
-					// Invoke the loader, also load additional component data
-					IComponent::Sptr result = callback(blob);
+				IComponent::Sptr result = _Load(typeIndex.value(), blob);
+				if (result != nullptr) {
+					// Also load additional component data, then index it under it's final GUID
 					IComponent::LoadBaseJson(result, blob);
-
-					// Make sure the component knows it's own type
-					result->_realType = typeIndex.value();
-					result->_weakSelfPtr = result;
-
-					// Add the component to the global pools
-					_Components[result->_realType].push_back(result);
-					return result;
+					_ComponentsByGuid[result->GetGUID()] = result;
 				}
+				return result;
 			}
 			return nullptr;
 		}
 
+		/// <summary>
+		/// Loads a component of the given registered type from a JSON blob. Unlike loading by name,
+		/// the base component data (GUID and enabled state) is passed in rather than read from the blob
+		/// </summary>
+		/// <param name="type">The type of component to load</param>
+		/// <param name="blob">The JSON blob to decode</param>
+		/// <param name="guid">The GUID to assign to the component</param>
+		/// <param name="enabled">Whether the component should be enabled</param>
+		/// <returns>The component as decoded from the JSON data, or nullptr</returns>
+		inline IComponent::Sptr Load(const std::type_index& type, const nlohmann::json& blob, const Guid& guid, bool enabled) {
+			IComponent::Sptr result = _Load(type, blob);
+			if (result != nullptr) {
+				result->OverrideGUID(guid);
+				result->IsEnabled = enabled;
+				_ComponentsByGuid[guid] = result;
+			}
+			return result;
+		}
+
+		/// <summary>
+		/// Gets the type that was registered with the given type name, or an empty optional if no such
+		/// type has been registered
+		/// </summary>
+		/// <param name="typeName">The name of the type to find (taken from GetComponentTypeName of component)</param>
+		static inline std::optional<std::type_index> GetTypeByName(const std::string& typeName) {
+			auto it = _TypeNameMap.find(typeName);
+			return it == _TypeNameMap.end() ? std::nullopt : it->second;
+		}
+
 		/// <summary>
 		/// Creates a component with the given type name
 		/// If the type name does not correspond to a registered type, will
@@ -76,6 +98,7 @@ namespace Gameplay {
 					result->_weakSelfPtr = result;
 					// Add the component to the global pools
 					_Components[result->_realType].push_back(result);
+					_ComponentsByGuid[result->GetGUID()] = result;
 					return result;
 				}
 			}
@@ -103,6 +126,7 @@ namespace Gameplay {
 				result->_weakSelfPtr = result;
 				// Add the component to the global pools
 				_Components[result->_realType].push_back(result);
+				_ComponentsByGuid[result->GetGUID()] = result;
 				return result;
 			}
 			return nullptr;
@@ -145,6 +169,7 @@ namespace Gameplay {
 
 			// Add to global component list for that type
 			_Components[type].push_back(component);
+			_ComponentsByGuid[component->GetGUID()] = component;
 
 			// Return the result
 			return component;
@@ -165,24 +190,21 @@ namespace Gameplay {
 			std::type_index type = std::type_index(typeid(ComponentType));
 			LOG_ASSERT(_TypeLoadRegistry[type] != nullptr, "You must register component types before creating them!");
 
-			// Clear any dead weak pointers
-			auto removeIt = std::remove_if(_Components[type].begin(), _Components[type].end(), [](const std::weak_ptr<IComponent>& ptr) {
-				return ptr.expired();
-			});
-			_Components[type].erase(removeIt, _Components[type].end());
-
-			// Search the component store for a component that matches that ID
-			auto& it = std::find_if(_Components[type].begin(), _Components[type].end(), [&](const std::weak_ptr<IComponent>& ptr) {
-				return (ptr.lock())->GetGUID() == id;
-			});
-
-			// If the component was found, return it. Otherwise return nullptr
-			if (it != _Components[type].end()) {
-				// We need to lock the weak pointer to convert it to a shared ptr
-				return std::dynamic_pointer_cast<ComponentType>((*it).lock());
-			} else {
+			// Look the component up in the GUID index
+			auto it = _ComponentsByGuid.find(id);
+			if (it == _ComponentsByGuid.end()) {
+				return nullptr;
+			}
+
+			// We need to lock the weak pointer to convert it to a shared ptr
+			IComponent::Sptr result = it->second.lock();
+			if (result == nullptr) {
+				_ComponentsByGuid.erase(it);
 				return nullptr;
 			}
+
+			// The index contains all component types, make sure it's the type we asked for
+			return result->_realType == type ? std::static_pointer_cast<ComponentType>(result) : nullptr;
 		}
 
 		/// <summary>
@@ -239,6 +261,7 @@ namespace Gameplay {
 		/// </summary>
 		inline void FlushAll() {
 			_Components = std::unordered_map<std::type_index, std::vector<std::weak_ptr<IComponent>>>();
+			_ComponentsByGuid = std::unordered_map<Guid, std::weak_ptr<IComponent>>();
 		}
 
 	private:
@@ -258,6 +281,30 @@ namespace Gameplay {
 		// actually increasing the reference count. Thus components will be destroyed at the correct
 		// time (when the only reference is the one stored here).
 		std::unordered_map<std::type_index, std::vector<std::weak_ptr<IComponent>>> _Components;  
+		// Index of all components by their GUID, for resolving cross references in O(1)
+		std::unordered_map<Guid, std::weak_ptr<IComponent>> _ComponentsByGuid;
+
+		/// <summary>
+		/// Invokes the loader for a registered type and adds the result to the component pools, does not
+		/// load the base component data or add the component to the GUID index
+		/// </summary>
+		inline IComponent::Sptr _Load(const std::type_index& type, const nlohmann::json& blob) {
+			// Get the load callback and make sure it exists
+			auto it = _TypeLoadRegistry.find(type);
+			if (it != _TypeLoadRegistry.end() && it->second) {
+				// Invoke the loader
+				IComponent::Sptr result = it->second(blob);
+
+				// Make sure the component knows it's own type
+				result->_realType = type;
+				result->_weakSelfPtr = result;
+
+				// Add the component to the global pools
+				_Components[result->_realType].push_back(result);
+				return result;
+			}
+			return nullptr;
+		}
 
 		template <typename T>
 		static IComponent::Sptr ParseTypeFromBlob(const nlohmann::json& blob) {
@@ -302,8 +349,12 @@ namespace Gameplay {
 			auto it = std::remove_if(componentStore.begin(), componentStore.end(), [](const std::weak_ptr<IComponent>& ptr) {
 				return ptr.expired();
 				});
-			if (it != componentStore.end()) {
-				componentStore.erase(it);
+			componentStore.erase(it, componentStore.end());
+
+			// Remove the component from the GUID index, as long as the entry hasn't been replaced
+			auto guidIt = _ComponentsByGuid.find(component->GetGUID());
+			if (guidIt != _ComponentsByGuid.end() && guidIt->second.expired()) {
+				_ComponentsByGuid.erase(guidIt);
 			}
 		}
 	};
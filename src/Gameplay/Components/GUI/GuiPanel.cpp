@@ -8,13 +8,18 @@ GuiPanel::GuiPanel() :
 	_borderRadius(-1),
 	_color(glm::vec4(1.0f)),
 	_texture(nullptr),
-	_transform(nullptr)
+	_sprite(nullptr),
+	_transform(nullptr),
+	_geometry(),
+	_isDirty(true),
+	_sizeVersion(0)
 { }
 
 GuiPanel::~GuiPanel() = default;
 
 void GuiPanel::SetColor(const glm::vec4& color) {
 	_color = color;
+	_isDirty = true;
 }
 
 const glm::vec4& GuiPanel::GetColor() const {
@@ -27,6 +32,7 @@ int GuiPanel::GetBorderRadius() const {
 
 void GuiPanel::SetBorderRadius(int value) {
 	_borderRadius = value;
+	_isDirty = true;
 }
 
 Texture2D::Sptr GuiPanel::GetTexture() const {
@@ -35,6 +41,16 @@ Texture2D::Sptr GuiPanel::GetTexture() const {
 
 void GuiPanel::SetTexture(const Texture2D::Sptr& value) {
 	_texture = value;
+	_isDirty = true;
+}
+
+GuiSprite::Sptr GuiPanel::GetSprite() const {
+	return _sprite;
+}
+
+void GuiPanel::SetSprite(const GuiSprite::Sptr& value) {
+	_sprite = value;
+	_isDirty = true;
 }
 
 void GuiPanel::Awake() {
@@ -46,10 +62,21 @@ void GuiPanel::Awake() {
 }
 
 void GuiPanel::StartGUI() {
-	Texture2D::Sptr tex = _texture != nullptr ? _texture : GuiBatcher::GetDefaultTexture();
-
-	GuiBatcher::PushRect(glm::vec2(0,0), _transform->GetSize(), _color, tex, _borderRadius < 0 ? GuiBatcher::GetDefaultBorderRadius() : _borderRadius);
-
+	// Resizing a rect doesn't always change its transform, so we need to check the size separately
+	bool isResized = _transform->GetSizeVersion() != _sizeVersion;
+	if (GuiBatcher::BeginRetained(_geometry, _isDirty || isResized)) {
+		int radius = _borderRadius < 0 ? GuiBatcher::GetDefaultBorderRadius() : _borderRadius;
+
+		if (_texture != nullptr) {
+			GuiBatcher::PushRect(glm::vec2(0,0), _transform->GetSize(), _color, _texture, radius);
+		} else {
+			GuiSprite::Sptr sprite = _sprite != nullptr ? _sprite : GuiBatcher::GetDefaultSprite();
+			GuiBatcher::PushRect(glm::vec2(0,0), _transform->GetSize(), _color, sprite, radius);
+		}
+		_isDirty = false;
+		_sizeVersion = _transform->GetSizeVersion();
+	}
+	GuiBatcher::EndRetained();
 }
 
 void GuiPanel::FinishGUI() {
@@ -57,15 +84,16 @@ void GuiPanel::FinishGUI() {
 
 void GuiPanel::RenderImGui()
 {
-	LABEL_LEFT(ImGui::ColorEdit4, "Color ", &_color.x);
-	LABEL_LEFT(ImGui::DragInt,    "Radius", &_borderRadius, 1, 0, 128);
+	_isDirty |= LABEL_LEFT(ImGui::ColorEdit4, "Color ", &_color.x);
+	_isDirty |= LABEL_LEFT(ImGui::DragInt,    "Radius", &_borderRadius, 1, 0, 128);
 }
 
 nlohmann::json GuiPanel::ToJson() const {
 	return {
 		{ "color",   _color },
 		{ "border",  _borderRadius },
-		{ "texture", _texture  ? _texture->GetGUID().str() : "null" }
+		{ "texture", _texture  ? _texture->GetGUID().str() : "null" },
+		{ "sprite",  _sprite   ? _sprite->GetGUID().str() : "null" }
 	};
 }
 
@@ -75,6 +103,7 @@ GuiPanel::Sptr GuiPanel::FromJson(const nlohmann::json& blob) {
 	result->_color        = JsonGet(blob, "color", result->_color);
 	result->_borderRadius = JsonGet(blob, "border", 0);
 	result->_texture      = ResourceManager::Get<Texture2D>(Guid(JsonGet<std::string>(blob, "texture", "null")));
+	result->_sprite       = ResourceManager::Get<GuiSprite>(Guid(JsonGet<std::string>(blob, "sprite", "null")));
 
 	return result;
 }
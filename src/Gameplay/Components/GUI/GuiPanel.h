@@ -3,6 +3,7 @@
 #include "Gameplay/Components/IComponent.h"
 #include "Gameplay/Components/GUI/RectTransform.h"
 #include "Graphics/Textures/Texture2D.h"
+#include "Graphics/GuiBatcher.h"
 
 /// <summary>
 /// Draws a textured background for UI components
@@ -40,10 +41,20 @@ public:
 	/// </summary>
 	Texture2D::Sptr GetTexture() const;
 	/// <summary>
-	/// Sets the background texture to use for this panel
+	/// Sets the background texture to use for this panel. Panels with their own texture
+	/// cannot be batched with other GUI elements, prefer using SetSprite where possible
 	/// </summary>
 	void SetTexture(const Texture2D::Sptr& value);
 
+	/// <summary>
+	/// Gets the background sprite for this panel
+	/// </summary>
+	GuiSprite::Sptr GetSprite() const;
+	/// <summary>
+	/// Sets the background sprite to use for this panel, this is ignored if the panel has a texture
+	/// </summary>
+	void SetSprite(const GuiSprite::Sptr& value);
+
 public:
 	virtual void Awake() override;
 	virtual void StartGUI() override;
@@ -56,7 +67,14 @@ public:
 protected:
 	int             _borderRadius;
 	Texture2D::Sptr _texture;
+	GuiSprite::Sptr _sprite;
 	glm::vec4       _color;
 
 	RectTransform::Sptr _transform;
+
+	// Our vertices are kept between frames, and only rebuilt when the panel or its transform changes
+	GuiBatcher::RetainedGeometry _geometry;
+	bool _isDirty;
+	// The size version of our rect transform when the geometry was last built
+	uint32_t _sizeVersion;
 };
\ No newline at end of file
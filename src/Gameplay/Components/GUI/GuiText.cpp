@@ -1,26 +1,29 @@
 #include "Gameplay/Components/GUI/GuiText.h"
-#include <locale>
-#include <codecvt>
 #include "Graphics/GuiBatcher.h"
 #include "Utils/ImGuiHelper.h"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/StringUtils.h"
 #include "Gameplay/GameObject.h"
 
-std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> StringConvert;
-
 GuiText::GuiText() :
 	IComponent(),
 	_text(LR"()"), // The LR and parenthesis tell us it's a unicode string (wide string)
 	_color(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)),
 	_font(nullptr),
 	_textSize(glm::vec2(0.0f)),
-	_textScale(1.0f)
+	_textScale(1.0f),
+	_layout(),
+	_isLayoutDirty(true),
+	_geometry(),
+	_isDirty(true),
+	_sizeVersion(0)
 { }
 
 GuiText::~GuiText() = default;
 
 void GuiText::SetColor(const glm::vec4& color) {
 	_color = color;
+	_isDirty = true;
 }
 
 const glm::vec4& GuiText::GetColor() const {
@@ -28,11 +31,17 @@ const glm::vec4& GuiText::GetColor() const {
 }
 
 std::string GuiText::GetText() const {
-	return StringConvert.to_bytes(_text);
+	return StringTools::WideToUtf8(_text);
 }
 
 void GuiText::SetText(const std::string& value) {
-	SetTextUnicode(StringConvert.from_bytes(value));
+	// Decode into scratch storage, so that setting the same value every frame (ex: score counters)
+	// does not allocate or invalidate anything
+	static std::wstring unicode;
+	StringTools::Utf8ToWide(value, unicode);
+	if (unicode != _text) {
+		SetTextUnicode(unicode);
+	}
 }
 
 const std::wstring& GuiText::GetTextUnicode() const {
@@ -40,10 +49,10 @@ const std::wstring& GuiText::GetTextUnicode() const {
 }
 
 void GuiText::SetTextUnicode(const std::wstring& value) {
-	_text = value;
-	
-	if (_font != nullptr) {
-		_textSize = _font->MeausureString(_text, _textScale);
+	if (_text != value) {
+		_text = value;
+		_isLayoutDirty = true;
+		_isDirty = true;
 	}
 }
 
@@ -53,6 +62,8 @@ const float GuiText::GetTextScale() const {
 
 void GuiText::SetTextScale(float value) {
 	_textScale = value;
+	_isLayoutDirty = true;
+	_isDirty = true;
 }
 
 const Font::Sptr& GuiText::GetFont() const {
@@ -61,9 +72,8 @@ const Font::Sptr& GuiText::GetFont() const {
 
 void GuiText::SetFont(const Font::Sptr& font) {
 	_font = font;
-	if (_font != nullptr) {
-		_textSize = _font->MeausureString(_text, _textScale);
-	}
+	_isLayoutDirty = true;
+	_isDirty = true;
 }
 
 void GuiText::Awake() {
@@ -77,29 +87,41 @@ void GuiText::Awake() {
 void GuiText::RenderGUI()
 {
 	if (_font != nullptr && !_text.empty()) {
-		glm::vec2 position = _transform->GetSize() / 2.0f;
-		position -= _textSize / 2.0f;
-		GuiBatcher::RenderText(_text, _font, position, _color, _textScale);
+		// Glyph lookups and kerning only need to happen when the text itself changes
+		if (_isLayoutDirty) {
+			_font->LayoutString(_text, _textScale, _layout);
+			_textSize = _layout.Size;
+			_isLayoutDirty = false;
+		}
+
+		// The text is centered in our rect, so resizing it needs a rebuild even if the transform is the same
+		bool isResized = _transform->GetSizeVersion() != _sizeVersion;
+		if (GuiBatcher::BeginRetained(_geometry, _isDirty || isResized)) {
+			glm::vec2 position = _transform->GetSize() / 2.0f;
+			position -= _textSize / 2.0f;
+			GuiBatcher::RenderText(_layout, _font, position, _color);
+			_isDirty = false;
+			_sizeVersion = _transform->GetSizeVersion();
+		}
+		GuiBatcher::EndRetained();
 	}
 }
 
 void GuiText::RenderImGui()
 {
 	static char buffer[4096];
-	std::string ascii = StringConvert.to_bytes(_text);
-	memcpy(buffer, ascii.data(), ascii.size());
+	std::string ascii = StringTools::WideToUtf8(_text);
+	size_t length = std::min(ascii.size(), sizeof(buffer) - 1);
+	memcpy(buffer, ascii.data(), length);
+	buffer[length] = '\0';
 
 	if (LABEL_LEFT(ImGui::InputTextMultiline, "Text", buffer, 4096)) {
-		_text = StringConvert.from_bytes(buffer);
-		if (_font != nullptr) {
-			_textSize = _font->MeausureString(_text, _textScale);
-		}
+		SetTextUnicode(StringTools::Utf8ToWide(buffer));
 	}
-	LABEL_LEFT(ImGui::ColorEdit4, "Color", &_color.x);
-	if (LABEL_LEFT(ImGui::DragFloat, "Scale", &_textScale, 0.01f)) {
-		if (_font != nullptr) {
-			_textSize = _font->MeausureString(_text, _textScale);
-		}
+	_isDirty |= LABEL_LEFT(ImGui::ColorEdit4, "Color", &_color.x);
+	float scale = _textScale;
+	if (LABEL_LEFT(ImGui::DragFloat, "Scale", &scale, 0.01f)) {
+		SetTextScale(scale);
 	}
 }
 
@@ -2,6 +2,7 @@
 #include "Gameplay/Components/IComponent.h"
 #include "Gameplay/Components/GUI/RectTransform.h"
 #include "Graphics/Font.h"
+#include "Graphics/GuiBatcher.h"
 
 /// <summary>
 /// Renders text for UI components
@@ -82,4 +83,14 @@ protected:
 	float           _textScale;
 
 	RectTransform::Sptr _transform;
+
+	// The positioned glyphs for our text, only re-done when the text, scale or font changes
+	TextLayout _layout;
+	bool _isLayoutDirty;
+
+	// Our glyph quads are kept between frames, and only rebuilt when the text or its transform changes
+	GuiBatcher::RetainedGeometry _geometry;
+	bool _isDirty;
+	// The size version of our rect transform when the geometry was last built
+	uint32_t _sizeVersion;
 };
\ No newline at end of file
@@ -12,6 +12,7 @@ RectTransform::RectTransform() :
 	_position({0.0f, 0.0f}),
 	_halfSize({0.5f, 0.5f}),
 	_rotation(0.0f),
+	_sizeVersion(0),
 	_transform(glm::mat3(1.0f)),
 	_transformDirty(true)
 { }
@@ -33,7 +34,7 @@ void RectTransform::SetMin(const glm::vec2& value)
 {
 	// min = position - halfSize
 	glm::vec2 newSize = glm::max(value, GetMax()) - glm::min(value, GetMax());
-	_halfSize = newSize / 2.0f;
+	__SetHalfSize(newSize / 2.0f);
 	_position = value + _halfSize;
 	_transformDirty = true;
 }
@@ -43,7 +44,7 @@ glm::vec2 RectTransform::GetMax() const {
 }
 void RectTransform::SetMax(const glm::vec2& value) {
 	glm::vec2 newSize = glm::max(value, GetMin()) - glm::min(value, GetMin());
-	_halfSize = newSize / 2.0f;
+	__SetHalfSize(newSize / 2.0f);
 	_position = value - _halfSize;
 	_transformDirty = true;
 }
@@ -52,11 +53,13 @@ glm::vec2 RectTransform::GetSize() const {
 	return _halfSize * 2.0f;
 }
 void RectTransform::SetSize(const glm::vec2& value) {
-	_halfSize = value * 2.0f;
+	__SetHalfSize(value / 2.0f);
+	_transformDirty = true;
 }
 
 void RectTransform::SetRotationDeg(float value) {
 	_rotation = glm::radians(value);
+	_transformDirty = true;
 }
 
 float RectTransform::GetRotationDeg() const {
@@ -68,6 +71,10 @@ const glm::mat3& RectTransform::GetLocalTransform() const {
 	return _transform;
 }
 
+uint32_t RectTransform::GetSizeVersion() const {
+	return _sizeVersion;
+}
+
 void RectTransform::RenderImGui()
 {
 	_transformDirty |= LABEL_LEFT(ImGui::DragFloat2, "Position", &_position.x, 0.01f);
@@ -124,3 +131,10 @@ void RectTransform::__RecalcTransforms() const {
 		_transformDirty = false;
 	}
 }
+
+void RectTransform::__SetHalfSize(const glm::vec2& value) {
+	if (value != _halfSize) {
+		_halfSize = value;
+		_sizeVersion++;
+	}
+}
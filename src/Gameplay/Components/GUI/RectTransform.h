@@ -67,6 +67,13 @@ public:
 	/// </summary>
 	const glm::mat3& GetLocalTransform() const;
 
+	/// <summary>
+	/// Gets a counter that is incremented whenever the size of the rect changes. Components
+	/// that keep geometry between frames can compare this to know when to rebuild, since
+	/// moving the min or max bounds can change the size without changing the local transform
+	/// </summary>
+	uint32_t GetSizeVersion() const;
+
 public:
 	// Inherited from IComponent
 
@@ -82,9 +89,11 @@ protected:
 	glm::vec2 _position;
 	glm::vec2 _halfSize;
 	float     _rotation;
+	uint32_t  _sizeVersion;
 
 	mutable glm::mat3 _transform;
 	mutable bool _transformDirty;
 
 	void __RecalcTransforms() const;
+	void __SetHalfSize(const glm::vec2& value);
 };
\ No newline at end of file
@@ -82,9 +82,23 @@ void InteractableObjectBehaviour::AddFeedbackBehaviour(InteractionFeedback f) {
 
 
 void InteractableObjectBehaviour::Update(float deltaTime) {
+	Gameplay::Scene* scene = GetGameObject()->GetScene();
+
+	// Pick up the result of the probe we queued last frame, anything other than ourselves blocks the view
+	if (_hasSightQuery) {
+		const Gameplay::Physics::PhysicsQueryHit* hit = scene->GetCompletedPhysicsQueries().GetHit(_sightQuery);
+		Gameplay::IComponent::Sptr hitBody = hit != nullptr ? hit->Body.lock() : nullptr;
+		_hasLineOfSight = hit == nullptr || (hitBody != nullptr && hitBody->GetGameObject() == GetGameObject());
+		_hasSightQuery = false;
+	}
+
 	if (_playerInTrigger) {
+		if (RequireLineOfSight && _body != nullptr) {
+			_sightQuery = scene->GetPhysicsQueries().AddRay(_body->GetGameObject()->GetPosition(), GetGameObject()->GetPosition(), Gameplay::Physics::PhysicsQueries::ALL_GROUPS, _body);
+			_hasSightQuery = true;
+		}
 
-		if (InputEngine::GetKeyState(GLFW_KEY_E) == ButtonState::Pressed) {
+		if (InputEngine::GetKeyState(GLFW_KEY_E) == ButtonState::Pressed && (!RequireLineOfSight || _hasLineOfSight)) {
 			_hasBeenActivated = true;
 			_playerInTrigger = false;
 			PerformFeedback();
@@ -105,6 +119,7 @@ void InteractableObjectBehaviour::OnTriggerVolumeEntered(const std::shared_ptr<G
 	if (!_hasBeenActivated) {
 		LOG_INFO("Body has entered our trigger volume: {}", body->GetGameObject()->Name);
 		_playerInTrigger = true;
+		_hasLineOfSight = false;
 		_body = body;
 		
 	}
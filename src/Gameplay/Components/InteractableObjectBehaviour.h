@@ -77,6 +77,8 @@ public:
 	Gameplay::Material::Sptr image;
 	Gameplay::GameObject::Sptr secret;
 	bool isSecret = false;
+	// When true, the player can only interact when nothing is blocking the line between them and the object
+	bool RequireLineOfSight = false;
 	// Inherited from IComponent
 	virtual void Update(float deltaTime) override;
 	virtual void OnTriggerVolumeEntered(const std::shared_ptr<Gameplay::Physics::RigidBody>& body) override;
@@ -93,6 +95,11 @@ protected:
 	bool _playerInTrigger = false;
 	bool _hasBeenActivated = false;
 
+	// Line of sight is probed through the scene's query batch, so the result arrives a frame later
+	bool _hasSightQuery = false;
+	bool _hasLineOfSight = false;
+	Gameplay::Physics::PhysicsQueries::Handle _sightQuery = 0;
+
 	Gameplay::Physics::RigidBody::Sptr _body;
 
 	GLFWwindow* _windowPointer;
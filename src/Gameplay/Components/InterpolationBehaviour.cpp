@@ -4,15 +4,16 @@
 #include "Utils/JsonGlmHelpers.h"
 #include "Gameplay/Scene.h"
 #include "Gameplay/InputEngine.h"
+#include "Utils/ResourceManager/ResourceManager.h"
 #include "GLFW/glfw3.h"
-
-#include <fstream>
+#include "Logging.h"
 
 InterpolationBehaviour::InterpolationBehaviour() :IComponent() {
 	//we will assume that the first behaviour pushed is the one to use, 
 	//and that it should constantly loop
 	_currentTransformIndex = 0;
-	_loopTransform = true;
+	_localClips = nullptr;
+	_playback.IsLooping = true;
 	_isRunning = true;
 	_amountOfTransforms = 0;
 	cooldown = 0;
@@ -30,22 +31,21 @@ InterpolationBehaviour::~InterpolationBehaviour() = default;
 void InterpolationBehaviour::ToggleBehaviour(std::string name, bool loops) {
 
 	//resets current behaviour
-	for (int i = 0; i < 3; i++) {
-		(_allTransforms[_currentTransformIndex]).transformFinished[i] = 0;
-		(_allTransforms[_currentTransformIndex]).transformIndexes[i] = 0;
-		(_allTransforms[_currentTransformIndex]).transformTimes[i] = 0;
-	}
+	_playback.Reset();
 
 	//searches for behaviour with specified name
-	for (int i = 0; i < _allTransforms.size(); i++) {
-		if (_allTransforms[i].animName == name) {
-			_currentTransformIndex = i;
+	int offset = 0;
+	for (auto& set : _clipSets) {
+		int index = set->FindClip(name);
+		if (index != -1) {
+			_SelectBehaviour(offset + index);
 			break;
 		}
+		offset += (int)set->GetClips().size();
 	}
 
 	//tells system whether the behaviour needs to loop or not
-	_loopTransform = loops;
+	_playback.IsLooping = loops;
 }
 
 /// <summary>
@@ -57,17 +57,13 @@ void InterpolationBehaviour::ToggleBehaviour(std::string name, bool loops) {
 void InterpolationBehaviour::ToggleBehaviour(int index, bool loops) {
 
 	//resets current behaviour
-	for (int i = 0; i < 3; i++) {
-		(_allTransforms[_currentTransformIndex]).transformFinished[i] = 0;
-		(_allTransforms[_currentTransformIndex]).transformIndexes[i] = 0;
-		(_allTransforms[_currentTransformIndex]).transformTimes[i] = 0;
-	}
+	_playback.Reset();
 
 	//sets to specified index
-	_currentTransformIndex = index;
+	_SelectBehaviour(index);
 
 	//tells system whether the behaviour needs to loop or not
-	_loopTransform = loops;
+	_playback.IsLooping = loops;
 
 }
 
@@ -80,115 +76,40 @@ void InterpolationBehaviour::PauseOrResumeCurrentBehaviour() {
 }
 
 void InterpolationBehaviour::Update(float deltaTime) {
-	if (_isRunning) {
-		InterpolationManager(deltaTime);
-	}
+	//playback is handled by the scene's animation system
 	if (InputEngine::GetKeyState(GLFW_KEY_ENTER) == ButtonState::Down) {
 		std::cout << "You pressed da button";
 		GetGameObject()->SetPosition(glm::vec3(GetGameObject()->GetPosition().x, GetGameObject()->GetPosition().y, -50));
 	}
 }
 
-/// <summary>
-/// Checks to see if position, rotation, or scale need to be updated
-/// </summary>
-/// <param name="deltaTime"></param>
-void InterpolationBehaviour::InterpolationManager(float deltaTime) {
-	TFormAnim currentTransform = _allTransforms[_currentTransformIndex];
-	int totalTforms = 0;
-	int completedTransformsTotal = 0;
-	for (int i = 0; i < 3; i++) {
-		if (currentTransform.hasFrames[i]) {
-			completedTransformsTotal += currentTransform.transformFinished[i];
-			totalTforms++;
-		}
-	}
-
-	if (completedTransformsTotal < totalTforms) {
-		if(currentTransform.hasFrames[0]) if (!currentTransform.transformFinished[0]) GetGameObject()->SetPosition(PerformTransformation(deltaTime, 0, currentTransform.animKeys[0]));
-		if(currentTransform.hasFrames[1]) if (!currentTransform.transformFinished[1])	GetGameObject()->SetRotation(PerformTransformation(deltaTime, 1, currentTransform.animKeys[1]));
-		if(currentTransform.hasFrames[2]) if (!currentTransform.transformFinished[2])	GetGameObject()->SetScale(PerformTransformation(deltaTime, 2, currentTransform.animKeys[2]));
-	}
-	else {
-		if (!_loopTransform) {
-			_isRunning = false;
-		}
-
-		for (int i = 0; i < 3; i++) {
-			if (currentTransform.hasFrames[i]) {
-				(_allTransforms[_currentTransformIndex]).transformFinished[i] = 0;
-				(_allTransforms[_currentTransformIndex]).transformIndexes[i] = 0;
-				(_allTransforms[_currentTransformIndex]).transformTimes[i] = 0;
-			}
-			
-		}
-
-	}
-
-}
-
-/// <summary>
-/// Finds the current keyframes for a transformation, calculates LERP, and returns the result
-/// </summary>
-/// <param name="deltaTime: ">the time since the last update</param>
-/// <param name="index: ">tells us if we want to use translation(0), rotation(1), or scale(2)</param>
-/// <param name="transformKeyFrames: ">the frames we are interpolating between</param>
-/// <returns>the interpolated result</returns>
-glm::vec3 InterpolationBehaviour::PerformTransformation(float deltaTime, int index, std::vector<TFormFrame> transformKeyFrames) {
-	//making things slightly less ugly
-	TFormAnim* currentTransform = &_allTransforms[_currentTransformIndex];
-	//variables
-	float t;
-	glm::vec3 p0, p1;
-
-	//add delta time to our current time value
-	currentTransform->transformTimes[index] += deltaTime;
-
-	//if we are over the duration of the current frame, update the index
-	if (currentTransform->transformTimes[index] >= (transformKeyFrames[currentTransform->transformIndexes[index]].tFormLength)) {
-		currentTransform->transformTimes[index] = 0;
-		currentTransform->transformIndexes[index]++;
-	}
-
-
-	if (currentTransform->transformIndexes[index] >= transformKeyFrames.size() - 1) {
-		//if we have reached the end of the keyframes and our behaviour isn't looping, we will say that the current transformation is complete
-		if (!_loopTransform) {
-			currentTransform->transformFinished[index] = true;
-			//return the current value
-			return transformKeyFrames[currentTransform->transformIndexes[index]].tFinalPose;
-		}//if we have reached the end of the keyframes and our behaviour is looping, we will set the index back to the beginning
-		else if (currentTransform->transformIndexes[index] > transformKeyFrames.size() - 1) {
-			currentTransform->transformIndexes[index] = 0;
+void InterpolationBehaviour::_SelectBehaviour(int index) {
+	_currentTransformIndex = index;
+	_playback.Set = nullptr;
+	_playback.Clip = nullptr;
+
+	//the index counts through the behaviours of every set, in the order the sets were added
+	for (auto& set : _clipSets) {
+		if (index < (int)set->GetClips().size()) {
+			_playback.Set = set.get();
+			_playback.Clip = &set->GetClips()[index];
+			return;
 		}
-
+		index -= (int)set->GetClips().size();
 	}
-
-	//divide time by current duration
-	t = currentTransform->transformTimes[index] / transformKeyFrames[currentTransform->transformIndexes[index]].tFormLength;
-	//get p0 and p1
-	p0 = transformKeyFrames[currentTransform->transformIndexes[index]].tFinalPose;
-	p1 = (currentTransform->transformIndexes[index] != transformKeyFrames.size() - 1) ? transformKeyFrames[currentTransform->transformIndexes[index] + 1].tFinalPose : transformKeyFrames[0].tFinalPose;
-
-	//interpolate and return result
-	return LERP(p0, p1, t);
 }
 
-/// <summary>
-/// performs linear interpolation
-/// </summary>
-/// <returns>interpolated result between p0 and p1, in respect to t</returns>
-template <typename T> T InterpolationBehaviour::LERP(T p0, T p1, float t) {
-	return((1.f - t) * p0) + (t * p1);
-}
-
-
 /// <summary>
 /// The function that you need to call every time you want to start pushing a new set of transformations
 /// </summary>
 /// <param name="transformationName: ">An identifiable name for the transformation</param>
 void InterpolationBehaviour::StartPushNewBehaviour(std::string transformationName) {
-	tName = transformationName;
+	//behaviours built in code aren't shared, so they get a set of their own
+	if (_localClips == nullptr) {
+		_localClips = std::make_shared<Gameplay::AnimationClipSet>();
+		_clipSets.push_back(_localClips);
+	}
+	_localClips->BeginClip(transformationName);
 	_amountOfTransforms++;
 }
 
@@ -201,17 +122,21 @@ void InterpolationBehaviour::StartPushNewBehaviour(std::string transformationNam
 /// <param name="transformDuration: ">the length of time the transformation will take</param>
 /// <param name="transformPose: ">the position, rotation, or scale of the object</param>
 void InterpolationBehaviour::AddKeyFrame(TFormType transformType, float transformDuration, glm::vec3 transformPose) {
-	TFormFrame frame(transformType, transformDuration, transformPose);
-
-	switch (transformType) {
-	case(TRANSLATION):
-		posFrames.push_back(frame);
-		break;
-	case(ROTATION):
-		rotFrames.push_back(frame);
-		break;
-	default:
-		sclFrames.push_back(frame);
+	if (_localClips == nullptr) {
+		LOG_WARN("Keyframe added before StartPushNewBehaviour was called, ignoring");
+		return;
+	}
+	_localClips->AddKey(transformType, transformDuration, transformPose);
+}
+
+/// <summary>
+/// Sets how the behaviour that is being pushed blends between its keyframes, behaviours are linear by default
+/// </summary>
+/// <param name="interpolation: ">how translation and scale keyframes are blended (linear or cubic)</param>
+/// <param name="slerpRotation: ">true to blend rotations as quaternions, false to blend their euler angles</param>
+void InterpolationBehaviour::SetPushedInterpolation(Gameplay::AnimationInterpolation interpolation, bool slerpRotation) {
+	if (_localClips != nullptr) {
+		_localClips->SetInterpolation(interpolation, slerpRotation);
 	}
 }
 
@@ -220,44 +145,27 @@ void InterpolationBehaviour::AddKeyFrame(TFormType transformType, float transfor
 /// More animations can be pushed by calling StartPushNewBehaviour again
 /// </summary>
 void InterpolationBehaviour::EndPushNewBehaviour() {
-	_allTransforms.push_back(TFormAnim(posFrames, rotFrames, sclFrames, tName));
-	posFrames.clear();
-	rotFrames.clear();
-	sclFrames.clear();
+	if (_localClips != nullptr) {
+		_localClips->EndClip();
+		//the set's clips may have moved, so we need to find our current behaviour again
+		_SelectBehaviour(_currentTransformIndex);
+	}
 }
 
 
+/// <summary>
+/// Adds all the behaviours from an interpolation script. Scripts are compiled once and shared
+/// between every object that uses them
+/// </summary>
+/// <param name="path: ">the path to the script</param>
 void InterpolationBehaviour::AddBehaviourScript(std::string path) {
-	std::fstream script;
-	std::string command;
-	std::string n;
-	int t;
-	float d;
-	glm::vec3 p{ 0.f };
-
-	script.open(path);
-	if (script.is_open()) {
-		while (script.good()) {
-			script >> command;
-
-			if (command == "s") {
-				script >> n;
-				StartPushNewBehaviour(n);
-			}
-			else if (command == "f") {
-				script >> t >> d >> p.x >> p.y >> p.z;
-				AddKeyFrame((TFormType)t, d, p);
-			}
-			else if (command == "e") {
-				EndPushNewBehaviour();
- 
-			}
-		}
-	}
-	else {
-		std::cout << "Could not locate " << path << " in the system. Canceling processes...\n";
-		exit(-1);
+	Gameplay::AnimationClipSet::Sptr set = Gameplay::AnimationClipSet::Load(path);
+	if (set == nullptr) {
+		return;
 	}
+	_clipSets.push_back(set);
+	_amountOfTransforms += (int)set->GetClips().size();
+	_SelectBehaviour(_currentTransformIndex);
 }
 
 
@@ -269,14 +177,17 @@ nlohmann::json InterpolationBehaviour::ToJson() const {
 	nlohmann::json result;
 
 	result["is_running"] = _isRunning;
-	result["is_looping"] = _loopTransform;
+	result["is_looping"] = _playback.IsLooping;
 	result["current_index"] = _currentTransformIndex;
-	result["num_of_transforms"] = _amountOfTransforms;
 
-	result["interpolation_scripts_used"] = loadedScripts.size();
-	for (int i = 0; i < loadedScripts.size(); i++) {
-		result["interpolation_script_" + std::to_string(i)] = loadedScripts[i];
+	//only sets compiled from scripts are resources, behaviours built in code are not saved
+	std::vector<std::string> clipSets;
+	for (auto& set : _clipSets) {
+		if (!set->Filename.empty()) {
+			clipSets.push_back(set->GetGUID().str());
+		}
 	}
+	result["clip_sets"] = clipSets;
 
 	return result;
 }
@@ -284,14 +195,26 @@ nlohmann::json InterpolationBehaviour::ToJson() const {
 InterpolationBehaviour::Sptr InterpolationBehaviour::FromJson(const nlohmann::json & blob) {
 	InterpolationBehaviour::Sptr result = std::make_shared<InterpolationBehaviour>();
 	result->_isRunning = blob["is_running"];
-	result->_loopTransform = blob["is_looping"];
-	result->_currentTransformIndex = blob["current_index"];
-	result->_amountOfTransforms = blob["num_of_transforms"];
-
-	int numOfFiles = blob["interpolation_scripts_used"];
-	for (int i = 0; i < numOfFiles; i++) {
-		result->AddBehaviourScript(blob["interpolation_script_" + std::to_string(i)]);
+	result->_playback.IsLooping = blob["is_looping"];
+
+	if (blob.contains("clip_sets")) {
+		for (auto& guid : blob["clip_sets"]) {
+			Gameplay::AnimationClipSet::Sptr set = ResourceManager::Get<Gameplay::AnimationClipSet>(Guid(guid));
+			if (set != nullptr) {
+				result->_clipSets.push_back(set);
+				result->_amountOfTransforms += (int)set->GetClips().size();
+			}
+		}
 	}
+	//older scenes reference their scripts directly
+	else {
+		int numOfFiles = JsonGet(blob, "interpolation_scripts_used", 0);
+		for (int i = 0; i < numOfFiles; i++) {
+			result->AddBehaviourScript(blob["interpolation_script_" + std::to_string(i)]);
+		}
+	}
+
+	result->_SelectBehaviour(blob["current_index"]);
 
 	return result;
-}
\ No newline at end of file
+}
@@ -1,5 +1,10 @@
 #pragma once
 #include "IComponent.h"
+#include "Gameplay/AnimationClipSet.h"
+
+namespace Gameplay {
+	class AnimationSystem;
+}
 
 /// <summary>
 /// a very simple, optional enum to make function calls a bit easier
@@ -19,63 +24,16 @@ enum TFormType {
 	SCALE
 };
 
-/// <summary>
-/// A structure that holds the frame data for a single transformation
-/// (translation, rotation, or scaling)
-/// </summary>
-struct TFormFrame {
-	TFormType tFormType;
-	float tFormLength;
-	glm::vec3 tFinalPose;
-
-	/// <summary>
-	/// constructor for a single frame data structure
-	/// </summary>
-	/// <param name="tft: ">the type of transformation (translation, rotation, scale)</param>
-	/// <param name="tfl: ">the duration of this frame in seconds</param>
-	/// <param name="tfp: ">the final value of the transformation as XYZ</param>
-	TFormFrame(TFormType tft, float tfl, glm::vec3 tfp) {
-		tFormType = tft;
-		tFormLength = tfl;
-		tFinalPose = tfp;
-	}
-};
-
-/// <summary>
-/// A structure that makes up a singular behaviour/animation/whatever
-/// </summary>
-struct TFormAnim {
-	std::vector<std::vector<TFormFrame>> animKeys;
-	std::string animName;
-	int transformIndexes[3]{ 0, 0, 0 };
-	float transformTimes[3]{ 0, 0, 0 };
-	bool transformFinished[3]{ 0, 0, 0 };
-	bool hasFrames[3]{ 0, 0, 0 };
-
-	/// <summary>
-	/// constructor for a TFormAnim
-	/// </summary>
-	/// <param name="posFrames: ">a vector holding each position data frame</param>
-	/// <param name="rotFrames: ">a vector holding each rotation data frame</param>
-	/// <param name="sclFrames: ">a vector holding each scale data frame</param>
-	/// <param name="aName: ">a string by which we can identify this behaviour</param>
-	TFormAnim(std::vector<TFormFrame> posFrames, std::vector<TFormFrame> rotFrames, std::vector<TFormFrame> sclFrames, std::string aName) {
-		animKeys.push_back(posFrames);
-		animKeys.push_back(rotFrames);
-		animKeys.push_back(sclFrames);
-
-		animName = aName;
-
-		for (int i = 0; i < 3; i++) { hasFrames[i] = (animKeys[i].size() > 0); }
-	}
-};
-
 /// <summary>
 /// A simple linear interpolation system that allows an object to follow a set path
 ///  or a set sequence of transformations. 
 /// 
 /// Multiple paths/sequences can be stored, but only one will be accessed at a time. 
 /// Toggling is performed via the "ToggleBehaviour" function
+/// 
+/// The paths are stored in shared Gameplay::AnimationClipSet resources, so each object 
+/// only keeps track of which clip it is playing and how far along it is. The scene's
+/// Gameplay::AnimationSystem does the actual playback for all objects at once
 /// </summary>
 class InterpolationBehaviour : public Gameplay::IComponent {
 public:
@@ -92,13 +50,9 @@ public:
 	void ToggleBehaviour(int, bool);
 	void PauseOrResumeCurrentBehaviour();
 
-	void InterpolationManager(float deltaTime);
-	glm::vec3 PerformTransformation(float deltaTime, int index, std::vector<TFormFrame> transformKeyFrames);
-	template <typename T> T LERP(T p0, T p1, float t);
-
-
 	void StartPushNewBehaviour(std::string bName);
 	void AddKeyFrame(TFormType, float, glm::vec3);
+	void SetPushedInterpolation(Gameplay::AnimationInterpolation interpolation, bool slerpRotation);
 	void EndPushNewBehaviour();
 
 	void AddBehaviourScript(std::string path);
@@ -107,21 +61,23 @@ public:
 	
 	bool _isRunning;
 protected:
+	//the compiled behaviours we can play, these are shared with every object using the same scripts
+	std::vector<Gameplay::AnimationClipSet::Sptr> _clipSets;
+	//behaviours pushed from code are built into a set that only this object uses
+	Gameplay::AnimationClipSet::Sptr _localClips;
 
-	std::vector<TFormAnim> _allTransforms;
+	//the behaviour that is currently playing, whether it loops, and how far along it is
+	Gameplay::AnimationPlayback _playback;
 	int _currentTransformIndex;
 	int _amountOfTransforms;
-	bool _loopTransform;
 	
 	int cooldown;
 
-	std::vector<std::string> loadedScripts;
+	/// <summary>
+	/// Finds the behaviour with the given index across all of our clip sets and makes it current
+	/// </summary>
+	void _SelectBehaviour(int index);
 
-private:
-	//these variables are used during initiation 
-	//they should not be accessed after start-up is complete, as they will be empty
-	std::vector<TFormFrame> posFrames;
-	std::vector<TFormFrame> rotFrames;
-	std::vector<TFormFrame> sclFrames;
-	std::string tName;
+	//the animation system plays our behaviour for us
+	friend class Gameplay::AnimationSystem;
 };
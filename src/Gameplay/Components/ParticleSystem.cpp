@@ -33,6 +33,11 @@ ParticleSystem::~ParticleSystem()
 
 void ParticleSystem::Update()
 {
+	// The simulation can't run if the transform feedback shader failed to build
+	if (!_updateShader->WaitForLink()) {
+		return;
+	}
+
 	// If we haven't previously initialized our data, initialize it now
 	if (!_hasInit) {
 		// Allocate some temp space for particles, so we can init the emitters
@@ -96,8 +101,10 @@ void ParticleSystem::Update()
 
 	// Bind the update shader and send our relevant uniforms
 	_updateShader->Bind();
-	_updateShader->SetUniform("u_Gravity", _gravity); 
-	_updateShader->SetUniformMatrix("u_ModelMatrix", GetGameObject()->GetTransform()); 
+	_gravityUniform.Resolve(_updateShader);
+	_modelMatrixUniform.Resolve(_updateShader);
+	_gravityUniform.Set(_gravity);
+	_modelMatrixUniform.Set(GetGameObject()->GetTransform());
 
 	// Our particles are points that we're simulating
 	glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, _query);
@@ -146,8 +153,8 @@ void ParticleSystem::Update()
 
 void ParticleSystem::Render()
 {
-	// Make sure that we've actually initialized our stuff
-	if (_hasInit) {
+	// Make sure that we've actually initialized our stuff, and that our shader built
+	if (_hasInit && _renderShader->WaitForLink()) {
 
 		// We're using our particle rendering shader
 		_renderShader->Bind();
@@ -263,13 +270,13 @@ void ParticleSystem::Awake()
 	_updateShader->LoadShaderPartFromFile("shaders/vertex_shaders/particles_sim_vs.glsl", ShaderPartType::Vertex);
  	_updateShader->LoadShaderPartFromFile("shaders/geometry_shaders/particle_sim_gs.glsl", ShaderPartType::Geometry);
 	_updateShader->RegisterVaryings(varyings, 6, true); // Here we call glTransformFeedbackVaryings, and let it know we want interleaved data
-	_updateShader->Link(); 
+	_updateShader->LinkAsync();
 
 	// This shader will render the particles
 	_renderShader = ShaderProgram::Create();
 	_renderShader->LoadShaderPartFromFile("shaders/vertex_shaders/particles_render_vs.glsl", ShaderPartType::Vertex);
 	_renderShader->LoadShaderPartFromFile("shaders/fragment_shaders/particles_render_fs.glsl", ShaderPartType::Fragment);
-	_renderShader->Link(); 
+	_renderShader->LinkAsync();
 }
 
 nlohmann::json ParticleSystem::ToJson() const {
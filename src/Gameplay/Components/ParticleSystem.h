@@ -1,6 +1,7 @@
 #pragma once
 #include "Gameplay/Components/IComponent.h"
 #include "Graphics/ShaderProgram.h"
+#include "Graphics/UniformHandle.h"
 
 ENUM(ParticleType, uint32_t,
 	Emitter       = 0,
@@ -55,5 +56,8 @@ protected:
 	ShaderProgram::Sptr _renderShader;
 	glm::vec3           _gravity;
 
+	UniformHandle<glm::vec3> _gravityUniform = "u_Gravity";
+	UniformHandle<glm::mat4> _modelMatrixUniform = "u_ModelMatrix";
+
 	std::vector<ParticleData> _emitters;
 };
\ No newline at end of file
@@ -26,7 +26,14 @@ const Gameplay::MeshResource::Sptr& RenderComponent::GetMeshResource() const {
 }
 
 VertexArrayObject::Sptr RenderComponent::GetMesh() const {
-	return _mesh ? _mesh->Mesh : nullptr;
+	if (_mesh == nullptr) {
+		return nullptr;
+	}
+	// Draw a stand-in while the mesh is streaming in
+	if (_mesh->GetLoadState() == ResourceLoadState::Pending) {
+		return Gameplay::MeshResource::GetPlaceholderMesh();
+	}
+	return _mesh->Mesh;
 }
 
 RenderComponent* RenderComponent::SetMaterial(const Gameplay::Material::Sptr& mat) {
@@ -54,8 +61,8 @@ RenderComponent::Sptr RenderComponent::FromJson(const nlohmann::json& data) {
 }
 
 void RenderComponent::RenderImGui() {
-	ImGui::Text("Indexed:   %s", GetMesh() != nullptr ? (_mesh->Mesh->GetIndexBuffer() != nullptr ? "true" : "false") : "N/A");
-	ImGui::Text("Triangles: %d", GetMesh() != nullptr ? (_mesh->Mesh->GetElementCount() / 3) : 0);
+	ImGui::Text("Indexed:   %s", GetMesh() != nullptr ? (GetMesh()->GetIndexBuffer() != nullptr ? "true" : "false") : "N/A");
+	ImGui::Text("Triangles: %d", GetMesh() != nullptr ? (GetMesh()->GetElementCount() / 3) : 0);
 	ImGui::Text("Source:    %s", (_mesh == nullptr || _mesh->Filename.empty()) ? "Generated" : _mesh->Filename.c_str());
 	ImGui::Separator();
 	ImGui::Text("Material:  %s", _material != nullptr ? _material->Name.c_str() : "NULL");
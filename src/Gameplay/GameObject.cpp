@@ -29,6 +29,7 @@ namespace Gameplay {
 		_worldTransform(MAT4_IDENTITY),
 		_inverseWorldTransform(MAT4_IDENTITY),
 		_isWorldTransformDirty(true),
+		_transformVersion(0),
 		_parent(WeakRef()),
 		_children(std::vector<WeakRef>())
 	{ }
@@ -114,6 +115,7 @@ namespace Gameplay {
 	void GameObject::SetPosition(const glm::vec3& position) {
 		_position = position;
 		_isLocalTransformDirty = true;
+		_transformVersion++;
 	}
 
 	const glm::vec3& GameObject::GetPosition() const {
@@ -127,6 +129,7 @@ namespace Gameplay {
 	void GameObject::SetRotation(const glm::quat& value) {
 		_rotation = value;
 		_isLocalTransformDirty = true;
+		_transformVersion++;
 	}
 
 	const glm::quat& GameObject::GetRotation() const {
@@ -136,6 +139,7 @@ namespace Gameplay {
 	void GameObject::SetRotation(const glm::vec3& eulerAngles) {
 		_rotation = glm::quat(glm::radians(eulerAngles));
 		_isLocalTransformDirty = true;
+		_transformVersion++;
 	}
 
 	glm::vec3 GameObject::GetRotationEuler() const {
@@ -145,12 +149,21 @@ namespace Gameplay {
 	void GameObject::SetScale(const glm::vec3& value) {
 		_scale = value;
 		_isLocalTransformDirty = true;
+		_transformVersion++;
 	}
 
 	const glm::vec3& GameObject::GetScale() const {
 		return _scale;
 	}
 
+	void GameObject::SetLocalTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+		_position = position;
+		_rotation = rotation;
+		_scale = scale;
+		_isLocalTransformDirty = true;
+		_transformVersion++;
+	}
+
 	const glm::mat4& GameObject::GetTransform() const {
 		_RecalcWorldTransform();
 		return _worldTransform;
@@ -354,7 +367,10 @@ namespace Gameplay {
 			}
 
 			// Render position label
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f);
+			if (LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f)) {
+				_isLocalTransformDirty = true;
+				_transformVersion++;
+			}
 			
 			// Get the ImGui storage state so we can avoid gimbal locking issues by storing euler angles in the editor
 			glm::vec3 euler = GetRotationEuler();
@@ -380,7 +396,10 @@ namespace Gameplay {
 			}
 			
 			// Draw the scale
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f);
+			if (LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f)) {
+				_isLocalTransformDirty = true;
+				_transformVersion++;
+			}
 
 			ImGui::Separator();
 			ImGui::TextUnformatted("Components");
@@ -474,16 +493,20 @@ namespace Gameplay {
 			// based on the type name (note that all component types need to be
 			// registered at the start of the application)
 			IComponent::Sptr component = scene->Components().Load(typeName, value);
-			component->_context = result.get();
-
-			// Add component to object and allow it to perform self initialization
-			result->_components.push_back(component);
-			component->OnLoad();
+			result->_AttachLoadedComponent(component);
 		}
 
 		return result;
 	}
 
+	void GameObject::_AttachLoadedComponent(const IComponent::Sptr& component) {
+		component->_context = this;
+
+		// Add component to object and allow it to perform self initialization
+		_components.push_back(component);
+		component->OnLoad();
+	}
+
 	nlohmann::json GameObject::ToJson() const {
 		GameObject::Sptr parent = _parent;
 		nlohmann::json result = {
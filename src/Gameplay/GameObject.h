@@ -212,6 +212,22 @@ namespace Gameplay {
 		/// </summary>
 		const glm::vec3& GetScale() const;
 
+		/// <summary>
+		/// Sets the position, rotation and scale of the object at once, only dirtying the
+		/// transform a single time
+		/// </summary>
+		/// <param name="position">The new position for the object</param>
+		/// <param name="rotation">The new rotation for the object</param>
+		/// <param name="scale">The new scaling factor for the object</param>
+		void SetLocalTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+		/// <summary>
+		/// Gets a counter that is incremented whenever the object's position, rotation or scale is
+		/// changed. Physics components compare this against the last value they synced with, so
+		/// that only objects that were actually moved get pushed into the physics world
+		/// </summary>
+		uint32_t GetTransformVersion() const { return _transformVersion; }
+
 		/// <summary>
 		/// Gets or recalculates and gets the object's world transform
 		/// This matrix transforms points from local space to world space
@@ -355,6 +371,9 @@ namespace Gameplay {
 		mutable glm::mat4 _inverseWorldTransform;
 		mutable bool _isWorldTransformDirty;
 
+		// Incremented whenever the position, rotation or scale changes
+		uint32_t _transformVersion;
+
 		// For the hierarchy
 		WeakRef _parent;
 		std::vector<WeakRef> _children;
@@ -378,6 +397,12 @@ namespace Gameplay {
 		void _RecalcWorldTransform() const;
 
 		void _PurgeDeletedChildren();
+
+		/// <summary>
+		/// Attaches a component that has been loaded from a scene file to this object,
+		/// and allows it to perform self initialization
+		/// </summary>
+		void _AttachLoadedComponent(const IComponent::Sptr& component);
 	};
 
 }
\ No newline at end of file
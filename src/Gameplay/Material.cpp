@@ -7,12 +7,72 @@
 #include "Utils/ImGuiHelper.h"
 #include "Graphics/Textures/Texture1D.h"
 #include "Graphics/Textures/Texture3D.h"
+#include <algorithm>
+#include <cstring>
 
 namespace Gameplay {
+	const char* Material::MATERIAL_BLOCK_NAME = "b_Material";
+
+	/// <summary>
+	/// Gets the number of columns in a matrix type (GLSL matCxR has C columns)
+	/// </summary>
+	static uint32_t MatrixColumnCount(ShaderDataType type) {
+		switch (type) {
+			case ShaderDataType::Mat2:   case ShaderDataType::Mat2x3: case ShaderDataType::Mat2x4:
+			case ShaderDataType::Dmat2:  case ShaderDataType::Dmat2x3: case ShaderDataType::Dmat2x4:
+				return 2;
+			case ShaderDataType::Mat3:   case ShaderDataType::Mat3x2: case ShaderDataType::Mat3x4:
+			case ShaderDataType::Dmat3:  case ShaderDataType::Dmat3x2: case ShaderDataType::Dmat3x4:
+				return 3;
+			case ShaderDataType::Mat4:   case ShaderDataType::Mat4x2: case ShaderDataType::Mat4x3:
+			case ShaderDataType::Dmat4:  case ShaderDataType::Dmat4x2: case ShaderDataType::Dmat4x3:
+				return 4;
+			default:
+				return 1;
+		}
+	}
+
+	/// <summary>
+	/// Looks for a member of the shader's material block matching a material parameter name, where
+	/// "u_Material.Shininess" matches the block member "Shininess"
+	/// </summary>
+	static bool FindMaterialBlockMember(const ShaderProgram::Sptr& shader, const std::string& name, ShaderProgram::UniformInfo* out) {
+		static const std::string paramPrefix = "u_Material.";
+		static const std::string blockPrefix = std::string(Material::MATERIAL_BLOCK_NAME) + ".";
+		if (shader == nullptr || name.compare(0, paramPrefix.size(), paramPrefix) != 0) {
+			return false;
+		}
+
+		ShaderProgram::UniformBlockInfo block;
+		if (!shader->FindUniformBlock(Material::MATERIAL_BLOCK_NAME, &block)) {
+			return false;
+		}
+
+		// Members are reported with the block name as a prefix when the block has an instance name
+		const char* member = name.c_str() + paramPrefix.size();
+		for (const ShaderProgram::UniformInfo& uniform : block.SubUniforms) {
+			const char* uniformName = uniform.Name.c_str();
+			if (uniform.Name.compare(0, blockPrefix.size(), blockPrefix) == 0) {
+				uniformName += blockPrefix.size();
+			}
+			if (strcmp(member, uniformName) == 0) {
+				if (out != nullptr) {
+					*out = uniform;
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
 	Material::Material(const ShaderProgram::Sptr& shader) :
 		IResource(),
 		_shader(shader),
-		_uniforms(std::unordered_map<std::string, UniformData>())
+		_uniforms(),
+		_uniformIndices(),
+		_blockData(),
+		_blockOffset(UniformBufferArena::InvalidOffset),
+		_isBlockDirty(false)
 	{
 		_PopulateUniforms();
 	}
@@ -20,9 +80,20 @@ namespace Gameplay {
 	Material::Material() :
 		IResource(),
 		_shader(nullptr),
-		_uniforms(std::unordered_map<std::string, UniformData>())
+		_uniforms(),
+		_uniformIndices(),
+		_blockData(),
+		_blockOffset(UniformBufferArena::InvalidOffset),
+		_isBlockDirty(false)
 	{ }
 
+	Material::~Material() {
+		if (_blockOffset != UniformBufferArena::InvalidOffset) {
+			UniformBufferArena::GetMaterialArena()->Free(_blockOffset, (uint32_t)_blockData.size());
+			_blockOffset = UniformBufferArena::InvalidOffset;
+		}
+	}
+
 	void Material::Set(const std::string& name, ShaderDataType type, const void* value, size_t arraySize)
 	{
 		// Try and find the matching uniform
@@ -33,6 +104,7 @@ namespace Gameplay {
 			// If it's a texture, we update TextureAsset so it adds to the ref count
 			if (GetShaderDataTypeCode(uniform.Type) == ShaderDataTypecode::Texture && type == ShaderDataType::None) {
 				uniform.TextureAsset = *reinterpret_cast<const ITexture::Sptr*>(value);
+				_UpdateTwoChannelFlag(uniform);
 			}
 			// Check for type mismatch
 			else if (uniform.Type != type && uniform.Type != ShaderDataType::None) {
@@ -48,6 +120,11 @@ namespace Gameplay {
 				else {
 					memcpy(uniform.Value, value, ShaderDataTypeSize(type));
 				}
+
+				// Block members get copied into the block, which will be uploaded next time we're applied
+				if (uniform.IsBlockMember) {
+					_WriteBlockValue(uniform);
+				}
 			}
 		}
 		// We couldn't find that uniform, log a warning
@@ -60,13 +137,26 @@ namespace Gameplay {
 		return _shader;
 	}
 
+	ITexture::Sptr Material::GetTexture(const std::string& name) const {
+		auto it = _uniformIndices.find(name);
+		if (it == _uniformIndices.end() || !_uniforms[it->second].IsTextureResource()) {
+			return nullptr;
+		}
+		return _uniforms[it->second].TextureAsset;
+	}
+
 	void Material::Apply() {
 		if (_shader != nullptr) {
 			// Skip the reserved # of texture slots
 			int textureSlot = 0;
 			
-			// Iterate over the uniforms map
-			for (auto&[name, data] : _uniforms) {
+			// Iterate over the uniforms
+			for (UniformData& data : _uniforms) {
+				// Skip uniforms that don't exist in the shader, and values that are stored in the material block
+				if (data.Location < 0 || data.IsBlockMember) {
+					continue;
+				}
+
 				// The typecode is basically the underlying type of the uniform
 				// ex: float, matrix, texture, etc...
 				ShaderDataTypecode typeCode = GetShaderDataTypeCode(data.Type);
@@ -94,6 +184,17 @@ namespace Gameplay {
 					_shader->SetUniform(data.Location, data.Type, data.ArraySize > 1 ? data.ArrayBlock : data.Value, data.ArraySize);
 				}
 			}
+
+			// Our block values only need to be uploaded if they have changed, after that a material
+			// switch is just binding our range of the arena
+			if (_blockOffset != UniformBufferArena::InvalidOffset) {
+				const UniformBufferArena::Sptr& arena = UniformBufferArena::GetMaterialArena();
+				if (_isBlockDirty) {
+					arena->Upload(_blockOffset, _blockData.data(), (uint32_t)_blockData.size());
+					_isBlockDirty = false;
+				}
+				arena->BindRange(MATERIAL_UBO_BINDING, _blockOffset, (uint32_t)_blockData.size());
+			}
 		}
 	}
 
@@ -107,9 +208,11 @@ namespace Gameplay {
 		if (open) {
 			ImGui::Text("Shader: %s", _shader != nullptr ? _shader->GetDebugName().c_str() : "null");
 			// Draw all of our valid uniforms
-			for (auto&[key, value] : _uniforms) {
+			for (UniformData& value : _uniforms) {
 				if (value.Location != -2 && value.Location != -1) {
-					value.RenderImGui();
+					if (value.RenderImGui() && value.IsBlockMember) {
+						_WriteBlockValue(value);
+					}
 				}
 			}
 
@@ -141,10 +244,17 @@ namespace Gameplay {
 				// Try loading a uniform from the blob, if successful, store it
 				Material::UniformData uniform = Material::UniformData::FromJson(value, key, result->_shader);
 				if (uniform.Location != -2) {
-					result->_uniforms[key] = uniform;
+					result->_StoreUniform(key, uniform);
 				}
 			}
 		}
+
+		// The textures may have changed compression since the material was saved, so we don't trust the stored flags
+		for (const UniformData& uniform : result->_uniforms) {
+			if (uniform.IsTextureResource()) {
+				result->_UpdateTwoChannelFlag(uniform);
+			}
+		}
 		return result;
 	}
 
@@ -157,43 +267,149 @@ namespace Gameplay {
 		};
 
 		// Store all the uniforms
-		for (auto& [key, value] : _uniforms) {
+		for (const UniformData& value : _uniforms) {
 			if (value.Location != -1) {
-				result["parameters"][key] = value.ToJson();
+				result["parameters"][value.Name] = value.ToJson();
 			}
 		}
 
 		return result;
 	}
 
+	void Material::_UpdateTwoChannelFlag(const UniformData& texture)
+	{
+		auto it = _uniformIndices.find(texture.Name + "IsTwoChannel");
+		if (it == _uniformIndices.end() || _uniforms[it->second].Type != ShaderDataType::Int) {
+			return;
+		}
+
+		// We go off the requested compression rather than the loaded format, since the texture may still be
+		// streaming in. Rebuilding Z is still correct for an uncompressed map, as the normals are unit length
+		Texture2D::Sptr texture2D = std::dynamic_pointer_cast<Texture2D>(texture.TextureAsset);
+		int isTwoChannel = texture2D != nullptr && texture2D->GetDescription().Compression == TextureCompression::NormalMap ? 1 : 0;
+
+		UniformData& flag = _uniforms[it->second];
+		memcpy(flag.Value, &isTwoChannel, sizeof(int));
+		if (flag.IsBlockMember) {
+			_WriteBlockValue(flag);
+		}
+	}
+
 	Material::UniformData& Material::_GetUniform(const std::string& name)
 	{
-		UniformData& data = _uniforms[name];
-		if (data.Location == -2) {
-			ShaderProgram::UniformInfo uniform;
-			if (_shader->FindUniform(name, &uniform)) {
-				// Ignoring our reserved textures
-				if (GetShaderDataTypeCode(uniform.Type) == ShaderDataTypecode::Texture && uniform.Binding >= MAX_TEXTURE_SLOTS) {
-					data.Location = -1;
-				}
-				else {
-					data = UniformData(name, _shader);
-				}
-			} else {
+		auto it = _uniformIndices.find(name);
+		if (it != _uniformIndices.end()) {
+			return _uniforms[it->second];
+		}
+
+		// We store the uniform even if it doesn't exist, so we only look it up once
+		UniformData data = UniformData();
+		data.Name = name;
+		ShaderProgram::UniformInfo uniform;
+		if (_shader->FindUniform(name, &uniform)) {
+			// Ignoring our reserved textures
+			if (GetShaderDataTypeCode(uniform.Type) == ShaderDataTypecode::Texture && uniform.Binding >= MAX_TEXTURE_SLOTS) {
 				data.Location = -1;
 			}
+			else {
+				data = UniformData(name, _shader);
+			}
+		} else if (FindMaterialBlockMember(_shader, name, nullptr)) {
+			data = UniformData(name, _shader);
+		} else {
+			data.Location = -1;
+		}
+
+		_uniformIndices[name] = _uniforms.size();
+		_uniforms.push_back(std::move(data));
+		return _uniforms.back();
+	}
+
+	void Material::_StoreUniform(const std::string& name, const UniformData& data)
+	{
+		auto it = _uniformIndices.find(name);
+		if (it != _uniformIndices.end()) {
+			_uniforms[it->second] = data;
+		} else {
+			_uniformIndices[name] = _uniforms.size();
+			_uniforms.push_back(data);
+		}
+
+		if (data.IsBlockMember) {
+			_WriteBlockValue(data);
 		}
-		return data;
 	}
 
 	void Material::_PopulateUniforms()
 	{
+		_AllocateBlock();
+
 		const auto& uniforms = _shader->GetUniforms();
 		for (const auto& [key, value] : uniforms) {
-			_uniforms[key] = _GetUniform(key);
+			_GetUniform(key);
+		}
+
+		// Block members don't show up as regular uniforms, so add them separately
+		ShaderProgram::UniformBlockInfo block;
+		if (_shader->FindUniformBlock(MATERIAL_BLOCK_NAME, &block)) {
+			const std::string blockPrefix = std::string(MATERIAL_BLOCK_NAME) + ".";
+			for (const ShaderProgram::UniformInfo& member : block.SubUniforms) {
+				std::string memberName = member.Name.compare(0, blockPrefix.size(), blockPrefix) == 0 ? member.Name.substr(blockPrefix.size()) : member.Name;
+				_GetUniform("u_Material." + memberName);
+			}
 		}
 	}
 
+	void Material::_AllocateBlock()
+	{
+		ShaderProgram::UniformBlockInfo block;
+		if (_blockOffset != UniformBufferArena::InvalidOffset || !_shader->FindUniformBlock(MATERIAL_BLOCK_NAME, &block)) {
+			return;
+		}
+
+		_blockData.assign(block.SizeInBytes, 0);
+		_blockOffset = UniformBufferArena::GetMaterialArena()->Allocate((uint32_t)_blockData.size());
+		_isBlockDirty = true;
+	}
+
+	void Material::_WriteBlockValue(const UniformData& uniform)
+	{
+		if (_blockOffset == UniformBufferArena::InvalidOffset) {
+			return;
+		}
+
+		ShaderDataTypecode typeCode = GetShaderDataTypeCode(uniform.Type);
+		uint32_t elementSize = ShaderDataTypeSize(uniform.Type);
+		const uint8_t* source = uniform.ArraySize > 1 ? (const uint8_t*)uniform.ArrayBlock : uniform.Value;
+
+		for (size_t ix = 0; ix < std::max<size_t>(uniform.ArraySize, 1); ix++) {
+			size_t offset = uniform.Location + ix * uniform.ArrayStride;
+			LOG_ASSERT(offset < _blockData.size(), "Material block write out of bounds");
+			uint8_t* dest = _blockData.data() + offset;
+			const uint8_t* element = source + ix * elementSize;
+
+			// std140 bools are 4 bytes each
+			if (typeCode == ShaderDataTypecode::Bool) {
+				for (uint32_t c = 0; c < elementSize; c++) {
+					uint32_t value = element[c] ? 1 : 0;
+					memcpy(dest + c * sizeof(uint32_t), &value, sizeof(uint32_t));
+				}
+			}
+			// std140 matrix columns are padded out to the matrix stride
+			else if ((typeCode == ShaderDataTypecode::Matrix || typeCode == ShaderDataTypecode::MatrixD) && uniform.MatrixStride > 0) {
+				uint32_t columns = MatrixColumnCount(uniform.Type);
+				uint32_t columnSize = elementSize / columns;
+				for (uint32_t c = 0; c < columns; c++) {
+					memcpy(dest + c * uniform.MatrixStride, element + c * columnSize, columnSize);
+				}
+			}
+			else {
+				memcpy(dest, element, elementSize);
+			}
+		}
+		_isBlockDirty = true;
+	}
+
 	bool Material::UniformData::RenderImGui() {
 		ImGui::PushID(Name.c_str());
 
@@ -400,6 +616,9 @@ namespace Gameplay {
 	{
 		// We extract the uniform info from the shader to populate our info
 		ShaderProgram::UniformInfo uniform;
+		IsBlockMember = false;
+		ArrayStride   = 0;
+		MatrixStride  = 0;
 		if (shader != nullptr && shader->FindUniform(uniformName, &uniform)) {
 			Name = uniformName;
 			Location = uniform.Location;
@@ -407,6 +626,22 @@ namespace Gameplay {
 			ArraySize = uniform.ArraySize;
 			BindingSlot = uniform.Binding;
 			
+			// Allocate memory for array if the uniform is an array
+			if (ArraySize > 1) {
+				ArrayBlock = malloc(ShaderDataTypeSize(Type) * ArraySize);
+			}
+		}
+		// The uniform may be in the material block, in which case location is the offset in the block
+		else if (FindMaterialBlockMember(shader, uniformName, &uniform)) {
+			Name = uniformName;
+			Location = uniform.Location;
+			Type = uniform.Type;
+			ArraySize = uniform.ArraySize;
+			BindingSlot = -1;
+			IsBlockMember = true;
+			ArrayStride = uniform.ArrayStride;
+			MatrixStride = uniform.MatrixStride;
+			
 			// Allocate memory for array if the uniform is an array
 			if (ArraySize > 1) {
 				ArrayBlock = malloc(ShaderDataTypeSize(Type) * ArraySize);
@@ -421,6 +656,10 @@ namespace Gameplay {
 		Location = other.Location;
 		ArraySize = other.ArraySize;
 		Type = other.Type;
+		BindingSlot = other.BindingSlot;
+		IsBlockMember = other.IsBlockMember;
+		ArrayStride = other.ArrayStride;
+		MatrixStride = other.MatrixStride;
 
 		if (GetShaderDataTypeCode(Type) == ShaderDataTypecode::Texture) {
 			TextureAsset = other.TextureAsset;
@@ -437,10 +676,14 @@ namespace Gameplay {
 	Material::UniformData::UniformData(UniformData&& other) :
 		TextureAsset(nullptr) 
 	{
-		Name      = other.Name;
-		Location  = other.Location;
-		ArraySize = other.ArraySize;
-		Type      = other.Type;
+		Name          = other.Name;
+		Location      = other.Location;
+		ArraySize     = other.ArraySize;
+		Type          = other.Type;
+		BindingSlot   = other.BindingSlot;
+		IsBlockMember = other.IsBlockMember;
+		ArrayStride   = other.ArrayStride;
+		MatrixStride  = other.MatrixStride;
 
 		if (GetShaderDataTypeCode(Type) == ShaderDataTypecode::Texture) {
 			TextureAsset = other.TextureAsset;
@@ -2,6 +2,7 @@
 #include <memory>
 #include "Graphics/ShaderProgram.h"
 #include "Graphics/Textures/ITexture.h"
+#include "Graphics/Buffers/UniformBufferArena.h"
 
 namespace Gameplay {
 	/// <summary>
@@ -19,6 +20,23 @@ namespace Gameplay {
 		/// </summary>
 		static const int MAX_TEXTURE_SLOTS = 14;
 
+		/// <summary>
+		/// The uniform buffer slot that the material parameter block is bound to
+		/// </summary>
+		static const int MATERIAL_UBO_BINDING = 3;
+
+		/// <summary>
+		/// Shaders can declare a std140 uniform block with this name to hold their non-texture
+		/// material parameters, ex:
+		///		layout (std140, binding = 3) uniform b_Material { float Shininess; } u_MaterialParams;
+		/// 
+		/// Members of the block are exposed to the material as "u_Material.[member]", so materials
+		/// and scene files do not need to change when a shader moves parameters into the block.
+		/// Each material keeps a copy of the block in a shared arena, which is only re-uploaded
+		/// when a parameter changes
+		/// </summary>
+		static const char* MATERIAL_BLOCK_NAME;
+
 		/// <summary>
 		/// A human readable name for the material
 		/// </summary>
@@ -33,6 +51,10 @@ namespace Gameplay {
 		/// </summary>
 		/// <param name="shader">The shader for the material</param>
 		Material(const ShaderProgram::Sptr& shader);
+		virtual ~Material();
+
+		NO_COPY(Material);
+		NO_MOVE(Material);
 
 		/// <summary>
 		/// Sets a material parameter with the given name and type
@@ -55,6 +77,30 @@ namespace Gameplay {
 		/// <param name="arraySize">The array size in the event that the value is an array</param>
 		void Set(const std::string& name, ShaderDataType type, const void* value, size_t arraySize = 1ul);
 
+		/// <summary>
+		/// Gets the value of a non-texture material parameter
+		/// </summary>
+		/// <typeparam name="T">The type of parameter to get</typeparam>
+		/// <param name="name">The name of the parameter</param>
+		/// <param name="out">Receives the value of the parameter</param>
+		/// <returns>True if the parameter exists and has the given type, false if otherwise</returns>
+		template <typename T>
+		bool TryGet(const std::string& name, T& out) const {
+			auto it = _uniformIndices.find(name);
+			if (it == _uniformIndices.end() || _uniforms[it->second].Type != GetShaderDataType<T>() || _uniforms[it->second].ArraySize > 1) {
+				return false;
+			}
+			out = _uniforms[it->second].Get<T>();
+			return true;
+		}
+
+		/// <summary>
+		/// Gets the texture assigned to a material parameter
+		/// </summary>
+		/// <param name="name">The name of the parameter</param>
+		/// <returns>The texture, or nullptr if the parameter does not exist or is not a texture</returns>
+		ITexture::Sptr GetTexture(const std::string& name) const;
+
 		/// <summary>
 		/// Gets the shader that this material is using
 		/// </summary>
@@ -93,7 +139,8 @@ namespace Gameplay {
 		struct UniformData {
 			// The name of the uniform in the shader
 			std::string    Name;
-			// Location of the uniform within the shader
+			// Location of the uniform within the shader, or the byte offset within the material
+			// block for block members
 			int            Location = -2;
 			union {
 				// A space to store non-array values, can store up to a dmat4
@@ -109,6 +156,12 @@ namespace Gameplay {
 			size_t         ArraySize;
 			int            BindingSlot;
 
+			// True if this uniform lives in the material block rather than being set on the program
+			bool           IsBlockMember;
+			// The std140 strides for block members
+			int            ArrayStride;
+			int            MatrixStride;
+
 			// The type of uniform
 			ShaderDataType Type = ShaderDataType::None;
 			
@@ -118,6 +171,9 @@ namespace Gameplay {
 				TextureAsset(nullptr),
 				ArraySize(0),
 				BindingSlot(-1),
+				IsBlockMember(false),
+				ArrayStride(0),
+				MatrixStride(0),
 				Type(ShaderDataType::None) 
 			{ }
 			UniformData(const UniformData& other);
@@ -171,11 +227,41 @@ namespace Gameplay {
 		/// </summary>
 		ShaderProgram::Sptr    _shader;
 		/// <summary>
-		/// The uniforms that the material will be modifying
+		/// The uniforms that the material will be modifying, stored flat so that Apply
+		/// iterates them in a fixed order
+		/// </summary>
+		std::vector<UniformData> _uniforms;
+		/// <summary>
+		/// Maps uniform names to their index in _uniforms
 		/// </summary>
-		std::unordered_map<std::string, UniformData> _uniforms;
+		std::unordered_map<std::string, size_t> _uniformIndices;
+
+		/// <summary>
+		/// CPU side copy of the std140 material block, and where it lives in the material arena
+		/// </summary>
+		std::vector<uint8_t> _blockData;
+		uint32_t             _blockOffset;
+		bool                 _isBlockDirty;
 
 		UniformData& _GetUniform(const std::string& name);
+		/// <summary>
+		/// Stores a uniform, replacing any existing uniform with the same name
+		/// </summary>
+		void _StoreUniform(const std::string& name, const UniformData& data);
 		void _PopulateUniforms();
+		/// <summary>
+		/// Allocates space in the material arena if the shader has a material block
+		/// </summary>
+		void _AllocateBlock();
+		/// <summary>
+		/// Copies the value of a block member into our block data using the std140 layout
+		/// </summary>
+		void _WriteBlockValue(const UniformData& uniform);
+		/// <summary>
+		/// Normal maps that are block compressed (BC5) only store X and Y, so shaders that support them
+		/// declare an int [texture name]IsTwoChannel parameter and rebuild Z when it is set. This updates
+		/// that parameter (if the shader has one) to match the texture that is assigned
+		/// </summary>
+		void _UpdateTwoChannelFlag(const UniformData& texture);
 	};
 }
\ No newline at end of file
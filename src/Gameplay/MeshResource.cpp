@@ -1,15 +1,99 @@
 #include "MeshResource.h"
 #include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <cstring>
+
+#include <btBulletCollisionCommon.h>
+#include <BulletCollision/CollisionShapes/btShapeHull.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
 
 #include "Utils/ObjLoader.h"
+#ifdef OPTIMIZED_OBJ_LOADER
+#include "Utils/OptimizedObjLoader.h"
+#endif
+#include "Utils/ResourceManager/ResourceManager.h"
+
+namespace fs = std::filesystem;
 
 namespace Gameplay {
+	const std::string collisionCacheFolder = "collision_cache/";
+
+	// Salts for the collision cache keys, bump the version in the low byte when the way hulls or BVHs are
+	// built changes so that stale files are ignored. The high bytes keep hull and BVH keys from ever matching
+	static const uint32_t HULL_CACHE_SALT = 0x48554C01; // 'HUL' v1
+	static const uint32_t BVH_CACHE_SALT  = 0x42564801; // 'BVH' v1
+
+	/// <summary>
+	/// FNV-1a hash, used to build the hull cache key
+	/// </summary>
+	static inline void HashBytes(uint64_t& hash, const void* data, size_t size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t ix = 0; ix < size; ix++) {
+			hash ^= bytes[ix];
+			hash *= 0x100000001b3ull;
+		}
+	}
+	static inline void HashString(uint64_t& hash, const std::string& value) {
+		// Include the length so that adjacent strings can't run together
+		uint64_t length = value.size();
+		HashBytes(hash, &length, sizeof(uint64_t));
+		HashBytes(hash, value.data(), value.size());
+	}
+
+	static inline std::string GetHullCachePath(uint64_t key) {
+		std::stringstream result;
+		result << collisionCacheFolder << std::hex << std::setw(16) << std::setfill('0') << key << ".hull";
+		return result.str();
+	}
+
+	/// <summary>
+	/// Pulls positions and indices out of raw interleaved vertex data and a raw index buffer
+	/// </summary>
+	static void ExtractCpuData(
+		const uint8_t* vertices, uint32_t numVertices, const BufferAttribute& posAttrib,
+		const uint8_t* indices, uint32_t numIndices, IndexType indexType,
+		std::vector<glm::vec3>& outPositions, std::vector<uint32_t>& outIndices)
+	{
+		outPositions.resize(numVertices);
+		for (uint32_t ix = 0; ix < numVertices; ix++) {
+			memcpy(&outPositions[ix], vertices + (posAttrib.Stride * ix) + posAttrib.Offset, sizeof(glm::vec3));
+		}
+
+		outIndices.resize(indices != nullptr ? numIndices : 0);
+		for (uint32_t ix = 0; ix < outIndices.size(); ix++) {
+			switch (indexType) {
+				case IndexType::UByte:
+					outIndices[ix] = indices[ix];
+					break;
+				case IndexType::UShort:
+					outIndices[ix] = reinterpret_cast<const uint16_t*>(indices)[ix];
+					break;
+				case IndexType::UInt:
+					outIndices[ix] = reinterpret_cast<const uint32_t*>(indices)[ix];
+					break;
+				default:
+					outIndices[ix] = 0;
+					break;
+			}
+		}
+	}
+
 	MeshResource::MeshResource() :
 		IResource(),
 		Filename(""),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		BulletTriMesh(nullptr),
+		ConvexHull(nullptr),
+		BulletBvhShape(nullptr),
+		KeepCpuData(false),
+		CpuPositions(),
+		CpuIndices(),
+		_megaBufferAllocation(),
+		_megaBufferSource()
 	{ }
 
 	MeshResource::MeshResource(const std::string& filename) :
@@ -17,12 +101,30 @@ namespace Gameplay {
 		Filename(filename),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		BulletTriMesh(nullptr),
+		ConvexHull(nullptr),
+		BulletBvhShape(nullptr),
+		KeepCpuData(false),
+		CpuPositions(),
+		CpuIndices(),
+		_megaBufferAllocation(),
+		_megaBufferSource()
 	{
 		Mesh = ObjLoader::LoadFromFile(filename);
 	}
 
-	MeshResource::~MeshResource() = default;
+	MeshResource::~MeshResource() {
+		MeshMegaBuffer::Remove(_megaBufferAllocation);
+	}
+
+	const MeshMegaBuffer::Allocation& MeshResource::GetMegaBufferAllocation() {
+		if (IsReady() && Mesh != _megaBufferSource.lock()) {
+			MeshMegaBuffer::Remove(_megaBufferAllocation);
+			_megaBufferAllocation = MeshMegaBuffer::Add(Mesh);
+			_megaBufferSource = Mesh;
+		}
+		return _megaBufferAllocation;
+	}
 
 	nlohmann::json MeshResource::ToJson() const {
 		nlohmann::json result;
@@ -36,12 +138,16 @@ namespace Gameplay {
 		} else {
 			result["filename"] = Filename.empty() ? "null" : Filename;
 		}
+		if (KeepCpuData) {
+			result["keep_cpu_data"] = true;
+		}
 		return result;
 	}
 
 	MeshResource::Sptr MeshResource::FromJson(const nlohmann::json & blob)
 	{
 		MeshResource::Sptr result = std::make_shared<MeshResource>();
+		result->KeepCpuData = JsonGet(blob, "keep_cpu_data", false);
 		if (blob.contains("params") && blob["params"].is_array()) {
 			std::vector<nlohmann::json> meshbuilderParams = blob["params"].get<std::vector<nlohmann::json>>();
 			MeshBuilder<VertexPosNormTexColTangents> mesh;
@@ -52,15 +158,56 @@ namespace Gameplay {
 			}
 			MeshFactory::CalculateTBN(mesh);
 			result->Mesh = mesh.Bake();
+			if (result->KeepCpuData) {
+				result->_StoreCpuData(mesh);
+			}
 		} else {
 			result->Filename = JsonGet<std::string>(blob, "filename", "null");
 			if (result->Filename != "null" && std::filesystem::exists(result->Filename)) {
+				// If we're streaming, parse the file on a worker and create the VAO when it's ready
+				if (ResourceManager::IsAsyncLoadingEnabled()) {
+					std::string filename = result->Filename;
+					#ifdef OPTIMIZED_OBJ_LOADER
+					std::shared_ptr<OptimizedObjLoader::BinaryMeshData> data = std::make_shared<OptimizedObjLoader::BinaryMeshData>();
+					ResourceManager::QueueAsyncLoad(result,
+						[filename, data]() { return OptimizedObjLoader::LoadBinaryData(filename, *data); },
+						[result, data]() {
+							result->Mesh = OptimizedObjLoader::Bake(*data);
+							if (result->KeepCpuData) {
+								auto it = std::find_if(data->VertexDeclaration.begin(), data->VertexDeclaration.end(), [](const BufferAttribute& attrib) { return attrib.Usage == AttribUsage::Position; });
+								if (it != data->VertexDeclaration.end()) {
+									ExtractCpuData(data->Vertices.data(), data->NumVertices, *it, data->NumIndices > 0 ? data->Indices.data() : nullptr, data->NumIndices, data->IndicesType, result->CpuPositions, result->CpuIndices);
+								}
+							}
+							return result->Mesh != nullptr;
+						}
+					);
+					#else
+					std::shared_ptr<MeshBuilder<VertexPosNormTexColTangents>> data = std::make_shared<MeshBuilder<VertexPosNormTexColTangents>>();
+					ResourceManager::QueueAsyncLoad(result,
+						[filename, data]() { *data = ObjLoader::LoadMeshData(filename); return true; },
+						[result, data]() {
+							result->Mesh = data->Bake();
+							if (result->KeepCpuData) {
+								result->_StoreCpuData(*data);
+							}
+							return true;
+						}
+					);
+					#endif
+					return result;
+				}
+
 				#ifdef OPTIMIZED_OBJ_LOADER
 				result->Mesh = OptimizedObjLoader::LoadFromFile(result->Filename);
 				#else
 				result->Mesh = ObjLoader::LoadFromFile(result->Filename);
 				#endif
 
+				if (result->KeepCpuData) {
+					result->LoadCpuData();
+				}
+
 			}
 		}
 		return result;
@@ -73,9 +220,370 @@ namespace Gameplay {
 		}
 		MeshFactory::CalculateTBN(mesh);
 		Mesh = mesh.Bake();
+
+		// Any derived data is out of date now
+		BulletTriMesh = nullptr;
+		ConvexHull = nullptr;
+		BulletBvhShape = nullptr;
+		CpuPositions.clear();
+		CpuIndices.clear();
+		if (KeepCpuData) {
+			_StoreCpuData(mesh);
+		}
 	}
 
 	void MeshResource::AddParam(const MeshBuilderParam & param) {
 		MeshBuilderParams.push_back(param);
 	}
+
+	bool MeshResource::LoadCpuData() {
+		if (!CpuPositions.empty()) {
+			return true;
+		}
+
+		if (MeshBuilderParams.size() > 0) {
+			// Generating is cheap compared to reading back from the GPU, and we don't need tangents for this
+			MeshBuilder<VertexPosNormTexColTangents> mesh;
+			for (auto& param : MeshBuilderParams) {
+				MeshFactory::AddParameterized(mesh, param);
+			}
+			_StoreCpuData(mesh);
+		}
+		else if (!Filename.empty() && Filename != "null" && fs::exists(Filename)) {
+			#ifdef OPTIMIZED_OBJ_LOADER
+			OptimizedObjLoader::BinaryMeshData data;
+			if (OptimizedObjLoader::LoadBinaryData(Filename, data)) {
+				auto it = std::find_if(data.VertexDeclaration.begin(), data.VertexDeclaration.end(), [](const BufferAttribute& attrib) { return attrib.Usage == AttribUsage::Position; });
+				if (it != data.VertexDeclaration.end()) {
+					ExtractCpuData(data.Vertices.data(), data.NumVertices, *it, data.NumIndices > 0 ? data.Indices.data() : nullptr, data.NumIndices, data.IndicesType, CpuPositions, CpuIndices);
+				}
+			}
+			#else
+			_StoreCpuData(ObjLoader::LoadMeshData(Filename, false));
+			#endif
+		}
+		// Meshes created at runtime have nothing to re-load from, so we have to read them back from OpenGL
+		else if (Mesh != nullptr && IsReady()) {
+			_ReadbackCpuData();
+		}
+
+		return !CpuPositions.empty();
+	}
+
+	std::shared_ptr<const std::vector<glm::vec3>> MeshResource::GetConvexHull() {
+		if (ConvexHull != nullptr) {
+			return ConvexHull;
+		}
+
+		std::shared_ptr<std::vector<glm::vec3>> points = std::make_shared<std::vector<glm::vec3>>();
+
+		// Try and grab the hull from disk first, so we don't even need to load the mesh data
+		uint64_t key = 0;
+		bool canPersist = _GetCollisionCacheKey(HULL_CACHE_SALT, key);
+		if (canPersist && _LoadHullCache(key, *points)) {
+			ConvexHull = points;
+			return ConvexHull;
+		}
+
+		bool hadCpuData = !CpuPositions.empty();
+		if (!LoadCpuData()) {
+			LOG_WARN("Mesh has no vertex data, unable to build a convex hull");
+			return nullptr;
+		}
+
+		// Wrap all the mesh positions in a temporary hull, and let bullet reduce it down to a handful of points.
+		// We disable the margin so the points we get back lie on the mesh, the final shape adds it's own margin
+		btConvexHullShape source(&CpuPositions[0].x, static_cast<int>(CpuPositions.size()), sizeof(glm::vec3));
+		source.setMargin(0.0f);
+		btShapeHull hull(&source);
+		if (hull.buildHull(0.0f) && hull.numVertices() > 0) {
+			points->resize(hull.numVertices());
+			for (int ix = 0; ix < hull.numVertices(); ix++) {
+				const btVector3& point = hull.getVertexPointer()[ix];
+				(*points)[ix] = glm::vec3(point.x(), point.y(), point.z());
+			}
+		} else {
+			LOG_WARN("Failed to reduce convex hull for mesh, using all {} vertices", CpuPositions.size());
+			*points = CpuPositions;
+		}
+
+		// Don't hang on to the mesh data if nobody asked us to
+		if (!hadCpuData && !KeepCpuData) {
+			CpuPositions = std::vector<glm::vec3>();
+			CpuIndices = std::vector<uint32_t>();
+		}
+
+		if (canPersist) {
+			_SaveHullCache(key, *points);
+		}
+
+		ConvexHull = points;
+		return ConvexHull;
+	}
+
+	std::shared_ptr<btBvhTriangleMeshShape> MeshResource::GetBvhTriangleMeshShape() {
+		if (BulletBvhShape != nullptr) {
+			return BulletBvhShape;
+		}
+
+		// The BVH only stores triangle indices, so we always need the triangles themselves
+		if (BulletTriMesh == nullptr) {
+			bool hadCpuData = !CpuPositions.empty();
+			if (!LoadCpuData()) {
+				LOG_WARN("Mesh has no vertex data, unable to build a triangle mesh shape");
+				return nullptr;
+			}
+
+			std::shared_ptr<btTriangleMesh> triMesh = std::make_shared<btTriangleMesh>();
+			triMesh->preallocateVertices(static_cast<int>(CpuPositions.size()));
+			for (const glm::vec3& position : CpuPositions) {
+				triMesh->findOrAddVertex(btVector3(position.x, position.y, position.z), false);
+			}
+			if (CpuIndices.size() > 0) {
+				triMesh->preallocateIndices(static_cast<int>(CpuIndices.size()));
+				for (size_t ix = 0; ix + 2 < CpuIndices.size(); ix += 3) {
+					triMesh->addTriangleIndices(CpuIndices[ix], CpuIndices[ix + 1], CpuIndices[ix + 2]);
+				}
+			} else {
+				for (int ix = 0; ix + 2 < static_cast<int>(CpuPositions.size()); ix += 3) {
+					triMesh->addTriangleIndices(ix, ix + 1, ix + 2);
+				}
+			}
+			BulletTriMesh = triMesh;
+
+			// Don't hang on to the mesh data if nobody asked us to
+			if (!hadCpuData && !KeepCpuData) {
+				CpuPositions = std::vector<glm::vec3>();
+				CpuIndices = std::vector<uint32_t>();
+			}
+		}
+
+		uint32_t numTriangles = static_cast<uint32_t>(BulletTriMesh->getNumTriangles());
+		uint64_t key = 0;
+		bool canPersist = _GetCollisionCacheKey(BVH_CACHE_SALT, key);
+		std::string cachePath = canPersist ? _GetBvhCachePath(key) : "";
+
+		btBvhTriangleMeshShape* shape = nullptr;
+		std::shared_ptr<void> bvhBuffer = nullptr;
+		btOptimizedBvh* bvh = canPersist ? _LoadBvhCache(cachePath, key, numTriangles, bvhBuffer) : nullptr;
+		if (bvh != nullptr) {
+			// The BVH lives in our buffer, so the shape will not try to free it
+			shape = new btBvhTriangleMeshShape(BulletTriMesh.get(), true, false);
+			shape->setOptimizedBvh(bvh);
+		} else {
+			shape = new btBvhTriangleMeshShape(BulletTriMesh.get(), true, true);
+			if (canPersist) {
+				_SaveBvhCache(cachePath, key, numTriangles, shape->getOptimizedBvh());
+			}
+		}
+
+		// The shape references the triangles and BVH buffer, so it keeps them alive for as long as a collider holds it
+		std::shared_ptr<btTriangleMesh> triMesh = BulletTriMesh;
+		BulletBvhShape = std::shared_ptr<btBvhTriangleMeshShape>(shape, [triMesh, bvhBuffer](btBvhTriangleMeshShape* ptr) {
+			delete ptr;
+		});
+		return BulletBvhShape;
+	}
+
+	void MeshResource::_StoreCpuData(const MeshBuilder<VertexPosNormTexColTangents>& mesh) {
+		const VertexPosNormTexColTangents* vertices = mesh.GetVertexDataPtr();
+		CpuPositions.resize(mesh.GetVertexCount());
+		for (size_t ix = 0; ix < CpuPositions.size(); ix++) {
+			CpuPositions[ix] = vertices[ix].Position;
+		}
+		CpuIndices.assign(mesh.GetIndexDataPtr(), mesh.GetIndexDataPtr() + mesh.GetIndexCount());
+	}
+
+	void MeshResource::_ReadbackCpuData() {
+		// Get the vertex declaration from the VAO so we can pull out positions
+		const VertexArrayObject::VertexDeclaration& vDecl = Mesh->GetVDecl();
+		auto it = std::find_if(vDecl.begin(), vDecl.end(), [](const BufferAttribute& attrib) {
+			return attrib.Usage == AttribUsage::Position;
+		});
+		const auto* vertBuff = Mesh->GetBufferBinding(AttribUsage::Position);
+		if (it == vDecl.end() || vertBuff == nullptr) {
+			LOG_WARN("Mesh vertex declaration does not have a position element");
+			return;
+		}
+
+		VertexBuffer::Sptr vertexBuff = vertBuff->GetBuffer();
+		IndexBuffer::Sptr indexBuff = Mesh->GetIndexBuffer();
+
+		std::vector<uint8_t> vertexStore(vertexBuff->GetTotalSize());
+		glGetNamedBufferSubData(vertexBuff->GetHandle(), 0, vertexBuff->GetTotalSize(), vertexStore.data());
+
+		std::vector<uint8_t> indexStore;
+		if (indexBuff != nullptr) {
+			indexStore.resize(indexBuff->GetTotalSize());
+			glGetNamedBufferSubData(indexBuff->GetHandle(), 0, indexBuff->GetTotalSize(), indexStore.data());
+		}
+
+		ExtractCpuData(
+			vertexStore.data(), static_cast<uint32_t>(vertexBuff->GetElementCount()), *it,
+			indexBuff != nullptr ? indexStore.data() : nullptr, indexBuff != nullptr ? static_cast<uint32_t>(indexBuff->GetElementCount()) : 0, 
+			indexBuff != nullptr ? indexBuff->GetElementType() : IndexType::Unknown,
+			CpuPositions, CpuIndices
+		);
+	}
+
+	bool MeshResource::_GetCollisionCacheKey(uint32_t salt, uint64_t& key) const {
+		key = 0xcbf29ce484222325ull;
+		HashBytes(key, &salt, sizeof(uint32_t));
+		if (MeshBuilderParams.size() > 0) {
+			for (const MeshBuilderParam& param : MeshBuilderParams) {
+				HashString(key, param.ToJson().dump());
+			}
+			return true;
+		}
+		else if (!Filename.empty() && Filename != "null" && fs::exists(Filename)) {
+			// Include the size and timestamp so that editing the model invalidates the hull
+			uint64_t fileSize = fs::file_size(Filename);
+			int64_t  fileTime = static_cast<int64_t>(fs::last_write_time(Filename).time_since_epoch().count());
+			HashString(key, Filename);
+			HashBytes(key, &fileSize, sizeof(uint64_t));
+			HashBytes(key, &fileTime, sizeof(int64_t));
+			return true;
+		}
+		return false;
+	}
+
+	bool MeshResource::_LoadHullCache(uint64_t key, std::vector<glm::vec3>& points) {
+		std::ifstream file(GetHullCachePath(key), std::ios::binary);
+		if (!file) {
+			return false;
+		}
+
+		HullCacheHeader header;
+		file.read(reinterpret_cast<char*>(&header), sizeof(HullCacheHeader));
+		if (!file || memcmp(header.HeaderBytes, "HULL", 4) != 0 || header.Version != 0x01 || header.Key != key || header.NumPoints == 0) {
+			return false;
+		}
+
+		points.resize(header.NumPoints);
+		file.read(reinterpret_cast<char*>(points.data()), sizeof(glm::vec3) * header.NumPoints);
+		return static_cast<bool>(file);
+	}
+
+	void MeshResource::_SaveHullCache(uint64_t key, const std::vector<glm::vec3>& points) {
+		HullCacheHeader header = HullCacheHeader();
+		header.Version   = 0x01;
+		header.Key       = key;
+		header.NumPoints = static_cast<uint32_t>(points.size());
+
+		std::error_code error;
+		fs::create_directories(collisionCacheFolder, error);
+
+		// We write to a temporary file and then swap it in, so that we never leave a half written hull behind
+		std::string cachePath = GetHullCachePath(key);
+		std::stringstream tempName;
+		tempName << cachePath << "." << std::this_thread::get_id() << ".tmp";
+		{
+			std::ofstream file(tempName.str(), std::ios::binary);
+			if (!file) {
+				LOG_WARN("Failed to open hull cache \"{}\" for writing", cachePath);
+				return;
+			}
+			file.write(reinterpret_cast<const char*>(&header), sizeof(HullCacheHeader));
+			file.write(reinterpret_cast<const char*>(points.data()), sizeof(glm::vec3) * points.size());
+		}
+
+		fs::rename(tempName.str(), cachePath, error);
+		if (error) {
+			fs::remove(tempName.str(), error);
+		}
+	}
+
+	std::string MeshResource::_GetBvhCachePath(uint64_t key) const {
+		if (MeshBuilderParams.size() == 0 && !Filename.empty() && Filename != "null") {
+			fs::path path = fs::path(Filename);
+			path.replace_extension(".bvh");
+			return path.string();
+		}
+		std::stringstream result;
+		result << collisionCacheFolder << std::hex << std::setw(16) << std::setfill('0') << key << ".bvh";
+		return result.str();
+	}
+
+	btOptimizedBvh* MeshResource::_LoadBvhCache(const std::string& path, uint64_t key, uint32_t numTriangles, std::shared_ptr<void>& buffer) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			return nullptr;
+		}
+
+		// The key covers the source file, and the triangle count catches any changes in how we build the triangles
+		BvhCacheHeader header;
+		file.read(reinterpret_cast<char*>(&header), sizeof(BvhCacheHeader));
+		if (!file || memcmp(header.HeaderBytes, "BVHC", 4) != 0 || header.Version != 0x01 || 
+			header.Key != key || header.NumTriangles != numTriangles || header.DataSize == 0) {
+			return nullptr;
+		}
+
+		// Bullet requires the serialized data to be 16 byte aligned to deserialize it in place
+		buffer = std::shared_ptr<void>(btAlignedAlloc(header.DataSize, 16), [](void* ptr) { btAlignedFree(ptr); });
+		file.read(reinterpret_cast<char*>(buffer.get()), header.DataSize);
+		if (!file) {
+			buffer = nullptr;
+			return nullptr;
+		}
+
+		btQuantizedBvh* result = btOptimizedBvh::deSerializeInPlace(buffer.get(), header.DataSize, false);
+		if (result == nullptr) {
+			buffer = nullptr;
+			return nullptr;
+		}
+		return static_cast<btOptimizedBvh*>(result);
+	}
+
+	void MeshResource::_SaveBvhCache(const std::string& path, uint64_t key, uint32_t numTriangles, btOptimizedBvh* bvh) {
+		if (bvh == nullptr) {
+			return;
+		}
+
+		BvhCacheHeader header = BvhCacheHeader();
+		header.Version      = 0x01;
+		header.Key          = key;
+		header.NumTriangles = numTriangles;
+		header.DataSize     = bvh->calculateSerializeBufferSize();
+
+		std::shared_ptr<void> data = std::shared_ptr<void>(btAlignedAlloc(header.DataSize, 16), [](void* ptr) { btAlignedFree(ptr); });
+		if (!bvh->serialize(data.get(), header.DataSize, false)) {
+			LOG_WARN("Failed to serialize BVH for \"{}\"", path);
+			return;
+		}
+
+		std::error_code error;
+		fs::path parent = fs::path(path).parent_path();
+		if (!parent.empty()) {
+			fs::create_directories(parent, error);
+		}
+
+		// We write to a temporary file and then swap it in, so that we never leave a half written BVH behind
+		std::stringstream tempName;
+		tempName << path << "." << std::this_thread::get_id() << ".tmp";
+		{
+			std::ofstream file(tempName.str(), std::ios::binary);
+			if (!file) {
+				LOG_WARN("Failed to open BVH cache \"{}\" for writing", path);
+				return;
+			}
+			file.write(reinterpret_cast<const char*>(&header), sizeof(BvhCacheHeader));
+			file.write(reinterpret_cast<const char*>(data.get()), header.DataSize);
+		}
+
+		fs::rename(tempName.str(), path, error);
+		if (error) {
+			fs::remove(tempName.str(), error);
+		}
+	}
+
+	VertexArrayObject::Sptr MeshResource::GetPlaceholderMesh() {
+		static VertexArrayObject::Sptr placeholder = nullptr;
+		if (placeholder == nullptr) {
+			MeshBuilder<VertexPosNormTexColTangents> mesh;
+			MeshFactory::AddCube(mesh, glm::vec3(0.0f), glm::vec3(0.5f));
+			MeshFactory::CalculateTBN(mesh);
+			placeholder = mesh.Bake();
+		}
+		return placeholder;
+	}
 }
\ No newline at end of file
@@ -1,10 +1,15 @@
 #pragma once
 #include "Utils/ResourceManager/IResource.h"
 #include "Graphics/VertexArrayObject.h"
+#include "Graphics/MeshMegaBuffer.h"
 #include "Utils/MeshFactory.h"
+#include "Utils/MeshBuilder.h"
+#include "Graphics/VertexTypes.h"
 
 // bullet triangle mesh pre-declaration
 class btTriangleMesh;
+class btBvhTriangleMeshShape;
+class btOptimizedBvh;
 
 namespace Gameplay {
 	/// <summary>
@@ -50,6 +55,29 @@ namespace Gameplay {
 		/// Allows for bullet to generate a triangle mesh from this mesh and cache it
 		/// </summary>
 		std::shared_ptr<btTriangleMesh> BulletTriMesh;
+		/// <summary>
+		/// The reduced set of points making up the convex hull of this mesh, shared between all
+		/// convex mesh colliders using it. See GetConvexHull
+		/// </summary>
+		std::shared_ptr<const std::vector<glm::vec3>> ConvexHull;
+		/// <summary>
+		/// An unscaled concave collision shape for this mesh, shared between all triangle mesh
+		/// colliders using it. See GetBvhTriangleMeshShape
+		/// </summary>
+		std::shared_ptr<btBvhTriangleMeshShape> BulletBvhShape;
+
+		/// <summary>
+		/// When true, a CPU side copy of the mesh's positions and indices is kept after the
+		/// mesh is loaded (default false)
+		/// </summary>
+		bool                            KeepCpuData;
+		/// <summary>
+		/// CPU side copies of the vertex positions and triangle indices of the mesh, empty unless
+		/// KeepCpuData is set or LoadCpuData has been called. If Indices is empty, every 3 positions
+		/// form a triangle
+		/// </summary>
+		std::vector<glm::vec3>          CpuPositions;
+		std::vector<uint32_t>           CpuIndices;
 
 		/// <summary>
 		/// Generates a new mesh from the mesh builder parameters
@@ -61,9 +89,91 @@ namespace Gameplay {
 		/// <param name="param">The parameter to add</param>
 		void AddParam(const MeshBuilderParam& param);
 
+		/// <summary>
+		/// Makes sure that CpuPositions and CpuIndices are populated, re-generating them from the mesh
+		/// builder params or the source file. Meshes with neither are read back from OpenGL as a last resort
+		/// </summary>
+		/// <returns>True if CPU data is available, false if otherwise</returns>
+		bool LoadCpuData();
+
+		/// <summary>
+		/// Gets the convex hull of this mesh, reduced to a small number of points. The hull is computed
+		/// the first time it is requested and persisted to disk, so later runs can skip building it
+		/// </summary>
+		/// <returns>The points of the hull, or nullptr if the mesh has no data to build a hull from</returns>
+		std::shared_ptr<const std::vector<glm::vec3>> GetConvexHull();
+
+		/// <summary>
+		/// Gets a concave triangle mesh shape for this mesh, for use with static bodies. The shape's
+		/// quantized BVH is built once and saved next to the mesh file, later runs load it in place
+		/// </summary>
+		/// <returns>The shape, or nullptr if the mesh has no data to build a shape from</returns>
+		std::shared_ptr<btBvhTriangleMeshShape> GetBvhTriangleMeshShape();
+
+		/// <summary>
+		/// Gets where this mesh lives in the shared mesh mega buffers, copying it in the first time
+		/// it is requested or after Mesh has been replaced
+		/// </summary>
+		/// <returns>The allocation, which is invalid if the mesh is still loading or is not compatible</returns>
+		const MeshMegaBuffer::Allocation& GetMegaBufferAllocation();
+
+		/// <summary>
+		/// Gets a simple mesh that can be rendered in place of meshes that are still
+		/// being streamed in
+		/// </summary>
+		static VertexArrayObject::Sptr GetPlaceholderMesh();
+
 		// Inherited from IResource
 
 		virtual nlohmann::json ToJson() const override;
 		static MeshResource::Sptr FromJson(const nlohmann::json& blob);
+
+	protected:
+		MeshMegaBuffer::Allocation _megaBufferAllocation;
+		// The VAO that our allocation was copied from, so we can tell when Mesh changes
+		VertexArrayObject::Wptr    _megaBufferSource;
+
+		// Header for persisted convex hull files
+		struct HullCacheHeader {
+			char     HeaderBytes[4] = { 'H', 'U', 'L', 'L' };
+			uint16_t Version = 0;
+			uint64_t Key = 0;
+			uint32_t NumPoints = 0;
+		};
+
+		void _StoreCpuData(const MeshBuilder<VertexPosNormTexColTangents>& mesh);
+		/// <summary>
+		/// Reads positions and indices back from the mesh's OpenGL buffers
+		/// </summary>
+		void _ReadbackCpuData();
+
+		// Header for persisted BVH files, the serialized btOptimizedBvh follows it
+		struct BvhCacheHeader {
+			char     HeaderBytes[4] = { 'B', 'V', 'H', 'C' };
+			uint16_t Version = 0;
+			uint64_t Key = 0;
+			uint32_t NumTriangles = 0;
+			uint32_t DataSize = 0;
+		};
+
+		/// <summary>
+		/// Gets a key identifying the source of this mesh, used to validate and name collision cache files
+		/// </summary>
+		/// <param name="salt">Mixed into the key, each kind of cache file has it's own so they can be invalidated separately</param>
+		/// <returns>False if the mesh has no persistent source (ex: it was created at runtime)</returns>
+		bool _GetCollisionCacheKey(uint32_t salt, uint64_t& key) const;
+		static bool _LoadHullCache(uint64_t key, std::vector<glm::vec3>& points);
+		static void _SaveHullCache(uint64_t key, const std::vector<glm::vec3>& points);
+
+		/// <summary>
+		/// Gets where the BVH for this mesh is stored, next to the mesh file if we have one
+		/// </summary>
+		std::string _GetBvhCachePath(uint64_t key) const;
+		/// <summary>
+		/// Loads a serialized BVH into an aligned buffer and deserializes it in place, the returned
+		/// BVH lives inside the buffer
+		/// </summary>
+		static btOptimizedBvh* _LoadBvhCache(const std::string& path, uint64_t key, uint32_t numTriangles, std::shared_ptr<void>& buffer);
+		static void _SaveBvhCache(const std::string& path, uint64_t key, uint32_t numTriangles, btOptimizedBvh* bvh);
 	};
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 namespace Gameplay::Physics {
 	/// <summary>
 	/// A complex collider type that allows us to construct collision hulls from arbitrary convex meshes
+	/// 
+	/// The hull is built once per MeshResource and reduced to a small number of points, so creating
+	/// the collider is cheap and collision queries don't need to visit every vertex of the mesh
 	/// </summary>
 	class ConvexMeshCollider final : public ICollider {
 	public:
@@ -17,9 +20,11 @@ namespace Gameplay::Physics {
 		virtual void DrawImGui() override;
 		virtual void ToJson(nlohmann::json& blob) const override;
 		virtual void FromJson(const nlohmann::json& data) override;
+		virtual const void* GetShapeSource() const override;
 
 	protected:
-		btTriangleMesh* _triMesh;
+		// The hull points, shared with the mesh resource that they were generated from
+		std::shared_ptr<const std::vector<glm::vec3>> _hull;
 		ConvexMeshCollider();
 
 		virtual btCollisionShape* CreateShape() const override;
@@ -0,0 +1,71 @@
+#include "TriangleMeshCollider.h"
+#include <BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
+
+#include "Gameplay/GameObject.h"
+#include "Gameplay/MeshResource.h"
+#include "Gameplay/Components/RenderComponent.h"
+#include "Gameplay/Physics/RigidBody.h"
+
+namespace Gameplay::Physics {
+	TriangleMeshCollider::Sptr TriangleMeshCollider::Create() {
+		return std::shared_ptr<TriangleMeshCollider>(new TriangleMeshCollider());
+	}
+
+	TriangleMeshCollider::~TriangleMeshCollider() = default;
+
+	TriangleMeshCollider::TriangleMeshCollider() :
+		ICollider(ColliderType::ConcaveMesh),
+		_meshShape(nullptr)
+	{ }
+
+	btCollisionShape* TriangleMeshCollider::CreateShape() const {
+		if (_meshShape == nullptr) {
+			return nullptr;
+		}
+		// Scaling a BVH shape directly would rebuild it's BVH, so we wrap the shared shape instead
+		return new btScaledBvhTriangleMeshShape(_meshShape.get(), btVector3(1.0f, 1.0f, 1.0f));
+	}
+
+	void TriangleMeshCollider::Awake(GameObject* context)
+	{
+		// Bullet does not support concave meshes on moving bodies
+		RigidBody::Sptr body = context->Get<RigidBody>();
+		if (body != nullptr && body->GetType() != RigidBodyType::Static) {
+			LOG_WARN("Triangle mesh collider on non-static body \"{}\", collisions will not be resolved correctly", context->Name);
+		}
+
+		// Get the components from the gameobject that we'll need to generate the mesh
+		RenderComponent::Sptr renderer = context->Get<RenderComponent>();
+		MeshResource::Sptr mesh = (renderer != nullptr ? renderer->GetMeshResource() : nullptr);
+
+		// If we have no mesh, we can't create a collider for it!
+		if (mesh == nullptr) {
+			LOG_WARN("Mesh collider attached to gameobject without a mesh!");
+			return;
+		}
+
+		// If we have an explicit collider, grab that instead
+		if (mesh->ColliderMeshData != nullptr) {
+			mesh = mesh->ColliderMeshData;
+		}
+
+		// The mesh resource will build or load the BVH once and share it between all colliders
+		_meshShape = mesh->GetBvhTriangleMeshShape();
+		if (_meshShape == nullptr) {
+			LOG_WARN("Mesh resource not fully configured!");
+		}
+	}
+
+	const void* TriangleMeshCollider::GetShapeSource() const {
+		return _meshShape.get();
+	}
+
+	void TriangleMeshCollider::FromJson(const nlohmann::json& data) {
+	}
+
+	void TriangleMeshCollider::ToJson(nlohmann::json& blob) const {
+	}
+
+	void TriangleMeshCollider::DrawImGui() {
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Gameplay/Physics/ICollider.h"
+
+class btBvhTriangleMeshShape;
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// A collider that uses the exact triangles of a mesh, allowing for concave shapes such as
+	/// level geometry. Triangle meshes can only be used by static bodies
+	/// 
+	/// The triangles and their BVH are shared between all colliders using the same MeshResource,
+	/// and the BVH is saved to disk so it only needs to be built once
+	/// </summary>
+	class TriangleMeshCollider final : public ICollider {
+	public:
+		typedef std::shared_ptr<TriangleMeshCollider> Sptr;
+		static TriangleMeshCollider::Sptr Create();
+		virtual ~TriangleMeshCollider();
+
+		// Inherited from ICollider
+		virtual void Awake(GameObject* context) override;
+		virtual void DrawImGui() override;
+		virtual void ToJson(nlohmann::json& blob) const override;
+		virtual void FromJson(const nlohmann::json& data) override;
+		virtual const void* GetShapeSource() const override;
+
+	protected:
+		// The unscaled mesh shape, shared with the mesh resource that it was generated from
+		std::shared_ptr<btBvhTriangleMeshShape> _meshShape;
+		TriangleMeshCollider();
+
+		virtual btCollisionShape* CreateShape() const override;
+	};
+}
@@ -0,0 +1,70 @@
+#include "Gameplay/Physics/CollisionShapeCache.h"
+#include <btBulletCollisionCommon.h>
+#include <Logging.h>
+
+#include "Gameplay/Physics/ICollider.h"
+#include "Utils/GlmBulletConversions.h"
+
+namespace Gameplay::Physics {
+	std::unordered_map<std::string, CollisionShapeCache::Entry> CollisionShapeCache::__shapes;
+	std::unordered_map<btCollisionShape*, std::string> CollisionShapeCache::__keys;
+	std::mutex CollisionShapeCache::__lock;
+
+	btCollisionShape* CollisionShapeCache::Acquire(const ICollider* collider, const glm::vec3& scale) {
+		std::string key = __MakeKey(collider, scale);
+
+		std::lock_guard<std::mutex> lock(__lock);
+		auto it = __shapes.find(key);
+		if (it != __shapes.end()) {
+			it->second.RefCount++;
+			return it->second.Shape;
+		}
+
+		// Mesh colliders may not have their data yet, we don't cache that so they can try again later
+		btCollisionShape* shape = collider->CreateShape();
+		if (shape == nullptr) {
+			return nullptr;
+		}
+		shape->setLocalScaling(ToBt(scale));
+
+		__shapes[key] = Entry{ shape, 1 };
+		__keys[shape] = key;
+		return shape;
+	}
+
+	void CollisionShapeCache::Release(btCollisionShape* shape) {
+		if (shape == nullptr) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(__lock);
+		auto keyIt = __keys.find(shape);
+		LOG_ASSERT(keyIt != __keys.end(), "Releasing a shape that was not acquired from the shape cache!");
+
+		auto it = __shapes.find(keyIt->second);
+		if (--it->second.RefCount == 0) {
+			delete it->second.Shape;
+			__shapes.erase(it);
+			__keys.erase(keyIt);
+		}
+	}
+
+	size_t CollisionShapeCache::GetShapeCount() {
+		std::lock_guard<std::mutex> lock(__lock);
+		return __shapes.size();
+	}
+
+	std::string CollisionShapeCache::__MakeKey(const ICollider* collider, const glm::vec3& scale) {
+		// The serialized form of a collider already holds every parameter that affects it's shape
+		nlohmann::json blob;
+		collider->ToJson(blob);
+
+		std::string key = std::to_string(*collider->GetType());
+		key += blob.dump();
+		// Mesh colliders have no parameters of their own, so they are told apart by the data they share
+		key += std::to_string(reinterpret_cast<uintptr_t>(collider->GetShapeSource()));
+		// Store the raw scale bits, so that any change in scale gets a new shape
+		key.append(reinterpret_cast<const char*>(&scale), sizeof(glm::vec3));
+		return key;
+	}
+}
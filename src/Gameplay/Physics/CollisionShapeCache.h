@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <mutex>
+#include <unordered_map>
+
+#include <GLM/glm.hpp>
+
+class btCollisionShape;
+
+namespace Gameplay::Physics {
+	class ICollider;
+
+	/// <summary>
+	/// Interns the bullet shapes created by colliders, so that bodies with identical colliders
+	/// (ex: a stack of crates) share a single shape instead of each allocating their own
+	///
+	/// Shapes are keyed on the collider type, it's serialized parameters, any shared data it
+	/// is built from and the final scale of the shape, and are deleted once the last body
+	/// using them releases them. Since shapes are shared, the scale is baked into the shape
+	/// when it is created and must never be changed afterwards
+	/// </summary>
+	class CollisionShapeCache {
+	public:
+		CollisionShapeCache() = delete;
+
+		/// <summary>
+		/// Gets the shape for a collider at the given scale, creating it if no body is using
+		/// a matching shape yet. Every successful call must be paired with a call to Release
+		/// </summary>
+		/// <param name="collider">The collider to get the shape for</param>
+		/// <param name="scale">The final scale of the shape, including the body's scale</param>
+		/// <returns>The shared shape, or nullptr if the collider could not create one</returns>
+		static btCollisionShape* Acquire(const ICollider* collider, const glm::vec3& scale);
+		/// <summary>
+		/// Releases a reference to a shape returned by Acquire, deleting the shape
+		/// if nothing else is using it
+		/// </summary>
+		/// <param name="shape">The shape to release, can be nullptr</param>
+		static void Release(btCollisionShape* shape);
+
+		/// <summary>
+		/// Gets the number of unique shapes that are currently alive
+		/// </summary>
+		static size_t GetShapeCount();
+
+	private:
+		struct Entry {
+			btCollisionShape* Shape;
+			uint32_t          RefCount;
+		};
+
+		static std::unordered_map<std::string, Entry> __shapes;
+		// Reverse lookup so that bodies only need to hold on to their shape pointers
+		static std::unordered_map<btCollisionShape*, std::string> __keys;
+		static std::mutex __lock;
+
+		static std::string __MakeKey(const ICollider* collider, const glm::vec3& scale);
+	};
+}
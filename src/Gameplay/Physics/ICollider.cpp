@@ -14,6 +14,7 @@
 #include "Gameplay/Physics/Colliders/ConeCollider.h"
 #include "Gameplay/Physics/Colliders/CylinderCollider.h"
 #include "Gameplay/Physics/Colliders/ConvexMeshCollider.h"
+#include "Gameplay/Physics/Colliders/TriangleMeshCollider.h"
 
 namespace Gameplay::Physics {
 	const char* ColliderTypeComboNames = "Plane\0Box\0Sphere\0Capsule\0Cone\0Cylinder\0Convex Mesh\0Concave Mesh\0Terrain\0";
@@ -27,21 +28,14 @@ namespace Gameplay::Physics {
 		_guid(Guid::New())
 	{ }
 
-	ICollider::~ICollider() {
-		if (_shape != nullptr) {
-			delete _shape;
-			_shape = nullptr;
-		}
-	}
+	// Our shape belongs to the shape cache, our body releases it
+	ICollider::~ICollider() = default;
 
 	ColliderType ICollider::GetType() const {
 		return _type;
 	}
 
 	btCollisionShape* ICollider::GetShape() const {
-		if (_shape == nullptr) {
-			_shape = CreateShape();
-		}
 		return _shape;
 	}
 
@@ -89,7 +83,7 @@ namespace Gameplay::Physics {
 			case ColliderType::Cone:        return ConeCollider::Create();
 			case ColliderType::Cylinder:    return CylinderCollider::Create();
 			case ColliderType::ConvexMesh:  return ConvexMeshCollider::Create();
-			case ColliderType::ConcaveMesh: throw std::runtime_error("Collider type not supported!"); return nullptr;
+			case ColliderType::ConcaveMesh: return TriangleMeshCollider::Create();
 			case ColliderType::Terrain:     throw std::runtime_error("Collider type not supported!"); return nullptr;
 			case ColliderType::Unknown:
 			default:
@@ -28,7 +28,7 @@ ENUM(ColliderType, int,
 	 Cylinder  = 6,
 	 // Convex meshes have no inward faces, ie no caves
 	 ConvexMesh = 7,
-	 // Concave meshes can have inward faces (NOT IMPLEMENTED)
+	 // Concave meshes can have inward faces, static bodies only
 	 ConcaveMesh = 8,
 	 // Used for creating terrain colliders,
 	 // much more complex than the other colliders (NOT IMPLEMENTED)
@@ -89,10 +89,18 @@ namespace Gameplay::Physics {
 		/// </summary>
 		virtual ColliderType GetType() const;
 		/// <summary>
-		/// Gets this collider's bullet collision shape
+		/// Gets this collider's bullet collision shape, will be nullptr until the collider's body
+		/// has been awoken. The shape is owned by the CollisionShapeCache and may be shared with
+		/// other bodies, so it must not be modified
 		/// </summary>
 		btCollisionShape* GetShape() const;
 
+		/// <summary>
+		/// Gets a pointer to any shared data that the collider's shape is built from (ex: a mesh
+		/// resource's hull), so that colliders without parameters can be told apart when sharing shapes
+		/// </summary>
+		virtual const void* GetShapeSource() const { return nullptr; }
+
 		/// <summary>
 		/// Sets the collider's position relative to it's RigidBody
 		/// </summary>
@@ -144,7 +152,7 @@ namespace Gameplay::Physics {
 	protected:
 		// Stores type 
 		ColliderType _type;
-		// Stores shape, note that mutable lets us modify in const functions
+		// Stores the shape our body acquired for us, note that mutable lets us modify in const functions
 		mutable btCollisionShape* _shape;
 		mutable bool _isDirty;
 
@@ -159,6 +167,7 @@ namespace Gameplay::Physics {
 	private:
 		// Allow RigidBody to access protected and private members
 		friend class PhysicsBase;
+		friend class CollisionShapeCache;
 
 		// These are private so derived classes don't accidentally use these
 		glm::vec3 _position;
@@ -2,6 +2,7 @@
 
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
+#include "Gameplay/Physics/CollisionShapeCache.h"
 
 #include "Utils/GlmBulletConversions.h"
 #include "Utils/ImGuiHelper.h"
@@ -15,16 +16,18 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		_scene(nullptr),
 		_colliders(std::vector<ICollider::Sptr>()),
 		_shape(nullptr),
+		_compound(nullptr),
+		_acquiredShapes(std::vector<btCollisionShape*>()),
 		_isShapeDirty(true),
 		_collisionGroup(0x01),
 		_collisionMask(0xFFFFFFFF),
-		_prevScale(glm::vec3(1.0f))
+		_prevScale(glm::vec3(1.0f)),
+		// Will never match a gameobject's version, so the first pre-step always syncs
+		_syncedTransformVersion(UINT32_MAX)
 	{ }
 
 	PhysicsBase::~PhysicsBase() {
-		if (_scene != nullptr) {
-			delete _shape;
-		}
+		_ReleaseShape();
 	}
 
 	void PhysicsBase::_RenderImGuiBase() {
@@ -150,58 +153,92 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 	void PhysicsBase::RemoveCollider(const ICollider::Sptr& collider) {
 		auto& it = std::find(_colliders.begin(), _colliders.end(), collider);
 		if (it != _colliders.end()) {
-			if (collider->GetShape() != nullptr) {
-				_shape->removeChildShape(collider->GetShape());
-				_isShapeDirty = true;
-			}
+			// Our shape keeps hold of the collider's shape until it is rebuilt in the next pre-step
+			collider->_shape = nullptr;
 			_colliders.erase(it);
+			_isShapeDirty = true;
 		}
 	}
 
+	void PhysicsBase::_BuildShape() {
+		glm::vec3 scale = GetGameObject()->GetScale();
 
-	void PhysicsBase::_AddColliderToShape(ICollider* collider) {
-		// Create the bullet collision shape from the collider
-		btCollisionShape* newShape = collider->CreateShape();
-		collider->_shape = newShape;
+		// Hold on to our old shapes until the new ones are acquired, so that shapes that haven't
+		// changed are not deleted and re-created
+		std::vector<btCollisionShape*> oldShapes;
+		std::swap(oldShapes, _acquiredShapes);
+		btCompoundShape* oldCompound = _compound;
+		_compound = nullptr;
 
-		// If the shape actually exists
-		if (newShape != nullptr) {
-			// We convert our shape parameters to a bullet transform
-			btTransform transform;
-			transform.setIdentity();
-			transform.setOrigin(ToBt(collider->_position));
-			transform.setRotation(ToBt(glm::quat(glm::radians(collider->_rotation))));
-			newShape->setLocalScaling(ToBt(collider->_scale));
+		// Shared shapes can't be scaled per body, so the body's scale is baked into each collider's shape
+		for (auto& collider : _colliders) {
+			collider->_shape = CollisionShapeCache::Acquire(collider.get(), collider->_scale * scale);
+			if (collider->_shape != nullptr) {
+				_acquiredShapes.push_back(collider->_shape);
+			}
+			collider->_isDirty = false;
+		}
 
-			// Add the shape to the compound shape
-			_shape->addChildShape(transform, newShape);
+		// A single collider sitting on the body's origin can be used directly, saving bullet from
+		// going through a compound shape for every collision test
+		if (_colliders.size() == 1 && _colliders[0]->_shape != nullptr && 
+			_colliders[0]->_position == glm::vec3(0.0f) && _colliders[0]->_rotation == glm::vec3(0.0f)) {
+			_shape = _colliders[0]->_shape;
+		} else {
+			_compound = new btCompoundShape(true, static_cast<int>(_colliders.size()));
+			for (auto& collider : _colliders) {
+				if (collider->_shape != nullptr) {
+					// We convert our shape parameters to a bullet transform, offsets are scaled with the body
+					btTransform transform;
+					transform.setIdentity();
+					transform.setOrigin(ToBt(collider->_position * scale));
+					transform.setRotation(ToBt(glm::quat(glm::radians(collider->_rotation))));
+					_compound->addChildShape(transform, collider->_shape);
+				}
+			}
+			_shape = _compound;
+		}
+		_prevScale = scale;
+		_isShapeDirty = false;
 
+		// If our body already exists, swap it over to the new shape
+		btCollisionObject* object = _GetCollisionObject();
+		if (object != nullptr) {
+			object->setCollisionShape(_shape);
 			// Remove any existing collision manifolds, so that our body can properly be updated with it's new shape
-			if (_scene != nullptr) {
-				_scene->GetPhysicsWorld()->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(_GetBroadphaseHandle(), _scene->GetPhysicsWorld()->getDispatcher());
-			}
+			_scene->GetPhysicsWorld()->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(_GetBroadphaseHandle(), _scene->GetPhysicsWorld()->getDispatcher());
+		}
 
-			// Our inertia has changed, so flag mass as dirty so it's recalculated
-			_isShapeDirty = true;
+		// Now that nothing is using them, we can let go of our old shapes
+		delete oldCompound;
+		for (btCollisionShape* shape : oldShapes) {
+			CollisionShapeCache::Release(shape);
 		}
 	}
 
+	void PhysicsBase::_ReleaseShape() {
+		for (auto& collider : _colliders) {
+			collider->_shape = nullptr;
+		}
+		for (btCollisionShape* shape : _acquiredShapes) {
+			CollisionShapeCache::Release(shape);
+		}
+		_acquiredShapes.clear();
+		delete _compound;
+		_compound = nullptr;
+		_shape = nullptr;
+	}
+
 	bool PhysicsBase::_HandleShapeDirty() {
-		bool wasDirty = false;
+		bool isDirty = _isShapeDirty || GetGameObject()->GetScale() != _prevScale;
 		for (auto& collider : _colliders) {
-			if (collider->_isDirty) {
-				// If the collider already had a shape, delete it
-				if (collider->_shape != nullptr) {
-					_shape->removeChildShape(collider->_shape);
-					delete collider->_shape;
-				}
-				_AddColliderToShape(collider.get());
-				collider->_isDirty = false;
-				wasDirty = true;
-			}
+			isDirty |= collider->_isDirty;
 		}
 
-		return wasDirty;
+		if (isDirty) {
+			_BuildShape();
+		}
+		return isDirty;
 	}
 
 	bool PhysicsBase::_HandleGroupDirty() {
@@ -224,11 +261,7 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		transform.setIdentity();
 		transform.setOrigin(ToBt(context->GetPosition()));	 
 		transform.setRotation(ToBt(context->GetRotation()));
-		if (context->GetScale() != _prevScale) {
-			_shape->setLocalScaling(ToBt(context->GetScale()));
-			_scene->GetPhysicsWorld()->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(_GetBroadphaseHandle(), _scene->GetPhysicsWorld()->getDispatcher());
-			_prevScale = context->GetScale();
-		}
+		_syncedTransformVersion = context->GetTransformVersion();
 	}
 
 	void PhysicsBase::_CopyGameobjectTransformFrom(const btTransform& transform) {
@@ -237,5 +270,12 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		// Update the pos and rotation params
 		context->SetPosition(ToGlm(transform.getOrigin()));
 		context->SetRotation(ToGlm(transform.getRotation()));
+
+		// The change came from bullet, so it does not need to be sent back
+		_syncedTransformVersion = context->GetTransformVersion();
+	}
+
+	bool PhysicsBase::_IsTransformChanged() const {
+		return GetGameObject()->GetTransformVersion() != _syncedTransformVersion;
 	}
 }
@@ -3,6 +3,7 @@
 #include "Gameplay/Physics/ICollider.h"
 
 class btTransform;
+class btCollisionObject;
 
 namespace Gameplay {
 	class Scene;
@@ -57,8 +58,8 @@ namespace Gameplay {
 
 			/// <summary>
 			/// Adds a new collider to this rigidbody.
-			/// Multiple colliders can be added to a rigidbody, as internally it
-			/// uses a compound shape collider
+			/// Multiple colliders can be added to a rigidbody, in which case internally
+			/// it uses a compound shape collider
 			/// </summary>
 			/// <param name="collider">The collider to add to this body</param>
 			/// <returns></returns>
@@ -89,8 +90,13 @@ namespace Gameplay {
 		protected:
 			Scene*        _scene;
 
-			// Stores the bullet shape associated with the physics object
-			btCompoundShape* _shape;
+			// Stores the bullet shape associated with the physics object, this is either our
+			// only collider's shared shape, or _compound
+			btCollisionShape* _shape;
+			// Only used when we have multiple colliders, or a collider is offset from the body
+			btCompoundShape*  _compound;
+			// The shapes we have acquired from the shape cache, and need to release
+			std::vector<btCollisionShape*> _acquiredShapes;
 
 			// List of colliders and whether they have been changed
 			std::vector<ICollider::Sptr> _colliders;
@@ -103,6 +109,9 @@ namespace Gameplay {
 
 			glm::vec3 _prevScale;
 
+			// The gameobject transform version that the physics world last matched
+			uint32_t  _syncedTransformVersion;
+
 			PhysicsBase();
 
 			void _RenderImGuiBase();
@@ -110,10 +119,14 @@ namespace Gameplay {
 			void ToJsonBase(nlohmann::json& output) const;
 			void FromJsonBase(const nlohmann::json& input);
 
-			// Handles adding a collider to our compound shape
-			void _AddColliderToShape(ICollider* collider);
+			// Acquires shapes for all our colliders at the gameobject's scale, and builds the shape
+			// for our body from them
+			void _BuildShape();
+			// Releases all the shapes held by the body
+			void _ReleaseShape();
 
-			// Handles resolving any dirty state stuff for our object
+			// Rebuilds our shape if a collider or the gameobject's scale has changed, returns true
+			// if the shape was rebuilt
 			bool _HandleShapeDirty();
 
 			bool _HandleGroupDirty();
@@ -122,8 +135,14 @@ namespace Gameplay {
 			void _CopyGameobjectTransformTo(btTransform& transform);
 			void _CopyGameobjectTransformFrom(const btTransform& transform);
 
+			// Returns true if the gameobject has been moved since the last time it's transform was
+			// copied to or from bullet
+			bool _IsTransformChanged() const;
+
 			// Gets the bullet broadphase proxy that we can use for clearing collisions
 			virtual btBroadphaseProxy* _GetBroadphaseHandle() = 0;
+			// Gets the bullet object that our shape is attached to, or nullptr if it has not been created
+			virtual btCollisionObject* _GetCollisionObject() = 0;
 
 			static int _editorSelectedColliderType;
 		};
@@ -0,0 +1,199 @@
+#include "Gameplay/Physics/PhysicsQueries.h"
+
+#include <btBulletCollisionCommon.h>
+#include <LinearMath/btThreads.h>
+#include <Logging.h>
+
+#include "Gameplay/Physics/PhysicsBase.h"
+#include "Utils/ThreadPool.h"
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// Returns true if the object can be reported by a query, triggers and the ignored object are skipped
+	/// </summary>
+	static inline bool IsQueryable(const btCollisionObject* object, const void* ignore) {
+		return (ignore == nullptr || object->getUserPointer() != ignore) &&
+			(object->getCollisionFlags() & btCollisionObject::CF_NO_CONTACT_RESPONSE) == 0;
+	}
+
+	/// <summary>
+	/// Gets the physics component that was stored in a bullet object's user pointer
+	/// </summary>
+	static inline std::weak_ptr<IComponent> GetComponent(const btCollisionObject* object) {
+		void* userPointer = object->getUserPointer();
+		return userPointer != nullptr ? *reinterpret_cast<std::weak_ptr<IComponent>*>(userPointer) : std::weak_ptr<IComponent>();
+	}
+
+	struct QueryRayCallback : public btCollisionWorld::ClosestRayResultCallback {
+		const void* Ignore;
+
+		QueryRayCallback(const btVector3& from, const btVector3& to, int mask, const void* ignore) :
+			ClosestRayResultCallback(from, to),
+			Ignore(ignore)
+		{
+			m_collisionFilterGroup = btBroadphaseProxy::AllFilter;
+			m_collisionFilterMask  = mask;
+		}
+
+		virtual bool needsCollision(btBroadphaseProxy* proxy) const override {
+			return ClosestRayResultCallback::needsCollision(proxy) && IsQueryable(static_cast<const btCollisionObject*>(proxy->m_clientObject), Ignore);
+		}
+	};
+
+	struct QuerySweepCallback : public btCollisionWorld::ClosestConvexResultCallback {
+		const void* Ignore;
+
+		QuerySweepCallback(const btVector3& from, const btVector3& to, int mask, const void* ignore) :
+			ClosestConvexResultCallback(from, to),
+			Ignore(ignore)
+		{
+			m_collisionFilterGroup = btBroadphaseProxy::AllFilter;
+			m_collisionFilterMask  = mask;
+		}
+
+		virtual bool needsCollision(btBroadphaseProxy* proxy) const override {
+			return ClosestConvexResultCallback::needsCollision(proxy) && IsQueryable(static_cast<const btCollisionObject*>(proxy->m_clientObject), Ignore);
+		}
+	};
+
+	struct QueryOverlapCallback : public btBroadphaseAabbCallback {
+		int                           Mask;
+		const void*                   Ignore;
+		std::vector<PhysicsQueryHit>& Hits;
+
+		QueryOverlapCallback(int mask, const void* ignore, std::vector<PhysicsQueryHit>& hits) :
+			Mask(mask),
+			Ignore(ignore),
+			Hits(hits)
+		{ }
+
+		virtual bool process(const btBroadphaseProxy* proxy) override {
+			const btCollisionObject* object = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+			if ((proxy->m_collisionFilterGroup & Mask) && IsQueryable(object, Ignore)) {
+				Hits.push_back({ GetComponent(object), 0.0f, glm::vec3(0.0f), glm::vec3(0.0f) });
+			}
+			// Keep going, we want every overlap
+			return true;
+		}
+	};
+
+	PhysicsQueries::PhysicsQueries() :
+		_queries(),
+		_results(),
+		_hits(),
+		_queryHits()
+	{ }
+
+	PhysicsQueries::Handle PhysicsQueries::AddRay(const glm::vec3& from, const glm::vec3& to, int mask, const std::shared_ptr<PhysicsBase>& ignore) {
+		return _Add(PhysicsQueryType::Ray, from, to, 0.0f, mask, ignore);
+	}
+
+	PhysicsQueries::Handle PhysicsQueries::AddSphereSweep(const glm::vec3& from, const glm::vec3& to, float radius, int mask, const std::shared_ptr<PhysicsBase>& ignore) {
+		LOG_ASSERT(radius > 0.0f, "Sphere sweep radius must be greater than zero");
+		return _Add(PhysicsQueryType::SphereSweep, from, to, radius, mask, ignore);
+	}
+
+	PhysicsQueries::Handle PhysicsQueries::AddOverlap(const glm::vec3& center, const glm::vec3& halfExtents, int mask, const std::shared_ptr<PhysicsBase>& ignore) {
+		return _Add(PhysicsQueryType::Overlap, center - halfExtents, center + halfExtents, 0.0f, mask, ignore);
+	}
+
+	void PhysicsQueries::Execute(btCollisionWorld* world) {
+		uint32_t numQueries = static_cast<uint32_t>(_queries.size());
+		_results.resize(numQueries);
+		_hits.clear();
+		if (_queryHits.size() < numQueries) {
+			_queryHits.resize(numQueries);
+		}
+
+		// Queries only read from the world, but bullet's broadphase ray tests share a traversal stack
+		// unless it was built thread safe
+		#if BT_THREADSAFE
+		ThreadPool::ParallelFor(numQueries, [&](uint32_t ix) {
+			_queryHits[ix].clear();
+			_RunQuery(world, _queries[ix], _queryHits[ix]);
+		}, 16);
+		#else
+		for (uint32_t ix = 0; ix < numQueries; ix++) {
+			_queryHits[ix].clear();
+			_RunQuery(world, _queries[ix], _queryHits[ix]);
+		}
+		#endif
+
+		// Flatten the per-query hits into a single array
+		for (uint32_t ix = 0; ix < numQueries; ix++) {
+			_results[ix].FirstHit = static_cast<uint32_t>(_hits.size());
+			_results[ix].NumHits  = static_cast<uint32_t>(_queryHits[ix].size());
+			_hits.insert(_hits.end(), _queryHits[ix].begin(), _queryHits[ix].end());
+		}
+	}
+
+	void PhysicsQueries::Clear() {
+		_queries.clear();
+		_results.clear();
+		_hits.clear();
+	}
+
+	const PhysicsQueryResult& PhysicsQueries::GetResult(Handle handle) const {
+		LOG_ASSERT(handle < _results.size(), "Query handle out of range, has the batch been executed?");
+		return _results[handle];
+	}
+
+	const PhysicsQueryHit* PhysicsQueries::GetHit(Handle handle) const {
+		const PhysicsQueryResult& result = GetResult(handle);
+		return result.HasHit() ? &_hits[result.FirstHit] : nullptr;
+	}
+
+	PhysicsQueries::Handle PhysicsQueries::_Add(PhysicsQueryType type, const glm::vec3& from, const glm::vec3& to, float radius, int mask, const std::shared_ptr<PhysicsBase>& ignore) {
+		Query query;
+		query.Type   = type;
+		query.From   = from;
+		query.To     = to;
+		query.Radius = radius;
+		query.Mask   = mask;
+		query.Ignore = ignore != nullptr ? &ignore->SelfRef() : nullptr;
+		_queries.push_back(query);
+		return static_cast<Handle>(_queries.size() - 1);
+	}
+
+	void PhysicsQueries::_RunQuery(btCollisionWorld* world, const Query& query, std::vector<PhysicsQueryHit>& hits) {
+		btVector3 from = btVector3(query.From.x, query.From.y, query.From.z);
+		btVector3 to   = btVector3(query.To.x, query.To.y, query.To.z);
+
+		switch (query.Type) {
+			case PhysicsQueryType::Ray:
+			{
+				QueryRayCallback callback(from, to, query.Mask, query.Ignore);
+				world->rayTest(from, to, callback);
+				if (callback.hasHit()) {
+					const btVector3& point  = callback.m_hitPointWorld;
+					const btVector3& normal = callback.m_hitNormalWorld;
+					hits.push_back({ GetComponent(callback.m_collisionObject), callback.m_closestHitFraction, glm::vec3(point.x(), point.y(), point.z()), glm::vec3(normal.x(), normal.y(), normal.z()) });
+				}
+				break;
+			}
+			case PhysicsQueryType::SphereSweep:
+			{
+				btSphereShape sphere(query.Radius);
+				btTransform fromTransform = btTransform(btQuaternion::getIdentity(), from);
+				btTransform toTransform   = btTransform(btQuaternion::getIdentity(), to);
+
+				QuerySweepCallback callback(from, to, query.Mask, query.Ignore);
+				world->convexSweepTest(&sphere, fromTransform, toTransform, callback);
+				if (callback.hasHit()) {
+					const btVector3& point  = callback.m_hitPointWorld;
+					const btVector3& normal = callback.m_hitNormalWorld;
+					hits.push_back({ GetComponent(callback.m_hitCollisionObject), callback.m_closestHitFraction, glm::vec3(point.x(), point.y(), point.z()), glm::vec3(normal.x(), normal.y(), normal.z()) });
+				}
+				break;
+			}
+			case PhysicsQueryType::Overlap:
+			{
+				QueryOverlapCallback callback(query.Mask, query.Ignore, hits);
+				world->getBroadphase()->aabbTest(from, to, callback);
+				break;
+			}
+			default:
+				break;
+		}
+	}
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <GLM/glm.hpp>
+#include <EnumToString.h>
+
+class btCollisionWorld;
+
+namespace Gameplay {
+	class IComponent;
+}
+
+namespace Gameplay::Physics {
+	class PhysicsBase;
+
+	ENUM(PhysicsQueryType, uint8_t,
+		Ray         = 0,
+		SphereSweep = 1,
+		Overlap     = 2
+	);
+
+	/// <summary>
+	/// A single hit from a physics query
+	/// </summary>
+	struct PhysicsQueryHit {
+		// The physics component (ex: RigidBody) that owns the object that was hit
+		std::weak_ptr<IComponent> Body;
+		// How far along the query the hit happened, in the 0-1 range (0 for overlaps)
+		float                     Fraction;
+		// The world space point and surface normal of the hit (zero for overlaps)
+		glm::vec3                 Point;
+		glm::vec3                 Normal;
+	};
+
+	/// <summary>
+	/// The range of hits that belong to a single query
+	/// </summary>
+	struct PhysicsQueryResult {
+		uint32_t FirstHit;
+		uint32_t NumHits;
+
+		bool HasHit() const { return NumHits > 0; }
+	};
+
+	/// <summary>
+	/// Collects a batch of ray, sphere sweep and overlap queries and runs them all at once against
+	/// a physics world. Queries are independent, so they are spread across the ThreadPool when bullet
+	/// is built with BT_THREADSAFE, and run on the calling thread otherwise
+	/// 
+	/// The world must not be stepped or modified while a batch is executing. Rays and sweeps report
+	/// the closest hit, overlaps report every body whose broadphase bounds touch the query box. Trigger
+	/// volumes are never reported
+	/// </summary>
+	class PhysicsQueries {
+	public:
+		typedef uint32_t Handle;
+
+		/// <summary>
+		/// Mask that accepts bodies in any collision group
+		/// </summary>
+		static const int ALL_GROUPS = -1;
+
+		PhysicsQueries();
+
+		/// <summary>
+		/// Adds a ray from one point to another
+		/// </summary>
+		/// <param name="from">The world space start of the ray</param>
+		/// <param name="to">The world space end of the ray</param>
+		/// <param name="mask">The collision groups that the ray can hit, see PhysicsBase::SetCollisionGroup</param>
+		/// <param name="ignore">An optional physics component that the ray will pass through (ex: the caster)</param>
+		/// <returns>A handle that can be used to retrieve the result after Execute</returns>
+		Handle AddRay(const glm::vec3& from, const glm::vec3& to, int mask = ALL_GROUPS, const std::shared_ptr<PhysicsBase>& ignore = nullptr);
+		/// <summary>
+		/// Adds a sphere that will be swept from one point to another
+		/// </summary>
+		Handle AddSphereSweep(const glm::vec3& from, const glm::vec3& to, float radius, int mask = ALL_GROUPS, const std::shared_ptr<PhysicsBase>& ignore = nullptr);
+		/// <summary>
+		/// Adds an axis aligned box that will report every body with overlapping broadphase bounds
+		/// </summary>
+		Handle AddOverlap(const glm::vec3& center, const glm::vec3& halfExtents, int mask = ALL_GROUPS, const std::shared_ptr<PhysicsBase>& ignore = nullptr);
+
+		/// <summary>
+		/// Gets the number of queries that have been added since the last clear
+		/// </summary>
+		size_t GetNumQueries() const { return _queries.size(); }
+
+		/// <summary>
+		/// Runs all queries in the batch against the world, replacing any previous results
+		/// </summary>
+		void Execute(btCollisionWorld* world);
+		/// <summary>
+		/// Removes all queries and results, invalidating all handles
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Gets the result for a query, only valid after Execute
+		/// </summary>
+		const PhysicsQueryResult& GetResult(Handle handle) const;
+		/// <summary>
+		/// Gets the first (for rays and sweeps, the closest) hit for a query
+		/// </summary>
+		/// <returns>The hit, or nullptr if the query did not hit anything</returns>
+		const PhysicsQueryHit* GetHit(Handle handle) const;
+		/// <summary>
+		/// Gets the flat array of hits for all queries, use GetResult to find the range for a query
+		/// </summary>
+		const std::vector<PhysicsQueryHit>& GetHits() const { return _hits; }
+
+	protected:
+		struct Query {
+			PhysicsQueryType Type;
+			glm::vec3        From;
+			glm::vec3        To;
+			float            Radius;
+			int              Mask;
+			// The user pointer of the object to skip, see IComponent::SelfRef
+			const void*      Ignore;
+		};
+
+		std::vector<Query>                        _queries;
+		std::vector<PhysicsQueryResult>           _results;
+		std::vector<PhysicsQueryHit>              _hits;
+		// Each query writes to it's own list while executing, so that workers never share storage
+		std::vector<std::vector<PhysicsQueryHit>> _queryHits;
+
+		Handle _Add(PhysicsQueryType type, const glm::vec3& from, const glm::vec3& to, float radius, int mask, const std::shared_ptr<PhysicsBase>& ignore);
+		static void _RunQuery(btCollisionWorld* world, const Query& query, std::vector<PhysicsQueryHit>& hits);
+	};
+}
@@ -0,0 +1,71 @@
+#include "Gameplay/Physics/PhysicsTaskScheduler.h"
+
+#include <vector>
+#include <algorithm>
+#include <Logging.h>
+
+#include "Utils/ThreadPool.h"
+
+PhysicsTaskScheduler::PhysicsTaskScheduler() :
+	btITaskScheduler("Engine ThreadPool")
+{ }
+
+PhysicsTaskScheduler* PhysicsTaskScheduler::Get() {
+	static PhysicsTaskScheduler instance;
+	return &instance;
+}
+
+void PhysicsTaskScheduler::Install() {
+	#if !BT_THREADSAFE
+	LOG_WARN("Bullet was not built with BT_THREADSAFE, multithreaded physics will run on a single thread");
+	#endif
+
+	if (btGetTaskScheduler() != Get()) {
+		btSetTaskScheduler(Get());
+	}
+}
+
+int PhysicsTaskScheduler::getMaxNumThreads() const {
+	// Worker threads plus the calling thread, which also takes part in parallel loops
+	return std::min(static_cast<int>(ThreadPool::GetNumThreads()) + 1, BT_MAX_THREAD_COUNT);
+}
+
+int PhysicsTaskScheduler::getNumThreads() const {
+	return getMaxNumThreads();
+}
+
+void PhysicsTaskScheduler::setNumThreads(int numThreads) {
+	// The number of threads is owned by the ThreadPool, which is configured by the app settings
+}
+
+void PhysicsTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) {
+	if (iEnd <= iBegin) return;
+
+	// Bullet hands us a grain size, so we split the range into chunks of that size and let the pool spread them out
+	int chunkSize = std::max(grainSize, 1);
+	int numChunks = (iEnd - iBegin + chunkSize - 1) / chunkSize;
+	ThreadPool::ParallelFor(static_cast<uint32_t>(numChunks), [&](uint32_t chunk) {
+		int begin = iBegin + static_cast<int>(chunk) * chunkSize;
+		body.forLoop(begin, std::min(begin + chunkSize, iEnd));
+	}, 1);
+}
+
+btScalar PhysicsTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) {
+	if (iEnd <= iBegin) return btScalar(0);
+
+	int chunkSize = std::max(grainSize, 1);
+	int numChunks = (iEnd - iBegin + chunkSize - 1) / chunkSize;
+
+	// Each chunk writes to it's own slot so we don't need any locking, the results are summed in order afterwards
+	std::vector<btScalar> partials(numChunks, btScalar(0));
+	ThreadPool::ParallelFor(static_cast<uint32_t>(numChunks), [&](uint32_t chunk) {
+		int begin = iBegin + static_cast<int>(chunk) * chunkSize;
+		partials[chunk] = body.sumLoop(begin, std::min(begin + chunkSize, iEnd));
+	}, 1);
+
+	btScalar result = btScalar(0);
+	for (btScalar partial : partials) {
+		result += partial;
+	}
+	return result;
+}
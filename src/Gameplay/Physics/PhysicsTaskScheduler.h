@@ -0,0 +1,34 @@
+#pragma once
+#include "LinearMath/btThreads.h"
+
+/// <summary>
+/// Implements bullet's task scheduler interface on top of the engine's ThreadPool, so that a
+/// multithreaded physics world shares the same workers as the rest of the engine instead of
+/// spinning up it's own threads
+/// 
+/// Bullet must be built with BT_THREADSAFE for the multithreaded world to actually run in parallel
+/// </summary>
+class PhysicsTaskScheduler : public btITaskScheduler {
+public:
+	/// <summary>
+	/// Gets the scheduler instance, bullet only supports a single global scheduler
+	/// </summary>
+	static PhysicsTaskScheduler* Get();
+
+	/// <summary>
+	/// Installs the scheduler as bullet's global task scheduler if it is not already, must be
+	/// invoked from the main thread after the ThreadPool has been initialized
+	/// </summary>
+	static void Install();
+
+	// Inherited from btITaskScheduler
+
+	virtual int getMaxNumThreads() const override;
+	virtual int getNumThreads() const override;
+	virtual void setNumThreads(int numThreads) override;
+	virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+	virtual btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+
+private:
+	PhysicsTaskScheduler();
+};
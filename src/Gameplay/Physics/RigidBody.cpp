@@ -27,7 +27,10 @@ namespace Gameplay::Physics {
 		_angularVelocity(btVector3(0, 0, 0)),
 		_angularVelocityDirty(false),
 		_angularFactor(btVector3(1,1,1)),
-		_angularFactorDirty(false)
+		_angularFactorDirty(false),
+		_previousTransform(btTransform::getIdentity()),
+		_currentTransform(btTransform::getIdentity()),
+		_isInterpolated(false)
 	{ }
 
 	RigidBody::~RigidBody() {
@@ -158,63 +161,96 @@ namespace Gameplay::Physics {
 		// Update any dirty state that may have changed
 		_HandleStateDirty();
 
-		if (_type != RigidBodyType::Static) {		
+		// Bullet already has our latest transform unless something outside of physics moved the object,
+		// this lets sleeping bodies stay asleep
+		if (_type != RigidBodyType::Static && _IsTransformChanged()) {
 			btTransform transform;
 			_CopyGameobjectTransformTo(transform);
 
-			// Copy to body and to it's motion state
+			// Kinematics are driven by their motion state, bullet reads from it every step
+			_motionState->Transform = transform;
+			_motionState->HasMoved  = false;
+
 			if (_type == RigidBodyType::Dynamic) {
 				_body->setWorldTransform(transform);
-			} else {
-				// Kinematics prefer to be driven my motion state for some reason :|
-				_body->getMotionState()->setWorldTransform(transform); 
+				_body->setInterpolationWorldTransform(transform);
+				// The object was moved from outside of physics, so it should not be interpolated from it's old position
+				_previousTransform = transform;
+				_currentTransform  = transform;
+				_isInterpolated    = false;
 			}
+
+			// Make sure the body responds to being moved
+			_body->activate();
 		}
 	}
 
 	void RigidBody::PhysicsPostStep(float dt) {
 		// Kinematics are driven externally and statics don't move, so only need to get data out for dynamics!
-		if (_type == RigidBodyType::Dynamic && _body->isActive()) {
-			btTransform transform = _body->getWorldTransform();
-			_CopyGameobjectTransformFrom(transform);
+		if (_type == RigidBodyType::Dynamic) {
+			_previousTransform = _currentTransform;
+
+			// Bullet only updates the motion state for bodies that are awake
+			if (_motionState->HasMoved) {
+				_motionState->HasMoved = false;
+				_currentTransform = _motionState->Transform;
+				_CopyGameobjectTransformFrom(_currentTransform);
+				_isInterpolated = false;
+
+				// Store a copy of our velocities
+				_linearVelocity = _body->getLinearVelocity();
+				_angularVelocity = _body->getAngularVelocity();
+			}
+		}
+	}
 
-			// Store a copy of our velocities
-			_linearVelocity = _body->getLinearVelocity();
-			_angularVelocity = _body->getAngularVelocity();
+	void RigidBody::PhysicsInterpolate(float alpha) {
+		if (_type != RigidBodyType::Dynamic || _body == nullptr) {
+			return;
 		}
+
+		// Resting bodies only need their gameobject written once, to undo the last blend
+		if (_previousTransform == _currentTransform) {
+			if (_isInterpolated) {
+				_CopyGameobjectTransformFrom(_currentTransform);
+				_isInterpolated = false;
+			}
+			return;
+		}
+
+		btTransform transform;
+		transform.setOrigin(_previousTransform.getOrigin().lerp(_currentTransform.getOrigin(), alpha));
+		transform.setRotation(_previousTransform.getRotation().slerp(_currentTransform.getRotation(), alpha));
+		_CopyGameobjectTransformFrom(transform);
+		_isInterpolated = true;
 	}
 
 	void RigidBody::Awake() {
 		GameObject* context = GetGameObject();
 		_scene = context->GetScene();
-		_prevScale = context->GetScale();
 		// Awake all our colliders to let them do initialization
 		// that requires the gameobject
 		for (auto& collider : _colliders) {
 			collider->Awake(context);
 		}
 
-		// Create our compound shape and add all colliders
-		_shape = new btCompoundShape(true, _colliders.size());
-		_shape->setLocalScaling(ToBt(context->GetScale()));
-		for (auto& collider : _colliders) {
-			_AddColliderToShape(collider.get());
-		}
-		_isShapeDirty = false;
+		// Get shapes for all our colliders and combine them into our body's shape
+		_BuildShape();
 
 		// Update inertia
 		_shape->calculateLocalInertia(_mass, _inertia);
 		_isMassDirty = false;
 
-		// Create a default motion state instance for tracking the bodies motion
-		_motionState = new btDefaultMotionState();
-
 		// Get the object's starting transform, create a bullet representation for it
 		btTransform transform; 
 		transform.setIdentity();
 		transform.setOrigin(ToBt(context->GetPosition()));
 		transform.setRotation(ToBt(context->GetRotation()));
-		_motionState->setWorldTransform(transform);
+
+		// Create a motion state to pass transforms between bullet and our gameobject
+		_motionState = new MotionState(transform);
+		_previousTransform = transform;
+		_currentTransform  = transform;
 
 		// Create the bullet rigidbody and add it to the physics scene
 		_body = new btRigidBody(_mass, _motionState, _shape, _inertia);
@@ -313,7 +349,7 @@ namespace Gameplay::Physics {
 			}
 		}
 
-		// If one of our colliders has changed, replace it's shape with it's
+		// If one of our colliders has changed, replace it's shape with it's new one
 		_isMassDirty |= _HandleShapeDirty();
 
 		// Handle updating our group or mask if they've changed
@@ -341,5 +377,9 @@ namespace Gameplay::Physics {
 		return _body != nullptr ? _body->getBroadphaseProxy() : nullptr;
 	}
 
+	btCollisionObject* RigidBody::_GetCollisionObject() {
+		return _body;
+	}
+
 }
 
@@ -164,6 +164,12 @@ namespace Gameplay::Physics {
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPostStep(float dt) override;
+		/// <summary>
+		/// Invoked for each RigidBody after all fixed steps for a frame have been taken, moves dynamic
+		/// bodies' gameobjects part way between the results of the last two steps
+		/// </summary>
+		/// <param name="alpha">How far between the previous and current step to place the object, 0-1</param>
+		void PhysicsInterpolate(float alpha);
 
 		// Inherited from IComponent
 		virtual void Awake() override;
@@ -174,6 +180,29 @@ namespace Gameplay::Physics {
 
 
 	protected:
+		/// <summary>
+		/// Bridges bullet's motion state to our rigid body. Bullet only pushes transforms
+		/// through this for bodies that are awake and moving, so sleeping bodies cost nothing
+		/// after a step
+		/// </summary>
+		class MotionState : public btMotionState {
+		public:
+			MotionState(const btTransform& transform) :
+				Transform(transform),
+				HasMoved(false) { }
+
+			// The latest transform, as given to bullet by us or to us by bullet
+			btTransform Transform;
+			// True if bullet has moved the body since we last copied the transform out
+			bool        HasMoved;
+
+			virtual void getWorldTransform(btTransform& worldTrans) const override { worldTrans = Transform; }
+			virtual void setWorldTransform(const btTransform& worldTrans) override {
+				Transform = worldTrans;
+				HasMoved  = true;
+			}
+		};
+
 		// The physics update mode for the body (static, dynamic, kinematic)
 		RigidBodyType _type;
 
@@ -189,7 +218,7 @@ namespace Gameplay::Physics {
 
 		// Our bullet state stuff
 		btRigidBody*     _body;
-		btMotionState*   _motionState;
+		MotionState*     _motionState;
 		btVector3        _inertia;
 		btVector3        _linearVelocity;
 		bool             _linearVelocityDirty;
@@ -198,9 +227,16 @@ namespace Gameplay::Physics {
 		btVector3        _angularFactor;
 		bool             _angularFactorDirty;
 
+		// The transforms from the last two physics steps, used to interpolate when rendering
+		btTransform      _previousTransform;
+		btTransform      _currentTransform;
+		// True if the gameobject holds a transform between the last two steps, rather than the latest one
+		bool             _isInterpolated;
+
 		// Handles resolving any dirty state stuff for our object
 		void _HandleStateDirty();
 
 		virtual btBroadphaseProxy* _GetBroadphaseHandle() override;
+		virtual btCollisionObject* _GetCollisionObject() override;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "Gameplay/Physics/TriggerVolume.h"
 
+#include <algorithm>
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 
 #include "Utils/GlmBulletConversions.h"
@@ -28,120 +29,136 @@ namespace Gameplay::Physics {
 		_HandleShapeDirty();
 		_HandleGroupDirty();
 
-		// Copy our transform info from OpenGL
-		GameObject* context = GetGameObject();
-		btTransform transform;
-		_CopyGameobjectTransformTo(transform);
-
-		_ghost->setWorldTransform(transform);
+		// Only push our transform into bullet when the gameobject has actually moved
+		if (_IsTransformChanged()) {
+			btTransform transform;
+			_CopyGameobjectTransformTo(transform);
+			_ghost->setWorldTransform(transform);
+		}
 	}
 
 	void TriggerVolume::PhysicsPostStep(float dt) {
-		// This will store all the objects inside the trigger this frame
-		std::vector<std::weak_ptr<RigidBody>> thisFrameCollision;
-
-		// Get all our collisions from from the world
-		_scene->GetPhysicsWorld()->getDispatcher()->dispatchAllCollisionPairs(_ghost->getOverlappingPairCache(), _scene->GetPhysicsWorld()->getDispatchInfo(), _scene->GetPhysicsWorld()->getDispatcher());
-		btBroadphasePairArray& collisionPairs = _ghost->getOverlappingPairCache()->getOverlappingPairArray();
-
-		// Determine how many objects are intersecting the volume
-		const int numObjects=collisionPairs.size();
-		thisFrameCollision.reserve(numObjects);
+		btOverlappingPairCache* worldPairs = _scene->GetPhysicsWorld()->getPairCache();
+		btBroadphaseProxy* ghostProxy = _ghost->getBroadphaseHandle();
 
 		// Will store our contact manifolds, can be static to be shared between frames and instances
-		static btManifoldArray	m_manifoldArray;
+		static btManifoldArray manifolds;
 
-		// Iterate over all the objects that we're colliding with
-		for (int i = 0; i < numObjects; ++i) {
-			// resize the number of manifolds to zero for everything we collide with
-			m_manifoldArray.resize(0);
+		// Find everything touching the volume this step. The world has already run narrowphase on all of
+		// our broadphase pairs, so we just look up those results rather than re-dispatching them ourselves
+		_stepOverlaps.clear();
+		for (int ix = 0; ix < _ghost->getNumOverlappingObjects(); ix++) {
+			const btCollisionObject* obj = _ghost->getOverlappingObject(ix);
 
-			// Get the btCollisionObject that we're colliding with
-			btCollisionObject *obj = _ghost->getOverlappingObject(i);
+			// Make sure the internal type is a bullet rigid body (no trigger-trigger interactions), and that the
+			// object's group matches our mask (since this isn't filtered for us)
+			if (obj->getInternalType() != btCollisionObject::CO_RIGID_BODY || !(obj->getBroadphaseHandle()->m_collisionFilterGroup & _collisionMask)) {
+				continue;
+			}
 
-			// Get the contact pair and resolve contact manifolds
-			btBroadphasePair* pair = &collisionPairs[i];
-			if (pair != nullptr && pair->m_algorithm != nullptr) {
-				pair->m_algorithm->getAllContactManifolds(m_manifoldArray);
-			} else {
+			// Make sure that the object is not a kinematic or static object (note: you may want
+			// to modify this behaviour depending on your game)
+			if (!(((obj->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT & btCollisionObject::CF_KINEMATIC_OBJECT) == 0) ||
+				((obj->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Statics)) ||
+				((obj->getCollisionFlags() & btCollisionObject::CF_KINEMATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Kinematics)))) {
 				continue;
 			}
 
-			// Iterate over all the contact manifolds and check if any of them have contacts
-			bool hasCollision = false;
-			for (int j=0; j < m_manifoldArray.size(); j++) {
-				btPersistentManifold* manifold = m_manifoldArray[j];
-				if (manifold != nullptr && manifold->getNumContacts() > 0) {
-					hasCollision = true;
-					break;
-				}
+			btBroadphasePair* pair = worldPairs->findPair(ghostProxy, obj->getBroadphaseHandle());
+			if (pair == nullptr || pair->m_algorithm == nullptr) {
+				continue;
 			}
 
-			// If we have contacts and the object's group matches our mask (since this isn't filtered for us)
-			if (hasCollision && (obj->getBroadphaseHandle()->m_collisionFilterGroup & _collisionMask)) {
-				// Make sure the internal type is a bullet rigid body (no trigger-trigger interactions)
-				if (obj->getInternalType() == btCollisionObject::CO_RIGID_BODY) {
-					// Get the collision object as a btRigidBody
-					const btRigidBody *body = (const btRigidBody *)obj;
-
-					// Make sure that the object is not a kinematic or static object (note: you may want
-					// to modify this behaviour depending on your game)
-					if (((body->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT & btCollisionObject::CF_KINEMATIC_OBJECT) == 0) ||
-						((body->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Statics)) ||
-						((body->getCollisionFlags() & btCollisionObject::CF_KINEMATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Kinematics))) {
-
-						// Extract the weak pointer that we stored in all our rigidbody user pointers
-						std::weak_ptr<IComponent> rawPtr = *reinterpret_cast<std::weak_ptr<IComponent>*>(body->getUserPointer());
-						// Cast lock the raw pointer and cast up to a RigidBody
-						std::shared_ptr<RigidBody> physicsPtr = std::dynamic_pointer_cast<RigidBody>(rawPtr.lock());
-
-						// As long as we got a pointer out, we can proceed to try and invoke
-						if (physicsPtr != nullptr && physicsPtr->GetGameObject() != GetGameObject()) {
-							// Add the object to the known collisions for this frame
-							thisFrameCollision.push_back(physicsPtr);
-
-							// Check to see if the object has been added to our object cache
-							auto& it = std::find_if(_currentCollisions.begin(), _currentCollisions.end(), [&](const std::weak_ptr<RigidBody>& item) {
-								return item.lock() == physicsPtr;
-							});
-
-							// If the object is NOT in the cache, we invoke all the callbacks
-							if (it == _currentCollisions.end()) {
-								physicsPtr->GetGameObject()->OnEnteredTrigger(std::dynamic_pointer_cast<TriggerVolume>(SelfRef().lock()));
-								GetGameObject()->OnTriggerVolumeEntered(physicsPtr);
-							}
-						}
-					}
+			// Check if any of the manifolds for the pair have contacts
+			manifolds.resize(0);
+			pair->m_algorithm->getAllContactManifolds(manifolds);
+			for (int j = 0; j < manifolds.size(); j++) {
+				if (manifolds[j] != nullptr && manifolds[j]->getNumContacts() > 0) {
+					_stepOverlaps.push_back(obj);
+					break;
 				}
-
 			}
 		}
-	
-		// Compare our current frame list to the previous frame to see if anything has left
-		for (auto& weakPtr : _currentCollisions) {
-			// Search the the current list to see if the item still exists
-			auto& it = std::find_if(thisFrameCollision.begin(), thisFrameCollision.end(), [&](const std::weak_ptr<RigidBody>& item) {
-				return item.lock() == weakPtr.lock();
-			});
-
-			// If the item no longer exists in the list, we need to invoke exit callbacks
-			if (it == thisFrameCollision.end()) {
-				RigidBody::Sptr body = weakPtr.lock();
-				if (body != nullptr) {
-					body->GetGameObject()->OnLeavingTrigger(std::dynamic_pointer_cast<TriggerVolume>(SelfRef().lock()));
-					GetGameObject()->OnTriggerVolumeLeaving(body);
+		std::sort(_stepOverlaps.begin(), _stepOverlaps.end());
+
+		// Extract the weak pointer that we stored in all our rigidbody user pointers, we only need to do
+		// this when a body first enters
+		auto enter = [&](const btCollisionObject* obj) {
+			std::weak_ptr<IComponent> rawPtr = *reinterpret_cast<std::weak_ptr<IComponent>*>(obj->getUserPointer());
+			std::shared_ptr<RigidBody> physicsPtr = std::dynamic_pointer_cast<RigidBody>(rawPtr.lock());
+
+			bool notify = physicsPtr != nullptr && physicsPtr->GetGameObject() != GetGameObject();
+			_nextCollisions.push_back({ obj, physicsPtr, notify });
+			if (notify) {
+				_pendingEvents.push_back({ physicsPtr, true });
+			}
+		};
+
+		// Walk the sorted lists for the last step and this step together, anything only in the old list has
+		// left the volume, and anything only in the new list has entered it
+		_nextCollisions.clear();
+		size_t prevIx = 0;
+		size_t currIx = 0;
+		while (prevIx < _currentCollisions.size() || currIx < _stepOverlaps.size()) {
+			if (currIx == _stepOverlaps.size() || (prevIx < _currentCollisions.size() && _currentCollisions[prevIx].Object < _stepOverlaps[currIx])) {
+				if (_currentCollisions[prevIx].Notify) {
+					_pendingEvents.push_back({ _currentCollisions[prevIx].Body, false });
+				}
+				prevIx++;
+			}
+			else if (prevIx == _currentCollisions.size() || _stepOverlaps[currIx] < _currentCollisions[prevIx].Object) {
+				enter(_stepOverlaps[currIx]);
+				currIx++;
+			}
+			else {
+				// If the body we stored has been destroyed, the collision object at this address belongs to a
+				// different body, so this is really a leave followed by an enter. The old body can't receive
+				// it's leave event anymore, so we only need to handle the enter
+				if (_currentCollisions[prevIx].Body.expired()) {
+					enter(_stepOverlaps[currIx]);
+				}
+				// Still inside the volume
+				else {
+					_nextCollisions.push_back(_currentCollisions[prevIx]);
 				}
+				prevIx++;
+				currIx++;
 			}
 		}
 
 		// Load the contents of the current collision items into the cache
-		_currentCollisions.swap(thisFrameCollision);
+		_currentCollisions.swap(_nextCollisions);
+	}
+
+	void TriggerVolume::DispatchTriggerEvents() {
+		if (_pendingEvents.empty()) {
+			return;
+		}
+
+		// Callbacks can cause more physics work, so we take the events out of the queue before invoking them
+		std::vector<TriggerEvent> events;
+		events.swap(_pendingEvents);
+
+		TriggerVolume::Sptr self = std::dynamic_pointer_cast<TriggerVolume>(SelfRef().lock());
+		for (const TriggerEvent& event : events) {
+			RigidBody::Sptr body = event.Body.lock();
+			if (body == nullptr) {
+				continue;
+			}
+
+			if (event.Entered) {
+				body->GetGameObject()->OnEnteredTrigger(self);
+				GetGameObject()->OnTriggerVolumeEntered(body);
+			} else {
+				body->GetGameObject()->OnLeavingTrigger(self);
+				GetGameObject()->OnTriggerVolumeLeaving(body);
+			}
+		}
 	}
 
 	void TriggerVolume::Awake() {
 		GameObject* context = GetGameObject();
 		_scene = GetGameObject()->GetScene();
-		_prevScale = context->GetScale();
 
 		// Awake all our colliders to let them do initialization
 		// that requires the gameobject
@@ -149,15 +166,11 @@ namespace Gameplay::Physics {
 			collider->Awake(context);
 		}
 
-		// Create our compound shape and add all colliders
-		_shape = new btCompoundShape(true, _colliders.size());
-		_shape->setLocalScaling(ToBt(context->GetScale()));
-		for (auto& collider : _colliders) {
-			_AddColliderToShape(collider.get());
-		}
+		// Get shapes for all our colliders and combine them into our trigger's shape
+		_BuildShape();
 
 		// Create the ghost object
-		_ghost = new btPairCachingGhostObject();
+		_ghost = new btGhostObject();
 		_ghost->setCollisionShape(_shape);
 		_ghost->setUserPointer(&SelfRef());
 		_ghost->setCollisionFlags(_ghost->getCollisionFlags() | btCollisionObject::CF_NO_CONTACT_RESPONSE);
@@ -195,6 +208,10 @@ namespace Gameplay::Physics {
 		return _ghost != nullptr ? _ghost->getBroadphaseHandle() : nullptr;
 	}
 
+	btCollisionObject* TriggerVolume::_GetCollisionObject() {
+		return _ghost;
+	}
+
 	void TriggerVolume::SetFlags(TriggerTypeFlags flags) {
 		_typeFlags = flags;
 	}
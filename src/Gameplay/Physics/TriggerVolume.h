@@ -4,7 +4,8 @@
 #include "Gameplay/Physics/RigidBody.h"
 #include "EnumToString.h"
 
-class btPairCachingGhostObject;
+class btGhostObject;
+class btCollisionObject;
 
 namespace Gameplay::Physics {
 
@@ -33,11 +34,17 @@ namespace Gameplay::Physics {
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPreStep(float dt) override;
 		/// <summary>
-		/// Invoked for each RigidBody after the physics world is stepped forward a frame,
-		/// handles copying transform to the OpenGL state
+		/// Invoked for each trigger after the physics world is stepped forward a frame, works out
+		/// which bodies have entered or left the volume and queues events for them
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPostStep(float dt) override;
+		/// <summary>
+		/// Invokes the enter and leave callbacks for any events queued by the last PhysicsPostStep.
+		/// The scene calls this once every trigger has been updated, so callbacks are free to
+		/// modify the scene
+		/// </summary>
+		void DispatchTriggerEvents();
 
 		void SetFlags(TriggerTypeFlags flags);
 		TriggerTypeFlags GetFlags() const;
@@ -51,12 +58,33 @@ namespace Gameplay::Physics {
 		MAKE_TYPENAME(TriggerVolume);
 
 	protected:
-		btPairCachingGhostObject*   _ghost;
+		// A body that is inside the volume, kept sorted by the bullet object so that we can diff
+		// the contents between steps in a single pass
+		struct Overlap {
+			const btCollisionObject*   Object;
+			std::weak_ptr<RigidBody>   Body;
+			// False for bodies that we don't send events for (ex: bodies on our own gameobject)
+			bool                       Notify;
+		};
+
+		// An enter or leave event that is waiting to be dispatched
+		struct TriggerEvent {
+			std::weak_ptr<RigidBody> Body;
+			bool                     Entered;
+		};
+
+		btGhostObject*              _ghost;
 		TriggerTypeFlags            _typeFlags;
 
-		std::vector<std::weak_ptr<RigidBody>> _currentCollisions;
+		std::vector<Overlap>        _currentCollisions;
+		std::vector<TriggerEvent>   _pendingEvents;
+
+		// Scratch storage reused between steps to avoid allocations
+		std::vector<const btCollisionObject*> _stepOverlaps;
+		std::vector<Overlap>                  _nextCollisions;
 
 		virtual btBroadphaseProxy* _GetBroadphaseHandle() override;
+		virtual btCollisionObject* _GetCollisionObject() override;
 
 	};
 }
\ No newline at end of file
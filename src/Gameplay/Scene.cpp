@@ -3,20 +3,30 @@
 #include <GLFW/glfw3.h>
 #include <locale>
 #include <codecvt>
+#include <filesystem>
+#include <fstream>
 
 #include "Utils/FileHelpers.h"
+#include "Utils/JsonGlmHelpers.h"
 #include "Utils/GlmBulletConversions.h"
+#include "Utils/MemoryMappedFile.h"
 
 #include "Gameplay/Physics/RigidBody.h"
 #include "Gameplay/Physics/TriggerVolume.h"
+#include "Gameplay/Physics/PhysicsTaskScheduler.h"
 #include "Gameplay/MeshResource.h"
 #include "Gameplay/Material.h"
+#include "Gameplay/SceneSnapshot.h"
 
 #include "Graphics/DebugDraw.h"
 #include "Graphics/Textures/TextureCube.h"
 #include "Graphics/VertexArrayObject.h"
 #include "Application/Application.h"
 
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+
 namespace Gameplay {
 	Scene::Scene() :
 		_objects(std::vector<GameObject::Sptr>()),
@@ -32,7 +42,16 @@ namespace Gameplay {
 		_skyboxTexture(nullptr),
 		_skyboxRotation(glm::mat3(1.0f)),
 		_ambientLight(glm::vec3(0.1f)),
-		_gravity(glm::vec3(0.0f, 0.0f, 0.0f))
+		_gravity(glm::vec3(0.0f, 0.0f, 0.0f)),
+		_isFixedPhysicsStep(false),
+		_physicsStepRate(60.0f),
+		_maxPhysicsSteps(4),
+		_physicsAccumulator(0.0f),
+		_physicsAlpha(0.0f),
+		_isMultithreadedPhysics(false),
+		_lastPhysicsStepTime(0.0f),
+		_constraintSolverPool(nullptr),
+		_bulletDebugDraw(nullptr)
 	{
 		GameObject::Sptr mainCam = CreateGameObject("Main Camera");		
 		MainCamera = mainCam->Add<Camera>();
@@ -50,6 +69,7 @@ namespace Gameplay {
 		_objects.clear();
 		_components.Clear();
 		_CleanupPhysics();
+		delete _bulletDebugDraw;
 		IsDestroyed = true;
 	}
 
@@ -61,6 +81,57 @@ namespace Gameplay {
 		return (BulletDebugMode)_bulletDebugDraw->getDebugMode();
 	}
 
+	void Scene::SetGravity(const glm::vec3& value) {
+		_gravity = value;
+		_physicsWorld->setGravity(ToBt(_gravity));
+	}
+
+	const glm::vec3& Scene::GetGravity() const {
+		return _gravity;
+	}
+
+	void Scene::SetFixedPhysicsStep(bool enabled) {
+		_isFixedPhysicsStep = enabled;
+		_physicsAccumulator = 0.0f;
+		_physicsAlpha = 0.0f;
+	}
+
+	bool Scene::GetFixedPhysicsStep() const {
+		return _isFixedPhysicsStep;
+	}
+
+	void Scene::SetPhysicsStepRate(float stepsPerSecond) {
+		LOG_ASSERT(stepsPerSecond > 0.0f, "Physics step rate must be greater than 0");
+		_physicsStepRate = stepsPerSecond;
+	}
+
+	float Scene::GetPhysicsStepRate() const {
+		return _physicsStepRate;
+	}
+
+	void Scene::SetMaxPhysicsSteps(int value) {
+		LOG_ASSERT(value > 0, "Must allow at least one physics step per frame");
+		_maxPhysicsSteps = value;
+	}
+
+	int Scene::GetMaxPhysicsSteps() const {
+		return _maxPhysicsSteps;
+	}
+
+	void Scene::SetMultithreadedPhysics(bool enabled) {
+		if (_isMultithreadedPhysics == enabled) return;
+		_isMultithreadedPhysics = enabled;
+		_RebuildPhysicsWorld();
+	}
+
+	bool Scene::GetMultithreadedPhysics() const {
+		return _isMultithreadedPhysics;
+	}
+
+	void Scene::ExecutePhysicsQueries(Physics::PhysicsQueries& queries) const {
+		queries.Execute(_physicsWorld);
+	}
+
 	void Scene::SetSkyboxShader(const std::shared_ptr<ShaderProgram>& shader) {
 		_skyboxShader = shader;
 	}
@@ -100,6 +171,7 @@ namespace Gameplay {
 		result->_scene = this;
 		result->_selfRef = result;
 		_objects.push_back(result);
+		_IndexObject(result);
 		return result;
 	}
 
@@ -111,17 +183,28 @@ namespace Gameplay {
 	}
 
 	GameObject::Sptr Scene::FindObjectByName(const std::string name) const {
+		// Check the cache first, making sure the object hasn't been renamed or deleted since
+		auto cacheIt = _objectsByName.find(name);
+		if (cacheIt != _objectsByName.end()) {
+			GameObject::Sptr cached = cacheIt->second.lock();
+			if (cached != nullptr && cached->Name == name && cached->_scene == this) {
+				return cached;
+			}
+		}
+
 		auto it = std::find_if(_objects.begin(), _objects.end(), [&](const GameObject::Sptr& obj) {
 			return obj->Name == name;
 		});
-		return it == _objects.end() ? nullptr : *it;
+		if (it == _objects.end()) {
+			return nullptr;
+		}
+		_objectsByName[name] = *it;
+		return *it;
 	}
 
 	GameObject::Sptr Scene::FindObjectByGUID(Guid id) const {
-		auto it = std::find_if(_objects.begin(), _objects.end(), [&](const GameObject::Sptr& obj) {
-			return obj->_guid == id;
-		});
-		return it == _objects.end() ? nullptr : *it;
+		auto it = _objectsByGuid.find(id);
+		return it == _objectsByGuid.end() ? nullptr : it->second.lock();
 	}
 
 	void Scene::SetAmbientLight(const glm::vec3& value) {
@@ -165,18 +248,52 @@ namespace Gameplay {
 		});
 
 		if (IsPlaying) {
-
-			_physicsWorld->stepSimulation(dt, 1);
-
-			_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
-				body->PhysicsPostStep(dt);
-			});
-			_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
-				body->PhysicsPostStep(dt);
-			});
+			double stepStartTime = glfwGetTime();
+			if (_isFixedPhysicsStep) {
+				float step = 1.0f / _physicsStepRate;
+				_physicsAccumulator += dt;
+
+				int numSteps = 0;
+				while (_physicsAccumulator >= step && numSteps < _maxPhysicsSteps) {
+					// Passing 0 substeps makes bullet step by exactly the time we give it
+					_physicsWorld->stepSimulation(step, 0);
+					_PhysicsPostStep(step);
+
+					_physicsAccumulator -= step;
+					numSteps++;
+				}
+
+				// If we could not catch up, drop the extra time rather than falling further behind every frame
+				if (_physicsAccumulator >= step) {
+					_physicsAccumulator = fmodf(_physicsAccumulator, step);
+				}
+
+				// Render bodies part way between the last two steps, so motion is smooth at any frame rate
+				_physicsAlpha = _physicsAccumulator / step;
+				_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
+					body->PhysicsInterpolate(_physicsAlpha);
+				});
+			} else {
+				_physicsWorld->stepSimulation(dt, 1);
+				_PhysicsPostStep(dt);
+			}
+			_lastPhysicsStepTime = static_cast<float>((glfwGetTime() - stepStartTime) * 1000.0);
 		}
 	}
 
+	void Scene::_PhysicsPostStep(float dt) {
+		_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
+			body->PhysicsPostStep(dt);
+		});
+		_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
+			body->PhysicsPostStep(dt);
+		});
+		// Events are only sent once every trigger is up to date, so callbacks can't see a half updated world
+		_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
+			body->DispatchTriggerEvents();
+		});
+	}
+
 	void Scene::DrawPhysicsDebug() {
 		if (_bulletDebugDraw->getDebugMode() != btIDebugDraw::DBG_NoDebug) {
 			_physicsWorld->debugDrawWorld();
@@ -190,6 +307,14 @@ namespace Gameplay {
 			for (int i = 0; i < _objects.size(); i++) {
 				_objects[i]->Update(dt);
 			}
+
+			// Animate everything after behaviours have had a chance to switch or pause their clips
+			_animationSystem.Update(_components, dt);
+
+			// Run everything that was queued this frame in one go, before the world is stepped again
+			_pendingQueries.Execute(_physicsWorld);
+			std::swap(_pendingQueries, _completedQueries);
+			_pendingQueries.Clear();
 		}
 		_FlushDeleteQueue();
 	}
@@ -208,18 +333,29 @@ namespace Gameplay {
 		return _physicsWorld;
 	}
 
-	Scene::Sptr Scene::FromJson(const nlohmann::json& data)
+	Scene::Sptr Scene::FromJson(const nlohmann::json& data, const std::string& filePath)
 	{
 
 		Scene::Sptr result = std::make_shared<Scene>();
+		result->_filePath = filePath;
 		result->MainCamera = nullptr;
 		result->_objects.clear();
+		result->_objectsByGuid.clear();
 		result->DefaultMaterial = ResourceManager::Get<Material>(Guid(data["default_material"]));
 
 		if (data.contains("ambient")) {
 			result->SetAmbientLight((data["ambient"]));
 		}
 
+		if (data.contains("physics") && data["physics"].is_object()) {
+			const nlohmann::json& blob = data["physics"];
+			result->_isFixedPhysicsStep = JsonGet(blob, "fixed_step", result->_isFixedPhysicsStep);
+			result->_physicsStepRate    = JsonGet(blob, "step_rate", result->_physicsStepRate);
+			result->_maxPhysicsSteps    = JsonGet(blob, "max_steps", result->_maxPhysicsSteps);
+			// No objects have been loaded yet, so swapping the world here is cheap
+			result->SetMultithreadedPhysics(JsonGet(blob, "multithreaded", false));
+		}
+
 		if (data.contains("skybox") && data["skybox"].is_object()) {
 			nlohmann::json& blob = data["skybox"].get<nlohmann::json>();
 			result->_skyboxMesh = ResourceManager::Get<MeshResource>(Guid(blob["mesh"]));
@@ -236,6 +372,7 @@ namespace Gameplay {
 			obj->_parent.SceneContext = result.get();
 			obj->_selfRef = obj;
 			result->_objects.push_back(obj);
+			result->_IndexObject(obj);
 		}
 
 		// Re-build the parent hierarchy 
@@ -259,6 +396,13 @@ namespace Gameplay {
 
 		blob["ambient"] = GetAmbientLight();
 
+		blob["physics"] = {
+			{ "fixed_step", _isFixedPhysicsStep },
+			{ "step_rate",  _physicsStepRate },
+			{ "max_steps",  _maxPhysicsSteps },
+			{ "multithreaded", _isMultithreadedPhysics }
+		};
+
 		blob["skybox"] = nlohmann::json();
 		blob["skybox"]["mesh"] = _skyboxMesh ? _skyboxMesh->GetGUID().str() : "null";
 		blob["skybox"]["shader"] = _skyboxShader ? _skyboxShader->GetGUID().str() : "null";
@@ -279,21 +423,344 @@ namespace Gameplay {
 		return blob;
 	}
 
-	void Scene::Save(const std::string& path) {
+	std::vector<uint8_t> Scene::ToSnapshot() const
+	{
+		using namespace SceneSnapshot;
+
+		std::vector<Object>        objects;
+		std::vector<ComponentType> types;
+		std::vector<Component>     components;
+		std::string                strings;
+		std::vector<uint8_t>       blobs;
+
+		// Objects reference their parents and components by index rather than GUID
+		std::unordered_map<const GameObject*, int32_t> objectIndices;
+		std::unordered_map<std::string, uint32_t> typeIndices;
+		for (int ix = 0; ix < _objects.size(); ix++) {
+			objectIndices[_objects[ix].get()] = ix;
+		}
+
+		auto addString = [&](const std::string& value) {
+			StringRef result = { static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size()) };
+			strings += value;
+			return result;
+		};
+
+		objects.reserve(_objects.size());
+		for (const auto& object : _objects) {
+			GameObject::Sptr parent = object->_parent;
+			auto parentIt = parent == nullptr ? objectIndices.end() : objectIndices.find(parent.get());
+
+			Object record;
+			record.Id             = object->_guid;
+			record.Name           = addString(object->Name);
+			record.ParentIndex    = parentIt == objectIndices.end() ? -1 : parentIt->second;
+			record.FirstComponent = static_cast<uint32_t>(components.size());
+			record.NumComponents  = static_cast<uint32_t>(object->_components.size());
+			record.Flags          = object->HideInHierarchy ? ObjectFlags::HideInHierarchy : ObjectFlags::None;
+			record.Position       = object->_position;
+			record.Rotation       = object->_rotation;
+			record.Scale          = object->_scale;
+			objects.push_back(record);
+
+			for (const auto& component : object->_components) {
+				// Look up or register the component's type
+				std::string typeName = component->ComponentTypeName();
+				auto typeIt = typeIndices.find(typeName);
+				if (typeIt == typeIndices.end()) {
+					typeIt = typeIndices.emplace(typeName, static_cast<uint32_t>(types.size())).first;
+					types.push_back({ addString(typeName) });
+				}
+
+				// Component data is stored as CBOR, the GUID and enabled state live in the record itself
+				std::vector<uint8_t> blob = nlohmann::json::to_cbor(component->ToJson());
+
+				Component componentRecord;
+				componentRecord.Id         = component->GetGUID();
+				componentRecord.TypeIndex  = typeIt->second;
+				componentRecord.IsEnabled  = component->IsEnabled ? 1 : 0;
+				componentRecord.BlobOffset = static_cast<uint32_t>(blobs.size());
+				componentRecord.BlobSize   = static_cast<uint32_t>(blob.size());
+				components.push_back(componentRecord);
+				blobs.insert(blobs.end(), blob.begin(), blob.end());
+			}
+		}
+
+		// Sections are laid out back to back, padded to 4 bytes
+		auto align = [](size_t offset) { return static_cast<uint32_t>((offset + 3) & ~(size_t)3); };
+
+		Header header;
+		header.Version              = CURRENT_VERSION;
+		header.NumObjects           = static_cast<uint32_t>(objects.size());
+		header.NumComponentTypes    = static_cast<uint32_t>(types.size());
+		header.NumComponents        = static_cast<uint32_t>(components.size());
+		header.ObjectsOffset        = align(sizeof(Header));
+		header.ComponentTypesOffset = align(header.ObjectsOffset + objects.size() * sizeof(Object));
+		header.ComponentsOffset     = align(header.ComponentTypesOffset + types.size() * sizeof(ComponentType));
+		header.StringsOffset        = align(header.ComponentsOffset + components.size() * sizeof(Component));
+		header.StringsSize          = static_cast<uint32_t>(strings.size());
+		header.BlobsOffset          = align(header.StringsOffset + strings.size());
+		header.BlobsSize            = static_cast<uint32_t>(blobs.size());
+
+		header.DefaultMaterial = DefaultMaterial ? DefaultMaterial->GetGUID() : Guid();
+		header.MainCamera      = MainCamera ? MainCamera->GetGUID() : Guid();
+		header.SkyboxMesh      = _skyboxMesh ? _skyboxMesh->GetGUID() : Guid();
+		header.SkyboxShader    = _skyboxShader ? _skyboxShader->GetGUID() : Guid();
+		header.SkyboxTexture   = _skyboxTexture ? _skyboxTexture->GetGUID() : Guid();
+		header.SkyboxRotation  = glm::quat_cast(_skyboxRotation);
+		header.AmbientLight    = _ambientLight;
+
+		header.IsFixedPhysicsStep     = _isFixedPhysicsStep ? 1 : 0;
+		header.PhysicsStepRate        = _physicsStepRate;
+		header.MaxPhysicsSteps        = _maxPhysicsSteps;
+		header.IsMultithreadedPhysics = _isMultithreadedPhysics ? 1 : 0;
+
+		std::vector<uint8_t> result(header.BlobsOffset + blobs.size(), 0);
+		memcpy(result.data(), &header, sizeof(Header));
+		memcpy(result.data() + header.ObjectsOffset, objects.data(), objects.size() * sizeof(Object));
+		memcpy(result.data() + header.ComponentTypesOffset, types.data(), types.size() * sizeof(ComponentType));
+		memcpy(result.data() + header.ComponentsOffset, components.data(), components.size() * sizeof(Component));
+		memcpy(result.data() + header.StringsOffset, strings.data(), strings.size());
+		memcpy(result.data() + header.BlobsOffset, blobs.data(), blobs.size());
+		return result;
+	}
+
+	Scene::Sptr Scene::FromSnapshot(const uint8_t* data, size_t size, const std::string& filePath)
+	{
+		using namespace SceneSnapshot;
+
+		// Validate the header and make sure all the sections actually fit in the data
+		if (data == nullptr || size < sizeof(Header)) {
+			LOG_ERROR("Scene snapshot is too small to contain a header");
+			return nullptr;
+		}
+		const Header& header = *reinterpret_cast<const Header*>(data);
+		if (memcmp(header.HeaderBytes, Header().HeaderBytes, 4) != 0 || header.Version != CURRENT_VERSION) {
+			LOG_ERROR("Data is not a scene snapshot, or has an unsupported version");
+			return nullptr;
+		}
+		if ((size_t)header.ObjectsOffset + (size_t)header.NumObjects * sizeof(Object) > size ||
+			(size_t)header.ComponentTypesOffset + (size_t)header.NumComponentTypes * sizeof(ComponentType) > size ||
+			(size_t)header.ComponentsOffset + (size_t)header.NumComponents * sizeof(Component) > size ||
+			(size_t)header.StringsOffset + header.StringsSize > size ||
+			(size_t)header.BlobsOffset + header.BlobsSize > size) {
+			LOG_ERROR("Scene snapshot is truncated or corrupt");
+			return nullptr;
+		}
+		// Same rules as SetPhysicsStepRate and SetMaxPhysicsSteps, written so that a NaN step rate also fails
+		if (!(header.PhysicsStepRate > 0.0f) || header.MaxPhysicsSteps <= 0) {
+			LOG_ERROR("Scene snapshot has invalid physics settings (step rate {}, max steps {})", header.PhysicsStepRate, header.MaxPhysicsSteps);
+			return nullptr;
+		}
+
+		const Object*        objects    = reinterpret_cast<const Object*>(data + header.ObjectsOffset);
+		const ComponentType* types      = reinterpret_cast<const ComponentType*>(data + header.ComponentTypesOffset);
+		const Component*     components = reinterpret_cast<const Component*>(data + header.ComponentsOffset);
+		const char*          strings    = reinterpret_cast<const char*>(data + header.StringsOffset);
+		const uint8_t*       blobs      = data + header.BlobsOffset;
+
+		// Check all the references between sections before we start building the scene, so that a corrupt
+		// snapshot is rejected and the caller can fall back to the JSON scene
+		auto isStringValid = [&](const StringRef& ref) {
+			return (size_t)ref.Offset + ref.Length <= header.StringsSize;
+		};
+		for (uint32_t ix = 0; ix < header.NumComponentTypes; ix++) {
+			if (!isStringValid(types[ix].Name)) {
+				LOG_ERROR("Scene snapshot has a component type name outside of the string pool");
+				return nullptr;
+			}
+		}
+		for (uint32_t ix = 0; ix < header.NumObjects; ix++) {
+			if (!isStringValid(objects[ix].Name)) {
+				LOG_ERROR("Scene snapshot has an object name outside of the string pool");
+				return nullptr;
+			}
+			if ((size_t)objects[ix].FirstComponent + objects[ix].NumComponents > header.NumComponents) {
+				LOG_ERROR("Scene snapshot has object components outside of the component table");
+				return nullptr;
+			}
+		}
+		for (uint32_t ix = 0; ix < header.NumComponents; ix++) {
+			if ((size_t)components[ix].BlobOffset + components[ix].BlobSize > header.BlobsSize) {
+				LOG_ERROR("Scene snapshot has component data outside of the blob section");
+				return nullptr;
+			}
+		}
+
+		auto getString = [&](const StringRef& ref) {
+			return std::string(strings + ref.Offset, ref.Length);
+		};
+
+		Scene::Sptr result = std::make_shared<Scene>();
+		result->_filePath = filePath;
+		result->MainCamera = nullptr;
+		result->_objects.clear();
+		result->_objectsByGuid.clear();
+		result->_objectsByGuid.reserve(header.NumObjects);
+
+		Guid defaultMaterial = header.DefaultMaterial.ToGuid();
+		if (defaultMaterial.isValid()) {
+			result->DefaultMaterial = ResourceManager::Get<Material>(defaultMaterial);
+		}
+		result->SetAmbientLight(header.AmbientLight);
+		Guid skyboxMesh = header.SkyboxMesh.ToGuid();
+		Guid skyboxShader = header.SkyboxShader.ToGuid();
+		Guid skyboxTexture = header.SkyboxTexture.ToGuid();
+		if (skyboxMesh.isValid()) {
+			result->_skyboxMesh = ResourceManager::Get<MeshResource>(skyboxMesh);
+		}
+		if (skyboxShader.isValid()) {
+			result->SetSkyboxShader(ResourceManager::Get<ShaderProgram>(skyboxShader));
+		}
+		if (skyboxTexture.isValid()) {
+			result->SetSkyboxTexture(ResourceManager::Get<TextureCube>(skyboxTexture));
+		}
+		result->SetSkyboxRotation(glm::mat3_cast(header.SkyboxRotation));
+
+		result->_isFixedPhysicsStep = header.IsFixedPhysicsStep != 0;
+		result->_physicsStepRate    = header.PhysicsStepRate;
+		result->_maxPhysicsSteps    = header.MaxPhysicsSteps;
+		// No objects have been loaded yet, so swapping the world here is cheap
+		result->SetMultithreadedPhysics(header.IsMultithreadedPhysics != 0);
+
+		// Resolve the component types once, rather than once per component
+		std::vector<std::optional<std::type_index>> componentTypes(header.NumComponentTypes);
+		for (uint32_t ix = 0; ix < header.NumComponentTypes; ix++) {
+			componentTypes[ix] = ComponentManager::GetTypeByName(getString(types[ix].Name));
+			if (!componentTypes[ix].has_value()) {
+				LOG_WARN("Component type \"{}\" has not been registered, components of this type will be skipped", getString(types[ix].Name));
+			}
+		}
+
+		// Allocate and index all the objects up front, so that parents can be linked by index as we go. Parents may
+		// come after their children, so the GUIDs need to be set here for the parent references to capture them
+		result->_objects.reserve(header.NumObjects);
+		for (uint32_t ix = 0; ix < header.NumObjects; ix++) {
+			GameObject::Sptr object(new GameObject());
+			object->_scene = result.get();
+			object->_selfRef = object;
+			object->_guid = objects[ix].Id.ToGuid();
+			result->_objects.push_back(object);
+			result->_IndexObject(object);
+		}
+
+		for (uint32_t ix = 0; ix < header.NumObjects; ix++) {
+			const Object& record = objects[ix];
+			const GameObject::Sptr& object = result->_objects[ix];
+
+			object->Name            = getString(record.Name);
+			object->_position       = record.Position;
+			object->_rotation       = record.Rotation;
+			object->_scale          = record.Scale;
+			object->HideInHierarchy = *(record.Flags & ObjectFlags::HideInHierarchy);
+
+			for (uint32_t componentIx = record.FirstComponent; componentIx < record.FirstComponent + record.NumComponents; componentIx++) {
+				const Component& componentRecord = components[componentIx];
+				if (componentRecord.TypeIndex >= header.NumComponentTypes || !componentTypes[componentRecord.TypeIndex].has_value()) {
+					continue;
+				}
+
+				// The blob ranges have been checked, but the data in them may still be garbage
+				const uint8_t* blobStart = blobs + componentRecord.BlobOffset;
+				nlohmann::json blob;
+				try {
+					blob = nlohmann::json::from_cbor(blobStart, blobStart + componentRecord.BlobSize);
+				}
+				catch (nlohmann::json::exception& e) {
+					LOG_ERROR("Scene snapshot has invalid component data: {}", e.what());
+					return nullptr;
+				}
+
+				IComponent::Sptr component = result->_components.Load(componentTypes[componentRecord.TypeIndex].value(), blob, componentRecord.Id.ToGuid(), componentRecord.IsEnabled != 0);
+				if (component != nullptr) {
+					object->_AttachLoadedComponent(component);
+				}
+			}
+
+			// Parents are referenced by index, so we can link directly without searching
+			if (record.ParentIndex >= 0 && record.ParentIndex < (int32_t)header.NumObjects && record.ParentIndex != (int32_t)ix) {
+				const GameObject::Sptr& parent = result->_objects[record.ParentIndex];
+				object->_parent = parent;
+				parent->_children.push_back(object);
+			}
+		}
+
+		Guid mainCamera = header.MainCamera.ToGuid();
+		if (mainCamera.isValid()) {
+			result->MainCamera = result->_components.GetComponentByGUID<Camera>(mainCamera);
+		}
+
+		return result;
+	}
+
+	void Scene::Save(const std::string& path, SceneFormat formats) {
 		_filePath = path;
+
 		// Save data to file
-		FileHelpers::WriteContentsToFile(path, ToJson().dump(1, '\t'));
-		LOG_INFO("Saved scene to \"{}\"", path);
+		if (*(formats & SceneFormat::Json)) {
+			FileHelpers::WriteContentsToFile(path, ToJson().dump(1, '\t'));
+			LOG_INFO("Saved scene to \"{}\"", path);
+		}
+		if (*(formats & SceneFormat::Binary)) {
+			std::string snapshotPath = GetSnapshotPath(path);
+			std::vector<uint8_t> snapshot = ToSnapshot();
+			std::ofstream file(snapshotPath, std::ios::binary);
+			if (file) {
+				file.write(reinterpret_cast<const char*>(snapshot.data()), snapshot.size());
+				LOG_INFO("Saved scene snapshot to \"{}\" ({} bytes)", snapshotPath, snapshot.size());
+			} else {
+				LOG_ERROR("Failed to open \"{}\" for writing", snapshotPath);
+			}
+		}
 	}
 
 	Scene::Sptr Scene::Load(const std::string& path)
 	{
+		// Prefer the binary snapshot if it's up to date, it's much faster to load
+		std::string snapshotPath = FindSnapshot(path);
+		if (!snapshotPath.empty()) {
+			LOG_INFO("Loading scene snapshot from \"{}\"", snapshotPath);
+			MemoryMappedFile file;
+			Scene::Sptr result = file.Open(snapshotPath) ? FromSnapshot(file.GetData(), file.GetSize(), path) : nullptr;
+			if (result != nullptr || snapshotPath == path) {
+				return result;
+			}
+			LOG_WARN("Failed to load scene snapshot, falling back to \"{}\"", path);
+		}
+
 		LOG_INFO("Loading scene from \"{}\"", path);
+		return FromJson(ReadSceneFile(path), path);
+	}
+
+	std::string Scene::GetSnapshotPath(const std::string& path)
+	{
+		std::filesystem::path result = path;
+		result.replace_extension(".scnb");
+		return result.string();
+	}
+
+	std::string Scene::FindSnapshot(const std::string& path)
+	{
+		std::filesystem::path filePath = path;
+		if (filePath.extension() == ".scnb") {
+			return path;
+		}
+
+		// Only use the snapshot if it's at least as new as the JSON, so hand edits to the JSON are respected
+		std::string snapshotPath = GetSnapshotPath(path);
+		std::error_code error;
+		if (std::filesystem::exists(snapshotPath, error) &&
+			(!std::filesystem::exists(filePath, error) ||
+				std::filesystem::last_write_time(snapshotPath, error) >= std::filesystem::last_write_time(filePath, error))) {
+			return snapshotPath;
+		}
+		return "";
+	}
+
+	nlohmann::json Scene::ReadSceneFile(const std::string& path)
+	{
 		std::string content = FileHelpers::ReadFile(path);
-		nlohmann::json blob = nlohmann::json::parse(content);
-		Scene::Sptr result = FromJson(blob);
-		result->_filePath = path;
-		return result;
+		return nlohmann::json::parse(content);
 	}
 
 	int Scene::NumObjects() const {
@@ -305,46 +772,124 @@ namespace Gameplay {
 	}
 
 	void Scene::_InitPhysics() {
-		_collisionConfig = new btDefaultCollisionConfiguration();
-		_collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
+		if (_isMultithreadedPhysics) {
+			// Bullet's parallel loops will run on the engine's ThreadPool
+			PhysicsTaskScheduler::Install();
+
+			// All threads allocate manifolds and collision algorithms from the same pools, so give them more room
+			btDefaultCollisionConstructionInfo constructionInfo;
+			constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+			constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+			_collisionConfig = new btDefaultCollisionConfiguration(constructionInfo);
+			_collisionDispatcher = new btCollisionDispatcherMt(_collisionConfig, 40);
+		} else {
+			_collisionConfig = new btDefaultCollisionConfiguration();
+			_collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
+		}
 		_broadphaseInterface = new btDbvtBroadphase();
 		_ghostCallback = new btGhostPairCallback();
 		_broadphaseInterface->getOverlappingPairCache()->setInternalGhostPairCallback(_ghostCallback);
-		_constraintSolver = new btSequentialImpulseConstraintSolver();
-		_physicsWorld = new btDiscreteDynamicsWorld(
-			_collisionDispatcher,
-			_broadphaseInterface,
-			_constraintSolver,
-			_collisionConfig
-		);
+		if (_isMultithreadedPhysics) {
+			// Islands are solved in parallel with one solver per thread, large islands are split up by the Mt solver
+			_constraintSolverPool = new btConstraintSolverPoolMt(PhysicsTaskScheduler::Get()->getNumThreads());
+			_constraintSolver = new btSequentialImpulseConstraintSolverMt();
+			_physicsWorld = new btDiscreteDynamicsWorldMt(
+				_collisionDispatcher,
+				_broadphaseInterface,
+				_constraintSolverPool,
+				_constraintSolver,
+				_collisionConfig
+			);
+		} else {
+			_constraintSolver = new btSequentialImpulseConstraintSolver();
+			_physicsWorld = new btDiscreteDynamicsWorld(
+				_collisionDispatcher,
+				_broadphaseInterface,
+				_constraintSolver,
+				_collisionConfig
+			);
+		}
 		_physicsWorld->setGravity(ToBt(_gravity));
-		// TODO bullet debug drawing
-		_bulletDebugDraw = new BulletDebugDraw();
+		// The debug drawer outlives the world, so that rebuilding the world keeps the debug mode
+		if (_bulletDebugDraw == nullptr) {
+			_bulletDebugDraw = new BulletDebugDraw();
+			_bulletDebugDraw->setDebugMode(btIDebugDraw::DBG_NoDebug);
+		}
 		_physicsWorld->setDebugDrawer(_bulletDebugDraw);
-		_bulletDebugDraw->setDebugMode(btIDebugDraw::DBG_NoDebug);
 	}
 
 	void Scene::_CleanupPhysics() {
 		delete _physicsWorld;
 		delete _constraintSolver;
+		delete _constraintSolverPool;
 		delete _broadphaseInterface;
 		delete _ghostCallback;
 		delete _collisionDispatcher;
 		delete _collisionConfig;
+		_constraintSolverPool = nullptr;
+	}
+
+	void Scene::_RebuildPhysicsWorld() {
+		// Pull everything out of the old world, remembering it's filtering so it can be re-added as-is
+		struct CollisionObjectEntry {
+			btCollisionObject* Object;
+			int                Group;
+			int                Mask;
+		};
+		std::vector<CollisionObjectEntry> objects;
+		btCollisionObjectArray& worldObjects = _physicsWorld->getCollisionObjectArray();
+		objects.reserve(worldObjects.size());
+
+		// Removing from the back keeps the array from shuffling as we go
+		for (int ix = worldObjects.size() - 1; ix >= 0; ix--) {
+			btCollisionObject* object = worldObjects[ix];
+			btBroadphaseProxy* proxy = object->getBroadphaseHandle();
+			objects.push_back({ object, proxy->m_collisionFilterGroup, proxy->m_collisionFilterMask });
+
+			btRigidBody* body = btRigidBody::upcast(object);
+			if (body != nullptr) {
+				_physicsWorld->removeRigidBody(body);
+			} else {
+				_physicsWorld->removeCollisionObject(object);
+			}
+		}
+
+		_CleanupPhysics();
+		_InitPhysics();
+
+		for (auto it = objects.rbegin(); it != objects.rend(); it++) {
+			btRigidBody* body = btRigidBody::upcast(it->Object);
+			if (body != nullptr) {
+				_physicsWorld->addRigidBody(body, it->Group, it->Mask);
+			} else {
+				_physicsWorld->addCollisionObject(it->Object, it->Group, it->Mask);
+			}
+		}
 	}
 
 
 	void Scene::_FlushDeleteQueue() {
 		for (auto& weakPtr : _deletionQueue) {
 			if (weakPtr.expired()) continue;
-			auto& it = std::find(_objects.begin(), _objects.end(), weakPtr.lock());
+			GameObject::Sptr object = weakPtr.lock();
+			auto& it = std::find(_objects.begin(), _objects.end(), object);
 			if (it != _objects.end()) {
 				_objects.erase(it);
+
+				// Only remove the index entry if it still points at this object
+				auto indexIt = _objectsByGuid.find(object->_guid);
+				if (indexIt != _objectsByGuid.end() && indexIt->second.lock() == object) {
+					_objectsByGuid.erase(indexIt);
+				}
 			}
 		}
 		_deletionQueue.clear();
 	}
 
+	void Scene::_IndexObject(const GameObject::Sptr& object) {
+		_objectsByGuid[object->_guid] = object;
+	}
+
 	void Scene::DrawAllGameObjectGUIs()
 	{
 		for (auto& object : _objects) {
@@ -373,8 +918,10 @@ namespace Gameplay {
 			glDepthFunc(GL_LEQUAL); 
 
 			_skyboxShader->Bind();
-			_skyboxShader->SetUniformMatrix("u_ClippedView", MainCamera->GetProjection());
-			_skyboxShader->SetUniformMatrix("u_EnvironmentRotation", _skyboxRotation * glm::inverse(glm::mat3(MainCamera->GetView())));
+			_skyboxClippedViewUniform.Resolve(_skyboxShader);
+			_skyboxRotationUniform.Resolve(_skyboxShader);
+			_skyboxClippedViewUniform.Set(MainCamera->GetProjection());
+			_skyboxRotationUniform.Set(_skyboxRotation * glm::inverse(glm::mat3(MainCamera->GetView())));
 			_skyboxTexture->Bind(0);
 			_skyboxMesh->Mesh->Draw();
 
@@ -6,12 +6,29 @@
 #include "Gameplay/GameObject.h"
 
 #include "Physics/BulletDebugDraw.h"
+#include "Physics/PhysicsQueries.h"
+#include "Gameplay/AnimationSystem.h"
+
+class btConstraintSolverPoolMt;
 
 #include "Graphics/Buffers/UniformBuffer.h"
 #include "Graphics/Textures/Texture3D.h"
+#include "Graphics/UniformHandle.h"
 
 struct GLFWwindow;
 
+/// <summary>
+/// The file formats that a scene can be saved in
+/// </summary>
+ENUM_FLAGS(SceneFormat, uint8_t,
+	None   = 0,
+	// Human readable JSON, used for editing and version control
+	Json   = 1 << 0,
+	// Binary snapshot (.scnb), used for fast loading
+	Binary = 1 << 1,
+	Both   = 3
+);
+
 class TextureCube;
 class ShaderProgram;
 
@@ -52,6 +69,67 @@ namespace Gameplay {
 		void SetPhysicsDebugDrawMode(BulletDebugMode mode);
 		BulletDebugMode GetPhysicsDebugDrawMode() const;
 
+		/// <summary>
+		/// Sets the global gravity applied to all dynamic bodies in the scene, in m/s^2
+		/// </summary>
+		void SetGravity(const glm::vec3& value);
+		const glm::vec3& GetGravity() const;
+
+		/// <summary>
+		/// Sets whether physics is stepped at a fixed rate (default false). When enabled, frame time is
+		/// accumulated and the world is stepped in fixed increments, with rigid bodies rendered at a
+		/// position interpolated between the last two steps
+		/// </summary>
+		void SetFixedPhysicsStep(bool enabled);
+		bool GetFixedPhysicsStep() const;
+		/// <summary>
+		/// Sets the number of fixed physics steps to take per second, default 60
+		/// </summary>
+		void SetPhysicsStepRate(float stepsPerSecond);
+		float GetPhysicsStepRate() const;
+		/// <summary>
+		/// Sets the maximum number of fixed steps that can be taken in a single frame to catch up after
+		/// a long frame, default 4. Any time beyond this is dropped
+		/// </summary>
+		void SetMaxPhysicsSteps(int value);
+		int GetMaxPhysicsSteps() const;
+		/// <summary>
+		/// Gets how far we are between the last fixed physics step and the next one, in the 0-1 range
+		/// </summary>
+		float GetPhysicsInterpolation() const { return _physicsAlpha; }
+		/// <summary>
+		/// Sets whether the scene uses bullet's multithreaded dynamics world (default false), which
+		/// spreads collision detection and island solving across the engine's ThreadPool. Changing
+		/// this rebuilds the physics world, moving any existing bodies into the new one
+		/// </summary>
+		void SetMultithreadedPhysics(bool enabled);
+		bool GetMultithreadedPhysics() const;
+		/// <summary>
+		/// Gets the time spent stepping the physics world during the last frame, in milliseconds
+		/// </summary>
+		float GetLastPhysicsStepTime() const { return _lastPhysicsStepTime; }
+
+		/// <summary>
+		/// Gets the scene's shared query batch. Components can add queries to it during Update, and
+		/// all of them are executed together at the end of the scene's update. The results can be
+		/// read from GetCompletedPhysicsQueries during the next update, using the same handles
+		/// </summary>
+		Physics::PhysicsQueries& GetPhysicsQueries() { return _pendingQueries; }
+		/// <summary>
+		/// Gets the query batch that was executed at the end of the last update
+		/// </summary>
+		const Physics::PhysicsQueries& GetCompletedPhysicsQueries() const { return _completedQueries; }
+
+		/// <summary>
+		/// Gets the system that plays back the interpolation behaviours in this scene
+		/// </summary>
+		AnimationSystem& GetAnimationSystem() { return _animationSystem; }
+		/// <summary>
+		/// Immediately runs a batch of queries against the physics world. Must not be called while
+		/// the world is being stepped
+		/// </summary>
+		void ExecutePhysicsQueries(Physics::PhysicsQueries& queries) const;
+
 		void SetSkyboxShader(const std::shared_ptr<ShaderProgram>& shader);
 		std::shared_ptr<ShaderProgram> GetSkyboxShader() const;
 
@@ -162,7 +240,9 @@ namespace Gameplay {
 		/// <summary>
 		/// Loads a scene from a JSON blob
 		/// </summary>
-		static Scene::Sptr FromJson(const nlohmann::json& data);
+		/// <param name="data">The JSON blob to load the scene from</param>
+		/// <param name="filePath">The path that the blob was read from, if any</param>
+		static Scene::Sptr FromJson(const nlohmann::json& data, const std::string& filePath = "");
 		/// <summary>
 		/// Converts this object into it's JSON representation for storage
 		/// </summary>
@@ -172,16 +252,50 @@ namespace Gameplay {
 		const ComponentManager& Components() const { return _components; }
 
 		/// <summary>
-		/// Saves this scene to an output JSON file
+		/// Converts this scene into a binary snapshot, see SceneSnapshot.h for the layout
+		/// </summary>
+		std::vector<uint8_t> ToSnapshot() const;
+		/// <summary>
+		/// Loads a scene from a binary snapshot in memory
 		/// </summary>
-		/// <param name="path">The path of the file to write to</param>
-		void Save(const std::string& path);
+		/// <param name="data">A pointer to the start of the snapshot</param>
+		/// <param name="size">The size of the snapshot in bytes</param>
+		/// <param name="filePath">The path that the snapshot was read from, if any</param>
+		/// <returns>The new scene, or nullptr if the snapshot was invalid</returns>
+		static Scene::Sptr FromSnapshot(const uint8_t* data, size_t size, const std::string& filePath = "");
+
 		/// <summary>
-		/// Loads a scene from an input JSON file
+		/// Saves this scene to an output file
+		/// </summary>
+		/// <param name="path">The path of the file to write to, binary snapshots will be written next to it with a .scnb extension</param>
+		/// <param name="formats">The formats to save the scene in, default JSON</param>
+		void Save(const std::string& path, SceneFormat formats = SceneFormat::Json);
+		/// <summary>
+		/// Loads a scene from an input JSON file or binary snapshot. If an up to date snapshot
+		/// exists next to a JSON file, the snapshot will be loaded instead
 		/// </summary>
 		/// <param name="path">The path of the file to read from</param>
 		/// <returns>A new scene loaded from the file</returns>
 		static Scene::Sptr Load(const std::string& path);
+		/// <summary>
+		/// Gets the path that the binary snapshot for a scene file will be saved to
+		/// </summary>
+		/// <param name="path">The path of the scene file</param>
+		static std::string GetSnapshotPath(const std::string& path);
+		/// <summary>
+		/// Gets the path of the binary snapshot that should be used to load the given scene file,
+		/// or an empty string if the scene should be loaded from JSON (ex: the snapshot is missing
+		/// or older than the JSON file)
+		/// </summary>
+		/// <param name="path">The path of the scene file</param>
+		static std::string FindSnapshot(const std::string& path);
+		/// <summary>
+		/// Reads and parses a scene file without constructing the scene. This does not touch
+		/// OpenGL or the resource manager, so is safe to invoke from a worker thread
+		/// </summary>
+		/// <param name="path">The path of the file to read from</param>
+		/// <returns>The parsed JSON blob for the scene, pass to FromJson to construct it</returns>
+		static nlohmann::json ReadSceneFile(const std::string& path);
 
 
 		int NumObjects() const;
@@ -204,6 +318,8 @@ namespace Gameplay {
 		btBroadphaseInterface*    _broadphaseInterface;
 		// Resolves contraints (ex: hinge constraints, angle axis, etc...)
 		btConstraintSolver*       _constraintSolver;
+		// Per-thread solvers used by the multithreaded world, nullptr when single threaded
+		btConstraintSolverPoolMt* _constraintSolverPool;
 		// this is what allows us to get our pairs from the trigger volumes
 		btGhostPairCallback*      _ghostCallback;
 
@@ -215,12 +331,35 @@ namespace Gameplay {
 		// Our physics scene's global gravity, default matches earth's gravity (m/s^2)
 		glm::vec3 _gravity;
 
+		// Fixed timestep settings, and the frame time that has not been simulated yet
+		bool  _isFixedPhysicsStep;
+		float _physicsStepRate;
+		int   _maxPhysicsSteps;
+		float _physicsAccumulator;
+		float _physicsAlpha;
+
+		bool  _isMultithreadedPhysics;
+		float _lastPhysicsStepTime;
+
+		// Queries being collected this frame, and the results of the last frame's queries
+		Physics::PhysicsQueries _pendingQueries;
+		Physics::PhysicsQueries _completedQueries;
+
+		AnimationSystem _animationSystem;
+
 		// Stores all the objects in our scene
 		std::vector<GameObject::Sptr>  _objects;
 		std::vector<std::weak_ptr<GameObject>>  _deletionQueue;
 
+		// Lookup tables for finding objects, kept in sync with _objects
+		std::unordered_map<Guid, GameObject::Wptr> _objectsByGuid;
+		// Names can be changed at any time, so this is only a cache that is validated on lookup
+		mutable std::unordered_map<std::string, GameObject::Wptr> _objectsByName;
+
 		// Info for rendering our skybox will be stored in the scene itself
 		std::shared_ptr<ShaderProgram>       _skyboxShader;
+		UniformHandle<glm::mat4>             _skyboxClippedViewUniform = "u_ClippedView";
+		UniformHandle<glm::mat3>             _skyboxRotationUniform = "u_EnvironmentRotation";
 		std::shared_ptr<MeshResource> _skyboxMesh;
 		std::shared_ptr<TextureCube>  _skyboxTexture;
 		glm::mat3                     _skyboxRotation;
@@ -240,7 +379,22 @@ namespace Gameplay {
 		/// Handles cleaning up bullet physics for this scene
 		/// </summary>
 		void _CleanupPhysics();
+		/// <summary>
+		/// Destroys and re-creates the physics world, moving all collision objects into the new world
+		/// </summary>
+		void _RebuildPhysicsWorld();
 
 		void _FlushDeleteQueue();
+
+		/// <summary>
+		/// Copies results out of the physics world after a step
+		/// </summary>
+		void _PhysicsPostStep(float dt);
+
+		/// <summary>
+		/// Adds an object to the scene's lookup tables, should be called whenever an object
+		/// is added to _objects or it's GUID changes
+		/// </summary>
+		void _IndexObject(const GameObject::Sptr& object);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <EnumToString.h>
+#include <GLM/glm.hpp>
+#include <GLM/gtc/quaternion.hpp>
+#include "Utils/GUID.hpp"
+
+namespace Gameplay {
+	/// <summary>
+	/// Describes the layout of our binary scene snapshot format (.scnb files)
+	///
+	/// A snapshot is a header followed by flat tables of fixed size records, which can be
+	/// read in place from a memory mapped file:
+	///		- Objects, one per game object, in scene order
+	///		- Component types, the type names used by the components in this file
+	///		- Components, grouped by object, referencing their type by index
+	///		- A string pool containing all object and type names
+	///		- A blob section containing the serialized (CBOR) data for each component
+	///
+	/// All offsets are in bytes from the start of the file, and all sections are 4 byte aligned
+	/// </summary>
+	namespace SceneSnapshot {
+		/// <summary>
+		/// A GUID stored as it's raw 16 bytes
+		/// </summary>
+		struct GuidKey {
+			uint8_t Bytes[16];
+
+			GuidKey() : Bytes() {}
+			GuidKey(const Guid& guid) { memcpy(Bytes, guid.bytes(), 16); }
+
+			Guid ToGuid() const {
+				uint8_t data[16];
+				memcpy(data, Bytes, 16);
+				return Guid::FromBytes(data);
+			}
+		};
+
+		/// <summary>
+		/// References a string in the string pool, strings are NOT null terminated
+		/// </summary>
+		struct StringRef {
+			uint32_t Offset;
+			uint32_t Length;
+		};
+
+		// The version written by Scene::ToSnapshot, older snapshots are rejected so the JSON is loaded instead
+		// Version 2 added the physics settings to the header
+		static const uint32_t CURRENT_VERSION = 0x02;
+
+		// Will be put at the start of the file, contains info about the contents of the file
+		struct Header {
+			// A check value so we can ensure that we're loading in the right file type
+			char      HeaderBytes[4] ={ 'S', 'C', 'N', 'B' };
+			// The version code, we can use this to create different loaders if our format changes
+			uint32_t  Version = 0;
+
+			uint32_t  NumObjects = 0;
+			uint32_t  NumComponentTypes = 0;
+			uint32_t  NumComponents = 0;
+
+			uint32_t  ObjectsOffset = 0;
+			uint32_t  ComponentTypesOffset = 0;
+			uint32_t  ComponentsOffset = 0;
+			uint32_t  StringsOffset = 0;
+			uint32_t  StringsSize = 0;
+			uint32_t  BlobsOffset = 0;
+			uint32_t  BlobsSize = 0;
+
+			// Scene level settings, invalid (all zero) GUIDs represent null references
+			GuidKey   DefaultMaterial;
+			GuidKey   MainCamera;
+			GuidKey   SkyboxMesh;
+			GuidKey   SkyboxShader;
+			GuidKey   SkyboxTexture;
+			glm::quat SkyboxRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+			glm::vec3 AmbientLight = glm::vec3(0.0f);
+
+			// Physics settings, stored as 32 bit values to keep the header 4 byte aligned
+			uint32_t  IsFixedPhysicsStep = 0;
+			float     PhysicsStepRate = 60.0f;
+			int32_t   MaxPhysicsSteps = 4;
+			uint32_t  IsMultithreadedPhysics = 0;
+		};
+
+		ENUM_FLAGS(ObjectFlags, uint32_t,
+			None            = 0,
+			HideInHierarchy = 1 << 0
+		);
+
+		// A single game object
+		struct Object {
+			GuidKey     Id;
+			StringRef   Name;
+			// Index of the parent object in the object table, or -1 for root objects
+			int32_t     ParentIndex;
+			// The range of this object's components in the component table
+			uint32_t    FirstComponent;
+			uint32_t    NumComponents;
+			ObjectFlags Flags;
+			glm::vec3   Position;
+			glm::quat   Rotation;
+			glm::vec3   Scale;
+		};
+
+		// A component type, resolved to a registered type once when loading
+		struct ComponentType {
+			StringRef Name;
+		};
+
+		// A single component attached to an object
+		struct Component {
+			GuidKey  Id;
+			// Index into the component type table
+			uint32_t TypeIndex;
+			uint32_t IsEnabled;
+			// The range in the blob section containing the component's data
+			uint32_t BlobOffset;
+			uint32_t BlobSize;
+		};
+
+		static_assert(sizeof(Header) % 4 == 0 && sizeof(Object) % 4 == 0 && sizeof(Component) % 4 == 0, "Snapshot records must be 4 byte aligned");
+	}
+}
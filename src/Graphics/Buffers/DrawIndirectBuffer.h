@@ -0,0 +1,33 @@
+#pragma once
+#include "IBuffer.h"
+#include <cstdint>
+#include <memory>
+
+/// <summary>
+/// Matches the layout that glMultiDrawElementsIndirect expects for each command
+/// </summary>
+/// <see>https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glMultiDrawElementsIndirect.xhtml</see>
+struct DrawElementsIndirectCommand {
+	uint32_t Count;
+	uint32_t InstanceCount;
+	uint32_t FirstIndex;
+	int32_t  BaseVertex;
+	uint32_t BaseInstance;
+};
+
+/// <summary>
+/// A buffer of indirect draw commands, which lets us submit many draws with a single call
+/// </summary>
+class DrawIndirectBuffer : public IBuffer
+{
+public:
+	typedef std::shared_ptr<DrawIndirectBuffer> Sptr;
+
+	static inline Sptr Create(BufferUsage usage = BufferUsage::DynamicDraw) {
+		return std::make_shared<DrawIndirectBuffer>(usage);
+	}
+
+	DrawIndirectBuffer(BufferUsage usage = BufferUsage::DynamicDraw) : IBuffer(BufferType::DrawIndirect, usage) { }
+
+	static void UnBind() { IBuffer::UnBind(BufferType::DrawIndirect); }
+};
@@ -52,6 +52,17 @@ public:
 	/// <param name="allowResize">True if resizing the buffer is allowed, otherwise an assertion is thrown for oversized writes</param>
 	virtual void UpdateData(const void* data, uint32_t elementSize, uint32_t elementCount, bool allowResize = true);
 
+	/// <summary>
+	/// Allocates immutable storage for this buffer using glNamedBufferStorage, which is required
+	/// for persistently mapped buffers. The buffer cannot be resized with LoadData or UpdateData
+	/// after this has been called, a new buffer should be created instead
+	/// </summary>
+	/// <param name="data">The initial data for the buffer, or nullptr to leave it uninitialized</param>
+	/// <param name="elementSize">The size of a single element, in bytes</param>
+	/// <param name="elementCount">The number of elements to allocate</param>
+	/// <param name="flags">The access that will be allowed when mapping the buffer</param>
+	void LoadStorage(const void* data, uint32_t elementSize, uint32_t elementCount, BufferMapMode flags);
+
 	/// <summary>
 	/// Loads an array of data into this buffer, using the bindless method glNamedBufferData
 	/// </summary>
@@ -134,4 +145,5 @@ protected:
 	uint32_t _size; // The size of the buffer in bytes
 	BufferUsage _usage; // The buffer usage mode (GL_STATIC_DRAW, GL_DYNAMIC_DRAW)
 	BufferType _type; // The buffer type (ex GL_ARRAY_BUFFER, GL_ARRAY_ELEMENT_BUFFER)
+	bool _isImmutable; // True if the storage was allocated with LoadStorage
 };
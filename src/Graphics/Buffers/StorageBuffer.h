@@ -0,0 +1,21 @@
+#pragma once
+#include "IBuffer.h"
+#include <memory>
+
+/// <summary>
+/// A shader storage buffer (SSBO), used for large arrays of data that are indexed by shaders,
+/// such as per-draw transforms or material tables
+/// </summary>
+class StorageBuffer : public IBuffer
+{
+public:
+	typedef std::shared_ptr<StorageBuffer> Sptr;
+
+	static inline Sptr Create(BufferUsage usage = BufferUsage::DynamicDraw) {
+		return std::make_shared<StorageBuffer>(usage);
+	}
+
+	StorageBuffer(BufferUsage usage = BufferUsage::DynamicDraw) : IBuffer(BufferType::ShaderStorage, usage) { }
+
+	static void UnBind(uint32_t slot) { IBuffer::UnBind(BufferType::ShaderStorage, slot); }
+};
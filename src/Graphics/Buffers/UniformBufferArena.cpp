@@ -0,0 +1,119 @@
+#include "UniformBufferArena.h"
+#include "Logging.h"
+#include <algorithm>
+
+UniformBufferArena::UniformBufferArena(uint32_t initialSize, BufferUsage usage) :
+	IBuffer(BufferType::Uniform, usage),
+	_freeRanges(),
+	_alignment(256)
+{
+	GLint alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	if (alignment > 0) {
+		_alignment = static_cast<uint32_t>(alignment);
+	}
+
+	// Round our size up to the alignment and allocate the storage
+	_size = ((std::max(initialSize, _alignment) + _alignment - 1) / _alignment) * _alignment;
+	glNamedBufferData(_rendererId, _size, nullptr, (GLenum)_usage);
+	_elementSize = 1;
+	_elementCount = _size;
+
+	_freeRanges.push_back({ 0, _size });
+}
+
+UniformBufferArena::~UniformBufferArena() = default;
+
+uint32_t UniformBufferArena::Allocate(uint32_t size) {
+	if (size == 0) {
+		return InvalidOffset;
+	}
+	uint32_t alignedSize = ((size + _alignment - 1) / _alignment) * _alignment;
+
+	// First fit, since the ranges are all multiples of the alignment we don't need to worry about padding
+	auto it = std::find_if(_freeRanges.begin(), _freeRanges.end(), [&](const FreeRange& range) {
+		return range.Size >= alignedSize;
+	});
+	if (it == _freeRanges.end()) {
+		_Grow(alignedSize);
+		it = std::find_if(_freeRanges.begin(), _freeRanges.end(), [&](const FreeRange& range) {
+			return range.Size >= alignedSize;
+		});
+		LOG_ASSERT(it != _freeRanges.end(), "Failed to grow uniform buffer arena");
+	}
+
+	uint32_t result = it->Offset;
+	it->Offset += alignedSize;
+	it->Size   -= alignedSize;
+	if (it->Size == 0) {
+		_freeRanges.erase(it);
+	}
+	return result;
+}
+
+void UniformBufferArena::Free(uint32_t offset, uint32_t size) {
+	if (offset == InvalidOffset || size == 0) {
+		return;
+	}
+	uint32_t alignedSize = ((size + _alignment - 1) / _alignment) * _alignment;
+
+	// Insert the range in sorted order, then merge with our neighbours
+	auto it = std::lower_bound(_freeRanges.begin(), _freeRanges.end(), offset, [](const FreeRange& range, uint32_t value) {
+		return range.Offset < value;
+	});
+	it = _freeRanges.insert(it, { offset, alignedSize });
+
+	auto next = it + 1;
+	if (next != _freeRanges.end() && it->Offset + it->Size == next->Offset) {
+		it->Size += next->Size;
+		_freeRanges.erase(next);
+	}
+	if (it != _freeRanges.begin()) {
+		auto prev = it - 1;
+		if (prev->Offset + prev->Size == it->Offset) {
+			prev->Size += it->Size;
+			_freeRanges.erase(it);
+		}
+	}
+}
+
+void UniformBufferArena::Upload(uint32_t offset, const void* data, uint32_t size) {
+	LOG_ASSERT(offset + size <= _size, "Write exceeds the bounds of the uniform buffer arena");
+	glNamedBufferSubData(_rendererId, offset, size, data);
+}
+
+void UniformBufferArena::BindRange(int slot, uint32_t offset, uint32_t size) const {
+	glBindBufferRange(GL_UNIFORM_BUFFER, slot, _rendererId, offset, size);
+}
+
+void UniformBufferArena::_Grow(uint32_t minAdditional) {
+	uint32_t newSize = std::max(_size * 2, _size + minAdditional);
+
+	// Create the new storage and copy our existing contents across
+	GLuint newBuffer = 0;
+	glCreateBuffers(1, &newBuffer);
+	glNamedBufferData(newBuffer, newSize, nullptr, (GLenum)_usage);
+	glCopyNamedBufferSubData(_rendererId, newBuffer, 0, 0, _size);
+	glDeleteBuffers(1, &_rendererId);
+	_SetRenderId(newBuffer);
+
+	// The new space is free, merging it with the last free range if it touches the old end
+	if (!_freeRanges.empty() && _freeRanges.back().Offset + _freeRanges.back().Size == _size) {
+		_freeRanges.back().Size += newSize - _size;
+	} else {
+		_freeRanges.push_back({ _size, newSize - _size });
+	}
+
+	LOG_INFO("Expanding uniform buffer arena from {} bytes to {} bytes", _size, newSize);
+	_size = newSize;
+	_elementCount = _size;
+}
+
+UniformBufferArena::Sptr UniformBufferArena::GetMaterialArena() {
+	static UniformBufferArena::Sptr arena = nullptr;
+	if (arena == nullptr) {
+		arena = std::make_shared<UniformBufferArena>();
+		arena->SetDebugName("Material Arena");
+	}
+	return arena;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "IBuffer.h"
+#include <vector>
+#include <memory>
+
+/// <summary>
+/// A single large uniform buffer that hands out aligned sub-ranges, so that many small
+/// blocks of uniform data (such as material parameters) can live in one buffer object
+/// and be bound with glBindBufferRange instead of switching buffers
+///
+/// Offsets returned by Allocate remain valid if the arena grows, but the underlying
+/// buffer handle may change, so GetHandle should be queried when binding
+/// </summary>
+class UniformBufferArena final : public IBuffer {
+public:
+	DEFINE_RESOURCE(UniformBufferArena);
+
+	/// <summary>
+	/// Value returned by Allocate when the allocation fails
+	/// </summary>
+	static const uint32_t InvalidOffset = 0xFFFFFFFF;
+
+	/// <summary>
+	/// Creates a new arena with the given initial capacity
+	/// </summary>
+	/// <param name="initialSize">The initial size of the arena in bytes, it will grow as needed</param>
+	/// <param name="usage">The usage hint for the buffer</param>
+	UniformBufferArena(uint32_t initialSize = 64 * 1024, BufferUsage usage = BufferUsage::DynamicDraw);
+	virtual ~UniformBufferArena();
+
+	/// <summary>
+	/// Allocates a range of the arena, aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+	/// </summary>
+	/// <param name="size">The size of the range in bytes</param>
+	/// <returns>The offset of the range in the arena</returns>
+	uint32_t Allocate(uint32_t size);
+	/// <summary>
+	/// Returns a range to the arena
+	/// </summary>
+	/// <param name="offset">The offset returned by Allocate</param>
+	/// <param name="size">The size that was passed to Allocate</param>
+	void Free(uint32_t offset, uint32_t size);
+
+	/// <summary>
+	/// Uploads data to a range of the arena
+	/// </summary>
+	/// <param name="offset">The offset in bytes to write to</param>
+	/// <param name="data">The data to upload</param>
+	/// <param name="size">The size of the data in bytes</param>
+	void Upload(uint32_t offset, const void* data, uint32_t size);
+
+	/// <summary>
+	/// Binds a range of the arena to a uniform buffer binding slot
+	/// </summary>
+	/// <param name="slot">The binding slot to bind to</param>
+	/// <param name="offset">The offset of the range, as returned by Allocate</param>
+	/// <param name="size">The size of the range in bytes</param>
+	void BindRange(int slot, uint32_t offset, uint32_t size) const;
+
+	/// <summary>
+	/// Gets the alignment that all allocations are rounded to
+	/// </summary>
+	uint32_t GetAlignment() const { return _alignment; }
+
+	/// <summary>
+	/// Gets the shared arena used for material parameter blocks
+	/// </summary>
+	static UniformBufferArena::Sptr GetMaterialArena();
+
+protected:
+	// A range of unused space in the arena, kept sorted by offset
+	struct FreeRange {
+		uint32_t Offset;
+		uint32_t Size;
+	};
+	std::vector<FreeRange> _freeRanges;
+	uint32_t _alignment;
+
+	/// <summary>
+	/// Grows the arena so that it can fit an allocation of the given size, copying over existing contents
+	/// </summary>
+	void _Grow(uint32_t minAdditional);
+};
@@ -1,24 +1,37 @@
 #include "Graphics/DebugDraw.h"
 
+// Vertices are written directly into mapped memory, and are never read back by the CPU
+static const BufferMapMode DEBUG_MAP_FLAGS = BufferMapMode::Write | BufferMapMode::Persistent | BufferMapMode::Coherent;
+
 DebugDrawer::DebugDrawer() :
 	_colorStack(std::stack<glm::vec3>()),
 	_transformStack(std::stack<glm::mat4>()),
+	_depthTestStack(std::stack<bool>()),
 	_viewProjection(glm::mat4(1.0f)),
-	_lineOffset(0),
-	_triangleOffset(0)
+	_worldMatrix(glm::mat4(1.0f)),
+	_isWorldIdentity(true),
+	_vbo(nullptr),
+	_vao(nullptr),
+	_vboBinding(nullptr),
+	_mappedData(nullptr),
+	_regionCapacity(0),
+	_currentRegion(0),
+	_regionFences()
 {
-	_linesVBO = VertexBuffer::Create(BufferUsage::DynamicDraw);
-	_linesVBO->LoadData<VertexPosCol>(nullptr, LINE_BATCH_SIZE * 2);
-	_linesVAO = VertexArrayObject::Create();
-	_linesVAO->AddVertexBuffer(_linesVBO, VertexPosCol::V_DECL);
-
-	_trisVBO = VertexBuffer::Create(BufferUsage::DynamicDraw);
-	_trisVBO->LoadData<VertexPosCol>(nullptr, TRI_BATCH_SIZE * 3);
-	_trisVAO = VertexArrayObject::Create();
-	_trisVAO->AddVertexBuffer(_trisVBO, VertexPosCol::V_DECL);
+	_vao = VertexArrayObject::Create();
+	_ReserveVertices(INITIAL_VERTEX_CAPACITY);
 
 	_colorStack.push(glm::vec3(1.0f));
 	_transformStack.push(glm::mat4(1.0f));
+	_depthTestStack.push(true);
+}
+
+DebugDrawer::~DebugDrawer() {
+	for (uint32_t ix = 0; ix < FRAME_REGIONS; ix++) {
+		if (_regionFences[ix] != nullptr) {
+			glDeleteSync(_regionFences[ix]);
+		}
+	}
 }
 
 void DebugDrawer::PushColor(const glm::vec3& color) {
@@ -33,15 +46,27 @@ glm::vec3 DebugDrawer::PopColor() {
 }
 
 void DebugDrawer::PushWorldMatrix(const glm::mat4& value) {
-	FlushAll();
 	_transformStack.push(value);
+	_worldMatrix = value;
+	_isWorldIdentity = value == glm::mat4(1.0f);
 }
 
 void DebugDrawer::PopWorldMatrix() {
 	LOG_ASSERT(_transformStack.size() > 1, "Attempting to pop more transforms than you are pushing! Check your code!");
-	FlushAll();
 	_transformStack.pop();
+	_worldMatrix = _transformStack.top();
+	_isWorldIdentity = _worldMatrix == glm::mat4(1.0f);
+}
+
+void DebugDrawer::PushDepthTest(bool enabled) {
+	_depthTestStack.push(enabled);
+}
 
+bool DebugDrawer::PopDepthTest() {
+	LOG_ASSERT(_depthTestStack.size() > 1, "Attempting to pop more depth modes than you are pushing! Check your code!");
+	bool result = _depthTestStack.top();
+	_depthTestStack.pop();
+	return result;
 }
 
 void DebugDrawer::DrawLine(const glm::vec3& p1, const glm::vec3& p2) {
@@ -54,35 +79,20 @@ void DebugDrawer::DrawLine(const glm::vec3& p1, const glm::vec3& p2, const glm::
 
 void DebugDrawer::DrawLine(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& color1, const glm::vec3& color2)
 {
-	_lineBuffer[_lineOffset + 0].Color = glm::vec4(color1, 1.0f);
-	_lineBuffer[_lineOffset + 0].Position = p1;
-	_lineBuffer[_lineOffset + 1].Color = glm::vec4(color2, 1.0f);
-	_lineBuffer[_lineOffset + 1].Position = p2;
-
-	_lineOffset += 2;
-	if (_lineOffset >= LINE_BATCH_SIZE) {
-		FlushLines();
-	}
+	std::vector<VertexPosCol>& vertices = _lineVertices[_depthTestStack.top() ? 0 : 1];
+
+	VertexPosCol vert;
+	vert.Position = _ToWorld(p1);
+	vert.Color = glm::vec4(color1, 1.0f);
+	vertices.push_back(vert);
+	vert.Position = _ToWorld(p2);
+	vert.Color = glm::vec4(color2, 1.0f);
+	vertices.push_back(vert);
 }
 
 void DebugDrawer::FlushLines()
 {
-	if (_lineOffset > 0) {
-		__Shader->Bind();
-		__Shader->SetUniformMatrix("u_MVP", _viewProjection * _transformStack.top());
-		int restorePoint = 0;
-		glLineWidth(2.0f);
-		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &restorePoint);
-		VertexArrayObject::Unbind();
-		_linesVBO->LoadData<VertexPosCol>(_lineBuffer, LINE_BATCH_SIZE * 2);
-		_linesVAO->Bind();
-		_linesVAO->Draw(DrawMode::LineList);
-		_linesVAO->Unbind();
-		_lineOffset = 0;
-		if (restorePoint != 0) {
-			glBindVertexArray(restorePoint);
-		}
-	}
+	_Flush(true, false);
 }
 
 void DebugDrawer::DrawTri(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3) {
@@ -96,42 +106,141 @@ void DebugDrawer::DrawTri(const glm::vec3& p1, const glm::vec3& p2, const glm::v
 
 void DebugDrawer::DrawTri(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, const glm::vec3& c1, const glm::vec3& c2, const glm::vec3& c3)
 {
-	_triBuffer[_triangleOffset + 0].Color = glm::vec4(c1, 1.0f);
-	_triBuffer[_triangleOffset + 0].Position = p1;
-	_triBuffer[_triangleOffset + 1].Color = glm::vec4(c2, 1.0f);
-	_triBuffer[_triangleOffset + 1].Position = p2;
-	_triBuffer[_triangleOffset + 2].Color = glm::vec4(c3, 1.0f);
-	_triBuffer[_triangleOffset + 2].Position = p3;
-
-	_triangleOffset += 3;
-	if (_triangleOffset >= TRI_BATCH_SIZE) {
-		FlushTris();
-	}
+	std::vector<VertexPosCol>& vertices = _triVertices[_depthTestStack.top() ? 0 : 1];
+
+	VertexPosCol vert;
+	vert.Position = _ToWorld(p1);
+	vert.Color = glm::vec4(c1, 1.0f);
+	vertices.push_back(vert);
+	vert.Position = _ToWorld(p2);
+	vert.Color = glm::vec4(c2, 1.0f);
+	vertices.push_back(vert);
+	vert.Position = _ToWorld(p3);
+	vert.Color = glm::vec4(c3, 1.0f);
+	vertices.push_back(vert);
 }
 
 void DebugDrawer::FlushTris()
 {
-	if (_triangleOffset > 0) {
-		__Shader->Bind();
-		__Shader->SetUniformMatrix("u_MVP", _viewProjection * _transformStack.top());
-		int restorePoint = 0;
-		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &restorePoint);
-		VertexArrayObject::Unbind();
-		_trisVBO->LoadData<VertexPosCol>(_triBuffer, TRI_BATCH_SIZE * 3);
-		_trisVAO->Bind();
-		_trisVAO->Draw(DrawMode::LineList);
-		_trisVAO->Unbind();
-		_triangleOffset = 0;
-		if (restorePoint != 0) {
-			glBindVertexArray(restorePoint);
+	_Flush(false, true);
+}
+
+void DebugDrawer::FlushAll()
+{
+	_Flush(true, true);
+}
+
+void DebugDrawer::_Flush(bool lines, bool tris)
+{
+	// Depth tested primitives are drawn first, then the ones that draw over everything
+	std::vector<VertexPosCol>* buckets[4] = {
+		lines ? &_lineVertices[0] : nullptr,
+		tris  ? &_triVertices[0]  : nullptr,
+		lines ? &_lineVertices[1] : nullptr,
+		tris  ? &_triVertices[1]  : nullptr
+	};
+	static const DrawMode modes[4] = { DrawMode::LineList, DrawMode::TriangleList, DrawMode::LineList, DrawMode::TriangleList };
+
+	uint32_t vertexCount = 0;
+	for (int ix = 0; ix < 4; ix++) {
+		vertexCount += buckets[ix] != nullptr ? static_cast<uint32_t>(buckets[ix]->size()) : 0;
+	}
+	if (vertexCount == 0) {
+		return;
+	}
+
+	// If our shader failed to build we drop the primitives, rather than letting them pile up
+	if (!__Shader->WaitForLink()) {
+		for (int ix = 0; ix < 4; ix++) {
+			if (buckets[ix] != nullptr) {
+				buckets[ix]->clear();
+			}
+		}
+		return;
+	}
+	_ReserveVertices(vertexCount);
+
+	// Make sure the GPU is done with the last draw that used this region before we overwrite it
+	uint32_t region = _currentRegion;
+	_currentRegion = (_currentRegion + 1) % FRAME_REGIONS;
+	if (_regionFences[region] != nullptr) {
+		glClientWaitSync(_regionFences[region], GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+		glDeleteSync(_regionFences[region]);
+		_regionFences[region] = nullptr;
+	}
+
+	// Copy over only the vertices that were used
+	uint32_t offsets[4];
+	uint32_t offset = region * _regionCapacity;
+	for (int ix = 0; ix < 4; ix++) {
+		offsets[ix] = offset;
+		if (buckets[ix] != nullptr && !buckets[ix]->empty()) {
+			memcpy(_mappedData + offset, buckets[ix]->data(), sizeof(VertexPosCol) * buckets[ix]->size());
+			offset += static_cast<uint32_t>(buckets[ix]->size());
+		}
+	}
+
+	// Points are already in world space, so we only need the view projection
+	__Shader->Bind();
+	__MvpUniform.Resolve(__Shader);
+	__MvpUniform.Set(_viewProjection);
+	glLineWidth(2.0f);
+
+	_vao->Bind();
+	bool isDepthDisabled = false;
+	for (int ix = 0; ix < 4; ix++) {
+		if (buckets[ix] == nullptr || buckets[ix]->empty()) {
+			continue;
 		}
+		if (ix >= 2 && !isDepthDisabled) {
+			glDisable(GL_DEPTH_TEST);
+			isDepthDisabled = true;
+		}
+		glDrawArrays((GLenum)modes[ix], offsets[ix], static_cast<GLsizei>(buckets[ix]->size()));
+		buckets[ix]->clear();
+	}
+	if (isDepthDisabled) {
+		glEnable(GL_DEPTH_TEST);
 	}
+	VertexArrayObject::Unbind();
+
+	_regionFences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 }
 
-void DebugDrawer::FlushAll()
+void DebugDrawer::_ReserveVertices(uint32_t vertexCount)
 {
-	FlushLines();
-	FlushTris();
+	if (vertexCount <= _regionCapacity) {
+		return;
+	}
+	uint32_t oldCapacity = _regionCapacity;
+	_regionCapacity = glm::max(vertexCount, _regionCapacity * 2);
+
+	// Buffer storage is immutable, so we need a new buffer. Nothing needs to be copied over, since
+	// vertices only live in the buffer until they are drawn
+	VertexBuffer::Sptr vbo = VertexBuffer::Create(BufferUsage::DynamicDraw);
+	vbo->LoadStorage(nullptr, sizeof(VertexPosCol), _regionCapacity * FRAME_REGIONS, DEBUG_MAP_FLAGS);
+	if (_vbo != nullptr) {
+		_vbo->Unmap();
+		_vao->ReplaceVertexBuffer(_vboBinding, vbo);
+	} else {
+		_vboBinding = _vao->AddVertexBuffer(vbo, VertexPosCol::V_DECL);
+	}
+	_vbo = vbo;
+	_mappedData = reinterpret_cast<VertexPosCol*>(_vbo->Map(DEBUG_MAP_FLAGS));
+	LOG_ASSERT(_mappedData != nullptr, "Failed to map debug draw buffer");
+
+	// The new buffer is not in use by the GPU yet
+	for (uint32_t ix = 0; ix < FRAME_REGIONS; ix++) {
+		if (_regionFences[ix] != nullptr) {
+			glDeleteSync(_regionFences[ix]);
+			_regionFences[ix] = nullptr;
+		}
+	}
+	_currentRegion = 0;
+
+	if (oldCapacity > 0) {
+		LOG_INFO("Expanding debug draw buffer from {} vertices to {} vertices", oldCapacity, _regionCapacity);
+	}
 }
 
 void DebugDrawer::SetViewProjection(const glm::mat4& viewProjection)
@@ -168,7 +277,7 @@ DebugDrawer& DebugDrawer::Get() {
 		__Shader = ShaderProgram::Create();
 		__Shader->LoadShaderPart(vs_source, ShaderPartType::Vertex);
 		__Shader->LoadShaderPart(fs_source, ShaderPartType::Fragment);
-		__Shader->Link();
+		__Shader->LinkAsync();
 	}
 	return *__Instance;
 }
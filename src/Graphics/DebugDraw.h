@@ -1,20 +1,33 @@
 #pragma once
 #include <GLM/glm.hpp>
 #include <stack>
+#include <vector>
 #include "Graphics/VertexTypes.h"
 #include "Graphics/ShaderProgram.h"
+#include "Graphics/VertexArrayObject.h"
+#include "Graphics/UniformHandle.h"
 
 /// <summary>
 /// Utility class for drawing lines and triangles in an immediate mode style
 /// 
 /// Includes a stack for transformations and color, to ease implementation of complex
 /// debuggers
+/// 
+/// Primitives are transformed into world space as they are added, and are sorted by type and
+/// depth mode. Flushing copies only the vertices that were used into a persistently mapped buffer,
+/// and draws each type and depth mode with a single call
 /// </summary>
 class DebugDrawer
 {
 public:
-	inline static const size_t LINE_BATCH_SIZE = 8192;
-	inline static const size_t TRI_BATCH_SIZE = 4096;
+	/// <summary>
+	/// The number of vertices each frame region of the GPU buffer starts with, grows as needed
+	/// </summary>
+	inline static const uint32_t INITIAL_VERTEX_CAPACITY = 16384;
+	/// <summary>
+	/// The number of flushes that can be in flight on the GPU before we need to wait for the oldest one
+	/// </summary>
+	inline static const uint32_t FRAME_REGIONS = 3;
 
 	// Delete copy and mode
 
@@ -23,7 +36,7 @@ public:
 	DebugDrawer& operator =(const DebugDrawer& other) = delete;
 	DebugDrawer& operator =(DebugDrawer&& other) = delete;
 
-	virtual ~DebugDrawer() = default;
+	virtual ~DebugDrawer();
 
 	/// <summary>
 	/// Gets the singleton instance of the debug drawer
@@ -47,15 +60,26 @@ public:
 	glm::vec3 PopColor();
 
 	/// <summary>
-	/// Pushes a new transform to the stack, replacing the existing value and flushing all lines and tris
+	/// Pushes a new transform to the stack, replacing the existing value. Points given to the draw
+	/// functions are transformed by this matrix when they are added
 	/// </summary>
 	/// <param name="world">The new world transform to use for drawing</param>
 	void PushWorldMatrix(const glm::mat4& world);
 	/// <summary>
-	/// Pops a transform from the stack, replacing the existing value and flushing all lines and tris
+	/// Pops a transform from the stack, replacing the existing value
 	/// </summary>
 	void PopWorldMatrix();
 
+	/// <summary>
+	/// Pushes whether following primitives should be hidden behind scene geometry (default true)
+	/// </summary>
+	/// <param name="enabled">True to depth test primitives, false to draw them on top of everything</param>
+	void PushDepthTest(bool enabled);
+	/// <summary>
+	/// Pops a depth test mode from the stack, restoring the previous value
+	/// </summary>
+	bool PopDepthTest();
+
 	/// <summary>
 	/// Draws a line between 2 points using the current debug color
 	/// </summary>
@@ -78,7 +102,7 @@ public:
 	/// <param name="c2">Color for second point</param>
 	void DrawLine(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& color1, const glm::vec3& color2);
 	/// <summary>
-	/// Flushes all lines to the screen, resetting our line count to 0s
+	/// Flushes all lines to the screen, resetting our line count to 0
 	/// </summary>
 	void FlushLines();
 
@@ -111,12 +135,14 @@ public:
 	/// <param name="c3">Color for third point</param>
 	void DrawTri(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, const glm::vec3& c1, const glm::vec3& c2, const glm::vec3& c3);
 	/// <summary>
-	/// Flushes all triangles to the screen, resetting our triangle count to 0s
+	/// Flushes all triangles to the screen, resetting our triangle count to 0
 	/// </summary>
 	void FlushTris();
 
 	/// <summary>
 	/// Flushes any remaining triangles and lines, drawing them to the screen and resetting their counters
+	/// 
+	/// Expects depth testing to be enabled, it is re-enabled after drawing primitives that ignore depth
 	/// </summary>
 	void FlushAll();
 
@@ -130,19 +156,39 @@ protected:
 
 	std::stack<glm::vec3> _colorStack;
 	std::stack<glm::mat4> _transformStack;
+	std::stack<bool>      _depthTestStack;
 	glm::mat4    _viewProjection;
+	// Cached top of the transform stack, so we can skip transforming points when it's the identity
 	glm::mat4    _worldMatrix;
+	bool         _isWorldIdentity;
 
-	size_t       _lineOffset;
-	VertexPosCol _lineBuffer[LINE_BATCH_SIZE * 2];
-	size_t       _triangleOffset;
-	VertexPosCol _triBuffer[TRI_BATCH_SIZE * 3];
+	// World space vertices waiting to be drawn, index 0 is depth tested and index 1 is drawn on top
+	std::vector<VertexPosCol> _lineVertices[2];
+	std::vector<VertexPosCol> _triVertices[2];
 
-	VertexBuffer::Sptr _linesVBO;
-	VertexArrayObject::Sptr _linesVAO;
-	VertexBuffer::Sptr _trisVBO;
-	VertexArrayObject::Sptr _trisVAO;
+	// The GPU buffer is split into FRAME_REGIONS regions, each flush writes to the next one
+	VertexBuffer::Sptr _vbo;
+	VertexArrayObject::Sptr _vao;
+	VertexArrayObject::VertexBufferBinding* _vboBinding;
+	VertexPosCol* _mappedData;
+	uint32_t      _regionCapacity;
+	uint32_t      _currentRegion;
+	// Signaled when the GPU is done drawing from each region
+	GLsync        _regionFences[FRAME_REGIONS];
+
+	inline glm::vec3 _ToWorld(const glm::vec3& point) const {
+		return _isWorldIdentity ? point : glm::vec3(_worldMatrix * glm::vec4(point, 1.0f));
+	}
+	/// <summary>
+	/// Uploads and draws the requested primitive types, then clears them
+	/// </summary>
+	void _Flush(bool lines, bool tris);
+	/// <summary>
+	/// Makes sure that each region of the GPU buffer can hold the given number of vertices
+	/// </summary>
+	void _ReserveVertices(uint32_t vertexCount);
 
 	inline static DebugDrawer* __Instance = nullptr;
 	inline static ShaderProgram::Sptr __Shader = nullptr;
+	inline static UniformHandle<glm::mat4> __MvpUniform = "u_MVP";
 };
\ No newline at end of file
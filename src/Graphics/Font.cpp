@@ -1,17 +1,26 @@
 #include "Graphics/Font.h"
 #include "Utils/FileHelpers.h"
 #include "Utils/JsonGlmHelpers.h"
-#include <set>
-#include <codecvt>
-#include <locale>
+#include "Utils/StringUtils.h"
 #include <cstdint>
+#include <algorithm>
 #include <stb_rect_pack.h>
 #include "Utils/JsonGlmHelpers.h"
+#include "Graphics/GuiAtlas.h"
 
 #define OVERSAMPLE_X 1
 #define OVERSAMPLE_Y 1
 #define PADDING 1
 
+// Distance fields extend this many pixels past the edge of each glyph
+#define SDF_PADDING 4
+// The value stored at the glyph edge, the shader treats 0.5 as the edge
+#define SDF_ON_EDGE 128
+// How much the stored value changes per pixel of distance, so the field reaches 0 at the padding
+#define SDF_DISTANCE_SCALE (128.0f / SDF_PADDING)
+// Distance field atlases grow in height until all glyphs fit, up to this limit
+#define SDF_MAX_ATLAS_HEIGHT 2048
+
 Font::Font() : Font("", 0.0f) { }
 
 Font::Font(const std::string& fontPath, float size) :
@@ -28,7 +37,12 @@ Font::Font(const std::string& fontPath, float size) :
 	_fontInfo(stbtt_fontinfo()),
 	_defaultGlyph(GlyphInfo()),
 	_atlasWidth(256),
-	_atlasHeight(256)
+	_atlasHeight(256),
+	_shareAtlas(true),
+	_usesSharedAtlas(false),
+	_isDistanceField(false),
+	_uvOffset(glm::vec2(0.0f)),
+	_uvScale(glm::vec2(1.0f))
 {
 	// For the box character
 	_glyphRanges.push_back({ 0xE000u, 0xE000u });
@@ -83,12 +97,20 @@ void Font::AddGlyphRange(uint32_t min, uint32_t max) {
 	_glyphRanges.push_back({ min, max });
 }
 
+void Font::SetShareAtlas(bool value) {
+	LOG_ASSERT(_atlas == nullptr, "Cannot change atlas sharing after the font has been baked!");
+	_shareAtlas = value;
+}
+
+void Font::SetDistanceField(bool value) {
+	LOG_ASSERT(_atlas == nullptr, "Cannot change the bake mode after the font has been baked!");
+	_isDistanceField = value;
+}
+
 void Font::Bake() {
 	LOG_ASSERT(_atlas == nullptr, "Bake has already been called!");
 	LOG_ASSERT(_fontInfo.data != nullptr, "Have not loaded a font asset!");
 
-	uint8_t* rawFontData = reinterpret_cast<uint8_t*>(_fontData.data());
-
 	// Collect all codepoint ranges into a set, so we have a list of unique codepoints
 	std::set<int> codePoints;
 	uint32_t numCodepoints = 0;
@@ -106,6 +128,211 @@ void Font::Bake() {
 	_glyphs = new stbtt_packedchar[numCodepoints];
 	memset(_glyphs, 0, sizeof(stbtt_packedchar) * numCodepoints);
 
+	// Rasterize the glyphs into a single channel image
+	uint8_t* atlasData = _isDistanceField ? __PackDistanceField(codePoints) : __PackBitmap(codePoints);
+	if (atlasData == nullptr) {
+		return;
+	}
+
+	// Try to move the glyphs into the shared GUI atlas, so that text can be batched with GUI sprites
+	_usesSharedAtlas = false;
+	if (_shareAtlas) {
+		// Only the rows that glyphs were packed into need to be copied
+		uint32_t usedHeight = 0;
+		for (uint32_t ix = 0; ix < numCodepoints; ix++) {
+			usedHeight = glm::max(usedHeight, (uint32_t)_glyphs[ix].y1 + PADDING);
+		}
+		usedHeight = glm::min(usedHeight, _atlasHeight);
+
+		GuiAtlas::Region region;
+		if (GuiAtlas::Add(atlasData, _atlasWidth, usedHeight, 1, region)) {
+			_atlas = region.Page;
+			_usesSharedAtlas = true;
+			_uvOffset = region.UvMin;
+			_uvScale  = glm::vec2(_atlasWidth, _atlasHeight) / glm::vec2(region.Page->GetWidth(), region.Page->GetHeight());
+		}
+	}
+
+	// Otherwise the font gets a texture of it's own
+	if (!_usesSharedAtlas) {
+		Texture2DDescription desc;
+		desc.Width = _atlasWidth;
+		desc.Height = _atlasHeight;
+		if (_isDistanceField) {
+			// The distance field shader reads from alpha, the same as glyphs in the shared atlas
+			std::vector<glm::u8vec4> pixels(_atlasWidth * (size_t)_atlasHeight);
+			for (size_t ix = 0; ix < pixels.size(); ix++) {
+				pixels[ix] = glm::u8vec4(255, 255, 255, atlasData[ix]);
+			}
+			desc.Format = InternalFormat::RGBA8;
+			_atlas = std::make_shared<Texture2D>(desc);
+			_atlas->LoadData(desc.Width, desc.Height, PixelFormat::RGBA, PixelType::UByte, pixels.data());
+		} else {
+			desc.Format = InternalFormat::R8;
+			_atlas = std::make_shared<Texture2D>(desc);
+			_atlas->LoadData(desc.Width, desc.Height, PixelFormat::Red, PixelType::UByte, atlasData);
+		}
+
+		_uvOffset = glm::vec2(0.0f);
+		_uvScale  = glm::vec2(1.0f);
+	}
+	delete[] atlasData;
+
+	uint32_t index = 0;
+	for (uint32_t codepoint : codePoints) {
+		_glyphMap[codepoint] = __CreateGlyph(index);
+		index++;
+
+		if (codepoint == 0xE000u)
+			_defaultGlyph = _glyphMap[codepoint];
+	}
+
+	// Copy the Latin range into a flat table, missing characters use the default glyph
+	_denseGlyphs.assign(DENSE_GLYPH_COUNT, _defaultGlyph);
+	for (const auto& [codepoint, glyph] : _glyphMap) {
+		if (codepoint >= DENSE_GLYPH_COUNT) {
+			break;
+		}
+		_denseGlyphs[codepoint] = glyph;
+	}
+
+	__BuildKerningTable(codePoints);
+}
+
+void Font::__BuildKerningTable(const std::set<int>& codePoints) {
+	_kerningPairs.clear();
+
+	// Look up glyph indices once, rather than for every pair
+	std::vector<std::pair<uint32_t, int>> glyphs;
+	for (int codepoint : codePoints) {
+		if ((uint32_t)codepoint >= DENSE_GLYPH_COUNT) {
+			break;
+		}
+		int glyphIndex = stbtt_FindGlyphIndex(&_fontInfo, codepoint);
+		if (glyphIndex != 0) {
+			glyphs.push_back({ (uint32_t)codepoint, glyphIndex });
+		}
+	}
+
+	// Both loops are in codepoint order, so the table comes out sorted by key
+	for (const auto& [left, leftGlyph] : glyphs) {
+		for (const auto& [right, rightGlyph] : glyphs) {
+			int kerning = stbtt_GetGlyphKernAdvance(&_fontInfo, leftGlyph, rightGlyph);
+			if (kerning != 0) {
+				_kerningPairs.push_back({ left * DENSE_GLYPH_COUNT + right, kerning * _pixelHeightScale });
+			}
+		}
+	}
+}
+
+const Texture2D::Sptr& Font::GetAtlas() {
+	return _atlas;
+}
+
+GlyphInfo Font::GetGlyph(uint32_t codePoint, float offsetX, float offsetY) const {
+	// Try and get glyph info from the codepoint, otherwise grab the default glyph
+	GlyphInfo result = GetGlyphInfo(codePoint);
+
+	result.OffsetX += offsetX;
+	result.OffsetY += offsetY;
+
+	return result;
+}
+
+float Font::GetKerning(int char1, int char2) const {
+	// Pairs in the dense range were all precomputed at bake time
+	if (!_denseGlyphs.empty() && (uint32_t)char1 < DENSE_GLYPH_COUNT && (uint32_t)char2 < DENSE_GLYPH_COUNT) {
+		uint32_t key = (uint32_t)char1 * DENSE_GLYPH_COUNT + (uint32_t)char2;
+		auto it = std::lower_bound(_kerningPairs.begin(), _kerningPairs.end(), key, [](const KerningPair& pair, uint32_t value) {
+			return pair.Key < value;
+		});
+		return (it != _kerningPairs.end() && it->Key == key) ? it->Amount : 0.0f;
+	}
+	return stbtt_GetCodepointKernAdvance(&_fontInfo, char1, char2) * _pixelHeightScale;
+}
+
+float Font::GetLineHeight() const {
+	return (_ascent - _descent + _lineGap) * _pixelHeightScale;
+}
+
+glm::vec2 Font::MeausureString(const std::string& text, const float scale /*= 1.0f*/) {
+	// We can convert an ASCII string to unicode!
+	return MeausureString(StringTools::Utf8ToWide(text), scale);
+}
+
+glm::vec2 Font::MeausureString(const std::wstring& text, const float scale /*= 1.0f*/) {
+	// Measuring uses the same rules as layout, so that measured text lines up with what gets drawn
+	TextLayout layout;
+	LayoutString(text, scale, layout);
+	return layout.Size;
+}
+
+void Font::LayoutString(const std::wstring& text, float scale, TextLayout& result) const {
+	result.Quads.clear();
+	result.Quads.reserve(text.size());
+
+	// The pen position in unscaled font pixels
+	glm::vec2 offset = glm::vec2(0.0f);
+
+	// We'll track the max size of the text as we go
+	float lineHeight = 0.0f;
+	float maxWidth = 0.0f;
+	float totalHeight = 0.0f;
+
+	// Iterate over all characters, ascii and unicode overlap in the 0-255 range!
+	size_t length = text.size();
+	for (size_t i = 0; i < length; i++) {
+		uint32_t codepoint = static_cast<uint32_t>(text[i]);
+
+		// A newline will advance to the next line and return to the start of the line
+		if (codepoint == '\n') {
+			offset.y += GetLineHeight();
+			offset.x = 0;
+			totalHeight += lineHeight;
+			lineHeight = 0.0f;
+		}
+		// A return character simply returns to the start of the line
+		else if (codepoint == '\r') {
+			offset.x = 0;
+		}
+		// A tab character is 4 spaces
+		else if (codepoint == '\t') {
+			offset.x += GetGlyphInfo(' ').OffsetX * 4;
+			maxWidth = glm::max(maxWidth, offset.x);
+		}
+		// All other characters get a quad
+		else {
+			const GlyphInfo& glyph = GetGlyphInfo(codepoint);
+
+			GlyphQuad quad;
+			for (int ix = 0; ix < 4; ix++) {
+				quad.Positions[ix] = (offset + glyph.Positions[ix]) * scale;
+				quad.UVs[ix]       = glyph.UVs[ix];
+			}
+			result.Quads.push_back(quad);
+
+			// Advance the offset based on the size of the glyph
+			offset.x += glyph.OffsetX;
+			offset.y += glyph.OffsetY;
+
+			// If we have more characters, see if there's any kerning between the
+			// current and next character and add it to the x offset
+			if (i < length - 1) {
+				offset.x += GetKerning(codepoint, text[i + 1]);
+			}
+
+			lineHeight = glm::max(lineHeight, -glyph.Positions[1].y);
+			maxWidth = glm::max(maxWidth, offset.x);
+		}
+	}
+	totalHeight += lineHeight;
+	result.Size = glm::vec2(maxWidth, totalHeight) * scale;
+}
+
+
+uint8_t* Font::__PackBitmap(const std::set<int>& codePoints) {
+	uint8_t* rawFontData = reinterpret_cast<uint8_t*>(_fontData.data());
+
 	// Collect unicode ranges, may differ from input ranges!
 	std::vector<stbtt_pack_range> ranges;
 
@@ -154,22 +381,15 @@ void Font::Bake() {
 
 	_CrtCheckMemory();
 
-	// Create a texture to store the atlas
-	Texture2DDescription desc;
-	desc.Width = _atlasWidth;
-	desc.Height = _atlasHeight;
-	desc.Format = InternalFormat::R8;
-	_atlas = std::make_shared<Texture2D>(desc);
-
 	// Allocate memory for the image, and point rect pack at it
-	uint8_t* atlasData = new uint8_t[desc.Width * (size_t)desc.Height];
-	memset(atlasData, 0, desc.Width * desc.Height);
+	uint8_t* atlasData = new uint8_t[_atlasWidth * (size_t)_atlasHeight];
+	memset(atlasData, 0, _atlasWidth * (size_t)_atlasHeight);
 
 	stbtt_pack_context context;
 	if (!stbtt_PackBegin(&context, atlasData, _atlasWidth, _atlasHeight, 0, 1, nullptr)) {
 		LOG_ERROR("Failed to pack font texture");
 		delete[] atlasData;
-		return;
+		return nullptr;
 	}
 	_CrtCheckMemory();
 
@@ -178,7 +398,7 @@ void Font::Bake() {
 		if (!stbtt_PackFontRange(&context, rawFontData, 0, range.font_size, range.first_unicode_codepoint_in_range, range.num_chars, range.chardata_for_range)) {
 			LOG_ERROR("Failed to pack font range");
 			delete[] atlasData;
-			return;
+			return nullptr;
 		}
 		_CrtCheckMemory();
 	}
@@ -186,86 +406,85 @@ void Font::Bake() {
 
 	_CrtCheckMemory();
 
-	// Upload data into the image
-	_atlas->LoadData(desc.Width, desc.Height, PixelFormat::Red, PixelType::UByte, atlasData);
-	delete[] atlasData;
-
-	uint32_t index = 0;
-	for (uint32_t codepoint : codePoints) {
-		_glyphMap[codepoint] = __CreateGlyph(index);
-		index++;
-
-		if (codepoint == 0xE000u)
-			_defaultGlyph = _glyphMap[codepoint];
-	}
-}
-
-const Texture2D::Sptr& Font::GetAtlas() {
-	return _atlas;
+	return atlasData;
 }
 
-GlyphInfo Font::GetGlyph(uint32_t codePoint, float offsetX, float offsetY) const {
-	// Try and get glyph info from the codepoint, otherwise grab the default glyph
-	auto it = _glyphMap.find(codePoint);		
-	GlyphInfo result = it == _glyphMap.end() ? _defaultGlyph : it->second;
-
-	result.OffsetX += offsetX;
-	result.OffsetY += offsetY;
-
-	return result;
-}
+uint8_t* Font::__PackDistanceField(const std::set<int>& codePoints) {
+	// Render a distance field for each glyph, these are padded so the field can fall off outside the glyph
+	std::vector<uint8_t*> bitmaps;
+	std::vector<stbrp_rect> rects(codePoints.size());
+	bitmaps.reserve(codePoints.size());
 
-float Font::GetKerning(int char1, int char2) const {
-	return stbtt_GetCodepointKernAdvance(&_fontInfo, char1, char2) * _pixelHeightScale;
-}
+	uint32_t index = 0;
+	for (int codepoint : codePoints) {
+		int width = 0, height = 0, xOff = 0, yOff = 0;
+		uint8_t* bitmap = stbtt_GetCodepointSDF(&_fontInfo, _pixelHeightScale, codepoint, SDF_PADDING, SDF_ON_EDGE, SDF_DISTANCE_SCALE, &width, &height, &xOff, &yOff);
+		int advance = 0, bearing = 0;
+		stbtt_GetCodepointHMetrics(&_fontInfo, codepoint, &advance, &bearing);
+
+		// Whitespace has no bitmap, but still needs to advance the cursor
+		if (bitmap == nullptr) {
+			width = height = xOff = yOff = 0;
+		}
 
-float Font::GetLineHeight() const {
-	return (_ascent - _descent + _lineGap) * _pixelHeightScale;
-}
+		stbtt_packedchar& glyph = _glyphs[index];
+		glyph.xoff     = (float)xOff;
+		glyph.yoff     = (float)yOff;
+		glyph.xoff2    = (float)(xOff + width);
+		glyph.yoff2    = (float)(yOff + height);
+		glyph.xadvance = advance * _pixelHeightScale;
+
+		rects[index].id = index;
+		rects[index].w  = bitmap != nullptr ? width + PADDING : 0;
+		rects[index].h  = bitmap != nullptr ? height + PADDING : 0;
+		bitmaps.push_back(bitmap);
+		index++;
+	}
 
-glm::vec2 Font::MeausureString(const std::string& text, const float scale /*= 1.0f*/) {
-	// We can convert an ASCII string to unicode!
-	std::wstring unicode = std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(text);
-	return MeausureString(unicode, scale);
-}
+	// Pack the glyphs, doubling the height of the atlas until they all fit
+	std::vector<stbrp_node> nodes(_atlasWidth);
+	stbrp_context context;
+	bool isPacked = false;
+	while (!isPacked && _atlasHeight <= SDF_MAX_ATLAS_HEIGHT) {
+		stbrp_init_target(&context, _atlasWidth, _atlasHeight, nodes.data(), (int)nodes.size());
+		isPacked = stbrp_pack_rects(&context, rects.data(), (int)rects.size()) != 0;
+		if (!isPacked) {
+			_atlasHeight *= 2;
+		}
+	}
 
-glm::vec2 Font::MeausureString(const std::wstring& text, const float scale /*= 1.0f*/) {
-	// Will cache the current glyph
-	GlyphInfo glyph;
+	uint8_t* atlasData = nullptr;
+	if (isPacked) {
+		atlasData = new uint8_t[_atlasWidth * (size_t)_atlasHeight];
+		memset(atlasData, 0, _atlasWidth * (size_t)_atlasHeight);
 
-	// We'll track the position and max size of the text
-	float xOff{ 0 }, yOff{ 0 };
-	float lineHeight = 0.0f;
-	float maxWidth = 0.0f;
-	float totalHeight = 0.0f;
+		// Copy the fields into the atlas, and record where they ended up
+		for (uint32_t ix = 0; ix < rects.size(); ix++) {
+			stbtt_packedchar& glyph = _glyphs[ix];
+			uint32_t width  = (uint32_t)(glyph.xoff2 - glyph.xoff);
+			uint32_t height = (uint32_t)(glyph.yoff2 - glyph.yoff);
 
-	// Iterate over all characters, ascii and unicode overlap in the 0-255 range!
-	for (size_t i = 0; i < text.size(); i++) {
-		glyph = GetGlyph(text[i], xOff, yOff);
-		xOff = glyph.OffsetX;
-		yOff = glyph.OffsetY;
+			glyph.x0 = (unsigned short)rects[ix].x;
+			glyph.y0 = (unsigned short)rects[ix].y;
+			glyph.x1 = (unsigned short)(rects[ix].x + width);
+			glyph.y1 = (unsigned short)(rects[ix].y + height);
 
-		lineHeight = glm::max(lineHeight, -glyph.Positions[1].y);
-		maxWidth = glm::max(maxWidth, xOff);
+			for (uint32_t row = 0; row < height; row++) {
+				memcpy(atlasData + (glyph.y0 + row) * (size_t)_atlasWidth + glyph.x0, bitmaps[ix] + row * (size_t)width, width);
+			}
+		}
+	} else {
+		LOG_ERROR("Failed to pack distance field font, glyphs do not fit in a {}x{} atlas", _atlasWidth, SDF_MAX_ATLAS_HEIGHT);
+	}
 
-		if (text[i] == '\n')
-		{
-			yOff += GetLineHeight();
-			totalHeight += lineHeight;
-			lineHeight = 0.0f;
-			xOff = 0;
-		} else if (text[i] == '\r') {
-			xOff = 0;
-		} else if (text[i] == '\t') {
-			float xOffTemp{ 0 }, yOffTemp{ 0 };
-			glyph = GetGlyph(' ', xOffTemp, yOffTemp);
-			xOff += glyph.OffsetX * 4;
+	for (uint8_t* bitmap : bitmaps) {
+		if (bitmap != nullptr) {
+			stbtt_FreeSDF(bitmap, nullptr);
 		}
 	}
-	totalHeight += lineHeight;
-	return glm::vec2(maxWidth, totalHeight) * scale;
-}
 
+	return atlasData;
+}
 
 GlyphInfo Font::__CreateGlyph(uint32_t index)
 {
@@ -286,10 +505,10 @@ GlyphInfo Font::__CreateGlyph(uint32_t index)
 	info.Positions[1] = { xmax, ymax };
 	info.Positions[2] = { xmin, ymax };
 	info.Positions[3] = { xmin, ymin };
-	info.UVs[0]       = { quad.s1, quad.t1 };
-	info.UVs[1]       = { quad.s1, quad.t0 };
-	info.UVs[2]       = { quad.s0, quad.t0 };
-	info.UVs[3]       = { quad.s0, quad.t1 };
+	info.UVs[0]       = _uvOffset + glm::vec2(quad.s1, quad.t1) * _uvScale;
+	info.UVs[1]       = _uvOffset + glm::vec2(quad.s1, quad.t0) * _uvScale;
+	info.UVs[2]       = _uvOffset + glm::vec2(quad.s0, quad.t0) * _uvScale;
+	info.UVs[3]       = _uvOffset + glm::vec2(quad.s0, quad.t1) * _uvScale;
 	info.IsPacked = true;
 
 	return info;
@@ -299,7 +518,9 @@ nlohmann::json Font::ToJson() const
 {
 	nlohmann::json blob = {
 		{ "filename", _fontPath },
-		{ "font_size", _fontSize }
+		{ "font_size", _fontSize },
+		{ "share_atlas", _shareAtlas },
+		{ "distance_field", _isDistanceField }
 	};
 
 	nlohmann::json ranges = std::vector<nlohmann::json>();
@@ -317,6 +538,8 @@ Font::Sptr Font::FromJson(const nlohmann::json& data) {
 	std::string path = JsonGet<std::string>(data, "filename", "");
 	float size = JsonGet(data, "font_size", 16.0f);
 	result->Load(path, size);
+	result->_shareAtlas = JsonGet(data, "share_atlas", true);
+	result->_isDistanceField = JsonGet(data, "distance_field", false);
 		
 	// Iterate over the ranges and add them to the font
 	if (data.contains("ranges") && data["ranges"].is_array()) {
@@ -4,6 +4,9 @@
 #include "Graphics/Textures/Texture2D.h"
 
 #include <stb_truetype.h>
+#include <map>
+#include <set>
+#include <vector>
 
 	struct GlyphInfo {
 		glm::vec2 Positions[4];
@@ -12,6 +15,24 @@
 		bool IsPacked;
 	};
 
+	/// <summary>
+	/// A single glyph that has been positioned relative to the start of a string
+	/// </summary>
+	struct GlyphQuad {
+		glm::vec2 Positions[4];
+		glm::vec2 UVs[4];
+	};
+
+	/// <summary>
+	/// The result of laying out a string with a font, which can be kept and re-drawn
+	/// until the text, scale or font changes
+	/// </summary>
+	struct TextLayout {
+		std::vector<GlyphQuad> Quads;
+		// The size of the text, as returned by Font::MeausureString
+		glm::vec2              Size = glm::vec2(0.0f);
+	};
+
 	/// <summary>
 	/// The font resource wraps around stb_truetype to allow us to render text to the screen
 	/// A Font class contains the texture atlas and data needed to render glyphs using said atlas
@@ -21,6 +42,12 @@
 		typedef std::shared_ptr<Font> Sptr;
 		typedef std::weak_ptr<Font> Wptr;
 
+		/// <summary>
+		/// Codepoints below this value (ASCII and Latin-1) are stored in a flat array rather than
+		/// a map, and have their kerning pairs precomputed when the font is baked
+		/// </summary>
+		static const uint32_t DENSE_GLYPH_COUNT = 256;
+
 
 		Font();
 		Font(const std::string& fontPath, float size = 16.0f);
@@ -43,13 +70,35 @@
 		/// <param name="max">The maximum unicode character (inclusive)</param>
 		void AddGlyphRange(uint32_t min, uint32_t max);
 
+		/// <summary>
+		/// Sets whether the glyphs should be packed into the shared GUI atlas when baking (default true),
+		/// so that text can be batched together with GUI sprites. Must be set before Bake is called
+		/// </summary>
+		void SetShareAtlas(bool value);
+		/// <summary>
+		/// Returns true if the glyphs were baked into the shared GUI atlas. Shared atlas pages store
+		/// glyph coverage in the alpha channel, rather than the red channel of a font-only texture
+		/// </summary>
+		bool UsesSharedAtlas() const { return _usesSharedAtlas; }
+
+		/// <summary>
+		/// Sets whether the font should be baked as a signed distance field (default false). Distance field
+		/// glyphs stay sharp when text is scaled, so a single font can be used at any size, and are drawn
+		/// with their own shader in the GuiBatcher. Must be set before Bake is called
+		/// </summary>
+		void SetDistanceField(bool value);
+		/// <summary>
+		/// Returns true if the glyphs in the atlas store a distance to the glyph edge in the alpha channel
+		/// </summary>
+		bool UsesDistanceField() const { return _isDistanceField; }
+
 		/// <summary>
 		/// Generates the texture to use when rendering with this font, must be called
 		/// before the font is used
 		/// </summary>
 		void Bake();
 		/// <summary>
-		/// Gets the texture atlas for this font
+		/// Gets the texture atlas for this font, which may be a page of the shared GUI atlas
 		/// </summary>
 		const Texture2D::Sptr& GetAtlas();
 
@@ -62,6 +111,18 @@
 		/// <param name="offsetY">The y position of the glyph</param>
 		GlyphInfo GetGlyph(uint32_t codePoint, float offsetX, float offsetY) const;
 		/// <summary>
+		/// Gets the glyph data for a codepoint without copying it, or the default glyph
+		/// if the font does not contain the codepoint
+		/// </summary>
+		/// <param name="codePoint">The unicode codepoint to lookup</param>
+		inline const GlyphInfo& GetGlyphInfo(uint32_t codePoint) const {
+			if (codePoint < _denseGlyphs.size()) {
+				return _denseGlyphs[codePoint];
+			}
+			auto it = _glyphMap.find(codePoint);
+			return it == _glyphMap.end() ? _defaultGlyph : it->second;
+		}
+		/// <summary>
 		/// Gets the kerning (horizontal space) between 2 unicode characters
 		/// </summary>
 		/// <param name="char1">The left character</param>
@@ -89,13 +150,31 @@
 		/// <returns>The dimension of the string as rendered with this font</returns>
 		virtual glm::vec2 MeausureString(const std::wstring& text, const float scale = 1.0f);
 
+		/// <summary>
+		/// Positions all the glyphs in a string, applying kerning and line breaks. The result can be
+		/// drawn with GuiBatcher::RenderText as many times as needed
+		/// </summary>
+		/// <param name="text">The unicode string to lay out</param>
+		/// <param name="scale">The scaling to apply to the text</param>
+		/// <param name="result">The layout to store the results in, existing contents are replaced</param>
+		void LayoutString(const std::wstring& text, float scale, TextLayout& result) const;
+
 		virtual nlohmann::json ToJson() const override;
 		static Font::Sptr FromJson(const nlohmann::json& data);
 
 	protected:
 		std::vector<glm::uvec2> _glyphRanges;
 		std::map<uint32_t, GlyphInfo> _glyphMap;
+		std::vector<GlyphInfo>        _denseGlyphs;
 		GlyphInfo                     _defaultGlyph;
+
+		// A non-zero kerning amount between two codepoints in the dense range
+		struct KerningPair {
+			uint32_t Key; // left * DENSE_GLYPH_COUNT + right
+			float    Amount;
+		};
+		// Sorted by key, pairs that are not in the table have no kerning
+		std::vector<KerningPair>      _kerningPairs;
 		Texture2D::Sptr   _atlas;
 		std::string       _fontPath;
 		std::string       _fontData;
@@ -110,8 +189,26 @@
 		uint32_t          _atlasWidth,
 			              _atlasHeight;
 
+		bool              _shareAtlas;
+		bool              _usesSharedAtlas;
+		bool              _isDistanceField;
+		// Maps glyph UVs from the baked bitmap into the atlas texture
+		glm::vec2         _uvOffset;
+		glm::vec2         _uvScale;
+
 		stbtt_packedchar* _glyphs;
 		stbtt_fontinfo    _fontInfo;
 
 		GlyphInfo __CreateGlyph(uint32_t index);
+		void __BuildKerningTable(const std::set<int>& codePoints);
+		/// <summary>
+		/// Rasterizes glyph coverage with stb_truetype's packer, returns a single channel image
+		/// the size of the atlas, or nullptr on failure
+		/// </summary>
+		uint8_t* __PackBitmap(const std::set<int>& codePoints);
+		/// <summary>
+		/// Renders a signed distance field for each glyph and packs them, returns a single channel
+		/// image the size of the atlas, or nullptr on failure
+		/// </summary>
+		uint8_t* __PackDistanceField(const std::set<int>& codePoints);
 	};
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "Graphics/GuiAtlas.h"
+#include "Logging.h"
+#include <algorithm>
+
+std::vector<GuiAtlas::Page> GuiAtlas::__pages;
+
+bool GuiAtlas::Add(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t numChannels, Region& region) {
+	LOG_ASSERT(numChannels >= 1 && numChannels <= 4, "GUI atlas images must have between 1 and 4 channels");
+	if (pixels == nullptr || width == 0 || height == 0) {
+		return false;
+	}
+
+	uint32_t paddedWidth  = width  + PADDING * 2;
+	uint32_t paddedHeight = height + PADDING * 2;
+	if (paddedWidth > PAGE_SIZE || paddedHeight > PAGE_SIZE) {
+		return false;
+	}
+
+	// Try all existing pages before starting a new one
+	Page* page = nullptr;
+	uint32_t x = 0, y = 0;
+	for (Page& existing : __pages) {
+		if (__Pack(existing, paddedWidth, paddedHeight, x, y)) {
+			page = &existing;
+			break;
+		}
+	}
+	if (page == nullptr) {
+		page = &__CreatePage();
+		bool packed = __Pack(*page, paddedWidth, paddedHeight, x, y);
+		LOG_ASSERT(packed, "Failed to pack image into an empty GUI atlas page");
+	}
+
+	// Expand the image to RGBA, clamping reads so that the edge pixels are extruded into the padding
+	std::vector<uint8_t> data((size_t)paddedWidth * paddedHeight * 4);
+	for (uint32_t py = 0; py < paddedHeight; py++) {
+		uint32_t sy = (uint32_t)glm::clamp((int)py - (int)PADDING, 0, (int)height - 1);
+		for (uint32_t px = 0; px < paddedWidth; px++) {
+			uint32_t sx = (uint32_t)glm::clamp((int)px - (int)PADDING, 0, (int)width - 1);
+			const uint8_t* src = pixels + ((size_t)sy * width + sx) * numChannels;
+			uint8_t* dst = data.data() + ((size_t)py * paddedWidth + px) * 4;
+			switch (numChannels) {
+				case 1:
+					dst[0] = dst[1] = dst[2] = 255;
+					dst[3] = src[0];
+					break;
+				case 2:
+					dst[0] = dst[1] = dst[2] = src[0];
+					dst[3] = src[1];
+					break;
+				case 3:
+					dst[0] = src[0];
+					dst[1] = src[1];
+					dst[2] = src[2];
+					dst[3] = 255;
+					break;
+				default:
+					memcpy(dst, src, 4);
+					break;
+			}
+		}
+	}
+	page->Texture->LoadData(paddedWidth, paddedHeight, PixelFormat::RGBA, PixelType::UByte, data.data(), x, y);
+
+	region.Page  = page->Texture;
+	region.UvMin = glm::vec2(x + PADDING, y + PADDING) / (float)PAGE_SIZE;
+	region.UvMax = glm::vec2(x + PADDING + width, y + PADDING + height) / (float)PAGE_SIZE;
+	region.Size  = glm::ivec2(width, height);
+	return true;
+}
+
+size_t GuiAtlas::GetPageCount() {
+	return __pages.size();
+}
+
+const Texture2D::Sptr& GuiAtlas::GetPage(size_t index) {
+	LOG_ASSERT(index < __pages.size(), "GUI atlas page index out of range");
+	return __pages[index].Texture;
+}
+
+GuiAtlas::Page& GuiAtlas::__CreatePage() {
+	// Mip maps would blend neighbouring images together, so pages are only linearly filtered
+	Texture2DDescription desc;
+	desc.Width               = PAGE_SIZE;
+	desc.Height              = PAGE_SIZE;
+	desc.Format              = InternalFormat::RGBA8;
+	desc.MinificationFilter  = MinFilter::Linear;
+	desc.MagnificationFilter = MagFilter::Linear;
+	desc.HorizontalWrap      = WrapMode::ClampToEdge;
+	desc.VerticalWrap        = WrapMode::ClampToEdge;
+	desc.GenerateMipMaps     = false;
+
+	Page page;
+	page.Texture = std::make_shared<Texture2D>(desc);
+	page.Skyline.push_back({ 0, 0, PAGE_SIZE });
+	__pages.push_back(page);
+
+	LOG_INFO("Created GUI atlas page {} ({}x{})", __pages.size() - 1, PAGE_SIZE, PAGE_SIZE);
+	return __pages.back();
+}
+
+bool GuiAtlas::__Fit(const Page& page, size_t nodeIndex, uint32_t width, uint32_t height, uint32_t& y) {
+	const SkylineNode& start = page.Skyline[nodeIndex];
+	if (start.X + width > PAGE_SIZE) {
+		return false;
+	}
+
+	// The rectangle has to sit on top of the highest node that it spans
+	y = start.Y;
+	uint32_t remaining = width;
+	for (size_t ix = nodeIndex; remaining > 0; ix++) {
+		if (ix >= page.Skyline.size()) {
+			return false;
+		}
+		y = glm::max(y, page.Skyline[ix].Y);
+		if (y + height > PAGE_SIZE) {
+			return false;
+		}
+		remaining -= glm::min(remaining, page.Skyline[ix].Width);
+	}
+	return true;
+}
+
+bool GuiAtlas::__Pack(Page& page, uint32_t width, uint32_t height, uint32_t& x, uint32_t& y) {
+	// Bottom-left heuristic, pick the position with the lowest top edge, and the narrowest node on ties
+	size_t   bestIndex  = page.Skyline.size();
+	uint32_t bestTop    = UINT32_MAX;
+	uint32_t bestWidth  = UINT32_MAX;
+	uint32_t bestY      = 0;
+	for (size_t ix = 0; ix < page.Skyline.size(); ix++) {
+		uint32_t fitY = 0;
+		if (__Fit(page, ix, width, height, fitY)) {
+			uint32_t top = fitY + height;
+			if (top < bestTop || (top == bestTop && page.Skyline[ix].Width < bestWidth)) {
+				bestIndex = ix;
+				bestTop   = top;
+				bestWidth = page.Skyline[ix].Width;
+				bestY     = fitY;
+			}
+		}
+	}
+	if (bestIndex == page.Skyline.size()) {
+		return false;
+	}
+
+	x = page.Skyline[bestIndex].X;
+	y = bestY;
+
+	// Add the new node, then trim the nodes that it now covers
+	page.Skyline.insert(page.Skyline.begin() + bestIndex, { x, y + height, width });
+	for (size_t ix = bestIndex + 1; ix < page.Skyline.size(); ) {
+		uint32_t prevEnd = page.Skyline[ix - 1].X + page.Skyline[ix - 1].Width;
+		SkylineNode& node = page.Skyline[ix];
+		if (node.X >= prevEnd) {
+			break;
+		}
+		uint32_t shrink = prevEnd - node.X;
+		if (node.Width <= shrink) {
+			page.Skyline.erase(page.Skyline.begin() + ix);
+			continue;
+		}
+		node.X     += shrink;
+		node.Width -= shrink;
+		break;
+	}
+
+	// Merge neighbouring nodes at the same height
+	for (size_t ix = 0; ix + 1 < page.Skyline.size(); ) {
+		if (page.Skyline[ix].Y == page.Skyline[ix + 1].Y) {
+			page.Skyline[ix].Width += page.Skyline[ix + 1].Width;
+			page.Skyline.erase(page.Skyline.begin() + ix + 1);
+		} else {
+			ix++;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <GLM/glm.hpp>
+#include "Graphics/Textures/Texture2D.h"
+
+/// <summary>
+/// Packs GUI images and font glyphs into a small number of large RGBA pages, so that
+/// GUI elements using different images can be drawn together by the GuiBatcher
+///
+/// Images are placed with a skyline bottom-left packer, and are surrounded by a border
+/// of their own edge pixels so that filtering does not bleed in from their neighbours.
+/// Regions are never released, the atlas is meant for images that live as long as the app
+/// </summary>
+class GuiAtlas {
+public:
+	/// <summary>
+	/// The width and height of each atlas page in pixels
+	/// </summary>
+	static const uint32_t PAGE_SIZE = 1024;
+	/// <summary>
+	/// The number of pixels each image is extruded by on every side
+	/// </summary>
+	static const uint32_t PADDING = 1;
+
+	/// <summary>
+	/// Describes where an image lives in the atlas
+	/// </summary>
+	struct Region {
+		// The page texture that the image was packed into
+		Texture2D::Sptr Page;
+		// The UV coordinates of the image within the page, excluding padding
+		glm::vec2       UvMin;
+		glm::vec2       UvMax;
+		// The size of the image in pixels
+		glm::ivec2      Size;
+
+		Region() :
+			Page(nullptr),
+			UvMin(glm::vec2(0.0f)),
+			UvMax(glm::vec2(0.0f)),
+			Size(glm::ivec2(0)) { }
+
+		bool IsValid() const { return Page != nullptr; }
+
+		/// <summary>
+		/// Converts a UV coordinate in the 0-1 range of the source image into page UVs
+		/// </summary>
+		glm::vec2 MapUV(const glm::vec2& uv) const { return UvMin + uv * (UvMax - UvMin); }
+	};
+
+	/// <summary>
+	/// Packs an image into the atlas, creating a new page if it does not fit in an existing one
+	///
+	/// Single channel images are treated as coverage (ex: font glyphs), and are stored as white
+	/// with the coverage in the alpha channel, so that they can be drawn with the same shader as
+	/// regular images
+	/// </summary>
+	/// <param name="pixels">The image data, rows are tightly packed</param>
+	/// <param name="width">The width of the image in pixels</param>
+	/// <param name="height">The height of the image in pixels</param>
+	/// <param name="numChannels">The number of 8 bit channels in the image (1, 3 or 4)</param>
+	/// <param name="region">Receives the region the image was packed into</param>
+	/// <returns>True if the image was packed, false if it is too large for a page</returns>
+	static bool Add(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t numChannels, Region& region);
+
+	/// <summary>
+	/// Gets the number of pages that have been created
+	/// </summary>
+	static size_t GetPageCount();
+	/// <summary>
+	/// Gets the texture for a page in the atlas
+	/// </summary>
+	static const Texture2D::Sptr& GetPage(size_t index);
+
+private:
+	// A segment of the skyline, everything below Y over the span [X, X + Width) is in use
+	struct SkylineNode {
+		uint32_t X;
+		uint32_t Y;
+		uint32_t Width;
+	};
+
+	struct Page {
+		Texture2D::Sptr          Texture;
+		std::vector<SkylineNode> Skyline;
+	};
+
+	static std::vector<Page> __pages;
+
+	static Page& __CreatePage();
+	/// <summary>
+	/// Finds the lowest position in the page that a rectangle will fit, and adds it to the skyline
+	/// </summary>
+	static bool __Pack(Page& page, uint32_t width, uint32_t height, uint32_t& x, uint32_t& y);
+	/// <summary>
+	/// Gets the height a rectangle would be placed at if it's left edge starts on the given node
+	/// </summary>
+	static bool __Fit(const Page& page, size_t nodeIndex, uint32_t width, uint32_t height, uint32_t& y);
+};
@@ -2,27 +2,127 @@
 #include <GLM/gtc/matrix_transform.hpp>
 #include <GLM/gtc/matrix_inverse.hpp>
 #include "Utils/ResourceManager/ResourceManager.h"
-#include <locale>
-#include <codecvt>
+#include "Utils/StringUtils.h"
+#include <algorithm>
 
-
-std::unordered_map<Texture2D*, GuiBatcher::MeshData> GuiBatcher::_meshBuilders;
+// The initial number of vertices in the retained buffer, enough for 4096 quads
+static const uint32_t INITIAL_RETAINED_CAPACITY = 16 * 1024;
+// Retained vertices are written directly into mapped memory, and are never read back by the CPU
+static const BufferMapMode RETAINED_MAP_FLAGS = BufferMapMode::Write | BufferMapMode::Persistent | BufferMapMode::Coherent;
 
 VertexArrayObject::Sptr GuiBatcher::__vao = nullptr;
+VertexBuffer::Sptr GuiBatcher::__vbo = nullptr;
+std::vector<VertexPosColTex> GuiBatcher::__immediateVertices;
+
+VertexArrayObject::Sptr GuiBatcher::__retainedVao = nullptr;
+VertexBuffer::Sptr GuiBatcher::__retainedVbo = nullptr;
+VertexArrayObject::VertexBufferBinding* GuiBatcher::__retainedBinding = nullptr;
+VertexPosColTex* GuiBatcher::__retainedData = nullptr;
+uint32_t GuiBatcher::__retainedCapacity = 0;
+std::vector<GuiBatcher::FreeRange> GuiBatcher::__freeRanges;
+std::vector<GuiBatcher::FreeRange> GuiBatcher::__releasedRanges;
+std::vector<GuiBatcher::PendingRelease> GuiBatcher::__pendingReleases;
+uint32_t GuiBatcher::__generation = 0;
+
+GuiBatcher::RetainedGeometry* GuiBatcher::__recording = nullptr;
+bool GuiBatcher::__isRebuilding = false;
+std::vector<VertexPosColTex> GuiBatcher::__scratchVertices;
+
 IndexBuffer::Sptr GuiBatcher::__ibo = nullptr;
+uint32_t GuiBatcher::__quadCapacity = 0;
+uint32_t GuiBatcher::__maxDrawQuads = 0;
+
+std::vector<GuiBatcher::DrawBatch> GuiBatcher::__batches;
+std::vector<GLsizei> GuiBatcher::__drawCounts;
+std::vector<GLint> GuiBatcher::__drawBaseVertices;
+std::vector<const void*> GuiBatcher::__drawOffsets;
 
-Texture2D::Sptr GuiBatcher::__defaultUITexture = nullptr;
+GuiSprite::Sptr GuiBatcher::__defaultUISprite = nullptr;
 int GuiBatcher::__defaultEdgeRadius = 0;
 
-VertexBuffer::Sptr GuiBatcher::__vbo = nullptr;
 ShaderProgram::Sptr GuiBatcher::__shader = nullptr;
 ShaderProgram::Sptr GuiBatcher::__fontShader = nullptr;
+ShaderProgram::Sptr GuiBatcher::__distanceFieldShader = nullptr;
 glm::ivec2 GuiBatcher::__windowSize = {0, 0};
 glm::mat4 GuiBatcher::__projection = glm::mat4(1.0f);
 glm::mat3 GuiBatcher::__model = glm::mat3(1.0f);
 std::vector<glm::mat3> GuiBatcher::__modelTransformStack = std::vector<glm::mat3>();
 std::vector<GuiBatcher::IRect> GuiBatcher::__scissorRects = std::vector<GuiBatcher::IRect>();
 
+GuiBatcher::RetainedGeometry::RetainedGeometry() :
+	_segments(),
+	_baseVertex(0),
+	_vertexCount(0),
+	_model(glm::mat3(1.0f)),
+	_generation(0),
+	_isValid(false)
+{ }
+
+GuiBatcher::RetainedGeometry::RetainedGeometry(const RetainedGeometry& other) :
+	RetainedGeometry()
+{ }
+
+GuiBatcher::RetainedGeometry& GuiBatcher::RetainedGeometry::operator=(const RetainedGeometry& other) {
+	Invalidate();
+	return *this;
+}
+
+GuiBatcher::RetainedGeometry::~RetainedGeometry() {
+	Invalidate();
+}
+
+void GuiBatcher::RetainedGeometry::Invalidate() {
+	GuiBatcher::__ReleaseRetained(_baseVertex, _vertexCount);
+	_segments.clear();
+	_baseVertex  = 0;
+	_vertexCount = 0;
+	_isValid     = false;
+}
+
+bool GuiBatcher::BeginRetained(RetainedGeometry& geometry, bool isDirty /*= false*/) {
+	LOG_ASSERT(__recording == nullptr, "BeginRetained calls cannot be nested!");
+	__StaticInit();
+	__recording = &geometry;
+
+	// Vertices are stored post-transform, so any change to the model transform requires a rebuild
+	__isRebuilding = isDirty || !geometry._isValid || geometry._generation != __generation || geometry._model != __model;
+	if (__isRebuilding) {
+		geometry._segments.clear();
+		__scratchVertices.clear();
+	}
+	return __isRebuilding;
+}
+
+void GuiBatcher::EndRetained() {
+	LOG_ASSERT(__recording != nullptr, "EndRetained called without a matching BeginRetained!");
+	RetainedGeometry& geometry = *__recording;
+	__recording = nullptr;
+
+	if (__isRebuilding) {
+		__isRebuilding = false;
+
+		// Always write to a new range, the old one may still be in use by the GPU for a previous frame
+		__ReleaseRetained(geometry._baseVertex, geometry._vertexCount);
+		geometry._vertexCount = static_cast<uint32_t>(__scratchVertices.size());
+		geometry._baseVertex  = 0;
+		if (geometry._vertexCount > 0) {
+			geometry._baseVertex = __AllocateRetained(geometry._vertexCount);
+			memcpy(__retainedData + geometry._baseVertex, __scratchVertices.data(), sizeof(VertexPosColTex) * geometry._vertexCount);
+		}
+		geometry._model      = __model;
+		geometry._generation = __generation;
+		geometry._isValid    = true;
+	}
+
+	for (const auto& segment : geometry._segments) {
+		__SubmitDraw(segment.Texture.get(), segment.Shader, true, geometry._baseVertex + segment.FirstQuad * 4, segment.QuadCount);
+	}
+}
+
+void GuiBatcher::InvalidateRetained() {
+	__generation++;
+}
+
 void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const Texture2D::Sptr& tex, const glm::vec2 uvMin, const glm::vec2 uvMax) {
 	// Create vertices and transform positions
 	VertexPosColTex verts[4];
@@ -30,16 +130,11 @@ void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm:
 	verts[1].Position = __model * glm::vec3(min.x, max.y, 1.0f);
 	verts[2].Position = __model * glm::vec3(max.x, max.y, 1.0f);
 	verts[3].Position = __model * glm::vec3(max.x, min.y, 1.0f);
-		
-	// Grab mesh info for the texture batch
-	MeshData& mesh = _meshBuilders[tex.get()];
-	// We can use the vertex count for depth, so that things drawn later have a bit of spacing
-	float depth = mesh.Builder.GetVertexCount() / 1000.0f;
 
-	// Copy in all color and set depth 
+	// Copy in all color, depth is left at 0 since draw order determines layering
 	for (int ix = 0; ix < 4; ix++) {
 		verts[ix].Color = color;
-		verts[ix].Position.z = depth;
+		verts[ix].Position.z = 0.0f;
 	}
 
 	// Copy over UV coords
@@ -48,21 +143,32 @@ void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm:
 	verts[2].UV = glm::vec2(uvMax.x, uvMin.y);
 	verts[3].UV = glm::vec2(uvMax.x, uvMax.y);
 
-	// Add vertices and indices to range
-	uint32_t ix = mesh.Builder.AddVertexRange(verts, 4);
-	mesh.Builder.AddIndexTri(ix + 0, ix + 2, ix + 1);
-	mesh.Builder.AddIndexTri(ix + 0, ix + 3, ix + 2);
+	__EmitQuad(verts, tex, GuiShaderMode::Sprite);
 }
 
 void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const Texture2D::Sptr& tex, int edgeRadius)
+{
+	__PushSlicedRect(min, max, color, tex, { 0,0 }, { 1,1 }, glm::vec2(tex->GetWidth(), tex->GetHeight()), edgeRadius);
+}
+
+void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const GuiSprite::Sptr& sprite, int edgeRadius)
+{
+	const GuiAtlas::Region& region = sprite->GetRegion();
+	if (!region.IsValid()) {
+		return;
+	}
+	__PushSlicedRect(min, max, color, region.Page, region.UvMin, region.UvMax, glm::vec2(region.Size), edgeRadius);
+}
+
+void GuiBatcher::__PushSlicedRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const Texture2D::Sptr& tex, const glm::vec2& uvMin, const glm::vec2& uvMax, const glm::vec2& sliceSize, int edgeRadius)
 {
 	if (edgeRadius <= 0) {
-		PushRect(min, max, color, tex, { 0,0 }, { 1,1 });
+		PushRect(min, max, color, tex, uvMin, uvMax);
 	} 
 	else {
 		glm::vec2 edgeOffset;
-		edgeOffset.x = edgeRadius / ((float)tex->GetWidth() - 2);
-		edgeOffset.y = edgeRadius / ((float)tex->GetHeight() - 2);
+		edgeOffset.x = edgeRadius / (sliceSize.x - 2) * (uvMax.x - uvMin.x);
+		edgeOffset.y = edgeRadius / (sliceSize.y - 2) * (uvMax.y - uvMin.y);
 		
 		// edge [min/max] [X,Y] screen
 		float eMinXS = min.x + edgeRadius;
@@ -71,25 +177,25 @@ void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm:
 		float eMaxYS = max.y - edgeRadius;
 
 		// UV [min/max] [X,Y]
-		float uMinXS = edgeOffset.x;
-		float uMaxXS = 1.0f - edgeOffset.x;
-		float uMinYS = edgeOffset.y;
-		float uMaxYS = 1.0f - edgeOffset.y;
+		float uMinXS = uvMin.x + edgeOffset.x;
+		float uMaxXS = uvMax.x - edgeOffset.x;
+		float uMinYS = uvMin.y + edgeOffset.y;
+		float uMaxYS = uvMax.y - edgeOffset.y;
 
 		// Left column
-		PushRect(glm::vec2(min.x, min.y),  glm::vec2(eMinXS, eMinYS), color, tex, glm::vec2(0.0f, uMaxYS),   glm::vec2(uMinXS, 1.0f));
-		PushRect(glm::vec2(min.x, eMinYS), glm::vec2(eMinXS, eMaxYS), color, tex, glm::vec2(0.0f, uMinYS), glm::vec2(uMinXS, uMaxYS));
-		PushRect(glm::vec2(min.x, eMaxYS), glm::vec2(eMinXS, max.y),  color, tex, glm::vec2(0.0f, 0.0f), glm::vec2(uMinXS, uMinYS));
+		PushRect(glm::vec2(min.x, min.y),  glm::vec2(eMinXS, eMinYS), color, tex, glm::vec2(uvMin.x, uMaxYS),   glm::vec2(uMinXS, uvMax.y));
+		PushRect(glm::vec2(min.x, eMinYS), glm::vec2(eMinXS, eMaxYS), color, tex, glm::vec2(uvMin.x, uMinYS), glm::vec2(uMinXS, uMaxYS));
+		PushRect(glm::vec2(min.x, eMaxYS), glm::vec2(eMinXS, max.y),  color, tex, glm::vec2(uvMin.x, uvMin.y), glm::vec2(uMinXS, uMinYS));
 
 		// Center column
-		PushRect(glm::vec2(eMinXS, min.y),  glm::vec2(eMaxXS, eMinYS), color, tex, glm::vec2(uMinXS, uMaxYS),   glm::vec2(uMaxXS, 1.0f));
+		PushRect(glm::vec2(eMinXS, min.y),  glm::vec2(eMaxXS, eMinYS), color, tex, glm::vec2(uMinXS, uMaxYS),   glm::vec2(uMaxXS, uvMax.y));
 		PushRect(glm::vec2(eMinXS, eMinYS), glm::vec2(eMaxXS, eMaxYS), color, tex, glm::vec2(uMinXS, uMinYS), glm::vec2(uMaxXS, uMaxYS));
-		PushRect(glm::vec2(eMinXS, eMaxYS), glm::vec2(eMaxXS, max.y), color, tex,  glm::vec2(uMinXS, 0.0f), glm::vec2(uMaxXS, uMinYS));
+		PushRect(glm::vec2(eMinXS, eMaxYS), glm::vec2(eMaxXS, max.y), color, tex,  glm::vec2(uMinXS, uvMin.y), glm::vec2(uMaxXS, uMinYS));
 
 		// Right column
-		PushRect(glm::vec2(eMaxXS, min.y),  glm::vec2(max.x, eMinYS), color, tex, glm::vec2(uMaxXS, uMaxYS),   glm::vec2(1.0f, 1.0f));
-		PushRect(glm::vec2(eMaxXS, eMinYS), glm::vec2(max.x, eMaxYS), color, tex, glm::vec2(uMaxXS, uMinYS), glm::vec2(1.0f, uMaxYS));
-		PushRect(glm::vec2(eMaxXS, eMaxYS), glm::vec2(max.x, max.y),  color, tex, glm::vec2(uMaxXS, 0.0f), glm::vec2(1.0f, uMinYS));
+		PushRect(glm::vec2(eMaxXS, min.y),  glm::vec2(max.x, eMinYS), color, tex, glm::vec2(uMaxXS, uMaxYS),   glm::vec2(uvMax.x, uvMax.y));
+		PushRect(glm::vec2(eMaxXS, eMinYS), glm::vec2(max.x, eMaxYS), color, tex, glm::vec2(uMaxXS, uMinYS), glm::vec2(uvMax.x, uMaxYS));
+		PushRect(glm::vec2(eMaxXS, eMaxYS), glm::vec2(max.x, max.y),  color, tex, glm::vec2(uMaxXS, uvMin.y), glm::vec2(uvMax.x, uMinYS));
 	}
 }
 
@@ -98,128 +204,293 @@ void GuiBatcher::SetProjection(const glm::mat4& projection) {
 }
 
 void GuiBatcher::RenderText(const std::wstring& text, const Font::Sptr& font, const glm::vec2& position, const glm::vec4& color, float scale /*= 1.0f*/) {
-	// How many characters we have
-	size_t length = text.size();
-
-	// Tracks the offset of the character
-	glm::vec2 offset = glm::vec2(0.0f);
+	// Re-use the same layout storage between calls to avoid allocating every frame
+	static TextLayout layout;
+	font->LayoutString(text, scale, layout);
+	RenderText(layout, font, position, color);
+}
 
-	// Transform the origin based off the model transform
-	glm::vec2 origin = position;
+void GuiBatcher::RenderText(const std::string& text, const Font::Sptr& font, const glm::vec2& position, const glm::vec4& color, float scale /*= 1.0f*/)
+{
+	static std::wstring unicode;
+	StringTools::Utf8ToWide(text, unicode);
+	RenderText(unicode, font, position, color, scale);
+}
 
+void GuiBatcher::RenderText(const TextLayout& layout, const Font::Sptr& font, const glm::vec2& position, const glm::vec4& color) {
 	// Gets the texture used to render the font
-	Texture2D::Sptr atlas = font->GetAtlas();
-
-	// Grab the mesh builder and make sure it's a texture batch
-	MeshData& mesh = _meshBuilders[atlas.get()];
-	mesh.IsFont = true;
+	const Texture2D::Sptr& atlas = font->GetAtlas();
+	// Fonts in the shared GUI atlas are stored as white with coverage in alpha, so they use the regular shader
+	GuiShaderMode shader = font->UsesSharedAtlas() ? GuiShaderMode::Sprite : GuiShaderMode::Font;
+	// Distance field fonts always keep their distance in alpha
+	if (font->UsesDistanceField()) {
+		shader = GuiShaderMode::DistanceField;
+	}
 
 	// Allocate some space for the vertices
 	VertexPosColTex verts[4];
-	verts[0].Color = color;
-	verts[1].Color = color;
-	verts[2].Color = color;
-	verts[3].Color = color;
-
-	float depth = mesh.Builder.GetVertexCount() / 1000.0f;
-
-	// Iterate over all characters in string
-	for (int i = 0; i < length; i++) {
-		// Grab the glyph data for the character
-		GlyphInfo glyph = font->GetGlyph(text[i], offset.x, offset.y);
-
-		// A newline will advance to the next line and return to the start of the line
-		if (text[i] == '\n') {
-			offset.y  += font->GetLineHeight() * scale;
-			offset.x = 0;
+	for (int ix = 0; ix < 4; ix++) {
+		verts[ix].Color = color;
+	}
+
+	// The glyphs have already been positioned, we just need to transform them
+	for (const GlyphQuad& quad : layout.Quads) {
+		for (int ix = 0; ix < 4; ix++) {
+			verts[ix].Position = __model * glm::vec3(position + quad.Positions[ix], 1.0f);
+			verts[ix].Position.z = 0.0f;
+			verts[ix].UV = quad.UVs[ix];
 		}
-		// A return character simply returns to the start of the line
-		else if (text[i] == '\r') {
-			offset.x = 0;
+		__EmitQuad(verts, atlas, shader);
+	}
+}
+
+void GuiBatcher::__EmitQuad(const VertexPosColTex* verts, const Texture2D::Sptr& tex, GuiShaderMode shader) {
+	if (__recording != nullptr) {
+		// Geometry that is not being rebuilt keeps its old vertices
+		if (!__isRebuilding) {
+			return;
 		}
-		// A tab character is 4 spaces
-		else if (text[i] == '\t') {
-			float xOffTemp{ 0 }, yOffTemp{ 0 };
-			glyph = font->GetGlyph(' ', xOffTemp, yOffTemp);
-			offset.x += glyph.OffsetX * 4;
+
+		uint32_t quad = static_cast<uint32_t>(__scratchVertices.size() / 4);
+		__scratchVertices.insert(__scratchVertices.end(), verts, verts + 4);
+
+		// Start a new segment whenever the texture or shader changes
+		auto& segments = __recording->_segments;
+		if (segments.empty() || segments.back().Texture != tex || segments.back().Shader != shader) {
+			segments.push_back({ tex, shader, quad, 0 });
 		}
-		// All other characters get rendered
-		else {
-			verts[0].Position = __model * glm::vec3(origin + (offset + glyph.Positions[0]) * scale, 1.0f);
-			verts[1].Position = __model * glm::vec3(origin + (offset + glyph.Positions[1]) * scale, 1.0f);
-			verts[2].Position = __model * glm::vec3(origin + (offset + glyph.Positions[2]) * scale, 1.0f);
-			verts[3].Position = __model * glm::vec3(origin + (offset + glyph.Positions[3]) * scale, 1.0f);
-			verts[0].UV = glyph.UVs[0];
-			verts[1].UV = glyph.UVs[1];
-			verts[2].UV = glyph.UVs[2];
-			verts[3].UV = glyph.UVs[3];
-
-			verts[0].Position.z = verts[1].Position.z = verts[2].Position.z = verts[3].Position.z = depth;
-
-			uint32_t ix = mesh.Builder.AddVertexRange(verts, 4);
-			mesh.Builder.AddIndexTri(ix + 0, ix + 1, ix + 2);
-			mesh.Builder.AddIndexTri(ix + 0, ix + 2, ix + 3);
-
-			// Advance the offset based on the size of the glyph
-			offset.x = glyph.OffsetX;
-			offset.y = glyph.OffsetY;
-
-			// If we have more characters, see if there's any kerning between the
-			// current and next character and add it to the x offset
-			if (i < length - 1) {
-				float kerning = font->GetKerning(text[i], text[i + 1]);
-				offset.x += kerning;
+		segments.back().QuadCount++;
+	} else {
+		uint32_t baseVertex = static_cast<uint32_t>(__immediateVertices.size());
+		__immediateVertices.insert(__immediateVertices.end(), verts, verts + 4);
+		__SubmitDraw(tex.get(), shader, false, baseVertex, 1);
+	}
+}
+
+void GuiBatcher::__SubmitDraw(Texture2D* tex, GuiShaderMode shader, bool isRetained, uint32_t baseVertex, uint32_t quadCount) {
+	if (tex == nullptr || quadCount == 0) {
+		return;
+	}
+
+	// Draws can only be merged with the previous batch, so that painter's order is kept
+	if (!__batches.empty()) {
+		DrawBatch& batch = __batches.back();
+		if (batch.Texture == tex && batch.Shader == shader && batch.IsRetained == isRetained) {
+			// If this range directly follows the last draw, we can just extend it
+			uint32_t last = batch.FirstDraw + batch.DrawCount - 1;
+			uint32_t lastQuads = static_cast<uint32_t>(__drawCounts[last]) / 6;
+			if (static_cast<uint32_t>(__drawBaseVertices[last]) + lastQuads * 4 == baseVertex) {
+				__drawCounts[last] += quadCount * 6;
+				__maxDrawQuads = glm::max(__maxDrawQuads, lastQuads + quadCount);
+				return;
 			}
+			__drawCounts.push_back(quadCount * 6);
+			__drawBaseVertices.push_back(baseVertex);
+			__maxDrawQuads = glm::max(__maxDrawQuads, quadCount);
+			batch.DrawCount++;
+			return;
+		}
+	}
+
+	__batches.push_back({ tex, shader, isRetained, static_cast<uint32_t>(__drawCounts.size()), 1 });
+	__drawCounts.push_back(quadCount * 6);
+	__drawBaseVertices.push_back(baseVertex);
+	__maxDrawQuads = glm::max(__maxDrawQuads, quadCount);
+}
+
+void GuiBatcher::__ReserveQuadIndices(uint32_t quadCount) {
+	if (quadCount <= __quadCapacity) {
+		return;
+	}
+	__quadCapacity = glm::max(quadCount, __quadCapacity * 2);
+
+	std::vector<uint32_t> indices;
+	indices.reserve((size_t)__quadCapacity * 6);
+	for (uint32_t ix = 0; ix < __quadCapacity; ix++) {
+		uint32_t base = ix * 4;
+		indices.push_back(base + 0);
+		indices.push_back(base + 1);
+		indices.push_back(base + 2);
+		indices.push_back(base + 0);
+		indices.push_back(base + 2);
+		indices.push_back(base + 3);
+	}
+	__ibo->LoadData(indices.data(), static_cast<uint32_t>(indices.size()));
+}
+
+uint32_t GuiBatcher::__AllocateRetained(uint32_t vertexCount) {
+	// First fit, try reclaiming ranges the GPU is done with before growing the buffer
+	auto findRange = [&]() {
+		return std::find_if(__freeRanges.begin(), __freeRanges.end(), [&](const FreeRange& range) {
+			return range.Size >= vertexCount;
+		});
+	};
+	auto it = findRange();
+	if (it == __freeRanges.end()) {
+		__ReclaimReleasedRanges();
+		it = findRange();
+	}
+	if (it == __freeRanges.end()) {
+		__GrowRetained(vertexCount);
+		it = findRange();
+		LOG_ASSERT(it != __freeRanges.end(), "Failed to grow retained GUI buffer");
+	}
+
+	uint32_t result = it->Offset;
+	it->Offset += vertexCount;
+	it->Size   -= vertexCount;
+	if (it->Size == 0) {
+		__freeRanges.erase(it);
+	}
+	return result;
+}
+
+void GuiBatcher::__ReleaseRetained(uint32_t offset, uint32_t vertexCount) {
+	if (vertexCount > 0) {
+		__releasedRanges.push_back({ offset, vertexCount });
+	}
+}
+
+void GuiBatcher::__FreeRange(uint32_t offset, uint32_t vertexCount) {
+	// Insert the range in sorted order, then merge with our neighbours
+	auto it = std::lower_bound(__freeRanges.begin(), __freeRanges.end(), offset, [](const FreeRange& range, uint32_t value) {
+		return range.Offset < value;
+	});
+	it = __freeRanges.insert(it, { offset, vertexCount });
+
+	auto next = it + 1;
+	if (next != __freeRanges.end() && it->Offset + it->Size == next->Offset) {
+		it->Size += next->Size;
+		__freeRanges.erase(next);
+	}
+	if (it != __freeRanges.begin()) {
+		auto prev = it - 1;
+		if (prev->Offset + prev->Size == it->Offset) {
+			prev->Size += it->Size;
+			__freeRanges.erase(it);
 		}
+	}
+}
 
+void GuiBatcher::__GrowRetained(uint32_t minAdditional) {
+	uint32_t oldCapacity = __retainedCapacity;
+	uint32_t newCapacity = glm::max(oldCapacity * 2, oldCapacity + minAdditional);
+	newCapacity = glm::max(newCapacity, INITIAL_RETAINED_CAPACITY);
+
+	// Buffer storage is immutable, so we need to make a new buffer and copy over existing vertices on the GPU
+	VertexBuffer::Sptr vbo = VertexBuffer::Create(BufferUsage::DynamicDraw);
+	vbo->LoadStorage(nullptr, sizeof(VertexPosColTex), newCapacity, RETAINED_MAP_FLAGS);
+	if (__retainedVbo != nullptr) {
+		__retainedVbo->Unmap();
+		glCopyNamedBufferSubData(__retainedVbo->GetHandle(), vbo->GetHandle(), 0, 0, (GLsizeiptr)oldCapacity * sizeof(VertexPosColTex));
+		__retainedVao->ReplaceVertexBuffer(__retainedBinding, vbo);
+	} else {
+		__retainedBinding = __retainedVao->AddVertexBuffer(vbo, VertexPosColTex::V_DECL);
 	}
+	__retainedVbo  = vbo;
+	__retainedData = reinterpret_cast<VertexPosColTex*>(__retainedVbo->Map(RETAINED_MAP_FLAGS));
+	LOG_ASSERT(__retainedData != nullptr, "Failed to map retained GUI buffer");
+
+	__FreeRange(oldCapacity, newCapacity - oldCapacity);
+	__retainedCapacity = newCapacity;
 
+	if (oldCapacity > 0) {
+		LOG_INFO("Expanding retained GUI buffer from {} vertices to {} vertices", oldCapacity, newCapacity);
+	}
 }
 
-void GuiBatcher::RenderText(const std::string& text, const Font::Sptr& font, const glm::vec2& position, const glm::vec4& color, float scale /*= 1.0f*/)
-{
-	static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-	RenderText(converter.from_bytes(text), font, position, color, scale);
+void GuiBatcher::__ReclaimReleasedRanges() {
+	// Fences are signaled in order, so we can stop at the first one that is still pending
+	size_t reclaimed = 0;
+	for (; reclaimed < __pendingReleases.size(); reclaimed++) {
+		PendingRelease& pending = __pendingReleases[reclaimed];
+		GLenum status = glClientWaitSync(pending.Fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+			break;
+		}
+		glDeleteSync(pending.Fence);
+		for (const FreeRange& range : pending.Ranges) {
+			__FreeRange(range.Offset, range.Size);
+		}
+	}
+	__pendingReleases.erase(__pendingReleases.begin(), __pendingReleases.begin() + reclaimed);
 }
 
 void GuiBatcher::Flush()
 {
 	__StaticInit();
+	__ReclaimReleasedRanges();
 
-	// Iterate over each texture and it's mesh
-	for (auto&[key, value] : _meshBuilders) {
-		Texture2D* tex = key;
-		// If the texture exists and the mesh has data
-		if (tex != nullptr && value.Builder.GetIndexCount() > 0) {
-			// Update the VAO and it's buffers
-			__vao->Bind();
-			__vbo->UpdateData(value.Builder.GetVertexDataPtr(), sizeof(VertexPosColTex), value.Builder.GetVertexCount(), true);
-			__ibo->UpdateData(value.Builder.GetIndexDataPtr(), sizeof(uint32_t), value.Builder.GetIndexCount(), true);
-
-			// Bind texture, send uniforms to shader
-			tex->Bind(0);
-			ShaderProgram::Sptr shader = value.IsFont ? __fontShader : __shader;
-			shader->Bind();
-			shader->SetUniformMatrix(0, &__projection, 1, false);
-
-			// Draw geometry
-			__vao->Draw();
-
-			// Clear mesh
-			value.Builder.Reset();
+	if (!__batches.empty()) {
+		// Immediate mode vertices are the only thing we need to upload, retained vertices are already on the GPU
+		if (!__immediateVertices.empty()) {
+			__vbo->UpdateData(__immediateVertices.data(), sizeof(VertexPosColTex), static_cast<uint32_t>(__immediateVertices.size()), true);
 		}
+		__ReserveQuadIndices(__maxDrawQuads);
+
+		// All our draws start at the beginning of the quad indices and use the base vertex to find their range
+		if (__drawOffsets.size() < __drawCounts.size()) {
+			__drawOffsets.resize(__drawCounts.size(), nullptr);
+		}
+
+		VertexArrayObject* boundVao = nullptr;
+		ShaderProgram* boundShader = nullptr;
+		for (const DrawBatch& batch : __batches) {
+			VertexArrayObject* vao = batch.IsRetained ? __retainedVao.get() : __vao.get();
+			if (vao != boundVao) {
+				vao->Bind();
+				boundVao = vao;
+			}
+
+			ShaderProgram* shader = __shader.get();
+			switch (batch.Shader) {
+				case GuiShaderMode::Font:
+					shader = __fontShader.get();
+					break;
+				case GuiShaderMode::DistanceField:
+					shader = __distanceFieldShader.get();
+					break;
+				default:
+					break;
+			}
+			// Skip batches whose shader failed to build, the results of drawing with them are undefined
+			if (!shader->WaitForLink()) {
+				continue;
+			}
+			if (shader != boundShader) {
+				shader->Bind();
+				shader->SetUniformMatrix(0, &__projection, 1, false);
+				boundShader = shader;
+			}
+
+			batch.Texture->Bind(0);
+			glMultiDrawElementsBaseVertex(GL_TRIANGLES, &__drawCounts[batch.FirstDraw], GL_UNSIGNED_INT, &__drawOffsets[batch.FirstDraw], batch.DrawCount, &__drawBaseVertices[batch.FirstDraw]);
+		}
+		VertexArrayObject::Unbind();
+	}
+
+	__batches.clear();
+	__drawCounts.clear();
+	__drawBaseVertices.clear();
+	__immediateVertices.clear();
+	__maxDrawQuads = 0;
+
+	// Ranges released this frame can be re-used once the GPU is done with everything submitted so far
+	if (!__releasedRanges.empty()) {
+		__pendingReleases.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), std::move(__releasedRanges) });
+		__releasedRanges.clear();
 	}
 }
 
 void GuiBatcher::PushModelTransform(const glm::mat3& transform) {
-	__modelTransformStack.push_back(transform);
+	__modelTransformStack.push_back(__model);
 	__model = __model * transform;
 }
 
 void GuiBatcher::PopModelTransform()
 {
 	LOG_ASSERT(__modelTransformStack.size() > 0, "Transform push/pop mismatch");
-	__model = __model * glm::inverse(__modelTransformStack.back());
+	__model = __modelTransformStack.back();
 	__modelTransformStack.pop_back();
 }
 
@@ -262,7 +533,7 @@ void GuiBatcher::__StaticInit()
 					}
 				)LIT", ShaderPartType::Fragment);
 
-		__shader->Link();
+		__shader->LinkAsync();
 
 		__fontShader = ShaderProgram::Create();
 		__fontShader->LoadShaderPart(R"LIT(#version 460
@@ -296,25 +567,60 @@ void GuiBatcher::__StaticInit()
 					}
 				)LIT" , ShaderPartType::Fragment);
 
-		__fontShader->Link();
+		__fontShader->LinkAsync();
+
+		__distanceFieldShader = ShaderProgram::Create();
+		__distanceFieldShader->LoadShaderPart(R"LIT(#version 460
+					layout(location = 0) in vec3 inPos;
+					layout(location = 1) in vec4 inColor;
+					layout(location = 3) in vec2 inUV;
+
+					layout(location = 0) out vec4 outColor;
+					layout(location = 1) out vec2 outUV;
+
+					layout(location = 0) uniform mat4 u_Projection;
+
+					void main() {
+						outColor = inColor;
+						outUV = inUV;
+						gl_Position = u_Projection * vec4(inPos, 1);
+					}
+				)LIT", ShaderPartType::Vertex);
+
+		__distanceFieldShader->LoadShaderPart(R"LIT(#version 460
+					layout(location = 0) in vec4 inColor;
+					layout(location = 1) in vec2 inUV;
+
+					layout(location = 0) out vec4 outColor;
+
+					uniform layout(binding=0) sampler2D s_Texture;
+
+					void main() {
+						// The glyph edge sits at 0.5, we smooth over roughly one screen pixel
+						// so that the text stays sharp no matter how much it is scaled
+						float dist = texture(s_Texture, inUV).a;
+						float edge = max(fwidth(dist), 0.0001);
+						float alpha = smoothstep(0.5 - edge, 0.5 + edge, dist);
+						outColor = vec4(inColor.rgb, inColor.a * alpha);
+					}
+				)LIT" , ShaderPartType::Fragment);
+
+		__distanceFieldShader->LinkAsync();
 
 		__vbo = VertexBuffer::Create(BufferUsage::DynamicDraw);
-		__ibo = IndexBuffer::Create(BufferUsage::DynamicDraw, IndexType::UInt);
+		__ibo = IndexBuffer::Create(BufferUsage::StaticDraw, IndexType::UInt);
+		__ReserveQuadIndices(1024);
 
 		__vao = VertexArrayObject::Create();
 		__vao->AddVertexBuffer(__vbo, VertexPosColTex::V_DECL);
 		__vao->SetIndexBuffer(__ibo);
 
-		// Generate a simple white texture with a black border
-		if (__defaultUITexture == nullptr) {
-			Texture2DDescription desc = Texture2DDescription();
-			desc.Width = 16;
-			desc.Height = 16;
-			desc.MinificationFilter = MinFilter::Nearest;
-			desc.MagnificationFilter = MagFilter::Nearest;
-			desc.Format = InternalFormat::RGBA8;
+		__retainedVao = VertexArrayObject::Create();
+		__GrowRetained(INITIAL_RETAINED_CAPACITY);
+		__retainedVao->SetIndexBuffer(__ibo);
 
-			__defaultUITexture = ResourceManager::CreateAsset<Texture2D>(desc);
+		// Generate a simple white sprite with a black border
+		if (__defaultUISprite == nullptr) {
 			glm::u8vec4 data[16 * 16];
 			// Set everything to white by default
 			memset(data, 255, 16 * 16 * 4);
@@ -326,7 +632,7 @@ void GuiBatcher::__StaticInit()
 					}
 				}
 			}
-			__defaultUITexture->LoadData(16, 16, PixelFormat::RGBA, PixelType::UByte, data);
+			__defaultUISprite = std::make_shared<GuiSprite>(16, 16, &data[0].x);
 		}
 
 		needsInit = false;
@@ -374,16 +680,18 @@ void GuiBatcher::PopScissorRect() {
 	glScissor(glm::min(bounds.Min.x, bounds.Max.x), glm::min(bounds.Min.y, bounds.Max.y), width, height);
 }
 
-void GuiBatcher::SetDefaultTexture(const Texture2D::Sptr& value) {
-	__defaultUITexture = value;
+void GuiBatcher::SetDefaultSprite(const GuiSprite::Sptr& value) {
+	__defaultUISprite = value;
+	InvalidateRetained();
 }
 
-const Texture2D::Sptr& GuiBatcher::GetDefaultTexture() {
-	return __defaultUITexture;
+const GuiSprite::Sptr& GuiBatcher::GetDefaultSprite() {
+	return __defaultUISprite;
 }
 
 void GuiBatcher::SetDefaultBorderRadius(int value) {
 	__defaultEdgeRadius = value;
+	InvalidateRetained();
 }
 
 int GuiBatcher::GetDefaultBorderRadius() {
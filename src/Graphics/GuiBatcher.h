@@ -7,8 +7,18 @@
 #include "Graphics/VertexArrayObject.h"
 #include "Graphics/VertexTypes.h"
 #include "Graphics/Font.h"
-#include "Utils/MeshBuilder.h"
-#include <unordered_map>
+#include "Graphics/GuiSprite.h"
+#include <vector>
+#include <EnumToString.h>
+
+	/// <summary>
+	/// Selects how the GUI batcher shades a quad
+	/// </summary>
+	ENUM(GuiShaderMode, uint8_t,
+		Sprite        = 0, // The texture color is multiplied by the vertex color
+		Font          = 1, // Glyph coverage is stored in the red channel of a font-only texture
+		DistanceField = 2  // A signed distance to the glyph edge is stored in the alpha channel
+	);
 
 	/// <summary>
 	/// The GUI Batcher class provides utilities for drawing rectangles and
@@ -16,6 +26,69 @@
 	/// </summary>
 	class GuiBatcher {
 	public:
+		/// <summary>
+		/// GUI geometry that is kept in a persistently mapped vertex buffer between frames, so that
+		/// it only needs to be rebuilt when something about it changes. Components should own one of
+		/// these for each element they draw, see BeginRetained
+		/// </summary>
+		class RetainedGeometry {
+		public:
+			RetainedGeometry();
+			// Copies do not share the vertex range, they will build their own when first drawn
+			RetainedGeometry(const RetainedGeometry& other);
+			RetainedGeometry& operator=(const RetainedGeometry& other);
+			~RetainedGeometry();
+
+			/// <summary>
+			/// Releases the vertices for this geometry, forcing it to be rebuilt the next time it is drawn
+			/// </summary>
+			void Invalidate();
+
+		private:
+			friend class GuiBatcher;
+
+			// A run of quads that all use the same texture and shader
+			struct Segment {
+				Texture2D::Sptr Texture;
+				GuiShaderMode   Shader;
+				uint32_t        FirstQuad;
+				uint32_t        QuadCount;
+			};
+
+			std::vector<Segment> _segments;
+			uint32_t  _baseVertex;
+			uint32_t  _vertexCount;
+			// The model transform and batcher generation that the vertices were built with
+			glm::mat3 _model;
+			uint32_t  _generation;
+			bool      _isValid;
+		};
+
+		/// <summary>
+		/// Begins drawing a retained piece of geometry. If this returns true, the geometry needs to be
+		/// rebuilt, and the caller should issue its PushRect and RenderText calls before calling 
+		/// EndRetained. Otherwise the vertices from a previous frame are re-used, and the caller
+		/// should go directly to EndRetained
+		/// 
+		/// Geometry is rebuilt automatically when the model transform has changed since it was built,
+		/// or when the default texture or border radius have changed
+		/// </summary>
+		/// <param name="geometry">The geometry to draw</param>
+		/// <param name="isDirty">True if the caller has changed something that requires a rebuild (ex: color or text)</param>
+		/// <returns>True if the geometry needs to be rebuilt</returns>
+		static bool BeginRetained(RetainedGeometry& geometry, bool isDirty = false);
+		/// <summary>
+		/// Finishes drawing a retained piece of geometry, uploading its vertices if they were rebuilt
+		/// and adding it to the batch in draw order
+		/// </summary>
+		static void EndRetained();
+
+		/// <summary>
+		/// Forces all retained geometry to be rebuilt the next time it is drawn, for instance when 
+		/// a font atlas has been re-generated
+		/// </summary>
+		static void InvalidateRetained();
+
 		/// <summary>
 		/// Adds a rectangle to the GUI batch, with a given border radius in pixels.
 		/// This can be used with textures to create rounded borders
@@ -38,6 +111,16 @@
 		/// <param name="uvMin">The maximum coord of the UV range</param>
 		static void PushRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const Texture2D::Sptr& tex, const glm::vec2 uvMin, const glm::vec2 uvMax);
 		/// <summary>
+		/// Adds a rectangle to the GUI batch using a sprite from the GUI atlas, with a given border radius
+		/// in pixels. Sprites on the same atlas page can be drawn in a single batch
+		/// </summary>
+		/// <param name="min">The minimum bounds in projection space coordinates</param>
+		/// <param name="max">The maximum bounds in projection space coordinates</param>
+		/// <param name="color">The color multiplier for the image</param>
+		/// <param name="sprite">The sprite to render with</param>
+		/// <param name="edgeRadius">The distance in pixels to the edge within the sprite for slicing</param>
+		static void PushRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const GuiSprite::Sptr& sprite, int edgeRadius = 0);
+		/// <summary>
 		/// Renders a left-aligned line of text at the given position using a font
 		/// </summary>
 		/// <param name="text">The unicode text to render</param>
@@ -55,6 +138,15 @@
 		/// <param name="color">The color of the text</param>
 		/// <param name="scale">The scaling to apply to the text</param>
 		static void RenderText(const std::string& text, const Font::Sptr& font, const glm::vec2& position, const glm::vec4& color, float scale = 1.0f);
+		/// <summary>
+		/// Renders text that has already been laid out with Font::LayoutString, this avoids
+		/// re-doing glyph lookups and kerning for text that does not change every frame
+		/// </summary>
+		/// <param name="layout">The positioned glyphs to render</param>
+		/// <param name="font">The font that the text was laid out with</param>
+		/// <param name="position">The position of the text in model space</param>
+		/// <param name="color">The color of the text</param>
+		static void RenderText(const TextLayout& layout, const Font::Sptr& font, const glm::vec2& position, const glm::vec4& color);
 
 		/// <summary>
 		/// Sets the projection matrix to use for rendering, should ideally be an orthographic
@@ -66,7 +158,7 @@
 		/// </summary>
 		static void SetWindowSize(const glm::ivec2& size);
 		/// <summary>
-		/// Draws all geometry to the screen and prepares for the next batch
+		/// Draws all geometry to the screen in the order it was submitted, and prepares for the next batch
 		/// </summary>
 		static void Flush();
 
@@ -94,17 +186,17 @@
 		static void PopScissorRect();
 
 		/// <summary>
-		/// Sets the default texture to use for the background of GUI objects
+		/// Sets the default sprite to use for the background of GUI objects
 		/// </summary>
-		static void SetDefaultTexture(const Texture2D::Sptr& value);
+		static void SetDefaultSprite(const GuiSprite::Sptr& value);
 		/// <summary>
-		/// Returns the current default texture for the background of GUI objects
+		/// Returns the current default sprite for the background of GUI objects
 		/// </summary>
-		static const Texture2D::Sptr& GetDefaultTexture();
+		static const GuiSprite::Sptr& GetDefaultSprite();
 
 		/// <summary>
 		/// Sets the default border radius of GUI objects in pixels, this should be the
-		/// distance from the edge of DefaultTexture to make slices for rounded rectangles
+		/// distance from the edge of DefaultSprite to make slices for rounded rectangles
 		/// </summary>
 		static void SetDefaultBorderRadius(int value);
 		/// <summary>
@@ -118,25 +210,99 @@
 			glm::ivec2 Max;
 		};
 
-		struct MeshData {
-			MeshBuilder<VertexPosColTex> Builder;
-			bool IsFont;
+		// A range of unused vertices in the retained buffer, kept sorted by offset
+		struct FreeRange {
+			uint32_t Offset;
+			uint32_t Size;
+		};
+
+		// Vertex ranges that were released, but may still be read by the GPU until the fence is signaled
+		struct PendingRelease {
+			GLsync                 Fence;
+			std::vector<FreeRange> Ranges;
+		};
+
+		// A run of draws that share a texture, shader and vertex source, drawn with one glMultiDrawElementsBaseVertex
+		struct DrawBatch {
+			Texture2D*    Texture;
+			GuiShaderMode Shader;
+			bool          IsRetained;
+			uint32_t   FirstDraw;
+			uint32_t   DrawCount;
 		};
 
 		static glm::ivec2 __windowSize;
 		static glm::mat4 __projection;
 		static glm::mat3 __model;
+		// Stores the model transform from before each push, so pops do not accumulate error
 		static std::vector<glm::mat3> __modelTransformStack;
 		static std::vector<IRect> __scissorRects;
 		static ShaderProgram::Sptr __shader;
 		static ShaderProgram::Sptr __fontShader;
-		static std::unordered_map<Texture2D*, MeshData> _meshBuilders;
+		static ShaderProgram::Sptr __distanceFieldShader;
+
+		// Immediate mode geometry, re-uploaded every flush
 		static VertexArrayObject::Sptr __vao;
 		static VertexBuffer::Sptr __vbo;
+		static std::vector<VertexPosColTex> __immediateVertices;
+
+		// Retained geometry, stored in a persistently mapped buffer
+		static VertexArrayObject::Sptr __retainedVao;
+		static VertexBuffer::Sptr __retainedVbo;
+		static VertexArrayObject::VertexBufferBinding* __retainedBinding;
+		static VertexPosColTex* __retainedData;
+		static uint32_t __retainedCapacity;
+		static std::vector<FreeRange> __freeRanges;
+		static std::vector<FreeRange> __releasedRanges;
+		static std::vector<PendingRelease> __pendingReleases;
+		static uint32_t __generation;
+
+		// The geometry being recorded between BeginRetained and EndRetained
+		static RetainedGeometry* __recording;
+		static bool __isRebuilding;
+		static std::vector<VertexPosColTex> __scratchVertices;
+
+		// Shared index buffer with the indices for a run of quads, used by both vertex sources
 		static IndexBuffer::Sptr __ibo;
+		static uint32_t __quadCapacity;
+		static uint32_t __maxDrawQuads;
+
+		// Draws in submission order, the per-draw arrays are indexed by DrawBatch::FirstDraw
+		static std::vector<DrawBatch> __batches;
+		static std::vector<GLsizei> __drawCounts;
+		static std::vector<GLint> __drawBaseVertices;
+		static std::vector<const void*> __drawOffsets;
 
-		static Texture2D::Sptr __defaultUITexture;
+		static GuiSprite::Sptr __defaultUISprite;
 		static int __defaultEdgeRadius;
 
 		static void __StaticInit();
+
+		/// <summary>
+		/// Adds a rectangle that is sliced into 9 parts, where the UV range is a sub-region of the texture
+		/// </summary>
+		/// <param name="sliceSize">The size in pixels used to convert the edge radius into UV space</param>
+		static void __PushSlicedRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const Texture2D::Sptr& tex, const glm::vec2& uvMin, const glm::vec2& uvMax, const glm::vec2& sliceSize, int edgeRadius);
+
+		/// <summary>
+		/// Adds a single quad to either the geometry being rebuilt, or the immediate mode batch
+		/// </summary>
+		static void __EmitQuad(const VertexPosColTex* verts, const Texture2D::Sptr& tex, GuiShaderMode shader);
+		/// <summary>
+		/// Appends a range of quads to the draw list, merging with the previous draw where possible
+		/// </summary>
+		static void __SubmitDraw(Texture2D* tex, GuiShaderMode shader, bool isRetained, uint32_t baseVertex, uint32_t quadCount);
+		/// <summary>
+		/// Makes sure the shared index buffer can draw the given number of quads in one call
+		/// </summary>
+		static void __ReserveQuadIndices(uint32_t quadCount);
+
+		static uint32_t __AllocateRetained(uint32_t vertexCount);
+		static void __ReleaseRetained(uint32_t offset, uint32_t vertexCount);
+		static void __FreeRange(uint32_t offset, uint32_t vertexCount);
+		static void __GrowRetained(uint32_t minAdditional);
+		/// <summary>
+		/// Returns ranges whose fences have been signaled to the free list
+		/// </summary>
+		static void __ReclaimReleasedRanges();
 	};
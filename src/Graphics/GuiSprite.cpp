@@ -0,0 +1,60 @@
+#include "Graphics/GuiSprite.h"
+#include <stb_image.h>
+#include "Logging.h"
+#include "Utils/JsonGlmHelpers.h"
+
+GuiSprite::GuiSprite() :
+	IResource(),
+	_filename(""),
+	_region()
+{ }
+
+GuiSprite::GuiSprite(const std::string& filePath) :
+	IResource(),
+	_filename(filePath),
+	_region()
+{
+	_LoadFromFile();
+}
+
+GuiSprite::GuiSprite(uint32_t width, uint32_t height, const uint8_t* rgba) :
+	IResource(),
+	_filename(""),
+	_region()
+{
+	if (!GuiAtlas::Add(rgba, width, height, 4, _region)) {
+		LOG_WARN("Generated GUI sprite ({}x{}) does not fit in a GUI atlas page", width, height);
+	}
+}
+
+GuiSprite::~GuiSprite() = default;
+
+nlohmann::json GuiSprite::ToJson() const {
+	return {
+		{ "filename", _filename }
+	};
+}
+
+GuiSprite::Sptr GuiSprite::FromJson(const nlohmann::json& data) {
+	return std::make_shared<GuiSprite>(JsonGet<std::string>(data, "filename", ""));
+}
+
+void GuiSprite::_LoadFromFile() {
+	if (_filename.empty()) {
+		return;
+	}
+
+	// Flip to match the orientation of images loaded by Texture2D, so UVs behave the same
+	int width = 0, height = 0, numChannels = 0;
+	stbi_set_flip_vertically_on_load(true);
+	uint8_t* data = stbi_load(_filename.c_str(), &width, &height, &numChannels, 4);
+	if (data == nullptr) {
+		LOG_WARN("Failed to load GUI sprite from {}", _filename);
+		return;
+	}
+
+	if (!GuiAtlas::Add(data, width, height, 4, _region)) {
+		LOG_WARN("GUI sprite {} ({}x{}) does not fit in a GUI atlas page", _filename, width, height);
+	}
+	stbi_image_free(data);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "Utils/ResourceManager/IResource.h"
+#include "Utils/Macros.h"
+#include "Graphics/GuiAtlas.h"
+
+/// <summary>
+/// An image for use in the GUI, which is packed into the shared GUI atlas rather
+/// than getting a texture of it's own. GUI elements that use sprites from the same
+/// atlas page can be drawn together in a single batch
+/// </summary>
+class GuiSprite : public IResource {
+public:
+	DEFINE_RESOURCE(GuiSprite);
+
+	/// <summary>
+	/// Default constructor, to be used by Resource manager and smart pointers only
+	/// </summary>
+	GuiSprite();
+	/// <summary>
+	/// Loads a sprite from an image file and packs it into the GUI atlas
+	/// </summary>
+	/// <param name="filePath">The path to the image</param>
+	GuiSprite(const std::string& filePath);
+	/// <summary>
+	/// Creates a sprite from RGBA8 pixel data and packs it into the GUI atlas. Note that
+	/// generated sprites cannot be re-created from the resource manifest
+	/// </summary>
+	/// <param name="width">The width of the image in pixels</param>
+	/// <param name="height">The height of the image in pixels</param>
+	/// <param name="rgba">The pixel data, with rows ordered bottom to top</param>
+	GuiSprite(uint32_t width, uint32_t height, const uint8_t* rgba);
+	virtual ~GuiSprite();
+
+	/// <summary>
+	/// Gets the path to the source image, or an empty string if the sprite was generated
+	/// </summary>
+	const std::string& GetFilename() const { return _filename; }
+
+	/// <summary>
+	/// Gets where the sprite lives in the GUI atlas, will be invalid if the sprite failed to load
+	/// </summary>
+	const GuiAtlas::Region& GetRegion() const { return _region; }
+	/// <summary>
+	/// Gets the atlas page texture that the sprite was packed into
+	/// </summary>
+	const Texture2D::Sptr& GetTexture() const { return _region.Page; }
+	/// <summary>
+	/// Gets the size of the sprite in pixels
+	/// </summary>
+	const glm::ivec2& GetSize() const { return _region.Size; }
+
+	virtual nlohmann::json ToJson() const override;
+	static GuiSprite::Sptr FromJson(const nlohmann::json& data);
+
+protected:
+	std::string      _filename;
+	GuiAtlas::Region _region;
+
+	void _LoadFromFile();
+};
@@ -0,0 +1,206 @@
+#include "MeshMegaBuffer.h"
+#include "Logging.h"
+#include <algorithm>
+#include <numeric>
+
+VertexArrayObject::Sptr MeshMegaBuffer::__vao = nullptr;
+VertexBuffer::Sptr      MeshMegaBuffer::__vbo = nullptr;
+IndexBuffer::Sptr       MeshMegaBuffer::__ibo = nullptr;
+VertexArrayObject::VertexBufferBinding* MeshMegaBuffer::__vboBinding = nullptr;
+
+std::vector<MeshMegaBuffer::FreeRange> MeshMegaBuffer::__freeVertices;
+std::vector<MeshMegaBuffer::FreeRange> MeshMegaBuffer::__freeIndices;
+uint32_t MeshMegaBuffer::__vertexCapacity = 0;
+uint32_t MeshMegaBuffer::__indexCapacity = 0;
+
+// Initial sizes for the buffers, these will double as needed
+static const uint32_t INITIAL_VERTEX_CAPACITY = 256 * 1024;
+static const uint32_t INITIAL_INDEX_CAPACITY  = 1024 * 1024;
+
+bool MeshMegaBuffer::IsCompatible(const VertexArrayObject::Sptr& mesh) {
+	if (mesh == nullptr || mesh->GetVertexCount() == 0) {
+		return false;
+	}
+
+	// All attributes must come from a single buffer, laid out exactly like our vertex type
+	const VertexArrayObject::VertexDeclaration& vDecl = mesh->GetVDecl();
+	const VertexArrayObject::VertexDeclaration& expected = VertexPosNormTexColTangents::V_DECL;
+	if (vDecl.size() != expected.size()) {
+		return false;
+	}
+	for (size_t ix = 0; ix < expected.size(); ix++) {
+		if (vDecl[ix].Slot != expected[ix].Slot || vDecl[ix].Size != expected[ix].Size ||
+			vDecl[ix].Type != expected[ix].Type || vDecl[ix].Stride != expected[ix].Stride ||
+			vDecl[ix].Offset != expected[ix].Offset) {
+			return false;
+		}
+	}
+
+	VertexArrayObject::VertexBufferBinding* binding = mesh->GetBufferBinding(AttribUsage::Position);
+	return binding != nullptr && binding->GetAttributes().size() == expected.size() && !binding->IsInstanced();
+}
+
+MeshMegaBuffer::Allocation MeshMegaBuffer::Add(const VertexArrayObject::Sptr& mesh) {
+	Allocation result;
+	if (!IsCompatible(mesh)) {
+		return result;
+	}
+	__Init();
+
+	const uint32_t stride = sizeof(VertexPosNormTexColTangents);
+	const VertexBuffer::Sptr& source = mesh->GetBufferBinding(AttribUsage::Position)->GetBuffer();
+	IndexBuffer::Sptr indices = mesh->GetIndexBuffer();
+
+	result.VertexCount = mesh->GetVertexCount();
+	result.IndexCount  = indices != nullptr ? indices->GetElementCount() : result.VertexCount;
+
+	if (!__AllocateRange(__freeVertices, result.VertexCount, result.BaseVertex)) {
+		__GrowVertices(result.VertexCount);
+		__AllocateRange(__freeVertices, result.VertexCount, result.BaseVertex);
+	}
+	if (!__AllocateRange(__freeIndices, result.IndexCount, result.FirstIndex)) {
+		__GrowIndices(result.IndexCount);
+		__AllocateRange(__freeIndices, result.IndexCount, result.FirstIndex);
+	}
+
+	// Vertices can always be copied directly on the GPU
+	glCopyNamedBufferSubData(source->GetHandle(), __vbo->GetHandle(), 0, (GLintptr)result.BaseVertex * stride, (GLsizeiptr)result.VertexCount * stride);
+
+	// Indices stay relative to the mesh, the base vertex is applied by the draw command
+	if (indices != nullptr && indices->GetElementType() == IndexType::UInt) {
+		glCopyNamedBufferSubData(indices->GetHandle(), __ibo->GetHandle(), 0, (GLintptr)result.FirstIndex * sizeof(uint32_t), (GLsizeiptr)result.IndexCount * sizeof(uint32_t));
+	} else {
+		std::vector<uint32_t> widened(result.IndexCount);
+		if (indices == nullptr) {
+			std::iota(widened.begin(), widened.end(), 0u);
+		} else {
+			std::vector<uint8_t> raw(indices->GetTotalSize());
+			glGetNamedBufferSubData(indices->GetHandle(), 0, raw.size(), raw.data());
+			for (uint32_t ix = 0; ix < result.IndexCount; ix++) {
+				widened[ix] = indices->GetElementType() == IndexType::UShort ? 
+					reinterpret_cast<const uint16_t*>(raw.data())[ix] : raw[ix];
+			}
+		}
+		glNamedBufferSubData(__ibo->GetHandle(), (GLintptr)result.FirstIndex * sizeof(uint32_t), (GLsizeiptr)widened.size() * sizeof(uint32_t), widened.data());
+	}
+
+	return result;
+}
+
+void MeshMegaBuffer::Remove(const Allocation& allocation) {
+	if (!allocation.IsValid() || __vao == nullptr) {
+		return;
+	}
+	__FreeRange(__freeVertices, allocation.BaseVertex, allocation.VertexCount);
+	__FreeRange(__freeIndices, allocation.FirstIndex, allocation.IndexCount);
+}
+
+const VertexArrayObject::Sptr& MeshMegaBuffer::GetVao() {
+	__Init();
+	return __vao;
+}
+
+void MeshMegaBuffer::__Init() {
+	if (__vao != nullptr) {
+		return;
+	}
+
+	__vertexCapacity = INITIAL_VERTEX_CAPACITY;
+	__indexCapacity  = INITIAL_INDEX_CAPACITY;
+
+	__vbo = VertexBuffer::Create(BufferUsage::StaticDraw);
+	__vbo->SetDebugName("Mega Buffer Vertices");
+	__vbo->LoadData(nullptr, sizeof(VertexPosNormTexColTangents), __vertexCapacity);
+
+	__ibo = IndexBuffer::Create(BufferUsage::StaticDraw);
+	__ibo->SetDebugName("Mega Buffer Indices");
+	__ibo->LoadData(nullptr, sizeof(uint32_t), __indexCapacity, IndexType::UInt);
+
+	__vao = VertexArrayObject::Create();
+	__vao->SetDebugName("Mega Buffer VAO");
+	__vboBinding = __vao->AddVertexBuffer(__vbo, VertexPosNormTexColTangents::V_DECL);
+	__vao->SetIndexBuffer(__ibo);
+	__vao->SetVDecl(VertexPosNormTexColTangents::V_DECL);
+
+	__freeVertices.push_back({ 0, __vertexCapacity });
+	__freeIndices.push_back({ 0, __indexCapacity });
+}
+
+bool MeshMegaBuffer::__AllocateRange(std::vector<FreeRange>& ranges, uint32_t count, uint32_t& offset) {
+	// First fit
+	auto it = std::find_if(ranges.begin(), ranges.end(), [&](const FreeRange& range) {
+		return range.Size >= count;
+	});
+	if (it == ranges.end()) {
+		return false;
+	}
+
+	offset = it->Offset;
+	it->Offset += count;
+	it->Size   -= count;
+	if (it->Size == 0) {
+		ranges.erase(it);
+	}
+	return true;
+}
+
+void MeshMegaBuffer::__FreeRange(std::vector<FreeRange>& ranges, uint32_t offset, uint32_t count) {
+	// Insert the range in sorted order, then merge with our neighbours
+	auto it = std::lower_bound(ranges.begin(), ranges.end(), offset, [](const FreeRange& range, uint32_t value) {
+		return range.Offset < value;
+	});
+	it = ranges.insert(it, { offset, count });
+
+	auto next = it + 1;
+	if (next != ranges.end() && it->Offset + it->Size == next->Offset) {
+		it->Size += next->Size;
+		ranges.erase(next);
+	}
+	if (it != ranges.begin()) {
+		auto prev = it - 1;
+		if (prev->Offset + prev->Size == it->Offset) {
+			prev->Size += it->Size;
+			ranges.erase(it);
+		}
+	}
+}
+
+void MeshMegaBuffer::__AddCapacity(std::vector<FreeRange>& ranges, uint32_t oldCapacity, uint32_t newCapacity) {
+	// Merge the new space with the last free range if it touches the old end
+	if (!ranges.empty() && ranges.back().Offset + ranges.back().Size == oldCapacity) {
+		ranges.back().Size += newCapacity - oldCapacity;
+	} else {
+		ranges.push_back({ oldCapacity, newCapacity - oldCapacity });
+	}
+}
+
+void MeshMegaBuffer::__GrowVertices(uint32_t minAdditional) {
+	const uint32_t stride = sizeof(VertexPosNormTexColTangents);
+	uint32_t newCapacity = std::max(__vertexCapacity * 2, __vertexCapacity + minAdditional);
+
+	VertexBuffer::Sptr vbo = VertexBuffer::Create(BufferUsage::StaticDraw);
+	vbo->SetDebugName("Mega Buffer Vertices");
+	vbo->LoadData(nullptr, stride, newCapacity);
+	glCopyNamedBufferSubData(__vbo->GetHandle(), vbo->GetHandle(), 0, 0, (GLsizeiptr)__vertexCapacity * stride);
+	__vao->ReplaceVertexBuffer(__vboBinding, vbo);
+	__vbo = vbo;
+
+	LOG_INFO("Expanding mesh mega buffer from {} vertices to {} vertices", __vertexCapacity, newCapacity);
+	__AddCapacity(__freeVertices, __vertexCapacity, newCapacity);
+	__vertexCapacity = newCapacity;
+}
+
+void MeshMegaBuffer::__GrowIndices(uint32_t minAdditional) {
+	uint32_t newCapacity = std::max(__indexCapacity * 2, __indexCapacity + minAdditional);
+
+	IndexBuffer::Sptr ibo = IndexBuffer::Create(BufferUsage::StaticDraw);
+	ibo->SetDebugName("Mega Buffer Indices");
+	ibo->LoadData(nullptr, sizeof(uint32_t), newCapacity, IndexType::UInt);
+	glCopyNamedBufferSubData(__ibo->GetHandle(), ibo->GetHandle(), 0, 0, (GLsizeiptr)__indexCapacity * sizeof(uint32_t));
+	__vao->SetIndexBuffer(ibo);
+	__ibo = ibo;
+
+	LOG_INFO("Expanding mesh mega buffer from {} indices to {} indices", __indexCapacity, newCapacity);
+	__AddCapacity(__freeIndices, __indexCapacity, newCapacity);
+	__indexCapacity = newCapacity;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Graphics/VertexArrayObject.h"
+#include "Graphics/VertexTypes.h"
+
+/// <summary>
+/// Stores the vertices and indices of many static meshes in one shared vertex buffer
+/// and one shared index buffer, so that they can all be drawn from a single VAO with
+/// glMultiDrawElementsIndirect
+/// 
+/// Only meshes using the VertexPosNormTexColTangents layout can be added, indices are
+/// widened to 32 bits
+/// </summary>
+class MeshMegaBuffer {
+public:
+	/// <summary>
+	/// Describes where a mesh lives in the mega buffers
+	/// </summary>
+	struct Allocation {
+		uint32_t BaseVertex;
+		uint32_t VertexCount;
+		uint32_t FirstIndex;
+		uint32_t IndexCount;
+
+		Allocation() :
+			BaseVertex(0),
+			VertexCount(0),
+			FirstIndex(0),
+			IndexCount(0) { }
+
+		bool IsValid() const { return IndexCount > 0; }
+	};
+
+	/// <summary>
+	/// Returns true if the given mesh can be stored in the mega buffers
+	/// </summary>
+	static bool IsCompatible(const VertexArrayObject::Sptr& mesh);
+
+	/// <summary>
+	/// Copies a mesh into the mega buffers, growing them if needed. The copy is done on the
+	/// GPU, except for meshes with 8 or 16 bit indices which need to be widened
+	/// </summary>
+	/// <param name="mesh">The mesh to copy</param>
+	/// <returns>The allocation for the mesh, which will be invalid if the mesh is not compatible</returns>
+	static Allocation Add(const VertexArrayObject::Sptr& mesh);
+	/// <summary>
+	/// Releases the space used by a mesh so that it can be re-used
+	/// </summary>
+	static void Remove(const Allocation& allocation);
+
+	/// <summary>
+	/// Gets the VAO that draws from the mega buffers
+	/// </summary>
+	static const VertexArrayObject::Sptr& GetVao();
+
+private:
+	// A range of unused elements in one of the buffers, kept sorted by offset
+	struct FreeRange {
+		uint32_t Offset;
+		uint32_t Size;
+	};
+
+	static VertexArrayObject::Sptr __vao;
+	static VertexBuffer::Sptr      __vbo;
+	static IndexBuffer::Sptr       __ibo;
+	static VertexArrayObject::VertexBufferBinding* __vboBinding;
+
+	static std::vector<FreeRange> __freeVertices;
+	static std::vector<FreeRange> __freeIndices;
+	static uint32_t __vertexCapacity;
+	static uint32_t __indexCapacity;
+
+	static void __Init();
+
+	static bool __AllocateRange(std::vector<FreeRange>& ranges, uint32_t count, uint32_t& offset);
+	static void __FreeRange(std::vector<FreeRange>& ranges, uint32_t offset, uint32_t count);
+	static void __AddCapacity(std::vector<FreeRange>& ranges, uint32_t oldCapacity, uint32_t newCapacity);
+
+	static void __GrowVertices(uint32_t minAdditional);
+	static void __GrowIndices(uint32_t minAdditional);
+};
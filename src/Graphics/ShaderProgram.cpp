@@ -3,29 +3,127 @@
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <thread>
+#include <map>
+#include <iomanip>
+#include <cstring>
+#include <algorithm>
 
 #include "Utils/FileHelpers.h"
+#include "Graphics/UniformHandle.h"
 #include "Utils/JsonGlmHelpers.h"
 
+namespace fs = std::filesystem;
+
+// These come from GL_KHR_parallel_shader_compile, which our loader may not have been generated with
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// Folder that linked program binaries are stored in
+const std::string binaryCacheFolder = "shader_cache/";
+
+uint32_t ShaderProgram::__linkGenerationCounter = 0;
+
+/// <summary>
+/// The header for a cached program binary
+/// </summary>
+struct ProgramBinaryHeader {
+	// A check value so we can ensure that we're loading in the right file type
+	char     HeaderBytes[4] ={ 'S', 'P', 'B', 'C' };
+	uint32_t Version = 0;
+	uint64_t Key = 0;
+	uint32_t BinaryFormat = 0;
+	uint32_t BinarySize = 0;
+};
+
+/// <summary>
+/// Information about the driver that we query once, program binaries are only valid
+/// for the driver that created them
+/// </summary>
+struct ShaderDriverInfo {
+	std::string Identifier;
+	bool        SupportsBinaries = false;
+	bool        SupportsParallelCompile = false;
+
+	static const ShaderDriverInfo& Get() {
+		static ShaderDriverInfo info = _Query();
+		return info;
+	}
+
+private:
+	static ShaderDriverInfo _Query() {
+		ShaderDriverInfo result;
+
+		const char* vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+		const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+		const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+		result.Identifier = std::string(vendor ? vendor : "") + "|" + (renderer ? renderer : "") + "|" + (version ? version : "");
+
+		// Drivers may support the program binary API but expose no formats, in which case we can't cache
+		GLint numFormats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+		result.SupportsBinaries = numFormats > 0;
+
+		// Let the driver use as many compiler threads as it wants
+		#ifdef GL_KHR_parallel_shader_compile
+		if (GLAD_GL_KHR_parallel_shader_compile) {
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+			result.SupportsParallelCompile = true;
+		}
+		#endif
+
+		LOG_INFO("Shader binary cache {}, parallel shader compile {}", result.SupportsBinaries ? "enabled" : "unavailable", result.SupportsParallelCompile ? "enabled" : "unavailable");
+		return result;
+	}
+};
+
+/// <summary>
+/// FNV-1a hash, used to build the binary cache key
+/// </summary>
+static inline void HashBytes(uint64_t& hash, const void* data, size_t size) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t ix = 0; ix < size; ix++) {
+		hash ^= bytes[ix];
+		hash *= 0x100000001b3ull;
+	}
+}
+static inline void HashString(uint64_t& hash, const std::string& value) {
+	// Include the length so that adjacent strings can't run together
+	uint64_t length = value.size();
+	HashBytes(hash, &length, sizeof(uint64_t));
+	HashBytes(hash, value.data(), value.size());
+}
+
 ShaderProgram::ShaderProgram() : 
 	IGraphicsResource(),
-	IResource()
+	IResource(),
+	_varyingsInterleaved(true),
+	_isLinkPending(false),
+	_isLinked(false),
+	_isFromBinaryCache(false),
+	_binaryCacheKey(0),
+	_linkGeneration(0)
 {
 	_rendererId = glCreateProgram();
 }
 
 ShaderProgram::ShaderProgram(const std::unordered_map<ShaderPartType, std::string>& filePaths) :
-	IGraphicsResource(),
-	IResource()
+	ShaderProgram()
 {
-	_rendererId = glCreateProgram();
 	for (auto& [type, path] : filePaths) {
 		LoadShaderPartFromFile(path.c_str(), type);
 	}
-	Link();
+	LinkAsync();
 }
 
 ShaderProgram::~ShaderProgram() {
+	// Clean up any shader parts left over from a link that never completed
+	for (auto& [type, id] : _handles) {
+		if (id != 0) {
+			glDeleteShader(id);
+		}
+	}
 	if (_rendererId != 0) {
 		glDeleteProgram(_rendererId);
 		_rendererId = 0;
@@ -33,53 +131,78 @@ ShaderProgram::~ShaderProgram() {
 }
 
 bool ShaderProgram::LoadShaderPart(const char* source, ShaderPartType type) {
-	// Creates a new shader part (VS, FS, GS, etc...)
-	GLuint handle = glCreateShader((GLenum)type);
-
-	// Load the GLSL source and compile it
-	glShaderSource(handle, 1, &source, nullptr);
-	glCompileShader(handle);
-
-	// Get the compilation status for the shader part
-	GLint status = 0;
-	glGetShaderiv(handle, GL_COMPILE_STATUS, &status);
-
-	if (status == GL_FALSE) {
-		// Get the size of the error log
-		GLint logSize = 0;
-		glGetShaderiv(handle, GL_INFO_LOG_LENGTH, &logSize);
+	// We can't know if the source compiles until we link, but we can catch missing source now
+	if (source == nullptr || source[0] == '\0') {
+		LOG_WARN("Attempted to load an empty {} shader, ignoring", ~type);
+		return false;
+	}
 
-		// Create a new character buffer for the log
-		char* log = new char[logSize];
+	// If we're overwriting, warn before we store
+	if (_resolvedSources.find(type) != _resolvedSources.end()) {
+		LOG_WARN("Another shader has been attached to this slot, overwriting");
+	}
+	_resolvedSources[type] = source;
 
-		// Get the log
-		glGetShaderInfoLog(handle, logSize, &logSize, log);
+	// Store info about where we got this data from
+	_fileSourceMap[type].IsFilePath = false;
+	_fileSourceMap[type].Source = source;
 
-		// Dump error log
-		LOG_ERROR("Failed to compile shader part:\n{}", log);
+	return true;
+}
 
-		// Clean up our log memory
-		delete[] log;
+void ShaderProgram::SetKeywords(const std::vector<std::string>& keywords) {
+	LOG_ASSERT(keywords.size() <= MAX_KEYWORDS, "Shaders can have at most {} keywords", MAX_KEYWORDS);
+	_keywords = keywords;
+	_variants.clear();
+}
 
-		// Delete the broken shader result
-		glDeleteShader(handle);
-		handle = 0;
+ShaderProgram* ShaderProgram::GetVariant(uint32_t keywordMask) {
+	if (_keywords.empty()) {
+		return this;
+	}
 
-		return false;
+	// Strip any bits that don't map to a keyword so they don't create duplicate variants
+	if (_keywords.size() < MAX_KEYWORDS) {
+		keywordMask &= (1u << _keywords.size()) - 1;
 	}
 
-	// If we're overwriting, warn and clean up the old program before we store
-	if (_handles[type] != 0) {
-		LOG_WARN("Another shader has been attached to this slot, overwriting");
-		glDeleteShader(_handles[type]);
+	auto it = _variants.find(keywordMask);
+	if (it != _variants.end()) {
+		return it->second.get();
 	}
-	_handles[type] = handle;
 
-	// Store info about where we got this data from
-	_fileSourceMap[type].IsFilePath = false;
-	_fileSourceMap[type].Source = source;
+	// Build the defines for this combination of keywords
+	std::stringstream defines;
+	defines << "#define SHADER_KEYWORDS " << keywordMask << "u\n";
+	for (size_t ix = 0; ix < _keywords.size(); ix++) {
+		if (keywordMask & (1u << ix)) {
+			defines << "#define " << _keywords[ix] << " 1\n";
+		}
+	}
+	std::string defineBlock = defines.str();
+
+	std::unique_ptr<ShaderProgram> variant = std::make_unique<ShaderProgram>();
+	variant->SetDebugName(GetDebugName() + " [" + std::to_string(keywordMask) + "]");
+	for (const auto& [type, source] : _resolvedSources) {
+		// Defines need to go after the #version directive, which must be the first thing in the source
+		std::string variantSource = source;
+		size_t versionPos = variantSource.find("#version");
+		size_t insertPos = versionPos != std::string::npos ? variantSource.find('\n', versionPos) : std::string::npos;
+		if (insertPos != std::string::npos) {
+			variantSource.insert(insertPos + 1, defineBlock);
+		} else {
+			variantSource.insert(0, defineBlock);
+		}
+		variant->LoadShaderPart(variantSource.c_str(), type);
+	}
+	variant->_varyings = _varyings;
+	variant->_varyingsInterleaved = _varyingsInterleaved;
+	variant->LinkAsync();
 
-	return status != GL_FALSE;
+	LOG_INFO("Compiling variant {} of shader \"{}\"", keywordMask, GetDebugName());
+	ShaderProgram* result = variant.get();
+	_variants[keywordMask] = std::move(variant);
+	return result;
 }
 
 bool ShaderProgram::LoadShaderPartFromFile(const char* path, ShaderPartType type) {
@@ -89,14 +212,12 @@ bool ShaderProgram::LoadShaderPartFromFile(const char* path, ShaderPartType type
 		// resolve #include directives
 		std::string source = FileHelpers::ReadResolveIncludes(path);
 		// Pass off to LoadShaderPart
-		bool result =  LoadShaderPart(source.c_str(), type);
-		_fileSourceMap[type].IsFilePath = true;
-		_fileSourceMap[type].Source = path;
-		if (result == false) {
-			LOG_ERROR("Source File: {}", path);
+		bool result = LoadShaderPart(source.c_str(), type);
+		if (result) {
+			_fileSourceMap[type].IsFilePath = true;
+			_fileSourceMap[type].Source = path;
 		}
-		glObjectLabel(GL_SHADER, _handles[type], -1, path);
-		return result; 
+		return result;
 	} else {
 		LOG_WARN("Could not open file at \"{}\"", path);
 		return false;
@@ -104,40 +225,87 @@ bool ShaderProgram::LoadShaderPartFromFile(const char* path, ShaderPartType type
 }
 
 bool ShaderProgram::Link() {
+	LinkAsync();
+	return WaitForLink();
+}
+
+void ShaderProgram::LinkAsync() {
+	// Finish any previous link first so we don't leak it's shader parts
+	if (_isLinkPending) {
+		WaitForLink();
+	}
 
 	LOG_TRACE("Starting shader link:");
-	GLenum err = glGetError();
-	
-	// Attach all our shaders
-	for (auto& [type, id] : _handles) {
-		if (id != 0) {
-			glAttachShader(_rendererId, id);
-			LOG_TRACE("\t{} - {}", ~type, _fileSourceMap[type].IsFilePath ? _fileSourceMap[type].Source : "<from source>");
+	const ShaderDriverInfo& driver = ShaderDriverInfo::Get();
+
+	_isLinkPending = true;
+	_isLinked = false;
+	_isFromBinaryCache = false;
+	_linkGeneration = ++__linkGenerationCounter;
+	_binaryCacheKey = _CalculateBinaryCacheKey();
+
+	// If we have a binary for this exact source and driver, we can skip compiling entirely
+	if (driver.SupportsBinaries && _LoadBinaryCache()) {
+		_isFromBinaryCache = true;
+		return;
+	}
+
+	// Kick off compiling all our stages, we don't check the status here so that the
+	// driver is free to compile them in the background
+	for (auto& [type, source] : _resolvedSources) {
+		GLuint handle = glCreateShader((GLenum)type);
+		const char* sourcePtr = source.c_str();
+		glShaderSource(handle, 1, &sourcePtr, nullptr);
+		glCompileShader(handle);
+
+		const ShaderSource& sourceInfo = _fileSourceMap[type];
+		if (sourceInfo.IsFilePath) {
+			glObjectLabel(GL_SHADER, handle, -1, sourceInfo.Source.c_str());
 		}
+
+		glAttachShader(_rendererId, handle);
+		LOG_TRACE("\t{} - {}", ~type, sourceInfo.IsFilePath ? sourceInfo.Source : "<from source>");
+		_handles[type] = handle;
+	}
+
+	// We need to let GL know we want the binary before we link
+	if (driver.SupportsBinaries) {
+		glProgramParameteri(_rendererId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	}
 
-	// Perform linking
+	// Perform linking, the result is checked in WaitForLink
 	glLinkProgram(_rendererId);
-	err = glGetError();
+}
 
-	// Remove shader parts to save space (we can do this since we only needed the shader parts to compile an actual shader program)
-	for (auto& [type, id] : _handles) { 
-		if (id != 0) {
-			glDetachShader(_rendererId, id);
-			glDeleteShader(id);
-		}
+bool ShaderProgram::IsLinkComplete() const {
+	if (!_isLinkPending) {
+		return true;
 	}
-	// Remove all the handles so we don't accidentally use them
-	_handles.clear();
+	// Without the extension, any query would block until the link is done
+	if (!ShaderDriverInfo::Get().SupportsParallelCompile) {
+		return true;
+	}
+	GLint complete = GL_TRUE;
+	glGetProgramiv(_rendererId, GL_COMPLETION_STATUS_KHR, &complete);
+	return complete != GL_FALSE;
+}
 
-	err = glGetError();
+bool ShaderProgram::WaitForLink() {
+	if (!_isLinkPending) {
+		return _isLinked;
+	}
+	_isLinkPending = false;
 
+	// This will block until the driver has finished linking
 	GLint status = 0;
 	glGetProgramiv(_rendererId, GL_LINK_STATUS, &status);
 
 	// If linking failed, figure out why
 	if (status == GL_FALSE)
 	{
+		// Errors in the stages will cause the link to fail, so report those first
+		_LogCompileErrors();
+
 		// Get the length of the log
 		GLint length = 0;
 		glGetProgramiv(_rendererId, GL_INFO_LOG_LENGTH, &length);
@@ -152,16 +320,163 @@ bool ShaderProgram::Link() {
 			LOG_ERROR("Shader failed to link for an unknown reason!");
 		}
 	} else {
-		LOG_TRACE("Linking complete, starting introspection");
+		LOG_TRACE("Linking complete{}, starting introspection", _isFromBinaryCache ? " (from binary cache)" : "");
+	}
+
+	// Remove shader parts to save space (we can do this since we only needed the shader parts to compile an actual shader program)
+	for (auto& [type, id] : _handles) { 
+		if (id != 0) {
+			glDetachShader(_rendererId, id);
+			glDeleteShader(id);
+		}
+	}
+	// Remove all the handles so we don't accidentally use them
+	_handles.clear();
+
+	// Store the program for next time
+	if (status != GL_FALSE && !_isFromBinaryCache && ShaderDriverInfo::Get().SupportsBinaries) {
+		_SaveBinaryCache();
 	}
 
 	// Perform our uniform introspection to see what uniforms are in the shader
 	_Introspect();
 
-	return status != GL_FALSE;
+	_isLinked = status != GL_FALSE;
+	return _isLinked;
+}
+
+void ShaderProgram::_LogCompileErrors() {
+	for (auto& [type, handle] : _handles) {
+		// Get the compilation status for the shader part
+		GLint status = 0;
+		glGetShaderiv(handle, GL_COMPILE_STATUS, &status);
+
+		if (status == GL_FALSE) {
+			// Get the size of the error log
+			GLint logSize = 0;
+			glGetShaderiv(handle, GL_INFO_LOG_LENGTH, &logSize);
+
+			// Create a new character buffer for the log
+			char* log = new char[logSize];
+
+			// Get the log
+			glGetShaderInfoLog(handle, logSize, &logSize, log);
+
+			// Dump error log
+			LOG_ERROR("Failed to compile shader part:\n{}", log);
+			if (_fileSourceMap[type].IsFilePath) {
+				LOG_ERROR("Source File: {}", _fileSourceMap[type].Source);
+			}
+
+			// Clean up our log memory
+			delete[] log;
+		}
+	}
+}
+
+uint64_t ShaderProgram::_CalculateBinaryCacheKey() const {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	HashString(hash, ShaderDriverInfo::Get().Identifier);
+
+	// Sort the stages so the key doesn't depend on the hash map ordering
+	std::map<ShaderPartType, const std::string*> stages;
+	for (auto& [type, source] : _resolvedSources) {
+		stages[type] = &source;
+	}
+	for (auto& [type, source] : stages) {
+		uint32_t typeCode = static_cast<uint32_t>(type);
+		HashBytes(hash, &typeCode, sizeof(uint32_t));
+		HashString(hash, *source);
+	}
+
+	for (const std::string& varying : _varyings) {
+		HashString(hash, varying);
+	}
+	HashBytes(hash, &_varyingsInterleaved, sizeof(bool));
+	return hash;
+}
+
+/// <summary>
+/// Gets the path to the binary cache file for the given key
+/// </summary>
+static inline std::string GetBinaryCachePath(uint64_t key) {
+	std::stringstream result;
+	result << binaryCacheFolder << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+	return result.str();
+}
+
+bool ShaderProgram::_LoadBinaryCache() {
+	std::ifstream file(GetBinaryCachePath(_binaryCacheKey), std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	// Make sure the file is a program binary for this exact program
+	ProgramBinaryHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(ProgramBinaryHeader));
+	if (!file || memcmp(header.HeaderBytes, "SPBC", 4) != 0 || header.Version != 0x01 || header.Key != _binaryCacheKey) {
+		return false;
+	}
+
+	std::vector<char> binary(header.BinarySize);
+	file.read(binary.data(), header.BinarySize);
+	if (!file) {
+		return false;
+	}
+
+	// The driver can still reject a binary (ex: after a driver update), in which case we fall back to compiling
+	glProgramBinary(_rendererId, header.BinaryFormat, binary.data(), header.BinarySize);
+	GLint status = 0;
+	glGetProgramiv(_rendererId, GL_LINK_STATUS, &status);
+	if (status == GL_FALSE) {
+		LOG_WARN("Cached program binary was rejected by the driver, recompiling");
+		return false;
+	}
+	return true;
+}
+
+void ShaderProgram::_SaveBinaryCache() {
+	GLint binarySize = 0;
+	glGetProgramiv(_rendererId, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+	if (binarySize <= 0) {
+		return;
+	}
+
+	ProgramBinaryHeader header = ProgramBinaryHeader();
+	header.Version = 0x01;
+	header.Key = _binaryCacheKey;
+
+	std::vector<char> binary(binarySize);
+	GLenum format = 0;
+	glGetProgramBinary(_rendererId, binarySize, &binarySize, &format, binary.data());
+	header.BinaryFormat = format;
+	header.BinarySize = static_cast<uint32_t>(binarySize);
+
+	std::error_code error;
+	fs::create_directories(binaryCacheFolder, error);
+
+	// We write to a temporary file and then swap it in, so that we never leave a half written binary behind
+	std::string cachePath = GetBinaryCachePath(_binaryCacheKey);
+	std::stringstream tempName;
+	tempName << cachePath << "." << std::this_thread::get_id() << ".tmp";
+	{
+		std::ofstream file(tempName.str(), std::ios::binary);
+		if (!file) {
+			LOG_WARN("Failed to open program binary cache \"{}\" for writing", cachePath);
+			return;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(ProgramBinaryHeader));
+		file.write(binary.data(), header.BinarySize);
+	}
+
+	fs::rename(tempName.str(), cachePath, error);
+	if (error) {
+		fs::remove(tempName.str(), error);
+	}
 }
 
 void ShaderProgram::Bind() {
+	WaitForLink();
 	// Simply calls glUseProgram with our shader handle
 	glUseProgram(_rendererId);
 }
@@ -325,10 +640,18 @@ void ShaderProgram::SetUniform(int location, ShaderDataType type, void* data, in
 }
 
 int ShaderProgram::__GetUniformLocation(const std::string& name) {
-	// Since the default constructor for UniformInfo sets location to -1,
-	// we can simply index the map and if it doesn't exist, the default
-	// will be used
-	return _uniforms[name].Location;
+	WaitForLink();
+	// Use find so that looking up a missing uniform doesn't insert it into the map
+	auto it = _uniforms.find(name);
+	return it != _uniforms.end() ? it->second.Location : -1;
+}
+
+int ShaderProgram::FindUniformLocation(uint32_t nameHash) {
+	WaitForLink();
+	auto it = std::lower_bound(_uniformLocations.begin(), _uniformLocations.end(), nameHash, [](const UniformLocationEntry& entry, uint32_t value) {
+		return entry.NameHash < value;
+	});
+	return (it != _uniformLocations.end() && it->NameHash == nameHash) ? it->Location : -1;
 }
 
 nlohmann::json ShaderProgram::ToJson() const {
@@ -360,13 +683,14 @@ ShaderProgram::Sptr ShaderProgram::FromJson(const nlohmann::json& data) {
 			// Otherwise do nothing
 		}
 	}
-	result->Link();
+	result->LinkAsync();
 	return result;
 }
 
 void ShaderProgram::_Introspect() {
 	_IntrospectUniforms();
 	_IntrospectUnifromBlocks();
+	_IntrospectStorageBlocks();
 }
 
 void ShaderProgram::_IntrospectUniforms() {
@@ -421,6 +745,44 @@ void ShaderProgram::_IntrospectUniforms() {
 		// Store the uniform info
 		_uniforms[e.Name] = e;
 	}
+
+	// Build our flat table of locations for UniformHandle, uniforms in blocks don't have locations
+	_uniformLocations.clear();
+	for (const auto& [name, info] : _uniforms) {
+		if (info.Location >= 0) {
+			_uniformLocations.push_back({ HashUniformName(name.c_str()), info.Location });
+		}
+	}
+	std::sort(_uniformLocations.begin(), _uniformLocations.end(), [](const UniformLocationEntry& a, const UniformLocationEntry& b) {
+		return a.NameHash < b.NameHash;
+	});
+	for (size_t ix = 1; ix < _uniformLocations.size(); ix++) {
+		if (_uniformLocations[ix].NameHash == _uniformLocations[ix - 1].NameHash) {
+			LOG_WARN("Uniform name hash collision in shader \"{}\", uniform handles may resolve to the wrong uniform", _debugName);
+		}
+	}
+}
+
+void ShaderProgram::_IntrospectStorageBlocks() {
+	// Query program for the number of shader storage blocks
+	int numBlocks = 0;
+	glGetProgramInterfaceiv(_rendererId, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &numBlocks);
+
+	for (int ix = 0; ix < numBlocks; ix++) {
+		static GLenum pNames[] ={
+			GL_BUFFER_BINDING,
+			GL_NAME_LENGTH
+		};
+		int results[2];
+		glGetProgramResourceiv(_rendererId, GL_SHADER_STORAGE_BLOCK, ix, 2, pNames, 2, NULL, results);
+
+		std::string name;
+		name.resize(results[1] - 1);
+		glGetProgramResourceName(_rendererId, GL_SHADER_STORAGE_BLOCK, ix, results[1], NULL, &name[0]);
+
+		LOG_TRACE("\tDetected a new storage block: {} -> binding {}", name, results[0]);
+		_storageBlocks[name] = results[0];
+	}
 }
 
 void ShaderProgram::_IntrospectUnifromBlocks() {
@@ -478,17 +840,21 @@ void ShaderProgram::_IntrospectUnifromBlocks() {
 				GL_NAME_LENGTH,
 				GL_TYPE,
 				GL_ARRAY_SIZE,
-				GL_OFFSET
+				GL_OFFSET,
+				GL_ARRAY_STRIDE,
+				GL_MATRIX_STRIDE
 			};
 			// Query data from the program
-			int props[4];
-			glGetProgramResourceiv(_rendererId, GL_UNIFORM, activeVars[v], 4, pNames, 4, NULL, props);
+			int props[6];
+			glGetProgramResourceiv(_rendererId, GL_UNIFORM, activeVars[v], 6, pNames, 6, NULL, props);
 
 			// Store properties into the UniformInfo
 			UniformInfo var = UniformInfo();
 			var.Type = FromGLShaderDataType(props[1]);
 			var.Location = props[3];
 			var.ArraySize = props[2];
+			var.ArrayStride = props[4];
+			var.MatrixStride = props[5];
 
 			// Get the uniform name
 			var.Name.resize(props[0] - 1);
@@ -511,6 +877,7 @@ void ShaderProgram::_IntrospectUnifromBlocks() {
 
 void ShaderProgram::BindUniformBlockToSlot(const std::string& name, int uboSlot)
 {
+	WaitForLink();
 	auto& it = _uniformBlocks.find(name);
 	if (it != _uniformBlocks.end()) {
 		UniformBlockInfo& block = it->second;
@@ -520,6 +887,7 @@ void ShaderProgram::BindUniformBlockToSlot(const std::string& name, int uboSlot)
 }
 
 bool ShaderProgram::FindUniform(const std::string& name, UniformInfo* out) {
+	WaitForLink();
 	for (auto& [key, uniform] : _uniforms) {
 		if (uniform.Name == name) {
 			if (out != nullptr) {
@@ -531,11 +899,37 @@ bool ShaderProgram::FindUniform(const std::string& name, UniformInfo* out) {
 	return false;
 }
 
+bool ShaderProgram::FindUniformBlock(const std::string& name, UniformBlockInfo* out) {
+	WaitForLink();
+	auto it = _uniformBlocks.find(name);
+	if (it != _uniformBlocks.end()) {
+		if (out != nullptr) {
+			*out = it->second;
+		}
+		return true;
+	}
+	return false;
+}
+
+bool ShaderProgram::FindStorageBlock(const std::string& name, int* binding) {
+	WaitForLink();
+	auto it = _storageBlocks.find(name);
+	if (it != _storageBlocks.end()) {
+		if (binding != nullptr) {
+			*binding = it->second;
+		}
+		return true;
+	}
+	return false;
+}
+
 GlResourceType ShaderProgram::GetResourceClass() const {
 	return GlResourceType::ShaderProgram;
 }
 
 void ShaderProgram::RegisterVaryings(const char* const* names, int numVaryings, bool interleaved /*= true*/)
 {
+	_varyings.assign(names, names + numVaryings);
+	_varyingsInterleaved = interleaved;
 	glTransformFeedbackVaryings(_rendererId, numVaryings, names, interleaved ? GL_INTERLEAVED_ATTRIBS : GL_SEPARATE_ATTRIBS);
 }
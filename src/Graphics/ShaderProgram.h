@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>               // for std::string
 #include <unordered_map>        // for std::unordered_map
+#include <vector>               // for std::vector
 #include <GLM/glm.hpp>          // for our GLM types
 #include <GLM/gtc/type_ptr.hpp> // for glm::value_ptr
 #include <Logging.h>            // for the logging functions
@@ -31,6 +32,9 @@ public:
 		int            ArraySize;
 		int            Location;
 		int            Binding;
+		// For uniforms in blocks, the byte stride between array elements and matrix columns
+		int            ArrayStride;
+		int            MatrixStride;
 		std::string    Name;
 
 		UniformInfo() :
@@ -38,6 +42,8 @@ public:
 			ArraySize(0),
 			Location(-1),
 			Binding(-1),
+			ArrayStride(0),
+			MatrixStride(0),
 			Name("") {}
 	};
 
@@ -71,17 +77,21 @@ public:
 
 	/// <summary>
 	/// Loads a single shader stage into this shader object (ex: Vertex Shader or Fragment Shader)
+	/// Compilation is deferred until the program is linked, so that programs found in the binary
+	/// cache never need to be compiled. Compile errors are reported when the link completes, so
+	/// callers must check the result of Link (or WaitForLink) to know if the shader is valid
 	/// </summary>
 	/// <param name="source">The source code of the shader to load</param>
 	/// <param name="type">The stage to load (GL_VERTEX_SHADER or GL_FRAGMENT_SHADER)</param>
-	/// <returns>True if the shader is loaded, false if there was an issue</returns>
+	/// <returns>True if the source was stored, false if it was empty. Does NOT indicate that the source compiles</returns>
 	bool LoadShaderPart(const char* source, ShaderPartType type);
 	/// <summary>
 	/// Loads a single shader stage into this shader object (ex: Vertex Shader or Fragment Shader) from an external file (in res)
+	/// As with LoadShaderPart, compile errors are only reported by Link
 	/// </summary>
 	/// <param name="path">The relative path to the file containing the source</param>
 	/// <param name="type">The stage to load (GL_VERTEX_SHADER or GL_FRAGMENT_SHADER)</param>
-	/// <returns>True if the shader is loaded, false if there was an issue</returns>
+	/// <returns>True if the file was read, false if it could not be found or was empty</returns>
 	bool LoadShaderPartFromFile(const char* path, ShaderPartType type);
 
 	/// <summary>
@@ -97,6 +107,30 @@ public:
 	/// </summary>
 	/// <returns>True if the linking was successful, false if otherwise</returns>
 	bool Link();
+	/// <summary>
+	/// Starts linking the program without waiting for the result. If a matching program binary
+	/// is in the cache it is loaded directly, otherwise all stages are compiled and linked, letting
+	/// the driver work on several programs in parallel (see GL_KHR_parallel_shader_compile)
+	/// 
+	/// The link is completed the first time the program is used, or when WaitForLink is called
+	/// </summary>
+	void LinkAsync();
+	/// <summary>
+	/// Returns true if the program is not waiting on the driver to finish linking, only
+	/// non-blocking when GL_KHR_parallel_shader_compile is supported
+	/// </summary>
+	bool IsLinkComplete() const;
+	/// <summary>
+	/// Blocks until a pending link started with LinkAsync has finished, reporting any errors
+	/// </summary>
+	/// <returns>True if the program is linked, false if otherwise</returns>
+	bool WaitForLink();
+	/// <summary>
+	/// Gets a number that identifies the most recent link of this program. Every link of every
+	/// program gets a new number, so this can be used to tell if something cached against a
+	/// program (such as a uniform location) is stale, even if a new program reuses the address
+	/// </summary>
+	uint32_t GetLinkGeneration() const { return _linkGeneration; }
 
 	/// <summary>
 	/// Binds this shader for use
@@ -107,7 +141,35 @@ public:
 	/// </summary>
 	static void Unbind();
 
-	const std::unordered_map<std::string, UniformInfo>& GetUniforms() const { return _uniforms; }
+	const std::unordered_map<std::string, UniformInfo>& GetUniforms() { WaitForLink(); return _uniforms; }
+
+	/// <summary>
+	/// The maximum number of keywords a shader can have, since variants are keyed by a bitmask
+	/// </summary>
+	static const int MAX_KEYWORDS = 32;
+
+	/// <summary>
+	/// Sets the keywords that variants of this shader can be compiled with. Bit N of a variant's
+	/// keyword mask enables keywords[N], which is injected into every stage as "#define [keyword] 1"
+	/// The mask itself is injected as "#define SHADER_KEYWORDS [mask]u", so shaders can resolve
+	/// flag tests at compile time
+	/// 
+	/// Changing the keywords discards any variants that have already been compiled. Variants are
+	/// built from the loaded sources, so a shader that is only used through its variants does not
+	/// need to be linked itself
+	/// </summary>
+	/// <param name="keywords">The keywords in bit order, at most MAX_KEYWORDS</param>
+	void SetKeywords(const std::vector<std::string>& keywords);
+	const std::vector<std::string>& GetKeywords() const { return _keywords; }
+
+	/// <summary>
+	/// Gets the variant of this shader for the given combination of keywords, compiling it the
+	/// first time it is requested. Variants start linking with LinkAsync, so requesting a variant
+	/// ahead of time lets it compile in the background
+	/// </summary>
+	/// <param name="keywordMask">A bitmask of the keywords to enable, bits beyond the number of keywords are ignored</param>
+	/// <returns>The variant, which is owned by this shader, or this shader if it has no keywords</returns>
+	ShaderProgram* GetVariant(uint32_t keywordMask);
 
 	// Inherited from IGraphicsResource
 
@@ -120,6 +182,28 @@ public:
 
 public:
 	bool FindUniform(const std::string& name, UniformInfo* out);
+	/// <summary>
+	/// Looks up the location of a uniform from the hash of it's name (see HashUniformName in
+	/// UniformHandle.h), using a flat table that is built after linking
+	/// </summary>
+	/// <param name="nameHash">The FNV-1a hash of the uniform's name</param>
+	/// <returns>The location of the uniform, or -1 if it does not exist</returns>
+	int FindUniformLocation(uint32_t nameHash);
+	/// <summary>
+	/// Looks up a uniform block by name. The sub uniforms of the block store their byte offset
+	/// within the block in their Location field
+	/// </summary>
+	/// <param name="name">The name of the block in the shader</param>
+	/// <param name="out">The block info to write to, or nullptr</param>
+	/// <returns>True if the block exists, false if otherwise</returns>
+	bool FindUniformBlock(const std::string& name, UniformBlockInfo* out);
+	/// <summary>
+	/// Looks up a shader storage block by name
+	/// </summary>
+	/// <param name="name">The name of the block in the shader</param>
+	/// <param name="binding">Receives the binding point of the block, or nullptr</param>
+	/// <returns>True if the block exists, false if otherwise</returns>
+	bool FindStorageBlock(const std::string& name, int* binding = nullptr);
 
 	void SetUniformMatrix(int location, const glm::mat3* value, int count = 1, bool transposed = false);
 	void SetUniformMatrix(int location, const glm::mat4* value, int count = 1, bool transposed = false);
@@ -187,7 +271,35 @@ protected:
 	
 	// Map access to look up uniform locations and blocks
 	std::unordered_map<std::string, UniformInfo> _uniforms;
+	// Uniform locations sorted by the hash of their names, used by UniformHandle
+	struct UniformLocationEntry {
+		uint32_t NameHash;
+		int      Location;
+	};
+	std::vector<UniformLocationEntry> _uniformLocations;
 	std::unordered_map<std::string, UniformBlockInfo> _uniformBlocks;
+	// Maps shader storage block names to their binding points
+	std::unordered_map<std::string, int> _storageBlocks;
+
+	// The fully resolved source for each stage, compiled when linking if the program was not cached
+	std::unordered_map<ShaderPartType, std::string> _resolvedSources;
+	// The transform feedback varyings, these are part of the linked program so they are part of the cache key
+	std::vector<std::string> _varyings;
+	bool                     _varyingsInterleaved;
+
+	// The keywords for our variants, and the variants that have been compiled so far
+	std::vector<std::string> _keywords;
+	std::unordered_map<uint32_t, std::unique_ptr<ShaderProgram>> _variants;
+
+	// Tracks the state of an in-flight link started with LinkAsync
+	bool     _isLinkPending;
+	bool     _isLinked;
+	bool     _isFromBinaryCache;
+	uint64_t _binaryCacheKey;
+	uint32_t _linkGeneration;
+
+	// The last link generation that was handed out, see GetLinkGeneration
+	static uint32_t __linkGenerationCounter;
 
 	// Stores information about the source of our shader parts
 	// EX: if a VS shader is loaded from a file, will contain
@@ -212,6 +324,28 @@ protected:
 	/// fed data from a uniform buffer
 	/// </summary>
 	void _IntrospectUnifromBlocks();
+	/// <summary>
+	/// Introspects shader storage blocks, we only need their names and bindings
+	/// </summary>
+	void _IntrospectStorageBlocks();
 
 	int __GetUniformLocation(const std::string& name);
+
+	/// <summary>
+	/// Calculates the binary cache key for this program, from the resolved source of all stages,
+	/// the varyings, and the driver that the binary was generated by
+	/// </summary>
+	uint64_t _CalculateBinaryCacheKey() const;
+	/// <summary>
+	/// Attempts to load the program from the binary cache, returning true if the program is linked
+	/// </summary>
+	bool _LoadBinaryCache();
+	/// <summary>
+	/// Stores the linked program in the binary cache
+	/// </summary>
+	void _SaveBinaryCache();
+	/// <summary>
+	/// Logs the compile errors for any stages that failed to compile
+	/// </summary>
+	void _LogCompileErrors();
 };
\ No newline at end of file
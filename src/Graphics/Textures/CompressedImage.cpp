@@ -0,0 +1,401 @@
+#include "CompressedImage.h"
+#include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <climits>
+#include <GLM/glm.hpp>
+#include <stb_image.h>
+#include <Logging.h>
+#include <GLFW/glfw3.h>
+
+const std::string cacheExtension = ".bctx";
+
+namespace fs = std::filesystem;
+
+/// <summary>
+/// Converts an 8 bit per channel colour to a packed 5:6:5 colour
+/// </summary>
+inline uint16_t PackRgb565(const glm::ivec3& color) {
+	return static_cast<uint16_t>(((color.r >> 3) << 11) | ((color.g >> 2) << 5) | (color.b >> 3));
+}
+
+/// <summary>
+/// Expands a packed 5:6:5 colour back to 8 bits per channel, matching what the GPU will decode
+/// </summary>
+inline glm::ivec3 UnpackRgb565(uint16_t color) {
+	int r = (color >> 11) & 0x1F;
+	int g = (color >> 5) & 0x3F;
+	int b = color & 0x1F;
+	return glm::ivec3((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+}
+
+CompressedImage::CompressedImage() :
+	Format(InternalFormat::Unknown),
+	Width(0),
+	Height(0),
+	Levels()
+{ }
+
+bool CompressedImage::IsCompressedFormat(InternalFormat format) {
+	return GetBlockSize(format) != 0;
+}
+
+size_t CompressedImage::GetBlockSize(InternalFormat format) {
+	switch (format) {
+		case InternalFormat::BC1:
+		case InternalFormat::BC4:
+			return 8;
+		case InternalFormat::BC3:
+		case InternalFormat::BC5:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
+bool CompressedImage::Encode(const uint8_t* rgba, uint32_t width, uint32_t height, InternalFormat format, bool generateMips, CompressedImage& result) {
+	if (rgba == nullptr || width == 0 || height == 0 || !IsCompressedFormat(format)) {
+		return false;
+	}
+
+	result.Format = format;
+	result.Width  = width;
+	result.Height = height;
+	result.Levels.clear();
+
+	// We'll box filter down to generate each mip level from the previous one
+	std::vector<uint8_t> current(rgba, rgba + (size_t)width * height * 4);
+	std::vector<uint8_t> next;
+	uint32_t levelWidth = width;
+	uint32_t levelHeight = height;
+
+	while (true) {
+		result.Levels.emplace_back();
+		_EncodeLevel(current.data(), levelWidth, levelHeight, format, result.Levels.back());
+
+		if (!generateMips || (levelWidth == 1 && levelHeight == 1)) {
+			break;
+		}
+
+		uint32_t nextWidth  = std::max(1u, levelWidth / 2);
+		uint32_t nextHeight = std::max(1u, levelHeight / 2);
+		next.resize((size_t)nextWidth * nextHeight * 4);
+		for (uint32_t y = 0; y < nextHeight; y++) {
+			uint32_t y0 = std::min(y * 2, levelHeight - 1);
+			uint32_t y1 = std::min(y * 2 + 1, levelHeight - 1);
+			for (uint32_t x = 0; x < nextWidth; x++) {
+				uint32_t x0 = std::min(x * 2, levelWidth - 1);
+				uint32_t x1 = std::min(x * 2 + 1, levelWidth - 1);
+				for (int c = 0; c < 4; c++) {
+					uint32_t sum =
+						current[((size_t)y0 * levelWidth + x0) * 4 + c] +
+						current[((size_t)y0 * levelWidth + x1) * 4 + c] +
+						current[((size_t)y1 * levelWidth + x0) * 4 + c] +
+						current[((size_t)y1 * levelWidth + x1) * 4 + c];
+					next[((size_t)y * nextWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+				}
+			}
+		}
+
+		current.swap(next);
+		levelWidth = nextWidth;
+		levelHeight = nextHeight;
+	}
+
+	return true;
+}
+
+std::string CompressedImage::GetCachePath(const std::string& sourceFile) {
+	fs::path path = fs::path(sourceFile);
+	path.replace_extension(cacheExtension);
+	return path.string();
+}
+
+bool CompressedImage::LoadCache(const std::string& sourceFile, CompressedImage& result) {
+	std::string cachePath = GetCachePath(sourceFile);
+	if (!fs::exists(cachePath) || !fs::exists(sourceFile)) {
+		return false;
+	}
+
+	std::ifstream file(cachePath, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	// Read the header and make sure the cache matches the source file
+	CacheHeader header = CacheHeader();
+	file.read(reinterpret_cast<char*>(&header), sizeof(CacheHeader));
+	if (!file || memcmp(header.HeaderBytes, CacheHeader().HeaderBytes, 4) != 0 || header.Version != 0x01) {
+		return false;
+	}
+	if (header.SourceSize != fs::file_size(sourceFile) ||
+		header.SourceTime != static_cast<int64_t>(fs::last_write_time(sourceFile).time_since_epoch().count())) {
+		return false;
+	}
+
+	result.Format = static_cast<InternalFormat>(header.Format);
+	result.Width  = header.Width;
+	result.Height = header.Height;
+	result.Levels.resize(header.NumLevels);
+	if (!IsCompressedFormat(result.Format)) {
+		return false;
+	}
+
+	// Read each level's size followed by it's blocks
+	for (Level& level : result.Levels) {
+		uint32_t dataSize = 0;
+		file.read(reinterpret_cast<char*>(&level.Width), sizeof(uint32_t));
+		file.read(reinterpret_cast<char*>(&level.Height), sizeof(uint32_t));
+		file.read(reinterpret_cast<char*>(&dataSize), sizeof(uint32_t));
+		if (!file) {
+			return false;
+		}
+		level.Data.resize(dataSize);
+		file.read(reinterpret_cast<char*>(level.Data.data()), dataSize);
+	}
+
+	return static_cast<bool>(file);
+}
+
+bool CompressedImage::SaveCache(const std::string& sourceFile) const {
+	std::string cachePath = GetCachePath(sourceFile);
+
+	// We write to a temporary file and then swap it in, so that two workers encoding the
+	// same image can't leave a half written cache behind
+	std::stringstream tempName;
+	tempName << cachePath << "." << std::this_thread::get_id() << ".tmp";
+	{
+		std::ofstream file(tempName.str(), std::ios::binary);
+		if (!file) {
+			LOG_WARN("Failed to open texture cache \"{}\" for writing", cachePath);
+			return false;
+		}
+
+		CacheHeader header = CacheHeader();
+		header.Version    = 0x01;
+		header.Format     = static_cast<uint32_t>(*Format);
+		header.Width      = Width;
+		header.Height     = Height;
+		header.NumLevels  = static_cast<uint32_t>(Levels.size());
+		header.SourceSize = fs::file_size(sourceFile);
+		header.SourceTime = static_cast<int64_t>(fs::last_write_time(sourceFile).time_since_epoch().count());
+		file.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+
+		for (const Level& level : Levels) {
+			uint32_t dataSize = static_cast<uint32_t>(level.Data.size());
+			file.write(reinterpret_cast<const char*>(&level.Width), sizeof(uint32_t));
+			file.write(reinterpret_cast<const char*>(&level.Height), sizeof(uint32_t));
+			file.write(reinterpret_cast<const char*>(&dataSize), sizeof(uint32_t));
+			file.write(reinterpret_cast<const char*>(level.Data.data()), dataSize);
+		}
+	}
+
+	std::error_code error;
+	fs::rename(tempName.str(), cachePath, error);
+	if (error) {
+		fs::remove(tempName.str(), error);
+		return false;
+	}
+	return true;
+}
+
+bool CompressedImage::LoadOrCreate(const std::string& sourceFile, TextureCompression mode, bool generateMips, CompressedImage& result) {
+	if (mode == TextureCompression::None) {
+		return false;
+	}
+
+	// Use the cache if it's up to date, and matches the settings we're after
+	if (LoadCache(sourceFile, result)) {
+		bool formatMatches = mode == TextureCompression::NormalMap ?
+			result.Format == InternalFormat::BC5 :
+			(result.Format == InternalFormat::BC1 || result.Format == InternalFormat::BC3);
+		bool hasMips = result.Levels.size() > 1 || (result.Width == 1 && result.Height == 1);
+		if (formatMatches && hasMips == generateMips) {
+			return true;
+		}
+	}
+
+	float startTime = static_cast<float>(glfwGetTime());
+
+	// Cache is missing or stale, decode the source image as RGBA so we can encode it
+	int width, height, numChannels;
+	stbi_set_flip_vertically_on_load(true);
+	uint8_t* data = stbi_load(sourceFile.c_str(), &width, &height, &numChannels, 4);
+	if (data == nullptr) {
+		LOG_WARN("STBI Failed to load image from \"{}\"", sourceFile);
+		return false;
+	}
+
+	// Colour images with any transparency need BC3, otherwise BC1 is half the size
+	InternalFormat format = InternalFormat::BC5;
+	if (mode == TextureCompression::Color) {
+		format = InternalFormat::BC1;
+		if (numChannels == 4 || numChannels == 2) {
+			for (size_t ix = 0; ix < (size_t)width * height; ix++) {
+				if (data[ix * 4 + 3] != 255) {
+					format = InternalFormat::BC3;
+					break;
+				}
+			}
+		}
+	}
+
+	bool success = Encode(data, width, height, format, generateMips, result);
+	stbi_image_free(data);
+
+	if (success) {
+		result.SaveCache(sourceFile);
+
+		float endTime = static_cast<float>(glfwGetTime());
+		LOG_TRACE("Compressed texture \"{}\" to {} in {} seconds ({} levels)", sourceFile, ~format, endTime - startTime, result.Levels.size());
+	}
+	return success;
+}
+
+void CompressedImage::_EncodeLevel(const uint8_t* rgba, uint32_t width, uint32_t height, InternalFormat format, Level& result) {
+	const uint32_t blocksX = std::max(1u, (width + 3) / 4);
+	const uint32_t blocksY = std::max(1u, (height + 3) / 4);
+	const size_t blockSize = GetBlockSize(format);
+
+	result.Width  = width;
+	result.Height = height;
+	result.Data.resize(blocksX * blocksY * blockSize);
+
+	uint8_t block[16 * 4];
+	for (uint32_t by = 0; by < blocksY; by++) {
+		for (uint32_t bx = 0; bx < blocksX; bx++) {
+			// Gather the 4x4 block, repeating edge pixels for images that aren't a multiple of 4
+			for (uint32_t py = 0; py < 4; py++) {
+				uint32_t y = std::min(by * 4 + py, height - 1);
+				for (uint32_t px = 0; px < 4; px++) {
+					uint32_t x = std::min(bx * 4 + px, width - 1);
+					memcpy(block + (py * 4 + px) * 4, rgba + ((size_t)y * width + x) * 4, 4);
+				}
+			}
+
+			uint8_t* output = result.Data.data() + (by * blocksX + bx) * blockSize;
+			switch (format) {
+				case InternalFormat::BC1:
+					_EncodeColorBlock(block, output);
+					break;
+				case InternalFormat::BC3:
+					_EncodeChannelBlock(block, 3, output);
+					_EncodeColorBlock(block, output + 8);
+					break;
+				case InternalFormat::BC4:
+					_EncodeChannelBlock(block, 0, output);
+					break;
+				case InternalFormat::BC5:
+					_EncodeChannelBlock(block, 0, output);
+					_EncodeChannelBlock(block, 1, output + 8);
+					break;
+				default:
+					break;
+			}
+		}
+	}
+}
+
+void CompressedImage::_EncodeColorBlock(const uint8_t* block, uint8_t* output) {
+	// Find the bounding box of the colours in the block
+	glm::ivec3 minColor(255), maxColor(0);
+	for (int ix = 0; ix < 16; ix++) {
+		glm::ivec3 color(block[ix * 4 + 0], block[ix * 4 + 1], block[ix * 4 + 2]);
+		minColor = glm::min(minColor, color);
+		maxColor = glm::max(maxColor, color);
+	}
+
+	// Inset the bounding box slightly, this reduces the error introduced by outliers
+	glm::ivec3 inset = (maxColor - minColor) >> 4;
+	minColor = glm::clamp(minColor + inset, glm::ivec3(0), glm::ivec3(255));
+	maxColor = glm::clamp(maxColor - inset, glm::ivec3(0), glm::ivec3(255));
+
+	// color0 > color1 selects the 4 colour mode
+	uint16_t color0 = PackRgb565(maxColor);
+	uint16_t color1 = PackRgb565(minColor);
+	if (color0 < color1) {
+		std::swap(color0, color1);
+	}
+
+	// Build the palette the GPU will use, from the quantized endpoints
+	glm::ivec3 palette[4];
+	palette[0] = UnpackRgb565(color0);
+	palette[1] = UnpackRgb565(color1);
+	palette[2] = (palette[0] * 2 + palette[1]) / 3;
+	palette[3] = (palette[0] + palette[1] * 2) / 3;
+
+	// Pick the closest palette entry for each texel
+	uint32_t indices = 0;
+	if (color0 != color1) {
+		for (int ix = 0; ix < 16; ix++) {
+			glm::ivec3 color(block[ix * 4 + 0], block[ix * 4 + 1], block[ix * 4 + 2]);
+			int bestIndex = 0;
+			int bestError = INT_MAX;
+			for (int p = 0; p < 4; p++) {
+				glm::ivec3 delta = color - palette[p];
+				int error = delta.r * delta.r + delta.g * delta.g + delta.b * delta.b;
+				if (error < bestError) {
+					bestError = error;
+					bestIndex = p;
+				}
+			}
+			indices |= bestIndex << (ix * 2);
+		}
+	}
+
+	// Blocks are stored little endian
+	output[0] = color0 & 0xFF;
+	output[1] = color0 >> 8;
+	output[2] = color1 & 0xFF;
+	output[3] = color1 >> 8;
+	output[4] = indices & 0xFF;
+	output[5] = (indices >> 8) & 0xFF;
+	output[6] = (indices >> 16) & 0xFF;
+	output[7] = (indices >> 24) & 0xFF;
+}
+
+void CompressedImage::_EncodeChannelBlock(const uint8_t* block, int channel, uint8_t* output) {
+	int minValue = 255, maxValue = 0;
+	for (int ix = 0; ix < 16; ix++) {
+		minValue = std::min(minValue, (int)block[ix * 4 + channel]);
+		maxValue = std::max(maxValue, (int)block[ix * 4 + channel]);
+	}
+
+	// value0 > value1 selects the 8 value mode
+	output[0] = static_cast<uint8_t>(maxValue);
+	output[1] = static_cast<uint8_t>(minValue);
+
+	uint64_t indices = 0;
+	if (maxValue != minValue) {
+		// Build the palette the GPU will use
+		int palette[8];
+		palette[0] = maxValue;
+		palette[1] = minValue;
+		for (int p = 1; p < 7; p++) {
+			palette[p + 1] = ((7 - p) * maxValue + p * minValue) / 7;
+		}
+
+		// Pick the closest palette entry for each texel
+		for (int ix = 0; ix < 16; ix++) {
+			int value = block[ix * 4 + channel];
+			int bestIndex = 0;
+			int bestError = INT_MAX;
+			for (int p = 0; p < 8; p++) {
+				int error = std::abs(value - palette[p]);
+				if (error < bestError) {
+					bestError = error;
+					bestIndex = p;
+				}
+			}
+			indices |= static_cast<uint64_t>(bestIndex) << (ix * 3);
+		}
+	}
+
+	// 16 3-bit indices, stored little endian
+	for (int ix = 0; ix < 6; ix++) {
+		output[2 + ix] = static_cast<uint8_t>((indices >> (ix * 8)) & 0xFF);
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <EnumToString.h>
+#include "Graphics/GlEnums.h"
+
+/// <summary>
+/// Determines if and how a texture should be block compressed when loaded from a file
+/// </summary>
+ENUM(TextureCompression, uint8_t,
+	// Texture is uploaded uncompressed
+	None      = 0,
+	// BC1 for opaque images, BC3 for images with alpha
+	Color     = 1,
+	// BC5, stores only the red and green channels (the shader must reconstruct Z)
+	NormalMap = 2
+);
+
+/// <summary>
+/// Represents an image that has been encoded into a GPU block compressed format (BC1/BC3/BC4/BC5),
+/// along with it's mip chain. Compressed images are cached next to their source files, so that
+/// the encoding only needs to happen the first time a texture is loaded
+///
+/// None of the methods on this class touch OpenGL, so they are safe to invoke from worker threads
+/// </summary>
+class CompressedImage {
+public:
+	/// <summary>
+	/// A single mip level of a compressed image
+	/// </summary>
+	struct Level {
+		uint32_t             Width;
+		uint32_t             Height;
+		std::vector<uint8_t> Data;
+	};
+
+	InternalFormat     Format;
+	uint32_t           Width;
+	uint32_t           Height;
+	std::vector<Level> Levels;
+
+	CompressedImage();
+
+	/// <summary>
+	/// Returns true if the given internal format is one of our block compressed formats
+	/// </summary>
+	static bool IsCompressedFormat(InternalFormat format);
+	/// <summary>
+	/// Gets the number of bytes used to store a single 4x4 block in the given format
+	/// </summary>
+	static size_t GetBlockSize(InternalFormat format);
+
+	/// <summary>
+	/// Encodes an RGBA8 image into the given block compressed format
+	/// </summary>
+	/// <param name="rgba">The source pixels, must be tightly packed RGBA8</param>
+	/// <param name="width">The width of the image in pixels</param>
+	/// <param name="height">The height of the image in pixels</param>
+	/// <param name="format">The block compressed format to encode to</param>
+	/// <param name="generateMips">True to generate and encode a full mip chain</param>
+	/// <param name="result">The image to store the encoded levels in</param>
+	/// <returns>True if the image was encoded</returns>
+	static bool Encode(const uint8_t* rgba, uint32_t width, uint32_t height, InternalFormat format, bool generateMips, CompressedImage& result);
+
+	/// <summary>
+	/// Gets the path that the compressed cache for the given source image will be stored at
+	/// </summary>
+	static std::string GetCachePath(const std::string& sourceFile);
+	/// <summary>
+	/// Loads the cached compressed image for a source file, if it exists and is up to date
+	/// </summary>
+	/// <param name="sourceFile">The path to the source image (ex: png)</param>
+	/// <param name="result">The image to load into</param>
+	/// <returns>True if the cache was valid and loaded, false if it must be regenerated</returns>
+	static bool LoadCache(const std::string& sourceFile, CompressedImage& result);
+	/// <summary>
+	/// Writes this image to the cache for the given source file
+	/// </summary>
+	/// <param name="sourceFile">The path to the source image (ex: png)</param>
+	/// <returns>True if the cache was written</returns>
+	bool SaveCache(const std::string& sourceFile) const;
+
+	/// <summary>
+	/// Loads a compressed version of an image file, using the cache if it is valid, otherwise the source image
+	/// will be decoded and encoded, and the cache will be updated
+	/// </summary>
+	/// <param name="sourceFile">The path to the source image (ex: png)</param>
+	/// <param name="mode">The compression mode to use, must not be None</param>
+	/// <param name="generateMips">True if the image should contain a full mip chain</param>
+	/// <param name="result">The image to load into</param>
+	/// <returns>True if a compressed image was loaded, false if the caller should fall back to loading uncompressed</returns>
+	static bool LoadOrCreate(const std::string& sourceFile, TextureCompression mode, bool generateMips, CompressedImage& result);
+
+protected:
+	// Will be put at the start of the cache file, contains info about the contents of the file
+	struct CacheHeader {
+		// A check value so we can ensure that we're loading in the right file type
+		char     HeaderBytes[4] ={ 'B', 'C', 'T', 'X' };
+		// The version code, we can use this to create different loaders if our format changes
+		uint16_t Version = 0;
+		// The GL internal format of the blocks
+		uint32_t Format = 0;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		uint32_t NumLevels = 0;
+		// Size and modified time of the source file, used to detect when the cache is stale
+		uint64_t SourceSize = 0;
+		int64_t  SourceTime = 0;
+	};
+
+	static void _EncodeLevel(const uint8_t* rgba, uint32_t width, uint32_t height, InternalFormat format, Level& result);
+	static void _EncodeColorBlock(const uint8_t* block, uint8_t* output);
+	static void _EncodeChannelBlock(const uint8_t* block, int channel, uint8_t* output);
+};
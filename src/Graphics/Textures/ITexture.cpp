@@ -5,7 +5,8 @@ bool ITexture::__isStaticInit = false;
 
 ITexture::ITexture(TextureType type) :
 	IGraphicsResource(),
-	_type(type)
+	_type(type),
+	_bindlessHandle(0)
 {
 	__StaticInit();
 	_Recreate();
@@ -13,13 +14,16 @@ ITexture::ITexture(TextureType type) :
 
 void ITexture::_Recreate()
 {
-	if (_rendererId == 0) {
+	// Any bindless handle is released along with the texture
+	_ReleaseBindlessHandle();
+	if (_rendererId != 0) {
 		glDeleteTextures(1, &_rendererId);
 	}
 	glCreateTextures((GLenum)_type, 1, &_rendererId);
 }
 
 ITexture::~ITexture() {
+	_ReleaseBindlessHandle();
 	if (glIsTexture(_rendererId)) {
 		glDeleteTextures(1, &_rendererId);
 		_rendererId = 0;
@@ -27,12 +31,20 @@ ITexture::~ITexture() {
 }
 
 void ITexture::Bind(int slot) {
-	if (_rendererId != 0) {
+	// If we're still streaming in, let the texture type pick a stand-in
+	if (_loadState != ResourceLoadState::Ready) {
+		_BindPlaceholder(slot);
+	}
+	else if (_rendererId != 0) {
 		// Instead of glActiveTexture + glBindTexture, we can one line it now :D
 		glBindTextureUnit(slot, _rendererId); 
 	}
 }
 
+void ITexture::_BindPlaceholder(int slot) {
+	Unbind(slot);
+}
+
 void ITexture::Unbind(int slot) {
 	glBindTextureUnit(slot, 0);
 }
@@ -43,6 +55,33 @@ void ITexture::Clear(const glm::vec4& color) {
 	}
 }
 
+uint64_t ITexture::GetBindlessHandle() {
+	if (_bindlessHandle == 0 && _rendererId != 0 && _loadState == ResourceLoadState::Ready && GetLimits().SUPPORTS_BINDLESS) {
+		#ifdef GL_ARB_bindless_texture
+		_bindlessHandle = glGetTextureHandleARB(_rendererId);
+		glMakeTextureHandleResidentARB(_bindlessHandle);
+		#endif
+	}
+	return _bindlessHandle;
+}
+
+bool ITexture::_IsSamplerStateLocked() const {
+	if (_bindlessHandle != 0) {
+		LOG_WARN("Attempted to change the sampler state of \"{}\" after a bindless handle was created, ignoring", GetDebugName());
+		return true;
+	}
+	return false;
+}
+
+void ITexture::_ReleaseBindlessHandle() {
+	if (_bindlessHandle != 0) {
+		#ifdef GL_ARB_bindless_texture
+		glMakeTextureHandleNonResidentARB(_bindlessHandle);
+		#endif
+		_bindlessHandle = 0;
+	}
+}
+
 GlResourceType ITexture::GetResourceClass() const {
 	return GlResourceType::Texture;
 }
@@ -58,6 +97,10 @@ void ITexture::__StaticInit()
 	glGetIntegerv(GL_MAX_3D_TEXTURE_SIZE, &__limits.MAX_3D_TEXTURE_SIZE);
 	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &__limits.MAX_TEXTURE_IMAGE_UNITS);
 	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &__limits.MAX_ANISOTROPY);
+	__limits.SUPPORTS_BINDLESS = false;
+	#ifdef GL_ARB_bindless_texture
+	__limits.SUPPORTS_BINDLESS = GLAD_GL_ARB_bindless_texture != 0;
+	#endif
 
 	// Enable seamless cube maps (we'll need this later!)
 	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
@@ -69,6 +112,7 @@ void ITexture::__StaticInit()
 	LOG_INFO("\t3D Size:    {}", __limits.MAX_3D_TEXTURE_SIZE);
 	LOG_INFO("\tUnits (FS): {}", __limits.MAX_TEXTURE_IMAGE_UNITS);
 	LOG_INFO("\tMax Aniso.: {}", __limits.MAX_ANISOTROPY);
+	LOG_INFO("\tBindless:   {}", __limits.SUPPORTS_BINDLESS);
 
 	__isStaticInit = true;
 }
@@ -24,6 +24,7 @@ public:
 		int   MAX_3D_TEXTURE_SIZE;
 		int   MAX_TEXTURE_IMAGE_UNITS;
 		float MAX_ANISOTROPY;
+		bool  SUPPORTS_BINDLESS;
 	};
 	
 	/// <summary>
@@ -48,6 +49,14 @@ public:
 	/// <param name="color">The color to clear to</param>
 	void Clear(const glm::vec4& color);
 
+	/// <summary>
+	/// Gets a bindless handle for this texture, making it resident the first time it is requested
+	/// (see GL_ARB_bindless_texture). Once a handle has been created the texture's sampler state
+	/// can no longer be changed
+	/// </summary>
+	/// <returns>The handle, or 0 if bindless textures are not supported or the texture is not loaded</returns>
+	uint64_t GetBindlessHandle();
+
 	// Inherited from IGraphicsResource
 
 	virtual GlResourceType GetResourceClass() const override;
@@ -60,7 +69,26 @@ protected:
 	/// </summary>
 	virtual void _Recreate();
 
+	/// <summary>
+	/// Returns true (and logs a warning) if a bindless handle has been created for this texture,
+	/// in which case the sampler state is immutable. Texture types should check this before
+	/// changing any sampler parameters
+	/// </summary>
+	bool _IsSamplerStateLocked() const;
+	/// <summary>
+	/// Makes our bindless handle non-resident, if we have one
+	/// </summary>
+	void _ReleaseBindlessHandle();
+
+	/// <summary>
+	/// Invoked by Bind when this texture is still being streamed in (or failed to load), allows
+	/// texture types to bind a stand-in texture. By default will simply unbind the slot
+	/// </summary>
+	/// <param name="slot">The slot to bind the placeholder to</param>
+	virtual void _BindPlaceholder(int slot);
+
 	TextureType _type; // The type for this texture, mainly used for debugging
+	uint64_t    _bindlessHandle; // The resident bindless handle for this texture, or 0
 
 // STATIC SECTION
 private:
@@ -29,16 +29,25 @@ Texture1D::Texture1D(const Texture1DDescription& description) :
 }
 
 void Texture1D::SetMinFilter(MinFilter value) {
+	if (_IsSamplerStateLocked()) {
+		return;
+	}
 	_description.MinificationFilter = value;
 	glTextureParameteri(_rendererId, GL_TEXTURE_MIN_FILTER, *_description.MinificationFilter);
 }
 
 void Texture1D::SetMagFilter(MagFilter value) {
+	if (_IsSamplerStateLocked()) {
+		return;
+	}
 	_description.MagnificationFilter = value;
 	glTextureParameteri(_rendererId, GL_TEXTURE_MAG_FILTER, *_description.MagnificationFilter);
 }
 
 void Texture1D::SetWrap(WrapMode value) {
+	if (_IsSamplerStateLocked()) {
+		return;
+	}
 	_description.Wrap = value;
 	glTextureParameteri(_rendererId, GL_TEXTURE_WRAP_S, *_description.Wrap);
 }
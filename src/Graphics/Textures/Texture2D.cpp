@@ -4,6 +4,7 @@
 #include "GLM/glm.hpp"
 #include "Utils/JsonGlmHelpers.h"
 #include "Utils/Base64.h"
+#include "Utils/ResourceManager/ResourceManager.h"
 
 /// <summary>
 /// Get the number of mipmap levels required for a texture of the given size
@@ -15,6 +16,11 @@ inline int CalcRequiredMipLevels(int width, int height) {
 	return (1 + floor(log2(glm::max(width, height))));
 }
 
+GLuint   Texture2D::__stagingBuffer = 0;
+uint8_t* Texture2D::__stagingData = nullptr;
+size_t   Texture2D::__stagingHead = 0;
+std::deque<Texture2D::StagingRange> Texture2D::__stagingRanges;
+
 nlohmann::json Texture2D::ToJson() const {
 	nlohmann::json result = {
 		{ "wrap_s",  ~_description.HorizontalWrap },
@@ -25,6 +31,10 @@ nlohmann::json Texture2D::ToJson() const {
 		{ "generate_mipmaps",  _description.GenerateMipMaps },
 	};
 
+	if (_description.Compression != TextureCompression::None) {
+		result["compression"] = ~_description.Compression;
+	}
+
 	if (!_description.Filename.empty()) {
 		result["filename"] = _description.Filename;
 	}
@@ -55,6 +65,26 @@ Texture2D::Sptr Texture2D::FromJson(const nlohmann::json& data)
 	descr.MagnificationFilter = JsonParseEnum(MagFilter, data, "filter_mag", MagFilter::Linear);
 	descr.MaxAnisotropic      = JsonGet(data, "anisotropic", 0.0f);
 	descr.GenerateMipMaps     = JsonGet(data, "generate_mipmaps", false);
+	descr.Compression         = JsonParseEnum(TextureCompression, data, "compression", TextureCompression::None);
+
+	// If we're streaming resources, we create the texture without a file, and decode the image on a worker thread
+	if (!descr.Filename.empty() && ResourceManager::IsAsyncLoadingEnabled()) {
+		std::string filename = descr.Filename;
+		PixelFormat formatHint = descr.FormatHint;
+		TextureCompression compression = descr.Compression;
+		bool generateMips = descr.GenerateMipMaps;
+		descr.Filename = "";
+
+		Texture2D::Sptr result = std::make_shared<Texture2D>(descr);
+		result->_description.Filename = filename;
+
+		std::shared_ptr<DecodedImage> image = std::make_shared<DecodedImage>();
+		ResourceManager::QueueAsyncLoad(result,
+			[filename, formatHint, compression, generateMips, image]() { return _DecodeImage(filename, formatHint, compression, generateMips, *image); },
+			[result, image]() { return result->_UploadImage(*image, true); }
+		);
+		return result;
+	}
 
 	Texture2D::Sptr result = std::make_shared<Texture2D>(descr);
 
@@ -95,6 +125,9 @@ Texture2D::Texture2D(const std::string& filePath) :
 }
 
 void Texture2D::SetMinFilter(MinFilter value) {
+	if (_IsSamplerStateLocked()) {
+		return;
+	}
 	if (_description.MultisampleCount == 1) {
 		_description.MinificationFilter = value;
 		glTextureParameteri(_rendererId, GL_TEXTURE_MIN_FILTER, *_description.MinificationFilter);
@@ -105,6 +138,9 @@ void Texture2D::SetMinFilter(MinFilter value) {
 }
 
 void Texture2D::SetMagFilter(MagFilter value) {
+	if (_IsSamplerStateLocked()) {
+		return;
+	}
 	if (_description.MultisampleCount == 1) {
 		_description.MagnificationFilter = value;
 		glTextureParameteri(_rendererId, GL_TEXTURE_MAG_FILTER, *_description.MagnificationFilter);
@@ -114,11 +150,15 @@ void Texture2D::SetMagFilter(MagFilter value) {
 }
 
 void Texture2D::SetAnisoLevel(float value) {
+	if (_IsSamplerStateLocked()) {
+		return;
+	}
 	if (value != _description.MaxAnisotropic) {
 		_description.MaxAnisotropic = glm::clamp(value, 1.0f, ITexture::GetLimits().MAX_ANISOTROPY);
 		glTextureParameterf(_rendererId, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
 
-		if (_description.GenerateMipMaps) {
+		// Compressed textures come with their mip chain pre-generated
+		if (_description.GenerateMipMaps && !CompressedImage::IsCompressedFormat(_description.Format)) {
 			glGenerateTextureMipmap(_rendererId);
 		}
 	}
@@ -132,10 +172,11 @@ void Texture2D::LoadData(uint32_t width, uint32_t height, PixelFormat format, Pi
 	_description.FormatHint = format;
 	_pixelType = type;
 
-	// Align the data store to the size of a single component to ensure we don't get weirdness with images that aren't RGBA
+	// Align the data store to the size of a single component to ensure we don't get weirdness with images that aren't RGBA,
+	// otherwise rows of RGB or RG images are assumed to be padded to 4 bytes and we read past the end of the data
 	// See https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glPixelStore.xhtml
 	int componentSize = (GLint)GetTexelComponentSize(type);
-	glPixelStorei(GL_PACK_ALIGNMENT, componentSize);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, componentSize);
 
 	// Upload our data to our image
 	glTextureSubImage2D(_rendererId, 0, offsetX, offsetY, width, height, (GLenum)format, (GLenum)type, data);
@@ -146,59 +187,174 @@ void Texture2D::LoadData(uint32_t width, uint32_t height, PixelFormat format, Pi
 	}
 }
 
+Texture2D::DecodedImage::~DecodedImage() {
+	// We now have data in the image, we can clear the STBI data
+	if (Data != nullptr) {
+		stbi_image_free(Data);
+		Data = nullptr;
+	}
+}
+
 void Texture2D::_LoadDataFromFile() {
 	LOG_ASSERT(_description.Width + _description.Height == 0, "This texture has already been configured with a size! Cannot re-allocate memory!");
 
 	if (!_description.Filename.empty()) {
-		// Variables that will store properties about our image
-		int width, height, numChannels;
-		const int targetChannels = GetTexelComponentCount(_description.FormatHint);
-
-		// Use STBI to load the image
-		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(_description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
-
-		// If we could not load any data, warn and return null
-		if (data == nullptr) {
-			LOG_WARN("STBI Failed to load image from \"{}\"", _description.Filename);
-			return ;
+		DecodedImage image;
+		if (!_DecodeImage(_description.Filename, _description.FormatHint, _description.Compression, _description.GenerateMipMaps, image)) {
+			return;
 		}
+		_UploadImage(image, false);
+	}
+	else {
+		SetDebugName(_description.Filename);
+	}
+}
+
+bool Texture2D::_DecodeImage(const std::string& filename, PixelFormat formatHint, TextureCompression compression, bool generateMips, DecodedImage& image) {
+	// Try to use (or generate) the block compressed cache first, we fall back to a regular decode if that fails
+	if (compression != TextureCompression::None && CompressedImage::LoadOrCreate(filename, compression, generateMips, image.Compressed)) {
+		image.Width  = image.Compressed.Width;
+		image.Height = image.Compressed.Height;
+		image.NumChannels = image.Compressed.Format == InternalFormat::BC5 ? 2 : 4;
+		return true;
+	}
+
+	const int targetChannels = GetTexelComponentCount(formatHint);
+
+	// Use STBI to load the image
+	stbi_set_flip_vertically_on_load(true);
+	image.Data = stbi_load(filename.c_str(), &image.Width, &image.Height, &image.NumChannels, targetChannels);
+
+	// If we could not load any data, warn and return
+	if (image.Data == nullptr) {
+		LOG_WARN("STBI Failed to load image from \"{}\"", filename);
+		return false;
+	}
+
+	// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
+	if (targetChannels != 0) {
+		image.NumChannels = targetChannels;
+	}
+
+	return true;
+}
 
-		// We should estimate a good format for our data
+bool Texture2D::_UploadImage(const DecodedImage& image, bool staged) {
+	if (!image.Compressed.Levels.empty()) {
+		_UploadCompressedImage(image.Compressed);
+		return true;
+	}
+
+	// We'll determine a recommended format for the image based on number of channels
+	// We hinted that we wanted a certain number of channels, but we're not guaranteed
+	// that all those channels exist (ex: loading an RGB image but requesting RGBA)
+	InternalFormat internal_format = GetInternalFormatForChannels8(image.NumChannels);
+	PixelFormat    image_format = GetPixelFormatForChannels(image.NumChannels);
+
+	// Update our description to match what we loaded
+	_description.Format = internal_format;
+	_description.Width = image.Width;
+	_description.Height = image.Height;
+
+	// Allocates our memory
+	_SetTextureParams();
+
+	// Upload data to our texture, images that are too large for the staging ring are uploaded directly
+	size_t dataSize = (size_t)image.Width * image.Height * image.NumChannels;
+	size_t offset = 0;
+	if (staged && _StageData(image.Data, dataSize, offset)) {
+		// With an unpack buffer bound, the data pointer is treated as an offset into the buffer
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, __stagingBuffer);
+		LoadData(image.Width, image.Height, image_format, PixelType::UByte, reinterpret_cast<void*>(offset));
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		// The range can be reused once the GPU is done copying out of it
+		__stagingRanges.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), offset, dataSize });
+	}
+	else {
+		LoadData(image.Width, image.Height, image_format, PixelType::UByte, image.Data);
+	}
+
+	SetDebugName(_description.Filename);
+	return true;
+}
 
-		// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
-		if (targetChannels != 0)
-			numChannels = targetChannels;
+bool Texture2D::_StageData(const void* data, size_t size, size_t& offset) {
+	if (size > STAGING_RING_SIZE) {
+		return false;
+	}
 
-		// We'll determine a recommended format for the image based on number of channels
-		// We hinted that we wanted a certain number of channels, but we're not guaranteed
-		// that all those channels exist (ex: loading an RGB image but requesting RGBA)
-		InternalFormat internal_format = GetInternalFormatForChannels8(numChannels);
-		PixelFormat    image_format = GetPixelFormatForChannels(numChannels);
+	// The ring lives for the lifetime of the context, so we map it once and write into it directly
+	if (__stagingBuffer == 0) {
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glCreateBuffers(1, &__stagingBuffer);
+		glNamedBufferStorage(__stagingBuffer, STAGING_RING_SIZE, nullptr, flags);
+		__stagingData = reinterpret_cast<uint8_t*>(glMapNamedBufferRange(__stagingBuffer, 0, STAGING_RING_SIZE, flags));
+		LOG_ASSERT(__stagingData != nullptr, "Failed to map texture staging buffer");
+	}
 
-		// This is one of those poorly documented things in OpenGL
-		if ((numChannels * width) % 4 != 0) {
-			LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
+	// Wrap around if the data won't fit in the rest of the ring
+	if (__stagingHead + size > STAGING_RING_SIZE) {
+		__stagingHead = 0;
+	}
+	offset = __stagingHead;
+
+	// Ranges are retired in the order they were written, so we wait on the newest range that overlaps
+	// ours, which also guarantees that every range before it is done
+	int lastOverlap = -1;
+	for (int ix = 0; ix < (int)__stagingRanges.size(); ix++) {
+		const StagingRange& range = __stagingRanges[ix];
+		if (range.Offset < offset + size && offset < range.Offset + range.Size) {
+			lastOverlap = ix;
 		}
+	}
+	for (int ix = 0; ix <= lastOverlap; ix++) {
+		StagingRange& range = __stagingRanges.front();
+		glClientWaitSync(range.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+		glDeleteSync(range.Fence);
+		__stagingRanges.pop_front();
+	}
 
-		// Update our description to match what we loaded
-		_description.Format = internal_format;
-		_description.Width = width;
-		_description.Height = height;
+	// Also retire any ranges the GPU has already finished with, so the queue doesn't grow unbounded
+	while (!__stagingRanges.empty() && glClientWaitSync(__stagingRanges.front().Fence, 0, 0) != GL_TIMEOUT_EXPIRED) {
+		glDeleteSync(__stagingRanges.front().Fence);
+		__stagingRanges.pop_front();
+	}
 
-		// Allocates our memory
-		_SetTextureParams();
+	memcpy(__stagingData + offset, data, size);
+	__stagingHead = offset + size;
+	return true;
+}
 
-		// Upload data to our texture
-		LoadData(width, height, image_format, PixelType::UByte, data);
+void Texture2D::_UploadCompressedImage(const CompressedImage& image) {
+	_description.Format = image.Format;
+	_description.Width  = image.Width;
+	_description.Height = image.Height;
+	_description.FormatHint = image.Format == InternalFormat::BC5 ? PixelFormat::RG : PixelFormat::RGBA;
+	_pixelType = PixelType::Unknown;
 
-		// We now have data in the image, we can clear the STBI data
-		stbi_image_free(data);
+	// Allocates our memory, then we upload each level of the mip chain as-is
+	_SetTextureParams();
+	for (size_t level = 0; level < image.Levels.size(); level++) {
+		const CompressedImage::Level& data = image.Levels[level];
+		glCompressedTextureSubImage2D(_rendererId, (GLint)level, 0, 0, data.Width, data.Height, *image.Format, (GLsizei)data.Data.size(), data.Data.data());
 	}
-	
+
 	SetDebugName(_description.Filename);
 }
 
+void Texture2D::_BindPlaceholder(int slot) {
+	// Shared 1x1 white texture, this lives for the lifetime of the GL context so we never free it
+	static GLuint placeholderId = 0;
+	if (placeholderId == 0) {
+		uint32_t white = 0xFFFFFFFF;
+		glCreateTextures(GL_TEXTURE_2D, 1, &placeholderId);
+		glTextureStorage2D(placeholderId, 1, GL_RGBA8, 1, 1);
+		glTextureSubImage2D(placeholderId, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &white);
+	}
+	glBindTextureUnit(slot, placeholderId);
+}
+
 void Texture2D::_SetTextureParams() {
 	// If we have a multisampled texture, and the current type is 2D, change it to 2D multisampled
 	if (_description.MultisampleCount > 1 && _type == TextureType::_2D) {
@@ -1,5 +1,7 @@
 #pragma once
 #include "ITexture.h"
+#include "CompressedImage.h"
+#include <deque>
 
 /// <summary>
 /// Describes all parameters we can manipulate with our 2D Textures
@@ -60,6 +62,12 @@ struct Texture2DDescription {
 	/// </summary>
 	PixelFormat    FormatHint;
 
+	/// <summary>
+	/// Whether images loaded from files should be block compressed, default None. Compressed
+	/// images (and their mip chains) are cached next to the source file
+	/// </summary>
+	TextureCompression Compression;
+
 	Texture2DDescription() :
 		Width(0), Height(0),
 		Format(InternalFormat::Unknown),
@@ -71,7 +79,8 @@ struct Texture2DDescription {
 		GenerateMipMaps(true),
 		MultisampleCount(1),
 		Filename(""),
-		FormatHint(PixelFormat::RGBA)
+		FormatHint(PixelFormat::RGBA),
+		Compression(TextureCompression::None)
 	{ }
 };
 
@@ -145,19 +154,84 @@ public:
 	static Texture2D::Sptr FromJson(const nlohmann::json& data);
 
 protected:
+	/// <summary>
+	/// Stores an image that has been decoded from disk, but not yet uploaded to the GPU
+	/// Frees the image data when destroyed
+	/// </summary>
+	struct DecodedImage {
+		int      Width;
+		int      Height;
+		int      NumChannels;
+		uint8_t* Data;
+		// If the image was block compressed, this will hold the compressed levels and Data will be null
+		CompressedImage Compressed;
+
+		DecodedImage() : Width(0), Height(0), NumChannels(0), Data(nullptr) {}
+		~DecodedImage();
+		NO_COPY(DecodedImage);
+	};
+
 	Texture2DDescription _description;
 	PixelType _pixelType;
 
+	// Size of the persistently mapped ring that staged uploads are copied through, large enough for a 4k RGBA image
+	static const size_t STAGING_RING_SIZE = 64 * 1024 * 1024;
+	// A range of the staging ring that may still be read by the GPU until the fence is signaled
+	struct StagingRange {
+		GLsync Fence;
+		size_t Offset;
+		size_t Size;
+	};
+	static GLuint   __stagingBuffer;
+	static uint8_t* __stagingData;
+	static size_t   __stagingHead;
+	static std::deque<StagingRange> __stagingRanges;
+
+	/// <summary>
+	/// Reserves a range of the staging ring and copies data into it, waiting on any earlier upload
+	/// that is still reading from the range. Creates the ring on first use. Must be called on the main thread
+	/// </summary>
+	/// <param name="data">The data to copy</param>
+	/// <param name="size">The size of the data in bytes</param>
+	/// <param name="offset">Will store the offset of the range within the staging buffer</param>
+	/// <returns>True if the data was staged, false if it does not fit in the ring</returns>
+	static bool _StageData(const void* data, size_t size, size_t& offset);
+
 	/// <summary>
 	/// Loads this texture from the file specified in the description
 	/// Will overwrite description size
 	/// </summary>
 	void _LoadDataFromFile();
 	/// <summary>
+	/// Decodes an image file into CPU memory, does not touch OpenGL so is safe to call from a worker thread
+	/// </summary>
+	/// <param name="filename">The path to the image to load</param>
+	/// <param name="formatHint">The pixel format hint to determine the channel count</param>
+	/// <param name="compression">The block compression to use, if the image can't be compressed it will be decoded normally</param>
+	/// <param name="generateMips">True if a compressed image should include it's mip chain</param>
+	/// <param name="image">The image to store the results in</param>
+	/// <returns>True if the image was decoded, false if otherwise</returns>
+	static bool _DecodeImage(const std::string& filename, PixelFormat formatHint, TextureCompression compression, bool generateMips, DecodedImage& image);
+	/// <summary>
+	/// Allocates this texture's storage to match a decoded image and uploads the data. Must be called on the main thread
+	/// </summary>
+	/// <param name="image">The image to upload</param>
+	/// <param name="staged">True to upload via the staging ring, allowing the driver to perform the transfer asynchronously</param>
+	/// <returns>True if the upload succeeded</returns>
+	bool _UploadImage(const DecodedImage& image, bool staged);
+	/// <summary>
+	/// Allocates this texture's storage in a block compressed format, and uploads every level of the image. Must be called on the main thread
+	/// </summary>
+	/// <param name="image">The compressed image to upload</param>
+	void _UploadCompressedImage(const CompressedImage& image);
+	/// <summary>
 	/// Allocates our texture's memory and sets sampling / filtering parameters
 	/// </summary>
 	void _SetTextureParams();
 
+	// Inherited from ITexture
+	virtual void _BindPlaceholder(int slot) override;
+
 public:
 	static Texture2D::Sptr LoadFromFile(const std::string& path, const Texture2DDescription& description = Texture2DDescription(), bool forceRgba = true);
 };
@@ -2,6 +2,7 @@
 #include "Utils/Base64.h"
 #include "Utils/JsonGlmHelpers.h"
 #include "Utils/StringUtils.h"
+#include "Utils/ResourceManager/ResourceManager.h"
 #include <Logging.h>
 #include <stb_image.h>
 #include <iostream>
@@ -34,12 +35,18 @@ Texture3D::Texture3D(const Texture3DDescription& description) :
 
 void Texture3D::SetMinFilter(MinFilter value)
 {
+	if (_IsSamplerStateLocked()) {
+		return;
+	}
 	_description.MinificationFilter = value;
 	glTextureParameteri(_rendererId, GL_TEXTURE_MIN_FILTER, *_description.MinificationFilter);
 }
 
 void Texture3D::SetMagFilter(MagFilter value)
 {
+	if (_IsSamplerStateLocked()) {
+		return;
+	}
 	_description.MagnificationFilter = value;
 	glTextureParameteri(_rendererId, GL_TEXTURE_MAG_FILTER, *_description.MagnificationFilter);
 }
@@ -115,6 +122,28 @@ Texture3D::Sptr Texture3D::FromJson(const nlohmann::json& data)
 	description.GenerateMipMaps = JsonGet(data, "generate_mipmaps", false);
 	description.FormatHint = JsonParseEnum(PixelFormat, data, "format", PixelFormat::Unknown);
 
+	// If we're streaming resources, parse the LUT on a worker thread and upload it when it's ready
+	if (!description.Filename.empty() && ResourceManager::IsAsyncLoadingEnabled()) {
+		std::filesystem::path fPath = std::filesystem::path(description.Filename);
+		std::string extension = fPath.extension().string();
+		StringTools::ToLower(extension);
+
+		if (extension.compare(".cube") == 0) {
+			std::string filename = description.Filename;
+			description.Filename = "";
+
+			Texture3D::Sptr result = std::make_shared<Texture3D>(description);
+			result->_description.Filename = filename;
+
+			std::shared_ptr<CubeFileData> lut = std::make_shared<CubeFileData>();
+			ResourceManager::QueueAsyncLoad(result,
+				[filename, lut]() { return _ParseCubeFile(filename, *lut); },
+				[result, lut]() { return result->_UploadCubeData(*lut); }
+			);
+			return result;
+		}
+	}
+
 	Texture3D::Sptr result = std::make_shared<Texture3D>(description);
 
 	// If we embedded data into the JSON, load it now
@@ -149,14 +178,21 @@ void Texture3D::_LoadDataFromFile()
 
 void Texture3D::_LoadCubeFile()
 {
-	std::ifstream inFile(_description.Filename);
+	CubeFileData data;
+	if (_ParseCubeFile(_description.Filename, data)) {
+		_UploadCubeData(data);
+	}
+}
+
+bool Texture3D::_ParseCubeFile(const std::string& filename, CubeFileData& result)
+{
+	std::ifstream inFile(filename);
 
 	if (!inFile.is_open()) {
-		LOG_WARN("Failed to open file .cube file: {}", _description.Filename);
-		return;
+		LOG_WARN("Failed to open file .cube file: {}", filename);
+		return false;
 	}
 
-	glm::u8vec3* textureData = nullptr;
 	uint32_t lutSize{ 0 };
 	uint32_t ix{ 0 };
 	glm::vec3 rgb { 0, 0, 0 };
@@ -185,18 +221,12 @@ void Texture3D::_LoadCubeFile()
 			std::stringstream lReader(line.substr(12));
 			lReader >> lutSize;
 
-			// Update the description's size
-			_description.Width = _description.Height = _description.Depth = lutSize;
+			// Update the result's size
+			result.Size = lutSize;
 
-			// If the size we read is non-zero, allocate our data!
+			// If the size we read is non-zero, allocate our data! This will discard any old data
 			if (lutSize > 0) {
-				// If we had data already, delete it
-				if (textureData != nullptr) {
-					delete[] textureData;
-				} 
-
-				// Allocate data to store texels in
-				textureData = new glm::u8vec3[(size_t)lutSize * lutSize * lutSize];
+				result.Texels.assign((size_t)lutSize * lutSize * lutSize, glm::u8vec3(0));
 				ix = 0;
 			}
 		}
@@ -210,8 +240,8 @@ void Texture3D::_LoadCubeFile()
 			// Trim any excess whitespace
 			StringTools::Trim(name);
 
-			// We'll store this in the debug name
-			SetDebugName(name);
+			// We'll store this and use it as the debug name when we upload
+			result.Title = name;
 		}
 
 		else if (line.find("DOMAIN_MIN") != std::string::npos)
@@ -224,7 +254,7 @@ void Texture3D::_LoadCubeFile()
 		{ /* ignore for now */ }
 
 		// Reading data lines
-		else if (!line.empty() && textureData != nullptr) {
+		else if (!line.empty() && !result.Texels.empty()) {
 
 			// Make sure we don't case a write access violation
 			if (ix >= (lutSize * lutSize * lutSize) && lutSize > 0) {
@@ -238,32 +268,41 @@ void Texture3D::_LoadCubeFile()
 			rgb = glm::clamp(rgb, glm::vec3(0), glm::vec3(1));
 
 			// Store in the array, converting to the correct scale for bytes
-			textureData[ix].r = static_cast<uint8_t>(rgb.r * 255);
-			textureData[ix].g = static_cast<uint8_t>(rgb.g * 255);
-			textureData[ix].b = static_cast<uint8_t>(rgb.b * 255);
+			result.Texels[ix].r = static_cast<uint8_t>(rgb.r * 255);
+			result.Texels[ix].g = static_cast<uint8_t>(rgb.g * 255);
+			result.Texels[ix].b = static_cast<uint8_t>(rgb.b * 255);
 
 			// Move to the next texel
 			ix++;
 		}
 	} 
 
-	if (textureData != nullptr) {
-		// Set the pixel format
-		_description.Format = InternalFormat::RGB8;
-		// We need to clamp to edge for LUTS
-		_description.WrapS = _description.WrapT = _description.WrapR = WrapMode::ClampToEdge;
+	if (result.Texels.empty()) {
+		LOG_WARN("Failed to load cube file: \"{}\"", filename);
+		return false;
+	}
 
-		// Allocate data and configure params
-		_SetTextureParams();
-		// Load data
-		LoadData(lutSize, lutSize, lutSize, PixelFormat::RGB, PixelType::UByte, textureData);
+	return true;
+}
 
-		// Clean up after ourselves
-		delete[] textureData;
-	}
-	else {
-		LOG_WARN("Failed to load cube file: \"{}\"", _description.Filename);
+bool Texture3D::_UploadCubeData(const CubeFileData& data)
+{
+	if (!data.Title.empty()) {
+		SetDebugName(data.Title);
 	}
+
+	// Set the size and pixel format
+	_description.Width = _description.Height = _description.Depth = data.Size;
+	_description.Format = InternalFormat::RGB8;
+	// We need to clamp to edge for LUTS
+	_description.WrapS = _description.WrapT = _description.WrapR = WrapMode::ClampToEdge;
+
+	// Allocate data and configure params
+	_SetTextureParams();
+	// Load data
+	LoadData(data.Size, data.Size, data.Size, PixelFormat::RGB, PixelType::UByte, (void*)data.Texels.data());
+
+	return true;
 }
 
 void Texture3D::_SetTextureParams()
@@ -1,5 +1,6 @@
 #pragma once
 #include "ITexture.h"
+#include <vector>
 
 /// <summary>
 /// Describes all parameters we can manipulate with our 2D Textures
@@ -147,6 +148,17 @@ public:
 	static Texture3D::Sptr FromJson(const nlohmann::json& data);
 
 protected:
+	/// <summary>
+	/// Stores the contents of a .cube LUT that has been parsed, but not yet uploaded to the GPU
+	/// </summary>
+	struct CubeFileData {
+		uint32_t                 Size;
+		std::string              Title;
+		std::vector<glm::u8vec3> Texels;
+
+		CubeFileData() : Size(0), Title(""), Texels() {}
+	};
+
 	Texture3DDescription _description;
 	PixelType _pixelType;
 
@@ -160,6 +172,19 @@ protected:
 	/// </summary>
 	void _LoadCubeFile();
 	/// <summary>
+	/// Parses a .cube file into CPU memory, does not touch OpenGL so is safe to call from a worker thread
+	/// </summary>
+	/// <param name="filename">The path to the .cube file</param>
+	/// <param name="result">The structure to store the parsed LUT in</param>
+	/// <returns>True if the file contained a valid LUT</returns>
+	static bool _ParseCubeFile(const std::string& filename, CubeFileData& result);
+	/// <summary>
+	/// Allocates this texture's storage and uploads a parsed LUT. Must be called on the main thread
+	/// </summary>
+	/// <param name="data">The parsed LUT data to upload</param>
+	/// <returns>True if the upload succeeded</returns>
+	bool _UploadCubeData(const CubeFileData& data);
+	/// <summary>
 	/// Allocates our texture's memory and sets sampling / filtering parameters
 	/// </summary>
 	void _SetTextureParams();
@@ -2,6 +2,7 @@
 #include <filesystem>
 #include "stb_image.h"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/ResourceManager/ResourceManager.h"
 
 TextureCube::TextureCube(const std::string& baseFilename) :
 	ITexture(TextureType::Cubemap),
@@ -41,6 +42,10 @@ nlohmann::json TextureCube::ToJson() const
 	} else {
 		result["base_filename"] = _description.Filename;
 	}
+
+	if (_description.Compression != TextureCompression::None) {
+		result["compression"] = ~_description.Compression;
+	}
 	return result;
 }
 
@@ -50,6 +55,7 @@ TextureCube::Sptr TextureCube::FromJson(const nlohmann::json& data)
 	descr.MinificationFilter  = JsonParseEnum(MinFilter, data, "filter_min", MinFilter::NearestMipNearest);
 	descr.MagnificationFilter = JsonParseEnum(MagFilter, data, "filter_mag", MagFilter::Linear);
 	descr.Filename       = JsonGet<std::string>(data, "base_filename", "");
+	descr.Compression    = JsonParseEnum(TextureCompression, data, "compression", TextureCompression::None);
 	if (data.contains("face_filenames") && data["face_filenames"].is_object()) {
 		for (auto& [key, value] : data["face_filenames"].items()) {
 			CubeMapFace face = ParseCubeMapFace(key, CubeMapFace::Unknown);
@@ -58,15 +64,54 @@ TextureCube::Sptr TextureCube::FromJson(const nlohmann::json& data)
 			}
 		}
 	}
+
+	// If we're streaming resources, decode the faces on a worker thread and upload them when they're ready
+	if (ResourceManager::IsAsyncLoadingEnabled()) {
+		std::shared_ptr<DecodedFaces> faces = std::make_shared<DecodedFaces>();
+		faces->FaceFileNames = descr.FaceFileNames;
+		std::string baseFilename = descr.Filename;
+		TextureCompression compression = descr.Compression;
+
+		// Clear out the files so that the constructor does not try to load them
+		descr.FaceFileNames.clear();
+		descr.Filename = "";
+		TextureCube::Sptr result = std::make_shared<TextureCube>(descr);
+		result->_description.Filename = baseFilename;
+
+		ResourceManager::QueueAsyncLoad(result,
+			[baseFilename, compression, faces]() { return _DecodeImages(baseFilename, compression, *faces); },
+			[result, faces]() { return result->_UploadImages(*faces); }
+		);
+		return result;
+	}
+
 	return std::make_shared<TextureCube>(descr);
 }
 
 void TextureCube::_LoadFromDescription()
+{
+	// Nothing to load, this is the case for cubes that are streamed in
+	if (_description.FaceFileNames.empty() && _description.Filename.empty()) {
+		return;
+	}
+
+	DecodedFaces faces;
+	faces.FaceFileNames = _description.FaceFileNames;
+	if (_DecodeImages(_description.Filename, _description.Compression, faces)) {
+		_UploadImages(faces);
+	}
+	else {
+		// Still store any resolved filenames so that we serialize correctly
+		_description.FaceFileNames = faces.FaceFileNames;
+	}
+}
+
+bool TextureCube::_DecodeImages(const std::string& baseFilename, TextureCompression compression, DecodedFaces& result)
 {
 	// If we weren't passed face filenames but WERE passed a base filename, try and get the 6 face files
-	if (_description.FaceFileNames.empty() && !_description.Filename.empty()) {
+	if (result.FaceFileNames.empty() && !baseFilename.empty()) {
 		// Get the file path and it's directory to extract the root file name w/o extension
-		std::filesystem::path baseName = std::filesystem::absolute(std::filesystem::path(_description.Filename));
+		std::filesystem::path baseName = std::filesystem::absolute(std::filesystem::path(baseFilename));
 		std::filesystem::path directory = baseName.parent_path();
 		std::filesystem::path rootFileName = directory / baseName.stem();
 
@@ -81,27 +126,24 @@ void TextureCube::_LoadFromDescription()
 			targetPath += "_" + ~face;
 			targetPath += baseName.extension();
 
-			// If the file exists, store it in the description
+			// If the file exists, store it in the result
 			if (std::filesystem::exists(targetPath)) {
-				_description.FaceFileNames[face] = targetPath.string();
+				result.FaceFileNames[face] = targetPath.string();
 			}
 		}
 	}
 
 	// If we don't have 6 faces for our cube, something has gone horribly wrong (or the files don't exist)
-	if (_description.FaceFileNames.size() != 6) {
+	if (result.FaceFileNames.size() != 6) {
 		LOG_ERROR("TextureCube was not given 6 faces, aborting load");
-		return;
+		return false;
 	}
 
-	// Load all the images into the texture
-	_LoadImages(_description.FaceFileNames);
-}
+	// Try to use (or generate) the block compressed cache first, we fall back to a regular decode if that fails
+	if (compression != TextureCompression::None && _DecodeCompressedImages(compression, result)) {
+		return true;
+	}
 
-void TextureCube::_LoadImages(const std::unordered_map<CubeMapFace, std::string>& faceFilenames)
-{
-	// Will store all of our texture data, back to back in memory
-	uint8_t* datastore = nullptr;
 	// The size of a single face's texture, in bytes
 	size_t textureDataSize = 0;
 
@@ -112,69 +154,108 @@ void TextureCube::_LoadImages(const std::unordered_map<CubeMapFace, std::string>
 	for (int ix = 0; ix < 6; ix++) {
 		CubeMapFace face = (CubeMapFace)ix;
 		
-		const std::string& filename = _description.FaceFileNames[face];
+		const std::string& filename = result.FaceFileNames[face];
 		int fileWidth, fileHeight, fileNumChannels;
 
 		// Use STBI to load the image
 		stbi_set_flip_vertically_on_load(true);
 		uint8_t* data = stbi_load(filename.c_str(), &fileWidth, &fileHeight, &fileNumChannels, 0);
 
-		// If we could not load any data, warn and return null
+		// If we could not load any data, warn and return
 		if (data == nullptr) {
-			if (data != nullptr) { delete[] datastore; }
 			LOG_ERROR("STBI Failed to load image from \"{}\"", filename);
-			return;
+			return false;
 		}
 		// If the texture is not square, warn and abort
 		if (fileWidth != fileHeight) {
-			if (data != nullptr) { delete[] datastore; }
 			LOG_ERROR("Image loaded from \"{}\" was not square", filename);
 			stbi_image_free(data);
-			return;
+			return false;
 		}
 		// If the dataStore is empty, this is the first texture we loaded
-		if (datastore == nullptr) {
+		if (result.Data.empty()) {
 			// Store the size and number of channels
-			_description.Size = fileWidth;
+			result.Size = fileWidth;
 			numChannels = fileNumChannels;
 
 			// Get the format and pixel format for the number of channels
-			_description.Format = GetInternalFormatForChannels8(numChannels);
-			_description.FormatHint = GetPixelFormatForChannels(numChannels);
+			result.Format = GetInternalFormatForChannels8(numChannels);
+			result.FormatHint = GetPixelFormatForChannels(numChannels);
 
 			// Determine how many bytes we'll need to store a single face worth of data
-			textureDataSize = ((size_t)_description.Size * _description.Size * GetTexelSize(_description.FormatHint, PixelType::Byte));
+			textureDataSize = ((size_t)result.Size * result.Size * GetTexelSize(result.FormatHint, PixelType::Byte));
 
 			// This is one of those poorly documented things in OpenGL
-			if ((GetTexelSize(_description.FormatHint, PixelType::Byte) * _description.Size) % 4 != 0) {
+			if ((GetTexelSize(result.FormatHint, PixelType::Byte) * result.Size) % 4 != 0) {
 				LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
 			}
 
 			// Allocate the data store for our image data
-			datastore = new uint8_t[textureDataSize * 6];
+			result.Data.resize(textureDataSize * 6);
 		}
 		// If this is NOT the first image, and it does not match previous images, abort
-		else if (fileWidth != _description.Size || fileNumChannels != numChannels) {
-			delete[] datastore;
+		else if (fileWidth != result.Size || fileNumChannels != numChannels) {
 			LOG_WARN("Image \"{}\" did not match size or format of texture cube", filename);
 			stbi_image_free(data);
-			return;
+			return false;
 		}
 
 		// Copy the data we loaded into the corresponding location in the data store
-		memcpy(datastore + textureDataSize * ix, data, textureDataSize);
+		memcpy(result.Data.data() + textureDataSize * ix, data, textureDataSize);
 		stbi_image_free(data);
 	}
 
+	return true;
+}
+
+bool TextureCube::_DecodeCompressedImages(TextureCompression compression, DecodedFaces& result)
+{
+	result.Compressed.resize(6);
+	for (int ix = 0; ix < 6; ix++) {
+		CompressedImage& image = result.Compressed[ix];
+
+		// Cubemaps only allocate a single level, so we don't need the mip chain
+		if (!CompressedImage::LoadOrCreate(result.FaceFileNames[(CubeMapFace)ix], compression, false, image) ||
+			image.Width != image.Height ||
+			image.Width != result.Compressed[0].Width ||
+			image.Format != result.Compressed[0].Format) {
+			// Faces may disagree if some have alpha and some don't, in which case we use uncompressed faces
+			result.Compressed.clear();
+			return false;
+		}
+	}
+
+	result.Size = result.Compressed[0].Width;
+	result.Format = result.Compressed[0].Format;
+	result.FormatHint = result.Format == InternalFormat::BC5 ? PixelFormat::RG : PixelFormat::RGBA;
+	return true;
+}
+
+bool TextureCube::_UploadImages(const DecodedFaces& faces)
+{
+	_description.FaceFileNames = faces.FaceFileNames;
+	_description.Size = faces.Size;
+	_description.Format = faces.Format;
+	_description.FormatHint = faces.FormatHint;
+
 	// Allocate memory and set up initial parameters
 	_SetTextureParams();
 
+	// Compressed faces are uploaded as-is, one face (layer) at a time
+	if (!faces.Compressed.empty()) {
+		for (int ix = 0; ix < 6; ix++) {
+			const CompressedImage::Level& level = faces.Compressed[ix].Levels[0];
+			glCompressedTextureSubImage3D(_rendererId, 0, 0, 0, ix, level.Width, level.Height, 1, *_description.Format, (GLsizei)level.Data.size(), level.Data.data());
+		}
+		return true;
+	}
+
 	// Set our pixel alignment to a single byte so we don't get banding
-	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
 	// Upload our data to our image (note that the custom enum tools let us convert to base type [GLenum] with the * operator)
-	glTextureSubImage3D(_rendererId, 0, 0, 0, 0, _description.Size, _description.Size, 6, *_description.FormatHint, *PixelType::UByte, datastore);
-	delete[] datastore;
+	glTextureSubImage3D(_rendererId, 0, 0, 0, 0, _description.Size, _description.Size, 6, *_description.FormatHint, *PixelType::UByte, faces.Data.data());
+	return true;
 }
 
 void TextureCube::_SetTextureParams(){
@@ -1,6 +1,8 @@
 #pragma once
 #include <EnumToString.h>
 #include "ITexture.h"
+#include "CompressedImage.h"
+#include <vector>
 
 /*
 0 	GL_TEXTURE_CUBE_MAP_POSITIVE_X
@@ -60,6 +62,12 @@ struct TextureCubeDescription {
 	/// </summary>
 	PixelFormat    FormatHint;
 
+	/// <summary>
+	/// Whether the faces should be block compressed when loaded, default None. Compressed
+	/// faces are cached next to their source files
+	/// </summary>
+	TextureCompression Compression;
+
 	/// <summary>
 	/// Creates a default (empty) cubemap description
 	/// </summary>
@@ -69,7 +77,8 @@ struct TextureCubeDescription {
 		MinificationFilter(MinFilter::NearestMipLinear),
 		MagnificationFilter(MagFilter::Linear),
 		Filename(""),
-		FormatHint(PixelFormat::RGBA)
+		FormatHint(PixelFormat::RGBA),
+		Compression(TextureCompression::None)
 	{ }
 };
 
@@ -112,10 +121,48 @@ public:
 	static TextureCube::Sptr FromJson(const nlohmann::json& data);
 
 protected:
+	/// <summary>
+	/// Stores the 6 faces of a cube map that have been decoded from disk, but not yet uploaded to the GPU
+	/// </summary>
+	struct DecodedFaces {
+		std::unordered_map<CubeMapFace, std::string> FaceFileNames;
+		uint32_t             Size;
+		InternalFormat       Format;
+		PixelFormat          FormatHint;
+		// All 6 faces, stored back to back in memory
+		std::vector<uint8_t> Data;
+		// If the faces were block compressed, this stores one image per face and Data will be empty
+		std::vector<CompressedImage> Compressed;
+
+		DecodedFaces() : FaceFileNames(), Size(0), Format(InternalFormat::Unknown), FormatHint(PixelFormat::Unknown), Data(), Compressed() {}
+	};
+
 	TextureCubeDescription _description;
 
 	virtual void _LoadFromDescription();
-	virtual void _LoadImages(const std::unordered_map<CubeMapFace, std::string>& faceFilenames);
+
+	/// <summary>
+	/// Resolves the face filenames (if only a base filename is given) and decodes all 6 faces into
+	/// CPU memory. Does not touch OpenGL so is safe to call from a worker thread
+	/// </summary>
+	/// <param name="baseFilename">The base filename to resolve face names from if result has no face filenames</param>
+	/// <param name="compression">The block compression to use, if the faces can't be compressed they will be decoded normally</param>
+	/// <param name="result">The structure to store the faces in, may have FaceFileNames pre-populated</param>
+	/// <returns>True if all 6 faces were loaded</returns>
+	static bool _DecodeImages(const std::string& baseFilename, TextureCompression compression, DecodedFaces& result);
+	/// <summary>
+	/// Attempts to load block compressed versions of all 6 faces, all faces must end up with the same size and format
+	/// </summary>
+	/// <param name="compression">The block compression to use</param>
+	/// <param name="result">The structure to store the faces in, must have all 6 FaceFileNames populated</param>
+	/// <returns>True if all 6 faces were compressed</returns>
+	static bool _DecodeCompressedImages(TextureCompression compression, DecodedFaces& result);
+	/// <summary>
+	/// Allocates this texture's storage and uploads the decoded faces. Must be called on the main thread
+	/// </summary>
+	/// <param name="faces">The faces to upload</param>
+	/// <returns>True if the upload succeeded</returns>
+	bool _UploadImages(const DecodedFaces& faces);
 
 	/// <summary>
 	/// Allocates our texture's memory and sets sampling / filtering parameters
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include <GLM/glm.hpp>
+#include <Logging.h>
+
+#include "Graphics/ShaderProgram.h"
+
+/// <summary>
+/// Calculates the 32 bit FNV-1a hash of a uniform name, can be evaluated at compile time
+/// </summary>
+/// <param name="name">The null terminated name of the uniform</param>
+constexpr uint32_t HashUniformName(const char* name) {
+	uint32_t hash = 0x811C9DC5u;
+	for (; *name != '\0'; name++) {
+		hash ^= static_cast<uint8_t>(*name);
+		hash *= 0x01000193u;
+	}
+	return hash;
+}
+
+/// <summary>
+/// A typed handle to a uniform in a shader program. The name is hashed at compile time, and the
+/// location is looked up once when the handle is resolved against a program, so setting the
+/// uniform does not need any string operations
+/// 
+/// Example:
+///		UniformHandle<glm::vec3> lightColor = "u_LightColor";
+///		lightColor.Resolve(shader); // after linking
+///		lightColor.Set(color);
+/// </summary>
+/// <typeparam name="T">The type of the uniform, must be a type supported by ShaderProgram::SetUniform</typeparam>
+template <typename T>
+class UniformHandle {
+public:
+	constexpr UniformHandle(const char* name) :
+		_name(name),
+		_hash(HashUniformName(name)),
+		_program(nullptr),
+		_generation(0),
+		_location(-1) { }
+
+	/// <summary>
+	/// Resolves the location of the uniform in the given program, waiting for it to finish
+	/// linking. Does nothing if the handle is already resolved against the program, so this
+	/// is cheap to call when switching between programs such as shader variants
+	/// 
+	/// The resolved location is tied to the program's link generation rather than just it's
+	/// address, so relinking the program or creating a new one at the same address re-resolves
+	/// 
+	/// If the uniform does not exist a warning is logged, and setting the handle does nothing
+	/// </summary>
+	/// <param name="program">The program to resolve the uniform in</param>
+	/// <returns>True if the uniform exists in the program</returns>
+	bool Resolve(ShaderProgram* program) {
+		uint32_t generation = program != nullptr ? program->GetLinkGeneration() : 0;
+		if (program != _program || generation != _generation) {
+			_program = program;
+			_generation = generation;
+			_location = program != nullptr ? program->FindUniformLocation(_hash) : -1;
+			if (_location == -1 && program != nullptr) {
+				LOG_WARN("Uniform \"{}\" was not found in shader \"{}\"", _name, program->GetDebugName());
+			}
+		}
+		return _location != -1;
+	}
+	bool Resolve(const ShaderProgram::Sptr& program) {
+		return Resolve(program.get());
+	}
+
+	/// <summary>
+	/// Sets the value of the uniform in the program the handle was resolved against
+	/// </summary>
+	void Set(const T& value) {
+		Set(&value, 1);
+	}
+	/// <summary>
+	/// Sets the value of an array uniform in the program the handle was resolved against
+	/// </summary>
+	void Set(const T* values, int count) {
+		if (_location == -1) {
+			return;
+		}
+		if constexpr (std::is_same<T, glm::mat3>::value || std::is_same<T, glm::mat4>::value) {
+			_program->SetUniformMatrix(_location, values, count);
+		} else {
+			_program->SetUniform(_location, values, count);
+		}
+	}
+
+	const char* GetName() const { return _name; }
+	uint32_t GetHash() const { return _hash; }
+	int GetLocation() const { return _location; }
+	bool IsValid() const { return _location != -1; }
+
+private:
+	const char*    _name;
+	uint32_t       _hash;
+	ShaderProgram* _program;
+	uint32_t       _generation;
+	int            _location;
+};
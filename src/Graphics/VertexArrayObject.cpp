@@ -43,7 +43,7 @@ VertexArrayObject::VertexBufferBinding* VertexArrayObject::AddVertexBuffer(const
 			_elementCount = _vertexCount;
 		}
 	} 
-	else if (buffer->GetElementCount() != _vertexCount) {
+	else if (!instanced && buffer->GetElementCount() != _vertexCount) {
 		LOG_WARN("Buffer element count does not match vertex count of this VAO!!!");
 	}
 
@@ -77,7 +77,14 @@ void VertexArrayObject::ReplaceVertexBuffer(VertexBufferBinding* binding, const
 	});
 
 	if (it != _vertexBuffers.end()) {
-		if (buffer->GetElementCount() != _vertexCount) {
+		// Replacing the first buffer re-defines our vertex count (ex: a buffer that has been resized)
+		if (it == _vertexBuffers.begin()) {
+			_vertexCount = buffer->GetElementCount();
+			if (_indexBuffer == nullptr) {
+				_elementCount = _vertexCount;
+			}
+		}
+		else if (!binding->Instanced && buffer->GetElementCount() != _vertexCount) {
 			LOG_WARN("Buffer element count does not match vertex count of this VAO!!!");
 		}
 
@@ -32,8 +32,15 @@ std::string FileHelpers::ReadFile(const std::string& filename) {
 }
 
 std::string FileHelpers::ReadResolveIncludes(const std::string& filename, std::vector<std::string> resolvedPaths) {
+	std::unordered_set<std::string> resolved(resolvedPaths.begin(), resolvedPaths.end());
+	std::string result;
+	_ResolveIncludes(filename, resolved, result);
+	return result;
+}
+
+void FileHelpers::_ResolveIncludes(const std::string& filename, std::unordered_set<std::string>& resolvedPaths, std::string& output) {
 	// Read the entire file contents for processing
-	std::string result = ReadFile(filename);
+	const std::string source = ReadFile(filename);
 	// Determine where the file we just read resides on the filesystem
 	const std::filesystem::path folder = std::filesystem::path(filename).parent_path();
 
@@ -41,19 +48,28 @@ std::string FileHelpers::ReadResolveIncludes(const std::string& filename, std::v
 	const char* includeToken = "#include";
 	const size_t includeTokenLen = const_strlen(includeToken);
 
+	// Rather than splicing includes into the source (which copies the rest of the file every time),
+	// we copy the text between include directives straight into the output
+	output.reserve(output.size() + source.size());
+	size_t copyFrom = 0;
+
 	// Look for the token in the file
-	size_t seek = result.find(includeToken, 0); 
+	size_t seek = source.find(includeToken, 0); 
 	// If we found it, there's work to do!
 	while (seek != std::string::npos) {
 		// Find the end of the line
-		size_t eol = result.find_first_of("\r\n", seek);
+		size_t eol = source.find_first_of("\r\n", seek);
 		if (eol == std::string::npos) {
-			eol = result.size();
+			eol = source.size();
 		}
 
+		// Copy everything up to the directive, the directive line itself is replaced
+		output.append(source, copyFrom, seek - copyFrom);
+		copyFrom = eol;
+
 		// Calculate the area from end of token to end of line, snip out as the path
 		size_t begin = seek + includeTokenLen + 1;
-		std::string path = result.substr(begin, eol - begin);
+		std::string path = source.substr(begin, eol - begin);
 
 		// Trim whitespace and any quotes 
 		StringTools::Trim(path);
@@ -73,28 +89,20 @@ std::string FileHelpers::ReadResolveIncludes(const std::string& filename, std::v
 		target = target.lexically_normal();
 		target = std::filesystem::relative(target);
 
-		// If we haven't included the file yet, include it now
-		if (std::find(resolvedPaths.begin(), resolvedPaths.end(), target.string()) == resolvedPaths.end()) {
-
+		// If we haven't included the file yet, include it now. We mark it as included before
+		// recursing so that circular includes terminate
+		if (resolvedPaths.insert(target.string()).second) {
 			// Make sure file exists, then load and resolve it's includes
 			LOG_ASSERT(std::filesystem::exists(target), "File does not exist");
-			std::string replacement = FileHelpers::ReadResolveIncludes(target.string(), resolvedPaths);
-
-			// Inject result into our string
-			result.replace(seek, eol - seek, replacement);
-			// Look for more includes!
-			seek = result.find(includeToken, seek + replacement.length());
-
-			resolvedPaths.push_back(target.string());
-		}
-		// File already included, remove the line and continue seeking
-		else {
-			result.replace(seek, eol - seek, "");
-			seek = result.find(includeToken, eol);
+			_ResolveIncludes(target.string(), resolvedPaths, output);
 		}
+
+		// Look for more includes!
+		seek = source.find(includeToken, eol);
 	}
 
-	return result;
+	// Copy whatever is left after the last include
+	output.append(source, copyFrom, std::string::npos);
 }
 
 void FileHelpers::WriteContentsToFile(const std::string& filename, const std::string& contents, bool append /*= false*/) {
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_set>
 
 class FileHelpers {
 public:
@@ -29,4 +30,14 @@ public:
 	/// <param name="contents">The contents of the file to write</param>
 	/// <param name="append">True if contents should be appended to end of existing files</param>
 	static void WriteContentsToFile(const std::string& filename, const std::string& contents, bool append = false);
+
+protected:
+	/// <summary>
+	/// Appends the contents of a file to the output, recursively expanding any includes in place
+	/// Each file is only ever included once, even if it is included from several other files
+	/// </summary>
+	/// <param name="filename">The path of the file to load</param>
+	/// <param name="resolvedPaths">The set of paths that have already been included</param>
+	/// <param name="output">The string to append the resolved contents to</param>
+	static void _ResolveIncludes(const std::string& filename, std::unordered_set<std::string>& resolvedPaths, std::string& output);
 };
\ No newline at end of file
@@ -31,6 +31,8 @@
 #include <string_view>
 #include <utility>
 #include <iomanip>
+#include <cstring>
+#include <cstdint>
 
 #ifdef GUID_CEREAL_ARCHIVES
 #include <cereal/cereal.hpp>
@@ -156,14 +158,27 @@ namespace details {
 
 namespace std {
 	// Specialization for std::hash<Guid> 
-	// Uses the underlying byte field and hashes the values together as a pair of
-	// 8 byte integers
+	// Uses the underlying byte field as a pair of 8 byte integers, and mixes all 128 bits
+	// together. Some standard libraries use identity hashes for integers, so we can't rely
+	// on std::hash<uint64_t> to spread the bits for us
 	template <>
 	struct hash<Guid>
 	{
 		std::size_t operator()(Guid const& guid) const {
-			const uint64_t* p = reinterpret_cast<const uint64_t*>(guid.bytes());
-			return details::hash<uint64_t, uint64_t>{}(p[0], p[1]);
+			uint64_t p[2];
+			memcpy(p, guid.bytes(), 16);
+			return static_cast<std::size_t>(_Mix(p[0] ^ _Mix(p[1] + 0x9e3779b97f4a7c15ull)));
+		}
+
+	private:
+		// Finalizer from MurmurHash3, every input bit affects every output bit
+		static inline uint64_t _Mix(uint64_t value) {
+			value ^= value >> 33;
+			value *= 0xff51afd7ed558ccdull;
+			value ^= value >> 33;
+			value *= 0xc4ceb9fe1a85ec53ull;
+			value ^= value >> 33;
+			return value;
 		}
 	};
 }
\ No newline at end of file
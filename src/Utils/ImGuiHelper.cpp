@@ -95,7 +95,11 @@ void ImGuiHelper::Init(GLFWwindow* window) {
 		"   Out_Color = vec4(depth, depth, depth, 1.0);\n"
 		"}\n";
 	_linearDepthShader->LoadShaderPart(fs, ShaderPartType::Fragment);
-	_linearDepthShader->Link();
+	// Compile errors only show up when linking, without the shader we fall back to drawing depth as-is
+	if (!_linearDepthShader->Link()) {
+		LOG_WARN("Failed to build the linear depth shader, depth textures will not be linearized");
+		_linearDepthShader = nullptr;
+	}
 }
 
 void ImGuiHelper::Cleanup() {
@@ -170,6 +174,11 @@ void ImGuiHelper::DrawLinearDepthTexture(const Texture2D::Sptr& image, const glm
 		ImVec2 dispSize;
 	};
 
+	if (_linearDepthShader == nullptr) {
+		ImGui::Image((ImTextureID)image->GetHandle(), ImVec2(size.x, size.y), ImVec2(0, 1), ImVec2(1, 0));
+		return;
+	}
+
 	ImDrawList* drawList = ImGui::GetWindowDrawList();
 
 	Data* temp = new Data();
@@ -231,7 +240,9 @@ void ImGuiHelper::EndFrame() {
 		{ 0.0f,             0.0f,                -1.0f,   0.0f },
 		{ (R + L) / (L - R),  (T + B) / (B - T),  0.0f,   1.0f },
 	};
-	glProgramUniformMatrix4fv(_linearDepthShader->GetHandle(), 0, 1, GL_FALSE, &ortho_projection[0][0]);
+	if (_linearDepthShader != nullptr) {
+		glProgramUniformMatrix4fv(_linearDepthShader->GetHandle(), 0, 1, GL_FALSE, &ortho_projection[0][0]);
+	}
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
 	// If we have multiple viewports enabled (can drag into a new window)
@@ -0,0 +1,108 @@
+#include "Utils/MemoryMappedFile.h"
+#include <Logging.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MemoryMappedFile::MemoryMappedFile() :
+	_data(nullptr),
+	_size(0),
+	#ifdef _WIN32
+	_fileHandle(INVALID_HANDLE_VALUE),
+	_mappingHandle(nullptr)
+	#else
+	_fileHandle(-1)
+	#endif
+{ }
+
+MemoryMappedFile::~MemoryMappedFile() {
+	Close();
+}
+
+bool MemoryMappedFile::Open(const std::string& filename) {
+	Close();
+
+	#ifdef _WIN32
+	_fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (_fileHandle == INVALID_HANDLE_VALUE) {
+		LOG_ERROR("Could not open file '{}'", filename);
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(_fileHandle, &size) || size.QuadPart == 0) {
+		LOG_ERROR("Could not map empty file '{}'", filename);
+		Close();
+		return false;
+	}
+	_size = static_cast<size_t>(size.QuadPart);
+
+	_mappingHandle = CreateFileMappingA(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (_mappingHandle == nullptr) {
+		LOG_ERROR("Could not map file '{}'", filename);
+		Close();
+		return false;
+	}
+
+	_data = static_cast<const uint8_t*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	#else
+	_fileHandle = open(filename.c_str(), O_RDONLY);
+	if (_fileHandle == -1) {
+		LOG_ERROR("Could not open file '{}'", filename);
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(_fileHandle, &info) != 0 || info.st_size == 0) {
+		LOG_ERROR("Could not map empty file '{}'", filename);
+		Close();
+		return false;
+	}
+	_size = static_cast<size_t>(info.st_size);
+
+	void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fileHandle, 0);
+	_data = data == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(data);
+	#endif
+
+	if (_data == nullptr) {
+		LOG_ERROR("Could not map file '{}'", filename);
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MemoryMappedFile::Close() {
+	#ifdef _WIN32
+	if (_data != nullptr) {
+		UnmapViewOfFile(_data);
+	}
+	if (_mappingHandle != nullptr) {
+		CloseHandle(_mappingHandle);
+		_mappingHandle = nullptr;
+	}
+	if (_fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(_fileHandle);
+		_fileHandle = INVALID_HANDLE_VALUE;
+	}
+	#else
+	if (_data != nullptr) {
+		munmap(const_cast<uint8_t*>(_data), _size);
+	}
+	if (_fileHandle != -1) {
+		close(_fileHandle);
+		_fileHandle = -1;
+	}
+	#endif
+
+	_data = nullptr;
+	_size = 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "Utils/Macros.h"
+
+/// <summary>
+/// Maps a file into memory for read-only access, letting the OS page the
+/// contents in on demand instead of copying the whole file into a buffer
+/// The mapping is released when this object is destroyed
+/// </summary>
+class MemoryMappedFile {
+public:
+	NO_COPY(MemoryMappedFile);
+	NO_MOVE(MemoryMappedFile);
+
+	MemoryMappedFile();
+	~MemoryMappedFile();
+
+	/// <summary>
+	/// Maps the given file into memory, closing any previously opened file
+	/// </summary>
+	/// <param name="filename">The path of the file to map</param>
+	/// <returns>True if the file was mapped, false if otherwise</returns>
+	bool Open(const std::string& filename);
+	/// <summary>
+	/// Unmaps the file, any pointers returned by GetData will be invalidated
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// Returns true if a file is currently mapped
+	/// </summary>
+	bool IsOpen() const { return _data != nullptr; }
+	/// <summary>
+	/// Gets a pointer to the start of the mapped file contents
+	/// </summary>
+	const uint8_t* GetData() const { return _data; }
+	/// <summary>
+	/// Gets the size of the mapped file in bytes
+	/// </summary>
+	size_t GetSize() const { return _size; }
+
+protected:
+	const uint8_t* _data;
+	size_t         _size;
+
+	#ifdef _WIN32
+	void* _fileHandle;
+	void* _mappingHandle;
+	#else
+	int   _fileHandle;
+	#endif
+};
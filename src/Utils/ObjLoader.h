@@ -18,6 +18,17 @@ public:
 	template <typename VertexType = VertexPosNormTexColTangents>
 	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename, bool calcTangents = true);
 
+	/// <summary>
+	/// Loads an OBJ file into a mesh builder without creating any OpenGL objects, so this
+	/// is safe to invoke from a worker thread. Use Bake on the result to get a VAO
+	/// </summary>
+	/// <typeparam name="VertexType">The type of vertex to load into</typeparam>
+	/// <param name="filename">The path to the OBJ file to load</param>
+	/// <param name="calcTangents">True if tangents and bitangents should be calculated</param>
+	/// <returns>A mesh builder containing the vertices and indices from the file</returns>
+	template <typename VertexType = VertexPosNormTexColTangents>
+	static MeshBuilder<VertexType> LoadMeshData(const std::string& filename, bool calcTangents = true);
+
 protected:
 	ObjLoader() = default;
 	~ObjLoader() = default;
@@ -26,6 +37,12 @@ protected:
 
 template <typename VertexType>
 VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename, bool calcTangents) {
+	// Move our data into a VAO and return it
+	return LoadMeshData<VertexType>(filename, calcTangents).Bake();
+}
+
+template <typename VertexType>
+MeshBuilder<VertexType> ObjLoader::LoadMeshData(const std::string& filename, bool calcTangents) {
 	// Open our file in binary mode
 	std::ifstream file;
 	file.open(filename, std::ios::binary);
@@ -187,6 +204,5 @@ VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename, boo
 	float endTime = static_cast<float>(glfwGetTime());
 	LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, mesh.GetVertexCount(), mesh.GetIndexCount());
 
-	// Move our data into a VAO and return it
-	return mesh.Bake();
+	return mesh;
 }
\ No newline at end of file
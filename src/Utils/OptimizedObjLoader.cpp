@@ -18,6 +18,14 @@ const std::string binaryExtension = ".bin";
 namespace fs = std::filesystem;
 
 VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& filename) {
+	BinaryMeshData data;
+	if (!LoadBinaryData(filename, data)) {
+		return nullptr;
+	}
+	return Bake(data);
+}
+
+bool OptimizedObjLoader::LoadBinaryData(const std::string& filename, BinaryMeshData& result) {
 	// Get the file extension and lowercase it
 	fs::path filePath = std::filesystem::path(filename);
 	std::string extension = filePath.extension().string();
@@ -32,19 +40,45 @@ VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& file
 			ConvertToBinary(filename, binPath.string());
 		}
 		// Load the corresponding binary file
-		return _LoadFromBinFile(binPath.string());
+		return _LoadFromBinFile(binPath.string(), result);
 	} 
 	// Load our fancy binary files
 	else if (extension == ".bin") {
-		return _LoadFromBinFile(filename);
+		return _LoadFromBinFile(filename, result);
 	}
 	// We've never met this extension in our life
 	else {
 		LOG_WARN("Cannot load model from \"{}\"", filename);
-		return nullptr;
+		return false;
 	}
 }
 
+VertexArrayObject::Sptr OptimizedObjLoader::Bake(const BinaryMeshData& data) {
+	// These will have the buffer pointers
+	IndexBuffer::Sptr indices = nullptr;
+	VertexBuffer::Sptr vertices = nullptr;
+
+	// If we have index data, load it
+	if (data.NumIndices > 0) {
+		indices = IndexBuffer::Create(BufferUsage::StaticDraw);
+		indices->LoadData(data.Indices.data(), GetIndexTypeSize(data.IndicesType), data.NumIndices, data.IndicesType);
+	}
+
+	// Create a new VBO and load data into OpenGL
+	vertices = VertexBuffer::Create(BufferUsage::StaticDraw);
+	vertices->LoadData(data.Vertices.data(), data.VertexStride, data.NumVertices);
+
+	// Create the VAO and attach our index and vertex buffers
+	VertexArrayObject::Sptr result = VertexArrayObject::Create();
+	result->SetIndexBuffer(indices);
+	result->AddVertexBuffer(vertices, data.VertexDeclaration);
+
+	// Copy in the vertex declaration we loaded
+	result->SetVDecl(data.VertexDeclaration);
+
+	return result;
+}
+
 void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::string& outFile) {
 	// Load in the input file
 	MeshBuilder<VertexPosNormTexColTangents>* mesh = _LoadFromObjFile(inFile);
@@ -233,7 +267,7 @@ MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(c
 	return mesh;
 }
 
-VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string& filename) {
+bool OptimizedObjLoader::_LoadFromBinFile(const std::string& filename, BinaryMeshData& result) {
 
 	// Open the output file
 	std::ifstream file(filename, std::ios::binary);
@@ -253,7 +287,7 @@ VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string&
 		file.read(reinterpret_cast<char*>(&header), sizeof(BinaryHeader));
 	} else {
 		LOG_ERROR("Not enough data in the file!");
-		return nullptr;
+		return false;
 	}
 
 	// TODO: validate header
@@ -270,59 +304,35 @@ VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string&
 		// Make sure there's enough data in the file
 		if (size < requiredBytes) {
 			LOG_ERROR("Not enough data in the file!");
-			return nullptr;
+			return false;
 		}
 
 		// Read all attributes from the file, this is basically our VDECL
-		std::vector<BufferAttribute> vertexDeclaration;
-		vertexDeclaration.resize(header.NumAttributes);
+		result.VertexDeclaration.resize(header.NumAttributes);
 		for (int ix = 0; ix < header.NumAttributes; ix++) {
-			file.read(reinterpret_cast<char*>(&vertexDeclaration[ix]), sizeof(BufferAttribute));
+			file.read(reinterpret_cast<char*>(&result.VertexDeclaration[ix]), sizeof(BufferAttribute));
 		}
 
-		// These will have the buffer pointers
-		IndexBuffer::Sptr indices = nullptr;
-		VertexBuffer::Sptr vertices = nullptr;
-
-		// If we have index data, load it
+		// If we have index data, read it into CPU memory
+		result.IndicesType = header.IndicesType;
+		result.NumIndices  = header.NumIndices;
 		if (header.NumIndices > 0) {
-			// Create index buffer
-			indices = IndexBuffer::Create(BufferUsage::StaticDraw);
-
-			// Create memory to store indices, then read from the file
-			void* dataStore = malloc(header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			file.read(reinterpret_cast<char*>(dataStore), header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			
-			// Load data into OpenGL and free the CPU memory we allocated
-			indices->LoadData(dataStore, GetIndexTypeSize(header.IndicesType), header.NumIndices, header.IndicesType);
-			free(dataStore);
+			result.Indices.resize(header.NumIndices * GetIndexTypeSize(header.IndicesType));
+			file.read(reinterpret_cast<char*>(result.Indices.data()), result.Indices.size());
 		}
 
-		// Create a new VBO
-		vertices = VertexBuffer::Create(BufferUsage::StaticDraw);
-
-		// Create memory to store vertices and load from file
-		void* vertexStore = malloc(header.NumVertices * (size_t)header.VertexStride);
-		file.read(reinterpret_cast<char*>(vertexStore), header.NumVertices * (size_t)header.VertexStride);
-
-		// Load data into OpenGL and free the CPU copy
-		vertices->LoadData(vertexStore, header.VertexStride, header.NumVertices);
-		free(vertexStore);
-
-		// Create the VAO and attach our index and vertex buffers
-		VertexArrayObject::Sptr result = VertexArrayObject::Create();
-		result->SetIndexBuffer(indices);
-		result->AddVertexBuffer(vertices, vertexDeclaration);
-
-		// Copy in the vertex declaration we loaded
-		result->SetVDecl(vertexDeclaration);
+		// Read our vertices into CPU memory
+		result.VertexStride = header.VertexStride;
+		result.NumVertices  = header.NumVertices;
+		result.Vertices.resize(header.NumVertices * (size_t)header.VertexStride);
+		file.read(reinterpret_cast<char*>(result.Vertices.data()), result.Vertices.size());
 
 		// Calculate and trace out how long it took us to load
 		float endTime = static_cast<float>(glfwGetTime());
 		LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, header.NumVertices, header.NumIndices);
 
-		return result;
+		return true;
 	}
 
-	return nullptr;
+	return false;
 }
@@ -19,6 +19,20 @@
 /// </summary>
 class OptimizedObjLoader {
 public:
+	/// <summary>
+	/// The contents of a binary mesh file that have been read into CPU memory, but have not
+	/// yet been uploaded to OpenGL
+	/// </summary>
+	struct BinaryMeshData {
+		std::vector<BufferAttribute> VertexDeclaration;
+		IndexType                    IndicesType = IndexType::Unknown;
+		uint32_t                     NumIndices = 0;
+		std::vector<uint8_t>         Indices;
+		uint16_t                     VertexStride = 0;
+		uint32_t                     NumVertices = 0;
+		std::vector<uint8_t>         Vertices;
+	};
+
 	/// <summary>
 	/// Loads a VAO from an OBJ file. On the first time this is called for an OBJ file, will convert the OBJ file 
 	/// to a binary file and load that instead. On subsequent runs, the binary file will be loaded instead
@@ -27,6 +41,20 @@ public:
 	/// <returns>A VAO loaded from disk</returns>
 	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename);
 	/// <summary>
+	/// Reads the binary mesh data for an OBJ or bin file into CPU memory, converting the OBJ file if required.
+	/// Does not touch OpenGL, so this is safe to invoke from a worker thread
+	/// </summary>
+	/// <param name="filename">The path to the .obj or .bin file to load</param>
+	/// <param name="result">The structure to read the mesh data into</param>
+	/// <returns>True if the data was loaded, false if otherwise</returns>
+	static bool LoadBinaryData(const std::string& filename, BinaryMeshData& result);
+	/// <summary>
+	/// Creates a VAO from mesh data that was loaded via LoadBinaryData, must be called on the main thread
+	/// </summary>
+	/// <param name="data">The mesh data to upload</param>
+	/// <returns>A VAO containing the mesh data</returns>
+	static VertexArrayObject::Sptr Bake(const BinaryMeshData& data);
+	/// <summary>
 	/// Manually converts an OBJ file into a binary mesh file
 	/// </summary>
 	/// <param name="inFile">The path to OBJ file to convert</param>
@@ -65,7 +93,7 @@ protected:
 	~OptimizedObjLoader() = default;
 
 	static MeshBuilder<VertexPosNormTexColTangents>* _LoadFromObjFile(const std::string& filename);
-	static VertexArrayObject::Sptr _LoadFromBinFile(const std::string& filename);
+	static bool _LoadFromBinFile(const std::string& filename, BinaryMeshData& result);
 };
 
 template <typename VertexType>
@@ -1,9 +1,20 @@
 #pragma once
 #include "Utils/GUID.hpp"
 #include "json.hpp"
+#include <EnumToString.h>
 
 #include "Utils/TypeHelpers.h"
 
+/// <summary>
+/// Tracks where a resource is in it's loading lifecycle. Resources that are
+/// streamed in asynchronously will be Pending until their data has been uploaded
+/// </summary>
+ENUM(ResourceLoadState, uint8_t,
+	Ready   = 0,
+	Pending = 1,
+	Failed  = 2
+);
+
 /// <summary>
 /// Base class for graphics that the resource manager may want to manage
 /// (ex: textures, models, shaders, materials, etc...)
@@ -31,6 +42,16 @@ public:
 	/// <param name="newValue">The new GUID for the object</param>
 	void OverrideGUID(Guid newValue) { _guid = newValue; }
 
+	/// <summary>
+	/// Gets the loading state of this resource, resources that are not Ready should
+	/// be substituted with a placeholder when rendering
+	/// </summary>
+	ResourceLoadState GetLoadState() const { return _loadState; }
+	/// <summary>
+	/// Returns true if this resource has finished loading
+	/// </summary>
+	bool IsReady() const { return _loadState == ResourceLoadState::Ready; }
+
 	virtual void ResolveReferences() {};
 
 	/// <summary>
@@ -42,8 +63,13 @@ public:
 	virtual nlohmann::json ToJson() const = 0;
 
 protected:
+	// The resource manager drives the load state for async loads
+	friend class ResourceManager;
+
 	Guid _guid;
-	IResource() : _guid(Guid::New()){}
+	// Only ever modified on the main thread
+	ResourceLoadState _loadState;
+	IResource() : _guid(Guid::New()), _loadState(ResourceLoadState::Ready) {}
 };
 
 /// <summary>
@@ -1,14 +1,34 @@
 #include "Utils/ResourceManager/ResourceManager.h"
 
+#include <GLFW/glfw3.h>
+#include <Logging.h>
+#include <limits>
+#include <algorithm>
+
 #include "Utils/ObjLoader.h"
 #include "Utils/FileHelpers.h"
 #include "Utils/StringUtils.h"
+#include "Utils/ThreadPool.h"
 
-std::map<std::type_index, std::map<Guid, IResource::Sptr>> ResourceManager::_resources;
+std::unordered_map<std::type_index, std::unordered_map<Guid, IResource::Sptr>> ResourceManager::_resources;
 std::map<std::string, std::function<Guid(const nlohmann::json&)>> ResourceManager::_typeLoaders;
 
+std::map<std::string, std::type_index> ResourceManager::_typeIndices;
+
 nlohmann::ordered_json ResourceManager::_manifest;
 
+std::map<Guid, ResourceManager::LoadTiming> ResourceManager::_loadTimings;
+std::vector<Guid>                            ResourceManager::_preloadedAssets;
+double                                       ResourceManager::_preloadStartTime = 0.0;
+
+bool                                   ResourceManager::_asyncEnabled = false;
+std::deque<ResourceManager::AsyncLoad> ResourceManager::_waitingLoads;
+std::deque<ResourceManager::AsyncLoad> ResourceManager::_decodedLoads;
+std::mutex                             ResourceManager::_decodedLoadsMutex;
+uint32_t                               ResourceManager::_loadsInFlight = 0;
+uint32_t                               ResourceManager::_batchQueued = 0;
+uint32_t                               ResourceManager::_batchCompleted = 0;
+
 void ResourceManager::Init() {
 	// TODO: initialize the resource manager once it's a bit more complex
 	//_manifest["textures"]  = std::vector<nlohmann::json>();
@@ -21,23 +41,168 @@ const nlohmann::ordered_json& ResourceManager::GetManifest() {
 	return _manifest;
 }
 
-void ResourceManager::LoadManifest(const std::string& path, bool preloadAssets) {
+void ResourceManager::LoadManifest(const std::string& path, bool preloadAssets, bool waitForPreload) {
 	std::string contents = FileHelpers::ReadFile(path);
 	nlohmann::ordered_json blob = nlohmann::ordered_json::parse(contents);
 	_manifest = blob;
 
 	if (preloadAssets) {
-		for (auto& [typeName, items] : blob.items()) {
-			auto& func = _typeLoaders[typeName];
-			if (func) {
-				for (auto& [guid, blob] : items.items()) {
-					func(blob);
+		_PreloadManifest(waitForPreload);
+	}
+}
+
+const std::map<Guid, ResourceManager::LoadTiming>& ResourceManager::GetLoadTimings() {
+	return _loadTimings;
+}
+
+void ResourceManager::_PreloadManifest(bool wait) {
+	// Represents a single asset in the manifest, and the edges to the assets that depend on it
+	struct PreloadNode {
+		std::string           TypeName;
+		nlohmann::json        Blob;
+		std::vector<uint32_t> Dependents;
+		uint32_t              NumDependencies = 0;
+	};
+
+	_preloadStartTime = glfwGetTime();
+	_preloadedAssets.clear();
+
+	// Gather every asset in the manifest that we know how to load
+	std::vector<PreloadNode> nodes;
+	std::unordered_map<std::string, uint32_t> guidLookup;
+	for (auto& [typeName, items] : _manifest.items()) {
+		auto it = _typeLoaders.find(typeName);
+		if (it == _typeLoaders.end() || !it->second || !items.is_object()) {
+			continue;
+		}
+		for (auto& [guid, blob] : items.items()) {
+			guidLookup[guid] = static_cast<uint32_t>(nodes.size());
+			PreloadNode node;
+			node.TypeName = typeName;
+			node.Blob = blob;
+			nodes.push_back(std::move(node));
+		}
+	}
+
+	// Any string in an asset that matches the GUID of another asset is treated as a dependency
+	// (ex: a material's shader and texture parameters)
+	std::vector<uint32_t> dependencies;
+	for (uint32_t ix = 0; ix < nodes.size(); ix++) {
+		dependencies.clear();
+		_CollectDependencies(nodes[ix].Blob, guidLookup, dependencies);
+
+		// Strip out duplicates and self references (ex: the guid field)
+		std::sort(dependencies.begin(), dependencies.end());
+		dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+		for (uint32_t dependency : dependencies) {
+			if (dependency != ix) {
+				nodes[dependency].Dependents.push_back(ix);
+				nodes[ix].NumDependencies++;
+			}
+		}
+	}
+
+	// Loads a single node, skipping it if it was already pulled in by another asset
+	auto loadNode = [](const PreloadNode& node) {
+		Guid id = Guid(node.Blob["guid"].get<std::string>());
+		auto typeIt = _typeIndices.find(node.TypeName);
+		if (typeIt != _typeIndices.end()) {
+			auto storeIt = _resources.find(typeIt->second);
+			if (storeIt != _resources.end()) {
+				auto it = storeIt->second.find(id);
+				if (it != storeIt->second.end() && it->second != nullptr) {
+					return;
 				}
 			}
 		}
+
+		double startTime = glfwGetTime();
+		_typeLoaders[node.TypeName](node.Blob);
+
+		LoadTiming& timing = _loadTimings[id];
+		timing.TypeName = node.TypeName;
+		timing.CreateMs = static_cast<float>((glfwGetTime() - startTime) * 1000.0);
+		_preloadedAssets.push_back(id);
+	};
+
+	// Topological sort, leaves (textures, meshes, shaders) are created first so their decodes can
+	// start on the worker threads, anything that depends on them is created once they exist
+	std::deque<uint32_t> ready;
+	for (uint32_t ix = 0; ix < nodes.size(); ix++) {
+		if (nodes[ix].NumDependencies == 0) {
+			ready.push_back(ix);
+		}
+	}
+	uint32_t numLoaded = 0;
+	while (!ready.empty()) {
+		uint32_t ix = ready.front();
+		ready.pop_front();
+
+		loadNode(nodes[ix]);
+		numLoaded++;
+
+		for (uint32_t dependent : nodes[ix].Dependents) {
+			if (--nodes[dependent].NumDependencies == 0) {
+				ready.push_back(dependent);
+			}
+		}
+	}
+
+	// Anything left is part of a dependency cycle, load in manifest order and let Get resolve them
+	if (numLoaded < nodes.size()) {
+		LOG_WARN("Manifest contains a dependency cycle, {} assets will be loaded in manifest order", nodes.size() - numLoaded);
+		for (const PreloadNode& node : nodes) {
+			if (node.NumDependencies > 0) {
+				loadNode(node);
+			}
+		}
+	}
+
+	if (wait) {
+		FlushAsyncLoads();
+	}
+
+	// If nothing is streaming, we can report right away, otherwise we'll report when the uploads finish
+	if (GetPendingLoadCount() == 0) {
+		_ReportPreloadTimings();
 	}
 }
 
+void ResourceManager::_CollectDependencies(const nlohmann::json& blob, const std::unordered_map<std::string, uint32_t>& guidLookup, std::vector<uint32_t>& result) {
+	if (blob.is_string()) {
+		auto it = guidLookup.find(blob.get<std::string>());
+		if (it != guidLookup.end()) {
+			result.push_back(it->second);
+		}
+	}
+	else if (blob.is_structured()) {
+		for (const auto& child : blob) {
+			_CollectDependencies(child, guidLookup, result);
+		}
+	}
+}
+
+void ResourceManager::_ReportPreloadTimings() {
+	if (_preloadedAssets.empty()) {
+		return;
+	}
+
+	// Sort so that the slowest assets are first
+	std::sort(_preloadedAssets.begin(), _preloadedAssets.end(), [](const Guid& a, const Guid& b) {
+		return _loadTimings[a].TotalMs() > _loadTimings[b].TotalMs();
+	});
+
+	LOG_INFO("Preloaded {} assets in {} seconds", _preloadedAssets.size(), glfwGetTime() - _preloadStartTime);
+	const size_t numToReport = std::min<size_t>(_preloadedAssets.size(), 10);
+	for (size_t ix = 0; ix < numToReport; ix++) {
+		const LoadTiming& timing = _loadTimings[_preloadedAssets[ix]];
+		LOG_INFO("\t{:>8.2f}ms {} {} (create: {:.2f}ms, decode: {:.2f}ms, upload: {:.2f}ms)",
+			timing.TotalMs(), timing.TypeName, _preloadedAssets[ix].str(), timing.CreateMs, timing.DecodeMs, timing.UploadMs);
+	}
+
+	_preloadedAssets.clear();
+}
+
 void ResourceManager::SaveManifest(const std::string& path) {
 	// Update all resources in the manifest so they match their current representation
 	for (auto& [type, map] : _resources) {
@@ -58,3 +223,150 @@ void ResourceManager::Cleanup() {
 	}
 }
 
+
+void ResourceManager::SetAsyncLoadingEnabled(bool value) {
+	_asyncEnabled = value;
+}
+
+bool ResourceManager::IsAsyncLoadingEnabled() {
+	return _asyncEnabled;
+}
+
+void ResourceManager::QueueAsyncLoad(const IResource::Sptr& resource, const std::function<bool()>& decode, const std::function<bool()>& upload) {
+	// If this is the first load since we went idle, start a new batch for progress reporting
+	if (GetPendingLoadCount() == 0) {
+		_batchQueued = 0;
+		_batchCompleted = 0;
+	}
+
+	resource->_loadState = ResourceLoadState::Pending;
+
+	AsyncLoad load;
+	load.Resource = resource;
+	load.Decode = decode;
+	load.Upload = upload;
+	_waitingLoads.push_back(std::move(load));
+	_batchQueued++;
+
+	_SubmitWaitingLoads();
+}
+
+void ResourceManager::ProcessUploads(float budgetMs) {
+	double startTime = glfwGetTime();
+	double budgetSeconds = budgetMs / 1000.0;
+
+	do {
+		// Grab the next decoded load, making sure we don't hold the lock while uploading
+		AsyncLoad load;
+		{
+			std::lock_guard<std::mutex> lock(_decodedLoadsMutex);
+			if (_decodedLoads.empty()) {
+				break;
+			}
+			load = std::move(_decodedLoads.front());
+			_decodedLoads.pop_front();
+		}
+
+		_CompleteLoad(load, true);
+	} while ((glfwGetTime() - startTime) < budgetSeconds);
+
+	// Uploads free up slots for more decodes
+	_SubmitWaitingLoads();
+
+	// If a manifest preload just finished streaming in, let the user know how long it took
+	if (!_preloadedAssets.empty() && GetPendingLoadCount() == 0) {
+		_ReportPreloadTimings();
+	}
+}
+
+void ResourceManager::FlushAsyncLoads(bool discard) {
+	// Drop anything that has not been handed to a worker yet
+	if (discard) {
+		for (auto& load : _waitingLoads) {
+			_CompleteLoad(load, false);
+		}
+		_waitingLoads.clear();
+	}
+
+	while (GetPendingLoadCount() > 0) {
+		if (discard) {
+			std::deque<AsyncLoad> decoded;
+			{
+				std::lock_guard<std::mutex> lock(_decodedLoadsMutex);
+				decoded.swap(_decodedLoads);
+			}
+			for (auto& load : decoded) {
+				_CompleteLoad(load, false);
+			}
+		} else {
+			ProcessUploads(std::numeric_limits<float>::max());
+		}
+
+		// Give the workers some time to finish up
+		if (GetPendingLoadCount() > 0) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+uint32_t ResourceManager::GetPendingLoadCount() {
+	return _loadsInFlight + static_cast<uint32_t>(_waitingLoads.size());
+}
+
+float ResourceManager::GetLoadProgress() {
+	if (_batchQueued == 0 || GetPendingLoadCount() == 0) {
+		return 1.0f;
+	}
+	return static_cast<float>(_batchCompleted) / static_cast<float>(_batchQueued);
+}
+
+void ResourceManager::_SubmitWaitingLoads() {
+	while (!_waitingLoads.empty() && _loadsInFlight < MAX_LOADS_IN_FLIGHT) {
+		std::shared_ptr<AsyncLoad> load = std::make_shared<AsyncLoad>(std::move(_waitingLoads.front()));
+		_waitingLoads.pop_front();
+		load->Submitted = true;
+		_loadsInFlight++;
+
+		ThreadPool::Enqueue([load]() {
+			// Loaders like the OBJ loader report failure by throwing, we don't want that to take down a worker
+			double startTime = glfwGetTime();
+			try {
+				load->DecodeSucceeded = load->Decode();
+			}
+			catch (std::exception& e) {
+				LOG_WARN("Failed to decode resource: {}", e.what());
+				load->DecodeSucceeded = false;
+			}
+			load->DecodeSeconds = glfwGetTime() - startTime;
+
+			std::lock_guard<std::mutex> lock(_decodedLoadsMutex);
+			_decodedLoads.push_back(std::move(*load));
+		});
+	}
+}
+
+void ResourceManager::_CompleteLoad(AsyncLoad& load, bool upload) {
+	bool success = false;
+	if (upload && load.DecodeSucceeded) {
+		double startTime = glfwGetTime();
+		success = load.Upload();
+
+		LoadTiming& timing = _loadTimings[load.Resource->GetGUID()];
+		if (timing.TypeName.empty()) {
+			timing.TypeName = StringTools::SanitizeClassName(typeid(*load.Resource).name());
+		}
+		timing.DecodeMs = static_cast<float>(load.DecodeSeconds * 1000.0);
+		timing.UploadMs = static_cast<float>((glfwGetTime() - startTime) * 1000.0);
+	}
+	load.Resource->_loadState = success ? ResourceLoadState::Ready : ResourceLoadState::Failed;
+	if (upload && !success) {
+		LOG_WARN("Async load failed for resource {}", load.Resource->GetGUID().str());
+	}
+
+	// Loads that were never handed to a worker are not counted as in flight
+	if (load.Submitted) {
+		_loadsInFlight--;
+	}
+
+	_batchCompleted++;
+}
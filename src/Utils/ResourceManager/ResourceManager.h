@@ -3,6 +3,9 @@
 #include <json.hpp>
 #include <unordered_map>
 #include <typeindex>
+#include <functional>
+#include <deque>
+#include <mutex>
 
 #include "Utils/GUID.hpp"
 #include "Utils/ResourceManager/IResource.h"
@@ -53,21 +56,28 @@ public:
 	/// <returns>The resource with the given GUID, or nullptr if none exists</returns>
 	template<typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static std::shared_ptr<T> Get(Guid id) {
-		// Try and grab the asset from the resource pool
-		std::shared_ptr<T> result =  std::dynamic_pointer_cast<T>(_resources[std::type_index(typeid(T))][id]);
+		// Null references are common in scene files, no need to search for them
+		if (!id.isValid()) {
+			return nullptr;
+		}
+
+		// Try and grab the asset from the resource pool, we use find so that misses don't insert null entries
+		std::shared_ptr<T> result = _Find<T>(id);
 
 		// If the asset is null, we can try finding it in the manifest to load it
 		if (result == nullptr) {
 			// Get the type name it'll be stored under
-			std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
+			static const std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
 
 			// If the manifest has an entry, we can load it!
-			if (_manifest[typeName].contains(id)) {
+			auto manifestIt = _manifest.find(typeName);
+			std::string key = id.str();
+			if (manifestIt != _manifest.end() && manifestIt->contains(key)) {
 				// Invoke the loader function with the manifest data
-				_typeLoaders[typeName](_manifest[typeName][id]);
+				_typeLoaders[typeName]((*manifestIt)[key]);
 
 				// Search resources again to get the resource
-				return std::dynamic_pointer_cast<T>(_resources[std::type_index(typeid(T))][id]);
+				return _Find<T>(id);
 			}
 		}
 
@@ -86,6 +96,9 @@ public:
 		// Extract the type name from a sanitized version of they typeid name
 		std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
 
+		// Remember which type the name maps to, so we can look up resources by type name
+		_typeIndices.emplace(typeName, std::type_index(typeid(T)));
+
 		// Create the type loader for the type
 		_typeLoaders[typeName] = [](const nlohmann::json& data) {
 			IResource::Sptr res = T::FromJson(data);
@@ -115,8 +128,13 @@ public:
 		// We can use typeid and type_index to get a unique ID for our types
 		std::type_index type = std::type_index(typeid(ResourceType));
 
+		auto storeIt = _resources.find(type);
+		if (storeIt == _resources.end()) {
+			return;
+		}
+
 		// Iterate over all the resources in the store
-		for (auto& [key, value] : _resources[type]) {
+		for (auto& [key, value] : storeIt->second) {
 			// If the pointer is alive and matches our enabled criteria, invoke the callback
 			if (value != nullptr) {
 				// Upcast to resource type and invoke the callback
@@ -132,10 +150,14 @@ public:
 	/// <summary>
 	/// Loads a manifest file into the resource manager. Note that this will not perform load on the assets themselves 
 	/// unless preloadAssets is set to true
+	/// 
+	/// When preloading, assets are loaded in dependency order (ex: shaders and textures before the materials
+	/// that use them), so that independent assets can be decoded in parallel when async loading is enabled
 	/// </summary>
 	/// <param name="path">The path to the JSON manifest file</param>
 	/// <param name="preloadAssets">True if all assets should be loaded into memory</param>
-	static void LoadManifest(const std::string& path, bool preloadAssets = false);
+	/// <param name="waitForPreload">True to block until all preloaded assets are ready, false to let them stream in</param>
+	static void LoadManifest(const std::string& path, bool preloadAssets = false, bool waitForPreload = true);
 	/// <summary>
 	/// Saves the manifest to the given JSON file
 	/// </summary>
@@ -147,21 +169,146 @@ public:
 	/// </summary>
 	static void Cleanup();
 
+	/// <summary>
+	/// Stores how long it took to load a single resource, used to track down slow assets
+	/// </summary>
+	struct LoadTiming {
+		std::string TypeName;
+		// Time spent in the type loader on the main thread (ex: creating objects, compiling shaders)
+		float       CreateMs = 0.0f;
+		// Time spent decoding on a worker thread, 0 for resources that load synchronously
+		float       DecodeMs = 0.0f;
+		// Time spent uploading to the GPU on the main thread
+		float       UploadMs = 0.0f;
+
+		float TotalMs() const { return CreateMs + DecodeMs + UploadMs; }
+	};
+
+	/// <summary>
+	/// Gets the load times for all resources that have been loaded from a manifest or streamed in
+	/// </summary>
+	static const std::map<Guid, LoadTiming>& GetLoadTimings();
+
+	/// <summary>
+	/// Enables or disables asynchronous loading. When enabled, resource types that support it will
+	/// decode their data on the thread pool and upload to the GPU from the main thread
+	/// </summary>
+	static void SetAsyncLoadingEnabled(bool value);
+	/// <summary>
+	/// Returns true if resources loaded from the manifest should be streamed in asynchronously
+	/// </summary>
+	static bool IsAsyncLoadingEnabled();
+
+	/// <summary>
+	/// Queues an asynchronous load for a resource. The resource will be marked as Pending until
+	/// the load completes, at which point it will be either Ready or Failed
+	/// </summary>
+	/// <param name="resource">The resource that is being loaded</param>
+	/// <param name="decode">Invoked on a worker thread, should perform all file IO and decoding, and return false on failure. Must not touch OpenGL</param>
+	/// <param name="upload">Invoked on the main thread once decode succeeds, should create GPU objects and return false on failure</param>
+	static void QueueAsyncLoad(const IResource::Sptr& resource, const std::function<bool()>& decode, const std::function<bool()>& upload);
+	/// <summary>
+	/// Performs GPU uploads for resources that have finished decoding, should be called once per frame
+	/// from the main thread. At least one upload will be processed per call
+	/// </summary>
+	/// <param name="budgetMs">The maximum amount of time to spend on uploads, in milliseconds</param>
+	static void ProcessUploads(float budgetMs);
+	/// <summary>
+	/// Blocks until all outstanding asynchronous loads have completed
+	/// </summary>
+	/// <param name="discard">True to drop the loads rather than uploading them (ex: when shutting down)</param>
+	static void FlushAsyncLoads(bool discard = false);
+	/// <summary>
+	/// Gets the number of asynchronous loads that have not yet completed
+	/// </summary>
+	static uint32_t GetPendingLoadCount();
+	/// <summary>
+	/// Gets the progress of the current batch of asynchronous loads, in the 0-1 range. Will be 1 when
+	/// no loads are pending
+	/// </summary>
+	static float GetLoadProgress();
+
 protected:
 	/// <summary>
 	/// This is a map of maps
 	/// The top level map uses type_index, so there's a map per resource type
 	/// The inner map handles mapping GUIDs to the corresponding resource
 	/// </summary>
-	static std::map<std::type_index, std::map<Guid, IResource::Sptr>> _resources;
+	static std::unordered_map<std::type_index, std::unordered_map<Guid, IResource::Sptr>> _resources;
+
+	/// <summary>
+	/// Looks up a resource that has already been loaded, without modifying the resource store
+	/// </summary>
+	template <typename T>
+	static std::shared_ptr<T> _Find(const Guid& id) {
+		auto storeIt = _resources.find(std::type_index(typeid(T)));
+		if (storeIt != _resources.end()) {
+			auto it = storeIt->second.find(id);
+			if (it != storeIt->second.end()) {
+				// Resources are only ever stored under their own type, so we don't need a dynamic cast
+				return std::static_pointer_cast<T>(it->second);
+			}
+		}
+		return nullptr;
+	}
 	/// <summary>
 	/// This map stores registered types, so we can load them from JSON files
 	/// </summary>
 	static std::map<std::string, std::function<Guid(const nlohmann::json&)>> _typeLoaders;
+	static std::map<std::string, std::type_index> _typeIndices;
 
 	/// <summary>
 	/// We use an ORDERED JSON file to allow serializing types in the order they are registered.
 	/// This allows us to register dependencies before the dependent resource
 	/// </summary>
 	static nlohmann::ordered_json _manifest;
+
+	/// <summary>
+	/// Represents a single asynchronous load as it moves through the pipeline
+	/// </summary>
+	struct AsyncLoad {
+		IResource::Sptr       Resource;
+		std::function<bool()> Decode;
+		std::function<bool()> Upload;
+		bool                  DecodeSucceeded = false;
+		double                DecodeSeconds = 0.0;
+		bool                  Submitted = false;
+	};
+
+	// The maximum number of loads that may be decoded but not yet uploaded, bounds memory use
+	// from decoded images and meshes that are waiting on the main thread
+	static const uint32_t MAX_LOADS_IN_FLIGHT = 16;
+
+	static std::map<Guid, LoadTiming> _loadTimings;
+	// The assets in the current manifest preload, reported on once they have all finished loading
+	static std::vector<Guid>     _preloadedAssets;
+	static double                _preloadStartTime;
+
+	static bool                  _asyncEnabled;
+	// Loads that have been requested, but not yet submitted to the thread pool (main thread only)
+	static std::deque<AsyncLoad> _waitingLoads;
+	// Loads that have been decoded and are waiting for upload (shared with workers)
+	static std::deque<AsyncLoad> _decodedLoads;
+	static std::mutex            _decodedLoadsMutex;
+	// Number of loads that have been submitted to the thread pool but not uploaded (main thread only)
+	static uint32_t              _loadsInFlight;
+	// Counters for the current batch of loads, used for progress reporting
+	static uint32_t              _batchQueued;
+	static uint32_t              _batchCompleted;
+
+	static void _SubmitWaitingLoads();
+	static void _CompleteLoad(AsyncLoad& load, bool upload);
+
+	/// <summary>
+	/// Loads all assets in the current manifest, ordered so that dependencies are loaded first
+	/// </summary>
+	static void _PreloadManifest(bool wait);
+	/// <summary>
+	/// Recursively collects any manifest assets that are referenced by GUID in the given blob
+	/// </summary>
+	static void _CollectDependencies(const nlohmann::json& blob, const std::unordered_map<std::string, uint32_t>& guidLookup, std::vector<uint32_t>& result);
+	/// <summary>
+	/// Logs the load times for the last manifest preload, slowest assets first
+	/// </summary>
+	static void _ReportPreloadTimings();
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Utils/StringUtils.h"
+#include <cstdint>
 
 std::string StringTools::SanitizeClassName(const std::string& name)
 {
@@ -65,3 +66,107 @@ int StringTools::Split(const std::string& s, std::vector<std::string>& results,
 	results.push_back(s.substr(lastPos, seek));
 	return ++result;
 }
+
+void StringTools::Utf8ToWide(const std::string& s, std::wstring& result) {
+	result.clear();
+	result.reserve(s.size());
+
+	const size_t length = s.size();
+	size_t ix = 0;
+	while (ix < length) {
+		uint8_t lead = static_cast<uint8_t>(s[ix]);
+
+		// ASCII fast path
+		if (lead < 0x80) {
+			result.push_back(static_cast<wchar_t>(lead));
+			ix++;
+			continue;
+		}
+
+		// Determine the sequence length and the bits held by the lead byte
+		size_t   extra;
+		uint32_t codepoint;
+		uint32_t minValue;
+		if ((lead & 0xE0) == 0xC0) {
+			extra = 1; codepoint = lead & 0x1F; minValue = 0x80;
+		} else if ((lead & 0xF0) == 0xE0) {
+			extra = 2; codepoint = lead & 0x0F; minValue = 0x800;
+		} else if ((lead & 0xF8) == 0xF0) {
+			extra = 3; codepoint = lead & 0x07; minValue = 0x10000;
+		} else {
+			result.push_back(static_cast<wchar_t>(0xFFFD));
+			ix++;
+			continue;
+		}
+
+		// Consume continuation bytes, stopping at the first one that is malformed
+		size_t consumed = 1;
+		bool valid = ix + extra < length;
+		for (; valid && consumed <= extra; consumed++) {
+			uint8_t next = static_cast<uint8_t>(s[ix + consumed]);
+			if ((next & 0xC0) != 0x80) {
+				valid = false;
+				break;
+			}
+			codepoint = (codepoint << 6) | (next & 0x3F);
+		}
+		if (!valid || codepoint < minValue || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+			result.push_back(static_cast<wchar_t>(0xFFFD));
+			ix += consumed;
+			continue;
+		}
+		ix += extra + 1;
+
+		// Platforms with a 16 bit wchar_t (ex: Windows) store wide strings as UTF-16
+		if (sizeof(wchar_t) == 2 && codepoint > 0xFFFF) {
+			codepoint -= 0x10000;
+			result.push_back(static_cast<wchar_t>(0xD800 + (codepoint >> 10)));
+			result.push_back(static_cast<wchar_t>(0xDC00 + (codepoint & 0x3FF)));
+		} else {
+			result.push_back(static_cast<wchar_t>(codepoint));
+		}
+	}
+}
+
+std::wstring StringTools::Utf8ToWide(const std::string& s) {
+	std::wstring result;
+	Utf8ToWide(s, result);
+	return result;
+}
+
+std::string StringTools::WideToUtf8(const std::wstring& s) {
+	std::string result;
+	result.reserve(s.size());
+
+	for (size_t ix = 0; ix < s.size(); ix++) {
+		uint32_t codepoint = static_cast<uint32_t>(s[ix]);
+
+		// Re-combine UTF-16 surrogate pairs, lone surrogates are replaced
+		if (sizeof(wchar_t) == 2 && codepoint >= 0xD800 && codepoint <= 0xDFFF) {
+			uint32_t low = ix + 1 < s.size() ? static_cast<uint32_t>(s[ix + 1]) : 0;
+			if (codepoint <= 0xDBFF && low >= 0xDC00 && low <= 0xDFFF) {
+				codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+				ix++;
+			} else {
+				codepoint = 0xFFFD;
+			}
+		}
+
+		if (codepoint < 0x80) {
+			result.push_back(static_cast<char>(codepoint));
+		} else if (codepoint < 0x800) {
+			result.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+			result.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+		} else if (codepoint < 0x10000) {
+			result.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+			result.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+			result.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+		} else {
+			result.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+			result.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+			result.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+			result.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+		}
+	}
+	return result;
+}
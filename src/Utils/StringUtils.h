@@ -115,4 +115,24 @@ public:
 	/// <param name="splitOn">The delimiter string to split on</param>
 	/// <returns>The number of tokens this command appended to the results</returns>
 	static int Split(const std::string& s, std::vector<std::string>& results, const std::string& splitOn = ",");
+
+	/// <summary>
+	/// Decodes a UTF-8 string into a wide string, without going through std::wstring_convert.
+	/// ASCII characters are copied directly, and invalid sequences are replaced with U+FFFD
+	/// </summary>
+	/// <param name="s">The UTF-8 string to decode</param>
+	/// <param name="result">The wide string to store the result in, existing contents are replaced</param>
+	static void Utf8ToWide(const std::string& s, std::wstring& result);
+	/// <summary>
+	/// Decodes a UTF-8 string into a wide string
+	/// </summary>
+	/// <param name="s">The UTF-8 string to decode</param>
+	/// <returns>The decoded wide string</returns>
+	static std::wstring Utf8ToWide(const std::string& s);
+	/// <summary>
+	/// Encodes a wide string into UTF-8, without going through std::wstring_convert
+	/// </summary>
+	/// <param name="s">The wide string to encode</param>
+	/// <returns>The UTF-8 encoded string</returns>
+	static std::string WideToUtf8(const std::wstring& s);
 };
\ No newline at end of file
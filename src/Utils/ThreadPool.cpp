@@ -0,0 +1,132 @@
+#include "Utils/ThreadPool.h"
+#include <Logging.h>
+
+std::vector<std::thread>          ThreadPool::_workers;
+std::deque<std::function<void()>> ThreadPool::_queue;
+std::mutex                        ThreadPool::_queueMutex;
+std::condition_variable           ThreadPool::_queueCondition;
+bool                              ThreadPool::_isRunning = false;
+thread_local bool                 ThreadPool::_isWorker = false;
+
+void ThreadPool::Init(uint32_t numThreads) {
+	LOG_ASSERT(!_isRunning, "Thread pool has already been initialized!");
+
+	// Leave one hardware thread for the main thread by default
+	if (numThreads == 0) {
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		numThreads = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	_isRunning = true;
+	_workers.reserve(numThreads);
+	for (uint32_t ix = 0; ix < numThreads; ix++) {
+		_workers.emplace_back(&ThreadPool::_WorkerMain);
+	}
+
+	LOG_INFO("Started thread pool with {} workers", numThreads);
+}
+
+void ThreadPool::Shutdown() {
+	{
+		std::unique_lock<std::mutex> lock(_queueMutex);
+		if (!_isRunning) return;
+		_isRunning = false;
+	}
+
+	// Wake everyone up so they can drain the queue and exit
+	_queueCondition.notify_all();
+	for (auto& worker : _workers) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+	_workers.clear();
+}
+
+uint32_t ThreadPool::GetNumThreads() {
+	return static_cast<uint32_t>(_workers.size());
+}
+
+bool ThreadPool::IsWorkerThread() {
+	return _isWorker;
+}
+
+void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func, uint32_t minBatchSize) {
+	if (count == 0) return;
+
+	// Figure out how many batches we want, we include the calling thread in the count
+	uint32_t numThreads = GetNumThreads() + 1;
+	uint32_t batchSize = std::max(minBatchSize, (count + numThreads - 1) / numThreads);
+	uint32_t numBatches = (count + batchSize - 1) / batchSize;
+
+	// Not worth farming out, or we're already on a worker (avoid waiting on ourselves)
+	if (numBatches <= 1 || _workers.empty() || _isWorker) {
+		for (uint32_t ix = 0; ix < count; ix++) {
+			func(ix);
+		}
+		return;
+	}
+
+	// Batches are claimed by index so that the calling thread can steal work while it waits
+	std::shared_ptr<std::atomic<uint32_t>> nextBatch = std::make_shared<std::atomic<uint32_t>>(0);
+	std::shared_ptr<std::atomic<uint32_t>> remaining = std::make_shared<std::atomic<uint32_t>>(numBatches);
+	std::shared_ptr<std::promise<void>> done = std::make_shared<std::promise<void>>();
+	std::future<void> doneFuture = done->get_future();
+
+	auto runBatches = [=, &func]() {
+		uint32_t batch;
+		while ((batch = nextBatch->fetch_add(1)) < numBatches) {
+			uint32_t end = std::min(count, (batch + 1) * batchSize);
+			for (uint32_t ix = batch * batchSize; ix < end; ix++) {
+				func(ix);
+			}
+			if (remaining->fetch_sub(1) == 1) {
+				done->set_value();
+			}
+		}
+	};
+
+	// One helper per worker, the calling thread does the rest
+	uint32_t helpers = std::min(numBatches - 1, GetNumThreads());
+	for (uint32_t ix = 0; ix < helpers; ix++) {
+		_Push(runBatches);
+	}
+	runBatches();
+
+	// func is captured by reference, so we must not return until every batch has finished
+	doneFuture.wait();
+}
+
+void ThreadPool::_Push(std::function<void()>&& work) {
+	{
+		std::unique_lock<std::mutex> lock(_queueMutex);
+		// If we have no workers, just do the work right now
+		if (!_isRunning) {
+			lock.unlock();
+			work();
+			return;
+		}
+		_queue.push_back(std::move(work));
+	}
+	_queueCondition.notify_one();
+}
+
+void ThreadPool::_WorkerMain() {
+	_isWorker = true;
+	while (true) {
+		std::function<void()> work;
+		{
+			std::unique_lock<std::mutex> lock(_queueMutex);
+			_queueCondition.wait(lock, []() { return !_isRunning || !_queue.empty(); });
+
+			// Only exit once the queue has been drained
+			if (!_isRunning && _queue.empty()) {
+				return;
+			}
+
+			work = std::move(_queue.front());
+			_queue.pop_front();
+		}
+		work();
+	}
+}
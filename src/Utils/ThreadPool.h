@@ -0,0 +1,79 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+/// <summary>
+/// A simple fixed size pool of worker threads that the engine can push CPU
+/// work onto (file IO, decoding, parsing). Work items must NOT touch OpenGL,
+/// since the GL context is only current on the main thread
+/// </summary>
+class ThreadPool {
+public:
+	ThreadPool() = delete;
+
+	/// <summary>
+	/// Spins up the worker threads, should be called once at application startup
+	/// </summary>
+	/// <param name="numThreads">The number of workers to create, or 0 to use one less than the hardware thread count</param>
+	static void Init(uint32_t numThreads = 0);
+	/// <summary>
+	/// Waits for all queued work to finish and joins all worker threads
+	/// </summary>
+	static void Shutdown();
+
+	/// <summary>
+	/// Gets the number of worker threads in the pool
+	/// </summary>
+	static uint32_t GetNumThreads();
+	/// <summary>
+	/// Returns true if the calling thread is one of the pool's worker threads
+	/// </summary>
+	static bool IsWorkerThread();
+
+	/// <summary>
+	/// Pushes a work item onto the pool, returning a future that will hold the result of the function
+	/// If the pool has not been initialized, the function is invoked immediately on the calling thread
+	/// </summary>
+	/// <typeparam name="Func">The type of callable to invoke</typeparam>
+	/// <param name="func">The function to invoke on a worker thread</param>
+	/// <returns>A future that can be used to retrieve the result of func</returns>
+	template <typename Func>
+	static auto Enqueue(Func&& func) -> std::future<decltype(func())> {
+		typedef decltype(func()) ResultType;
+
+		// packaged_task is not copyable, so we wrap it in a shared pointer so it can live in a std::function
+		std::shared_ptr<std::packaged_task<ResultType()>> task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<Func>(func));
+		std::future<ResultType> result = task->get_future();
+		_Push([task]() { (*task)(); });
+		return result;
+	}
+
+	/// <summary>
+	/// Invokes func(ix) for every ix in [0, count), splitting the range into batches across the
+	/// worker threads. The calling thread will also process batches, and will block until all
+	/// iterations have completed
+	/// </summary>
+	/// <param name="count">The number of iterations to perform</param>
+	/// <param name="func">The function to invoke for each index</param>
+	/// <param name="minBatchSize">The smallest number of iterations to hand to a single worker</param>
+	static void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func, uint32_t minBatchSize = 32);
+
+protected:
+	static std::vector<std::thread>          _workers;
+	static std::deque<std::function<void()>> _queue;
+	static std::mutex                        _queueMutex;
+	static std::condition_variable           _queueCondition;
+	static bool                              _isRunning;
+
+	static thread_local bool                 _isWorker;
+
+	static void _Push(std::function<void()>&& work);
+	static void _WorkerMain();
+};